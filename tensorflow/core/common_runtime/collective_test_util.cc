@@ -19,6 +19,7 @@ limitations under the License.
 #include "absl/synchronization/notification.h"
 #include "tensorflow/core/common_runtime/base_collective_executor.h"
 #include "tensorflow/core/common_runtime/device_resolver_local.h"
+#include "tensorflow/core/common_runtime/local_device.h"
 #include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/common_runtime/threadpool_device.h"
 #include "tensorflow/core/framework/cancellation.h"
@@ -88,9 +89,14 @@ namespace {
 constexpr int kStepId = 0;
 
 std::vector<std::unique_ptr<Device>> CreateCPUDevices(
-    int num_workers, int num_devices_per_worker) {
+    int num_workers, int num_devices_per_worker, int num_intra_op_threads) {
   SessionOptions sess_opts;
   sess_opts.env = Env::Default();
+  // The size only applies to devices that do not share the global pool.
+  if (num_intra_op_threads > 0) {
+    sess_opts.config.set_intra_op_parallelism_threads(num_intra_op_threads);
+    LocalDevice::set_use_global_threadpool(false);
+  }
   Bytes mem_limit(4 << 20);
   DeviceLocality dev_locality;
   std::vector<std::unique_ptr<Device>> devices;
@@ -102,6 +108,7 @@ std::vector<std::unique_ptr<Device>> CreateCPUDevices(
           sess_opts, dev_name, mem_limit, dev_locality, cpu_allocator()));
     }
   }
+  if (num_intra_op_threads > 0) LocalDevice::set_use_global_threadpool(true);
   return devices;
 }
 
@@ -141,7 +148,7 @@ std::vector<std::unique_ptr<Device>> CreateGPUDevices() {
 
 std::unique_ptr<CollectiveTestEnv> CreateCollectiveTestEnv(
     int num_workers, int num_devices_per_worker, DeviceType device_type,
-    bool use_nccl) {
+    bool use_nccl, int num_intra_op_threads) {
   auto test_env = std::make_unique<CollectiveTestEnv>();
   test_env->param_resolver = std::make_unique<TestParamResolver>();
   // We don't create CollecticeExecutor from the CollecticeExecutorMgr so we
@@ -154,7 +161,8 @@ std::unique_ptr<CollectiveTestEnv> CreateCollectiveTestEnv(
 
   std::vector<std::unique_ptr<Device>> devices;
   if (device_type == DEVICE_CPU) {
-    devices = CreateCPUDevices(num_workers, num_devices_per_worker);
+    devices = CreateCPUDevices(num_workers, num_devices_per_worker,
+                               num_intra_op_threads);
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
   } else if (device_type == DEVICE_GPU) {
     CHECK(num_workers == 1) << "GPU only supports single worker tests";
@@ -88,9 +88,11 @@ struct CollectiveTestEnv {
   CollectiveTestEnv() : device_type(DEVICE_DEFAULT) {}
 };
 
+// If `num_intra_op_threads` is positive, every CPU device gets its own
+// intra-op pool of that size instead of sharing the global one.
 std::unique_ptr<CollectiveTestEnv> CreateCollectiveTestEnv(
     int num_workers, int num_devices_per_worker, DeviceType device_type,
-    bool use_nccl = false);
+    bool use_nccl = false, int num_intra_op_threads = 0);
 
 core::RefCountPtr<CollectiveParams> CreateCollectiveParams(
     const CollectiveTestEnv& test_env, int rank,
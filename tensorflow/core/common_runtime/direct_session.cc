@@ -52,6 +52,7 @@ limitations under the License.
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/graph_def_util.h"
+#include "tensorflow/core/framework/inter_op_scheduler.h"
 #include "tensorflow/core/framework/log_memory.h"
 #include "tensorflow/core/framework/logging.h"
 #include "tensorflow/core/framework/metrics.h"
@@ -75,6 +76,7 @@ limitations under the License.
 #include "tensorflow/core/lib/monitoring/counter.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/nccl/collective_communicator.h"
@@ -200,6 +202,37 @@ std::string GetRendezvousKey(const std::string& tensor_name,
                          frame_iter.frame_id, ":", frame_iter.iter_id);
 }
 
+// Rough per-node memory of a partition graph, its executor and its kernel,
+// on top of the size of the node's NodeDef.
+constexpr int64_t kExecutorBytesPerNode = 512;
+
+// Returns true if the kernel of the stateless node `node_def` may be shared
+// by every executor of the session that contains an identical node. Kernels
+// that call functions are tied to the FunctionLibraryRuntime of one executor
+// and are never shared.
+bool IsShareableStatelessKernel(FunctionLibraryRuntime* lib,
+                                const NodeDef& node_def) {
+  if (lib->IsStateful(node_def.op()) ||
+      lib->GetFunctionLibraryDefinition()->Find(node_def.op()) != nullptr) {
+    return false;
+  }
+  for (const auto& attr : node_def.attr()) {
+    if (attr.second.has_func() || attr.second.list().func_size() > 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the key of the shared stateless kernel of `node_def` on `device`.
+// Unlike stateful kernels, which are keyed by node name, it includes a hash
+// of the node, since pruning and optimization may give nodes with the same
+// name different inputs or attrs in different executors.
+std::string SharedKernelKey(const Device& device, const NodeDef& node_def) {
+  return absl::StrCat(device.name(), ";", node_def.name(), ";",
+                      strings::FpToString(DeterministicProtoHash64(node_def)));
+}
+
 }  // namespace
 
 class DirectSessionFactory : public SessionFactory {
@@ -303,8 +336,10 @@ static DirectSessionRegistrar registrar;
 
 std::atomic_int_fast64_t DirectSession::step_id_counter_(1);
 
-static RunHandlerPool* GetOrCreateRunHandlerPool(
-    const SessionOptions& options) {
+// Returns the number of inter-op and intra-op threads of the process-wide
+// run-handler pool or inter-op scheduler.
+static void GetRunHandlerThreadCounts(const SessionOptions& options,
+                                      int* inter_threads, int* intra_threads) {
   int num_inter_threads = 0;
   int num_intra_threads = 0;
   static const int env_num_inter_threads = NumInterOpThreadsFromEnvironment();
@@ -335,7 +370,16 @@ static RunHandlerPool* GetOrCreateRunHandlerPool(
     }
   }
 
+  *inter_threads = num_inter_threads;
+  *intra_threads = num_intra_threads;
+}
+
+static RunHandlerPool* GetOrCreateRunHandlerPool(
+    const SessionOptions& options) {
   static RunHandlerPool* pool = [&]() {
+    int num_inter_threads;
+    int num_intra_threads;
+    GetRunHandlerThreadCounts(options, &num_inter_threads, &num_intra_threads);
     LOG(INFO) << "Creating run-handler pool with "
                  "[num_inter_threads, num_intra_threads] as ["
               << num_inter_threads << "," << num_intra_threads << "]";
@@ -344,6 +388,37 @@ static RunHandlerPool* GetOrCreateRunHandlerPool(
   return pool;
 }
 
+// Returns true if TF_RUN_HANDLER_USE_INTER_OP_SCHEDULER selects the
+// InterOpScheduler for runs that ask for the run-handler pool.
+static bool UseInterOpScheduler() {
+  static const bool use_inter_op_scheduler = [] {
+    bool flag;
+    auto status = ReadBoolFromEnvVar("TF_RUN_HANDLER_USE_INTER_OP_SCHEDULER",
+                                     /*default_val=*/false, &flag);
+    if (!status.ok()) {
+      LOG(ERROR) << "UseInterOpScheduler: " << status.message();
+      return false;
+    }
+    return flag;
+  }();
+  return use_inter_op_scheduler;
+}
+
+static InterOpScheduler* GetOrCreateInterOpScheduler(
+    const SessionOptions& options) {
+  static InterOpScheduler* scheduler = [&]() {
+    int num_inter_threads;
+    int num_intra_threads;
+    GetRunHandlerThreadCounts(options, &num_inter_threads, &num_intra_threads);
+    LOG(INFO) << "Creating inter-op scheduler with " << num_inter_threads
+              << " threads";
+    InterOpScheduler::Options scheduler_options;
+    scheduler_options.num_threads = num_inter_threads;
+    return new InterOpScheduler(Env::Default(), scheduler_options);
+  }();
+  return scheduler;
+}
+
 bool DirectSession::ShouldUseRunHandlerPool(
     const RunOptions& run_options) const {
   if (options_.config.use_per_session_threads()) return false;
@@ -406,6 +481,17 @@ DirectSession::DirectSession(const SessionOptions& options,
   if (!status.ok()) {
     LOG(ERROR) << status.message();
   }
+  absl::Status cache_status =
+      ReadInt64FromEnvVar("TF_DIRECT_SESSION_EXECUTOR_CACHE_MAX_BYTES", 0,
+                          &executor_cache_max_bytes_);
+  cache_status.Update(ReadBoolFromEnvVar(
+      "TF_DIRECT_SESSION_SHARE_STATELESS_KERNELS", false,
+      &share_stateless_kernels_));
+  cache_status.Update(ReadBoolFromEnvVar(
+      "TF_DIRECT_SESSION_LAZY_KERNEL_CREATION", false, &lazy_kernel_creation_));
+  if (!cache_status.ok()) {
+    LOG(ERROR) << cache_status.message();
+  }
   session_handle_ =
       absl::StrCat("direct", strings::FpToString(random::New64()));
   if (options.config.log_device_placement()) {
@@ -688,8 +774,16 @@ absl::Status DirectSession::RunInternal(
   }
 
   std::unique_ptr<RunHandler> handler;
+  std::unique_ptr<InterOpScheduler::Request> scheduler_request;
   if (ShouldUseRunHandlerPool(run_options) &&
-      run_options.experimental().use_run_handler_pool()) {
+      run_options.experimental().use_run_handler_pool() &&
+      UseInterOpScheduler()) {
+    VLOG(1) << "Using InterOpScheduler to schedule inter-op closures.";
+    scheduler_request = GetOrCreateInterOpScheduler(options_)->CreateRequest(
+        run_options.experimental().run_handler_pool_options().priority(),
+        deadline ? absl::ToUnixMicros(*deadline) : 0);
+  } else if (ShouldUseRunHandlerPool(run_options) &&
+             run_options.experimental().use_run_handler_pool()) {
     VLOG(1) << "Using RunHandler to scheduler inter-op closures.";
     handler = GetOrCreateRunHandlerPool(options_)->Get(
         step_id, call_timeout,
@@ -701,6 +795,7 @@ absl::Status DirectSession::RunInternal(
     }
   }
   auto* handler_ptr = handler.get();
+  auto* scheduler_request_ptr = scheduler_request.get();
 
   Executor::Args::Runner default_runner = nullptr;
 
@@ -710,6 +805,10 @@ absl::Status DirectSession::RunInternal(
     default_runner = [handler_ptr](Executor::Args::Closure c) {
       handler_ptr->ScheduleInterOpClosure(std::move(c));
     };
+  } else if (scheduler_request_ptr != nullptr) {
+    default_runner = [scheduler_request_ptr](Executor::Args::Closure c) {
+      scheduler_request_ptr->ScheduleInterOpClosure(std::move(c));
+    };
   } else {
     default_runner = [pool](Executor::Args::Closure c) {
       pool->Schedule(std::move(c));
@@ -942,7 +1041,7 @@ absl::Status DirectSession::Run(
   metrics::RecordGraphInputTensors(input_size);
 
   // Check if we already have an executor for these arguments.
-  ExecutorsAndKeys* executors_and_keys;
+  std::shared_ptr<ExecutorsAndKeys> executors_and_keys;
   RunStateArgs run_state_args(run_options.debug_options());
   run_state_args.collective_graph_key =
       run_options.experimental().collective_graph_key();
@@ -985,7 +1084,7 @@ absl::Status DirectSession::Run(
   }
 
   TF_RETURN_IF_ERROR(RunInternal(step_id, run_options, &call_frame,
-                                 executors_and_keys, run_metadata,
+                                 executors_and_keys.get(), run_metadata,
                                  threadpool_options));
 
   // Receive outputs.
@@ -1043,7 +1142,7 @@ absl::Status DirectSession::PRunSetup(
   thread::ThreadPool* pool = thread_pools_[0].first;
 
   // Check if we already have an executor for these arguments.
-  ExecutorsAndKeys* executors_and_keys;
+  std::shared_ptr<ExecutorsAndKeys> executors_and_keys;
   // TODO(cais): TFDBG support for partial runs.
   DebugOptions debug_options;
   RunStateArgs run_state_args(debug_options);
@@ -1476,10 +1575,23 @@ absl::Status DirectSession::CreateExecutors(
     params.device = device;
     params.session_metadata = session_metadata;
     params.function_library = lib;
+    params.lazy_kernel_creation = lazy_kernel_creation_;
     auto opseg = device->op_segment();
+    const bool share_stateless_kernels = share_stateless_kernels_;
     params.create_kernel =
-        [this, lib, opseg](const std::shared_ptr<const NodeProperties>& props,
-                           OpKernel** kernel) {
+        [this, lib, device, opseg, share_stateless_kernels](
+            const std::shared_ptr<const NodeProperties>& props,
+            OpKernel** kernel) {
+          auto create_fn = [lib, &props](OpKernel** kernel) {
+            return lib->CreateKernel(props, kernel);
+          };
+          // Identical stateless nodes of different subgraphs can share one
+          // kernel, so that it is only instantiated for the first signature.
+          if (share_stateless_kernels &&
+              IsShareableStatelessKernel(lib, props->node_def)) {
+            return FindOrCreateSharedKernel(
+                SharedKernelKey(*device, props->node_def), create_fn, kernel);
+          }
           // NOTE(mrry): We must not share function kernels (implemented
           // using `CallOp`) between subgraphs, because `CallOp::handle_`
           // is tied to a particular subgraph. Even if the function itself
@@ -1487,18 +1599,21 @@ absl::Status DirectSession::CreateExecutors(
           if (!OpSegment::ShouldOwnKernel(lib, props->node_def.op())) {
             return lib->CreateKernel(props, kernel);
           }
-          auto create_fn = [lib, &props](OpKernel** kernel) {
-            return lib->CreateKernel(props, kernel);
-          };
           // Kernels created for subgraph nodes need to be cached.  On
           // cache miss, create_fn() is invoked to create a kernel based
           // on the function library here + global op registry.
           return opseg->FindOrCreate(session_handle_, props->node_def.name(),
                                      kernel, create_fn);
         };
-    params.delete_kernel = [lib](OpKernel* kernel) {
-      if (kernel && !OpSegment::ShouldOwnKernel(lib, kernel->type_string()))
+    params.delete_kernel = [this, lib, device,
+                            share_stateless_kernels](OpKernel* kernel) {
+      if (kernel == nullptr) return;
+      if (share_stateless_kernels &&
+          IsShareableStatelessKernel(lib, kernel->def())) {
+        ReleaseSharedKernel(SharedKernelKey(*device, kernel->def()));
+      } else if (!OpSegment::ShouldOwnKernel(lib, kernel->type_string())) {
         delete kernel;
+      }
     };
 
     optimizer.Optimize(lib, options_.env, device, &partition_graph,
@@ -1516,6 +1631,10 @@ absl::Status DirectSession::CreateExecutors(
                                          device->name(),
                                          partition_graph.get()));
 
+    for (const Node* n : partition_graph->nodes()) {
+      ek->estimated_bytes += kExecutorBytesPerNode + n->def().ByteSizeLong();
+    }
+
     item->executor = nullptr;
     item->device = device;
     auto executor_type = options_.config.experimental().executor_type();
@@ -1568,7 +1687,8 @@ absl::Status DirectSession::CreateExecutors(
 absl::Status DirectSession::GetOrCreateExecutors(
     absl::Span<const std::string> inputs, absl::Span<const std::string> outputs,
     absl::Span<const std::string> target_nodes,
-    ExecutorsAndKeys** executors_and_keys, RunStateArgs* run_state_args) {
+    std::shared_ptr<ExecutorsAndKeys>* executors_and_keys,
+    RunStateArgs* run_state_args) {
   int64_t handle_name_counter_value = -1;
   if (LogMemory::IsEnabled() || run_state_args->is_partial_run) {
     handle_name_counter_value = handle_name_counter_.fetch_add(1);
@@ -1595,7 +1715,8 @@ absl::Status DirectSession::GetOrCreateExecutors(
     mutex_lock l(executor_lock_);  // could use reader lock
     auto it = executors_.find(key);
     if (it != executors_.end()) {
-      *executors_and_keys = it->second.get();
+      it->second->last_use = ++executor_cache_clock_;
+      *executors_and_keys = it->second;
       return absl::OkStatus();
     }
   }
@@ -1628,7 +1749,8 @@ absl::Status DirectSession::GetOrCreateExecutors(
     mutex_lock l(executor_lock_);
     auto it = executors_.find(sorted_key);
     if (it != executors_.end()) {
-      *executors_and_keys = it->second.get();
+      it->second->last_use = ++executor_cache_clock_;
+      *executors_and_keys = it->second;
       return absl::OkStatus();
     }
   }
@@ -1659,25 +1781,157 @@ absl::Status DirectSession::GetOrCreateExecutors(
   TF_RETURN_IF_ERROR(
       CreateExecutors(callable_options, &ek, &func_info, run_state_args));
 
+  // Evicted executors are destroyed after the lock is released.
+  std::vector<std::shared_ptr<ExecutorsAndKeys>> evicted;
   // Reacquire the lock, try to insert into the map.
   mutex_lock l(executor_lock_);
 
   // Another thread may have created the entry before us, in which case we will
   // reuse the already created one.
+  if (executor_cache_max_bytes_ > 0) {
+    ek->function_info = std::move(func_info);
+  }
   auto insert_result = executors_.emplace(
       sorted_key, std::shared_ptr<ExecutorsAndKeys>(std::move(ek)));
   if (insert_result.second) {
-    functions_.push_back(std::move(func_info));
+    if (func_info != nullptr) {
+      functions_.push_back(std::move(func_info));
+    }
+    executor_cache_bytes_ += insert_result.first->second->estimated_bytes;
   }
+  insert_result.first->second->last_use = ++executor_cache_clock_;
 
   // Insert the value under the original key, so the fast path lookup will work
   // if the user uses the same order of inputs, outputs, and targets again.
   executors_.emplace(key, insert_result.first->second);
-  *executors_and_keys = insert_result.first->second.get();
+  *executors_and_keys = insert_result.first->second;
 
+  if (executor_cache_max_bytes_ > 0) {
+    EvictExecutorsLocked(executors_and_keys->get(), &evicted);
+  }
   return absl::OkStatus();
 }
 
+void DirectSession::EvictExecutorsLocked(
+    const ExecutorsAndKeys* keep,
+    std::vector<std::shared_ptr<ExecutorsAndKeys>>* evicted) {
+  while (executor_cache_bytes_ > executor_cache_max_bytes_) {
+    const ExecutorsAndKeys* victim = nullptr;
+    for (const auto& it : executors_) {
+      const ExecutorsAndKeys* ek = it.second.get();
+      // PRun() looks up the executors of a partial run by key, so they are
+      // never evicted.
+      if (ek == keep || ek->graph != nullptr) continue;
+      if (victim == nullptr || ek->last_use < victim->last_use) victim = ek;
+    }
+    if (victim == nullptr) return;
+    VLOG(1) << "Evicting executors for " << victim->items.size()
+            << " partitions (" << victim->estimated_bytes << " bytes)";
+    executor_cache_bytes_ -= victim->estimated_bytes;
+    // Runs that are still using `victim` hold their own reference to it.
+    for (auto it = executors_.begin(); it != executors_.end();) {
+      if (it->second.get() == victim) {
+        evicted->push_back(std::move(it->second));
+        it = executors_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+}
+
+void DirectSession::PrecompileAsync(
+    std::vector<RunSignature> signatures,
+    std::function<void(const absl::Status&)> done) {
+  absl::Status s = CheckNotClosed();
+  if (s.ok()) s = CheckGraphCreated("PrecompileAsync()");
+  if (!s.ok() || signatures.empty()) {
+    done(s);
+    return;
+  }
+
+  struct PrecompileState {
+    mutex mu;
+    absl::Status status TF_GUARDED_BY(mu);
+    size_t pending TF_GUARDED_BY(mu);
+    std::function<void(const absl::Status&)> done;
+  };
+  auto state = std::make_shared<PrecompileState>();
+  state->pending = signatures.size();
+  state->done = std::move(done);
+
+  thread::ThreadPool* pool = thread_pools_[0].first;
+  for (RunSignature& signature : signatures) {
+    // Counted as an active run, so that the destructor waits for it.
+    active_runs_.fetch_add(1, std::memory_order_relaxed);
+    pool->Schedule([this, state, signature = std::move(signature)]() {
+      absl::Status s = CheckNotClosed();
+      if (s.ok()) {
+        // Matches the signature of a Run() call without RunOptions.
+        DebugOptions debug_options;
+        RunStateArgs run_state_args(debug_options);
+        std::shared_ptr<ExecutorsAndKeys> executors_and_keys;
+        s = GetOrCreateExecutors(signature.feeds, signature.fetches,
+                                 signature.targets, &executors_and_keys,
+                                 &run_state_args);
+      }
+      absl::Status status;
+      bool last;
+      {
+        mutex_lock l(state->mu);
+        state->status.Update(s);
+        last = --state->pending == 0;
+        status = state->status;
+      }
+      // `done` may delete the session, so the run must be over by then.
+      active_runs_.fetch_sub(1, std::memory_order_acq_rel);
+      if (last) state->done(status);
+    });
+  }
+}
+
+absl::Status DirectSession::FindOrCreateSharedKernel(
+    const std::string& key,
+    const std::function<absl::Status(OpKernel**)>& create_fn,
+    OpKernel** kernel) {
+  {
+    mutex_lock l(shared_kernels_mu_);
+    auto it = shared_kernels_.find(key);
+    if (it != shared_kernels_.end()) {
+      ++it->second.refs;
+      *kernel = it->second.kernel;
+      return absl::OkStatus();
+    }
+  }
+  // Kernels are created without holding the lock, so that executors built
+  // concurrently do not wait for each other.
+  OpKernel* created = nullptr;
+  TF_RETURN_IF_ERROR(create_fn(&created));
+  OpKernel* duplicate = nullptr;
+  {
+    mutex_lock l(shared_kernels_mu_);
+    auto result = shared_kernels_.emplace(key, SharedKernel{created, 0});
+    if (!result.second) duplicate = created;
+    ++result.first->second.refs;
+    *kernel = result.first->second.kernel;
+  }
+  // Another executor created the same kernel first.
+  delete duplicate;
+  return absl::OkStatus();
+}
+
+void DirectSession::ReleaseSharedKernel(const std::string& key) {
+  OpKernel* kernel = nullptr;
+  {
+    mutex_lock l(shared_kernels_mu_);
+    auto it = shared_kernels_.find(key);
+    if (it == shared_kernels_.end() || --it->second.refs > 0) return;
+    kernel = it->second.kernel;
+    shared_kernels_.erase(it);
+  }
+  delete kernel;
+}
+
 absl::Status DirectSession::CreateGraphs(
     const BuildGraphOptions& subgraph_options,
     std::unordered_map<std::string, std::unique_ptr<Graph>>* outputs,
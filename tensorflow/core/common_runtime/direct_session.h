@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_COMMON_RUNTIME_DIRECT_SESSION_H_
 
 #include <atomic>
+#include <functional>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -137,6 +138,22 @@ class DirectSession : public Session {
 
   absl::Status Finalize() override;
 
+  // The feeds, fetches and targets of a Run() call.
+  struct RunSignature {
+    std::vector<std::string> feeds;
+    std::vector<std::string> fetches;
+    std::vector<std::string> targets;
+  };
+
+  // Builds and caches the executors for each of `signatures` on the
+  // session's inter-op thread pool, so that the first Run() with one of them
+  // does not pay for pruning, placement and optimization. Calls `done` once
+  // every signature has been processed, with the first error if any.
+  // Must be called after Create().
+  // NOTE: Experimental and subject to change.
+  void PrecompileAsync(std::vector<RunSignature> signatures,
+                       std::function<void(const absl::Status&)> done);
+
   const SessionOptions& options() const { return options_; }
 
   // Resets the global thread pools (both the default and named pools).
@@ -147,6 +164,8 @@ class DirectSession : public Session {
  private:
   // For access to collective_graph_key_.
   friend class DirectSessionCollectiveTest;
+  // For access to executors_.
+  friend class DirectSessionExecutorCacheTest;
 
   // We create one executor and its dependent library runtime for
   // every partition.
@@ -165,9 +184,15 @@ class DirectSession : public Session {
   // a partition of the graph bundled with its dependent library runtime.
   // 'input_keys' are the rendezvous keys for the feeds and 'output_keys'
   // are rendezvous keys for the fetches.
+  struct FunctionInfo;
   struct ExecutorsAndKeys {
     ExecutorsAndKeys() : step_count(0) {}
 
+    // Owns the function library of `items` if `executors_` is bounded, so
+    // that an evicted entry releases it once the last run using the entry
+    // is done. Otherwise it is owned by `functions_`. Declared first so that
+    // it is destroyed after `items`.
+    std::unique_ptr<FunctionInfo> function_info;
     std::atomic_int_fast64_t step_count;
     std::unique_ptr<Graph> graph;
     NameNodeMap name_to_node;
@@ -183,6 +208,13 @@ class DirectSession : public Session {
     CallableOptions callable_options;
 
     int64_t collective_graph_key = BuildGraphOptions::kNoCollectiveGraphKey;
+
+    // Rough size of the partition graphs and executors, used to bound the
+    // memory of `executors_`.
+    int64_t estimated_bytes = 0;
+    // The value of `executor_cache_clock_` when this was last looked up.
+    // Guarded by `executor_lock_`.
+    int64_t last_use = 0;
   };
 
   // A FunctionInfo object is created for every unique set of feeds/fetches.
@@ -247,11 +279,31 @@ class DirectSession : public Session {
 
   // Retrieves an already existing set of executors to run 'inputs' and
   // 'outputs', or creates and caches them for future use.
-  absl::Status GetOrCreateExecutors(absl::Span<const std::string> inputs,
-                                    absl::Span<const std::string> outputs,
-                                    absl::Span<const std::string> target_nodes,
-                                    ExecutorsAndKeys** executors_and_keys,
-                                    RunStateArgs* run_state_args);
+  absl::Status GetOrCreateExecutors(
+      absl::Span<const std::string> inputs,
+      absl::Span<const std::string> outputs,
+      absl::Span<const std::string> target_nodes,
+      std::shared_ptr<ExecutorsAndKeys>* executors_and_keys,
+      RunStateArgs* run_state_args);
+
+  // Moves the least recently used entries of `executors_`, other than
+  // `keep` and those of partial runs, to `evicted` until the cached
+  // executors fit in `executor_cache_max_bytes_`.
+  void EvictExecutorsLocked(
+      const ExecutorsAndKeys* keep,
+      std::vector<std::shared_ptr<ExecutorsAndKeys>>* evicted)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(executor_lock_);
+
+  // Sets `*kernel` to the shared stateless kernel stored under `key`,
+  // creating it with `create_fn` if there is none, and takes a reference to
+  // it. Every successful call must be matched by a `ReleaseSharedKernel()`.
+  absl::Status FindOrCreateSharedKernel(
+      const std::string& key,
+      const std::function<absl::Status(OpKernel**)>& create_fn,
+      OpKernel** kernel);
+  // Drops a reference to the shared kernel stored under `key`, and deletes
+  // it when no executor uses it any more.
+  void ReleaseSharedKernel(const std::string& key);
 
   // Creates a set of executors to run the subgraph defined by
   // `callable_options`.
@@ -374,6 +426,31 @@ class DirectSession : public Session {
   // same ExecutorsAndKey object.
   std::unordered_map<std::string, std::shared_ptr<ExecutorsAndKeys>> executors_
       TF_GUARDED_BY(executor_lock_);
+  // If positive, bounds the total `estimated_bytes` of `executors_`. Set
+  // from TF_DIRECT_SESSION_EXECUTOR_CACHE_MAX_BYTES.
+  int64_t executor_cache_max_bytes_ = 0;
+  int64_t executor_cache_bytes_ TF_GUARDED_BY(executor_lock_) = 0;
+  int64_t executor_cache_clock_ TF_GUARDED_BY(executor_lock_) = 0;
+
+  // If true, identical stateless nodes of different executors share one
+  // kernel. Set from TF_DIRECT_SESSION_SHARE_STATELESS_KERNELS.
+  bool share_stateless_kernels_ = false;
+  // The shared stateless kernels and the number of executors that use each.
+  // Unlike kernels owned by the devices' OpSegments, which live as long as
+  // the session, a shared kernel is deleted with the last executor that uses
+  // it, so that evicting executors releases their kernels.
+  struct SharedKernel {
+    OpKernel* kernel;
+    int refs;
+  };
+  mutex shared_kernels_mu_;
+  std::unordered_map<std::string, SharedKernel> shared_kernels_
+      TF_GUARDED_BY(shared_kernels_mu_);
+
+  // If true, executors create the kernels of stateless nodes when they first
+  // run instead of at executor creation. Set from
+  // TF_DIRECT_SESSION_LAZY_KERNEL_CREATION.
+  bool lazy_kernel_creation_ = false;
 
   class RunCallableCallFrame;
   struct Callable {
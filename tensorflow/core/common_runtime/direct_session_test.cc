@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/direct_session.h"
 
+#include <cstdlib>
 #include <map>
 #include <memory>
 #include <random>
@@ -25,6 +26,7 @@ limitations under the License.
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/container/flat_hash_set.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/strings/match.h"
@@ -3142,4 +3144,141 @@ TEST(DirectSessionTest, TestStatefulOutputRequiredOp) {
   TF_ASSERT_OK(session->Close());
 }
 
+class DirectSessionExecutorCacheTest : public ::testing::Test {
+ protected:
+  // Creates a session computing y = -a and z = -y, with the environment
+  // variable `env_var`, if not null, set to `value`.
+  std::unique_ptr<Session> CreateSession(const char* env_var,
+                                         const char* value) {
+    Graph graph(OpRegistry::Global());
+    Tensor a_tensor(DT_FLOAT, TensorShape({2, 2}));
+    test::FillValues<float>(&a_tensor, {1, 2, 3, 4});
+    Node* a = test::graph::Constant(&graph, a_tensor);
+    Node* y = test::graph::Unary(&graph, "Neg", a);
+    Node* z = test::graph::Unary(&graph, "Neg", y);
+    y_ = absl::StrCat(y->name(), ":0");
+    z_ = absl::StrCat(z->name(), ":0");
+    GraphDef def;
+    graph.ToGraphDef(&def);
+
+    if (env_var != nullptr) setenv(env_var, value, /*overwrite=*/1);
+    std::unique_ptr<Session> session(NewSession(SessionOptions()));
+    if (env_var != nullptr) unsetenv(env_var);
+    TF_CHECK_OK(session->Create(def));
+    return session;
+  }
+
+  static absl::Status Precompile(
+      Session* session, std::vector<DirectSession::RunSignature> signatures) {
+    absl::Status status;
+    absl::Notification done;
+    static_cast<DirectSession*>(session)->PrecompileAsync(
+        std::move(signatures), [&status, &done](const absl::Status& s) {
+          status = s;
+          done.Notify();
+        });
+    done.WaitForNotification();
+    return status;
+  }
+
+  static int NumCachedExecutors(Session* session) {
+    DirectSession* direct_session = static_cast<DirectSession*>(session);
+    mutex_lock l(direct_session->executor_lock_);
+    absl::flat_hash_set<const void*> distinct;
+    for (const auto& it : direct_session->executors_) {
+      distinct.insert(it.second.get());
+    }
+    return distinct.size();
+  }
+
+  static int NumSharedKernels(Session* session) {
+    DirectSession* direct_session = static_cast<DirectSession*>(session);
+    mutex_lock l(direct_session->shared_kernels_mu_);
+    return direct_session->shared_kernels_.size();
+  }
+
+  void ExpectOutputs(Session* session) {
+    std::vector<Tensor> outputs;
+    TF_ASSERT_OK(session->Run({}, {y_, z_}, {}, &outputs));
+    ASSERT_EQ(2, outputs.size());
+    test::ExpectTensorEqual<float>(
+        outputs[0], test::AsTensor<float>({-1, -2, -3, -4}, {2, 2}));
+    test::ExpectTensorEqual<float>(
+        outputs[1], test::AsTensor<float>({1, 2, 3, 4}, {2, 2}));
+  }
+
+  std::string y_;
+  std::string z_;
+};
+
+TEST_F(DirectSessionExecutorCacheTest, PrecompileCachesExecutors) {
+  auto session = CreateSession(nullptr, nullptr);
+  TF_ASSERT_OK(
+      Precompile(session.get(), {{{}, {y_}, {}}, {{}, {y_, z_}, {}}}));
+  EXPECT_EQ(NumCachedExecutors(session.get()), 2);
+  // Both signatures hit the cache.
+  std::vector<Tensor> outputs;
+  TF_ASSERT_OK(session->Run({}, {y_}, {}, &outputs));
+  ExpectOutputs(session.get());
+  EXPECT_EQ(NumCachedExecutors(session.get()), 2);
+  TF_ASSERT_OK(session->Close());
+}
+
+TEST_F(DirectSessionExecutorCacheTest, PrecompileReportsErrors) {
+  auto session = CreateSession(nullptr, nullptr);
+  EXPECT_FALSE(
+      Precompile(session.get(), {{{}, {y_}, {}}, {{}, {"missing:0"}, {}}})
+          .ok());
+  EXPECT_EQ(NumCachedExecutors(session.get()), 1);
+  TF_ASSERT_OK(session->Close());
+  EXPECT_FALSE(Precompile(session.get(), {{{}, {y_}, {}}}).ok());
+}
+
+TEST_F(DirectSessionExecutorCacheTest, EvictsLeastRecentlyUsedExecutors) {
+  auto session =
+      CreateSession("TF_DIRECT_SESSION_EXECUTOR_CACHE_MAX_BYTES", "1");
+  std::vector<Tensor> outputs;
+  TF_ASSERT_OK(session->Run({}, {y_}, {}, &outputs));
+  EXPECT_EQ(NumCachedExecutors(session.get()), 1);
+  // Every new signature evicts the previous one, and evicted signatures are
+  // rebuilt on demand.
+  ExpectOutputs(session.get());
+  EXPECT_EQ(NumCachedExecutors(session.get()), 1);
+  TF_ASSERT_OK(session->Run({}, {y_}, {}, &outputs));
+  test::ExpectTensorEqual<float>(
+      outputs[0], test::AsTensor<float>({-1, -2, -3, -4}, {2, 2}));
+  EXPECT_EQ(NumCachedExecutors(session.get()), 1);
+  TF_ASSERT_OK(session->Close());
+}
+
+TEST_F(DirectSessionExecutorCacheTest, SharesStatelessKernels) {
+  auto session =
+      CreateSession("TF_DIRECT_SESSION_SHARE_STATELESS_KERNELS", "1");
+  TF_ASSERT_OK(Precompile(session.get(), {{{}, {y_}, {}}, {{}, {z_}, {}}}));
+  std::vector<Tensor> outputs;
+  TF_ASSERT_OK(session->Run({}, {z_}, {}, &outputs));
+  test::ExpectTensorEqual<float>(
+      outputs[0], test::AsTensor<float>({1, 2, 3, 4}, {2, 2}));
+  ExpectOutputs(session.get());
+  TF_ASSERT_OK(session->Close());
+}
+
+TEST_F(DirectSessionExecutorCacheTest, EvictionReleasesSharedKernels) {
+  setenv("TF_DIRECT_SESSION_SHARE_STATELESS_KERNELS", "1", /*overwrite=*/1);
+  auto session =
+      CreateSession("TF_DIRECT_SESSION_EXECUTOR_CACHE_MAX_BYTES", "1");
+  unsetenv("TF_DIRECT_SESSION_SHARE_STATELESS_KERNELS");
+  std::vector<Tensor> outputs;
+  TF_ASSERT_OK(session->Run({}, {y_}, {}, &outputs));
+  const int num_y_kernels = NumSharedKernels(session.get());
+  // Evicts the executors of `y_` but keeps the kernels that the executors of
+  // both outputs use.
+  ExpectOutputs(session.get());
+  EXPECT_GT(NumSharedKernels(session.get()), num_y_kernels);
+  // Evicts the executors of both outputs, which releases the kernel of `z_`.
+  TF_ASSERT_OK(session->Run({}, {y_}, {}, &outputs));
+  EXPECT_EQ(NumSharedKernels(session.get()), num_y_kernels);
+  TF_ASSERT_OK(session->Close());
+}
+
 }  // namespace tensorflow
@@ -0,0 +1,232 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/elementwise_fusion_pass.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/common_runtime/optimization_registry.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/util/device_name_utils.h"
+#include "tensorflow/core/util/dump_graph.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+namespace {
+
+// Maximum number of ops fused into one node.
+constexpr int kMaxFusedOps = 32;
+
+// The ops supported by the _FusedElementwise kernel.
+bool IsSupportedOp(absl::string_view op) {
+  static const auto* ops = new absl::flat_hash_set<absl::string_view>({
+      "Abs",     "Add",     "AddV2",   "Div",        "Exp",
+      "Inv",     "Log",     "Maximum", "Minimum",    "Mul",
+      "Neg",     "RealDiv", "Relu",    "Reciprocal", "Rsqrt",
+      "Sigmoid", "Sqrt",    "Square",  "SquaredDifference",
+      "Sub",     "Tanh",
+  });
+  return ops->contains(op);
+}
+
+// `node`'s device is a CPU.
+bool HasCpuDevice(const Node* node) {
+  DeviceNameUtils::ParsedName device;
+  if (!DeviceNameUtils::ParseFullName(node->assigned_device_name(), &device))
+    return false;
+  return device.type == "CPU";
+}
+
+bool IsFusible(const Node* node) {
+  if (!node->IsOp() || !IsSupportedOp(node->type_string()) ||
+      !HasCpuDevice(node)) {
+    return false;
+  }
+  DataType dtype;
+  if (!TryGetNodeAttr(node->attrs(), "T", &dtype) ||
+      (dtype != DT_FLOAT && dtype != DT_DOUBLE)) {
+    return false;
+  }
+  for (const Edge* edge : node->in_edges()) {
+    if (edge->IsControlEdge()) return false;
+  }
+  return true;
+}
+
+// Returns true if `producer` can be computed inside the fused node of its
+// consumer `consumer`.
+bool CanFuseInto(const Node* producer, const Node* consumer) {
+  // The only out edge of `producer` is the one to `consumer`, so its value is
+  // not needed anywhere else.
+  return producer->out_edges().size() == 1 && IsFusible(producer) &&
+         producer->assigned_device_name() == consumer->assigned_device_name() &&
+         producer->input_type(0) == consumer->input_type(0);
+}
+
+// Appends the producers of `node` that can be fused into it, and then `node`,
+// to `group`, so that every node follows its fused producers.
+absl::Status CollectGroup(Node* node, int* budget, std::vector<Node*>* group) {
+  for (int i = 0; i < node->num_inputs(); ++i) {
+    const Edge* edge;
+    TF_RETURN_IF_ERROR(node->input_edge(i, &edge));
+    if (*budget > 0 && CanFuseInto(edge->src(), node)) {
+      --*budget;
+      TF_RETURN_IF_ERROR(CollectGroup(edge->src(), budget, group));
+    }
+  }
+  group->push_back(node);
+  return absl::OkStatus();
+}
+
+// Replaces the nodes of `group` with one _FusedElementwise node.
+absl::Status FuseGroup(Graph* graph, const std::vector<Node*>& group) {
+  Node* root = group.back();
+  absl::flat_hash_map<const Node*, int> op_index;
+  for (int i = 0; i < group.size(); ++i) {
+    op_index[group[i]] = i;
+  }
+
+  // The inputs of the fused node are the distinct tensors the group reads
+  // from outside.
+  std::vector<NodeBuilder::NodeOut> args;
+  absl::flat_hash_map<std::pair<const Node*, int>, int> arg_index;
+  for (const Node* node : group) {
+    for (int i = 0; i < node->num_inputs(); ++i) {
+      const Edge* edge;
+      TF_RETURN_IF_ERROR(node->input_edge(i, &edge));
+      if (op_index.contains(edge->src())) continue;
+      auto inserted = arg_index.emplace(
+          std::make_pair(edge->src(), edge->src_output()), args.size());
+      if (inserted.second) {
+        args.emplace_back(edge->src(), edge->src_output());
+      }
+    }
+  }
+  const int num_args = args.size();
+
+  std::vector<std::string> op_names;
+  std::vector<int> operands;
+  for (const Node* node : group) {
+    op_names.push_back(node->type_string());
+    for (int i = 0; i < 2; ++i) {
+      if (i >= node->num_inputs()) {
+        operands.push_back(-1);
+        continue;
+      }
+      const Edge* edge;
+      TF_RETURN_IF_ERROR(node->input_edge(i, &edge));
+      auto it = op_index.find(edge->src());
+      operands.push_back(
+          it != op_index.end()
+              ? num_args + it->second
+              : arg_index.at(std::make_pair(edge->src(), edge->src_output())));
+    }
+  }
+
+  Node* fused;
+  TF_RETURN_IF_ERROR(
+      NodeBuilder(graph->NewName(absl::StrCat(root->name(), "/fused")),
+                  "_FusedElementwise")
+          .Input(args)
+          .Attr("T", root->input_type(0))
+          .Attr("num_args", num_args)
+          .Attr("op_names", op_names)
+          .Attr("operands", operands)
+          .Device(root->requested_device())
+          .Finalize(graph, &fused));
+  fused->set_assigned_device_name(root->assigned_device_name());
+  for (const Edge* edge : root->out_edges()) {
+    if (edge->IsControlEdge()) {
+      graph->AddControlEdge(fused, edge->dst(), /*allow_duplicates=*/true);
+    } else {
+      graph->AddEdge(fused, 0, edge->dst(), edge->dst_input());
+    }
+  }
+  const std::string name = root->name();
+  for (Node* node : group) {
+    graph->RemoveNode(node);
+  }
+  fused->set_name(name);
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::Status ElementwiseFusionPass::Run(
+    const GraphOptimizationPassOptions& options) {
+  bool enabled;
+  absl::Status status =
+      ReadBoolFromEnvVar("TF_CPU_ELEMENTWISE_FUSION", false, &enabled);
+  if (!status.ok()) {
+    LOG(ERROR) << "ElementwiseFusionPass: " << status.message();
+    return absl::OkStatus();
+  }
+  if (!enabled || options.graph == nullptr) {
+    return absl::OkStatus();
+  }
+  Graph* graph = options.graph->get();
+  if (VLOG_IS_ON(1)) {
+    VLOG(1) << DumpGraphToFile("before_elementwise_fusion_pass", *graph,
+                               options.flib_def);
+  }
+
+  // Visit consumers before their producers, so that each group is collected
+  // from its root.
+  std::vector<Node*> order;
+  GetReversePostOrder(*graph, &order);
+  absl::flat_hash_set<const Node*> visited;
+  std::vector<std::vector<Node*>> groups;
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    Node* node = *it;
+    if (visited.contains(node) || !IsFusible(node)) continue;
+    int budget = kMaxFusedOps - 1;
+    std::vector<Node*> group;
+    TF_RETURN_IF_ERROR(CollectGroup(node, &budget, &group));
+    visited.insert(group.begin(), group.end());
+    if (group.size() > 1) groups.push_back(std::move(group));
+  }
+
+  int num_fused_ops = 0;
+  for (const std::vector<Node*>& group : groups) {
+    num_fused_ops += group.size();
+    TF_RETURN_IF_ERROR(FuseGroup(graph, group));
+  }
+  VLOG(1) << "elementwise_fusion_pass fused " << num_fused_ops << " ops into "
+          << groups.size() << " nodes.";
+
+  if (VLOG_IS_ON(1)) {
+    VLOG(1) << DumpGraphToFile("after_elementwise_fusion_pass", *graph,
+                               options.flib_def);
+  }
+  return absl::OkStatus();
+}
+
+REGISTER_OPTIMIZATION(OptimizationPassRegistry::POST_REWRITE_FOR_EXEC, 20,
+                      ElementwiseFusionPass);
+
+}  // namespace tensorflow
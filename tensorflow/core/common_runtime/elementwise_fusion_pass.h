@@ -0,0 +1,46 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_ELEMENTWISE_FUSION_PASS_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_ELEMENTWISE_FUSION_PASS_H_
+
+#include "absl/status/status.h"
+#include "tensorflow/core/common_runtime/optimization_registry.h"
+
+// Fuses trees of unary and binary elementwise ops on CPU into one
+// _FusedElementwise node, which computes them in one pass over its inputs
+// without materializing the intermediate tensors.
+//
+// A node is fused into its consumer if both are supported float or double
+// ops assigned to the same CPU device, the node has no control edges, and
+// the consumer is its only consumer. For example, the graph:
+//   x, y -> Mul -> Sigmoid -> Sub(c) -> Relu -> z
+// is rewritten to:
+//   x, y, c -> _FusedElementwise -> z
+// The fused node takes the name of the last op of the tree.
+//
+// The pass only runs when the TF_CPU_ELEMENTWISE_FUSION environment
+// variable is true.
+
+namespace tensorflow {
+
+class ElementwiseFusionPass : public GraphOptimizationPass {
+ public:
+  absl::Status Run(const GraphOptimizationPassOptions& options) override;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_ELEMENTWISE_FUSION_PASS_H_
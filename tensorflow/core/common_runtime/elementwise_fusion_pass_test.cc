@@ -0,0 +1,157 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/elementwise_fusion_pass.h"
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/cc/framework/ops.h"
+#include "tensorflow/cc/framework/scope.h"
+#include "tensorflow/cc/ops/array_ops.h"
+#include "tensorflow/cc/ops/const_op.h"
+#include "tensorflow/cc/ops/math_ops.h"
+#include "tensorflow/cc/ops/nn_ops.h"
+#include "tensorflow/core/common_runtime/optimization_registry.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+const char kCpu0[] = "/job:localhost/replica:0/task:0/device:CPU:0";
+
+class ElementwiseFusionPassTest : public ::testing::Test {
+ protected:
+  void SetUp() override { setenv("TF_CPU_ELEMENTWISE_FUSION", "1", 1); }
+  void TearDown() override { unsetenv("TF_CPU_ELEMENTWISE_FUSION"); }
+
+  // Builds the graph from `scope`, places it on CPU and runs the pass.
+  void RunPass(const Scope& scope) {
+    graph_ = std::make_unique<Graph>(OpRegistry::Global());
+    TF_ASSERT_OK(scope.ToGraph(graph_.get()));
+    for (Node* node : graph_->op_nodes()) {
+      node->set_assigned_device_name(kCpu0);
+    }
+    GraphOptimizationPassOptions options;
+    options.graph = &graph_;
+    ElementwiseFusionPass pass;
+    TF_ASSERT_OK(pass.Run(options));
+  }
+
+  Node* GetNode(const std::string& name) {
+    for (Node* node : graph_->nodes()) {
+      if (node->name() == name) return node;
+    }
+    return nullptr;
+  }
+
+  int CountNodes(const std::string& op) {
+    int count = 0;
+    for (const Node* node : graph_->op_nodes()) {
+      if (node->type_string() == op) ++count;
+    }
+    return count;
+  }
+
+  std::unique_ptr<Graph> graph_;
+};
+
+TEST_F(ElementwiseFusionPassTest, FusesChain) {
+  Scope scope = Scope::NewRootScope().ExitOnError();
+  auto x = ops::Placeholder(scope.WithOpName("x"), DT_FLOAT);
+  auto y = ops::Placeholder(scope.WithOpName("y"), DT_FLOAT);
+  auto mul = ops::Mul(scope.WithOpName("mul"), x, y);
+  auto sigmoid = ops::Sigmoid(scope.WithOpName("sigmoid"), mul);
+  auto sub = ops::Sub(scope.WithOpName("sub"), sigmoid,
+                      ops::Const(scope.WithOpName("c"), 0.5f));
+  auto relu = ops::Relu(scope.WithOpName("relu"), sub);
+  ops::Identity(scope.WithOpName("out"), relu);
+  RunPass(scope);
+
+  EXPECT_EQ(CountNodes("_FusedElementwise"), 1);
+  EXPECT_EQ(GetNode("mul"), nullptr);
+  EXPECT_EQ(GetNode("sigmoid"), nullptr);
+  EXPECT_EQ(GetNode("sub"), nullptr);
+  Node* fused = GetNode("relu");
+  ASSERT_NE(fused, nullptr);
+  EXPECT_EQ(fused->type_string(), "_FusedElementwise");
+  EXPECT_EQ(fused->assigned_device_name(), kCpu0);
+
+  std::vector<std::string> op_names;
+  std::vector<int32_t> operands;
+  int num_args;
+  TF_ASSERT_OK(GetNodeAttr(fused->attrs(), "op_names", &op_names));
+  TF_ASSERT_OK(GetNodeAttr(fused->attrs(), "operands", &operands));
+  TF_ASSERT_OK(GetNodeAttr(fused->attrs(), "num_args", &num_args));
+  EXPECT_EQ(op_names,
+            std::vector<std::string>({"Mul", "Sigmoid", "Sub", "Relu"}));
+  EXPECT_EQ(operands, std::vector<int32_t>({0, 1, 3, -1, 4, 2, 5, -1}));
+  EXPECT_EQ(num_args, 3);
+
+  const Edge* edge;
+  TF_ASSERT_OK(fused->input_edge(0, &edge));
+  EXPECT_EQ(edge->src()->name(), "x");
+  TF_ASSERT_OK(fused->input_edge(1, &edge));
+  EXPECT_EQ(edge->src()->name(), "y");
+  TF_ASSERT_OK(fused->input_edge(2, &edge));
+  EXPECT_EQ(edge->src()->name(), "c");
+  TF_ASSERT_OK(GetNode("out")->input_edge(0, &edge));
+  EXPECT_EQ(edge->src(), fused);
+}
+
+TEST_F(ElementwiseFusionPassTest, KeepsValuesWithSeveralConsumers) {
+  Scope scope = Scope::NewRootScope().ExitOnError();
+  auto x = ops::Placeholder(scope.WithOpName("x"), DT_FLOAT);
+  auto y = ops::Placeholder(scope.WithOpName("y"), DT_FLOAT);
+  auto mul = ops::Mul(scope.WithOpName("mul"), x, y);
+  auto neg = ops::Neg(scope.WithOpName("neg"), mul);
+  auto exp = ops::Exp(scope.WithOpName("exp"), mul);
+  ops::Identity(scope.WithOpName("out0"), neg);
+  ops::Identity(scope.WithOpName("out1"), exp);
+  RunPass(scope);
+
+  EXPECT_EQ(CountNodes("_FusedElementwise"), 0);
+  EXPECT_NE(GetNode("mul"), nullptr);
+}
+
+TEST_F(ElementwiseFusionPassTest, SkipsUnsupportedTypes) {
+  Scope scope = Scope::NewRootScope().ExitOnError();
+  auto x = ops::Placeholder(scope.WithOpName("x"), DT_INT32);
+  auto neg = ops::Neg(scope.WithOpName("neg"), x);
+  ops::Square(scope.WithOpName("square"), neg);
+  RunPass(scope);
+
+  EXPECT_EQ(CountNodes("_FusedElementwise"), 0);
+}
+
+TEST_F(ElementwiseFusionPassTest, DisabledByDefault) {
+  unsetenv("TF_CPU_ELEMENTWISE_FUSION");
+  Scope scope = Scope::NewRootScope().ExitOnError();
+  auto x = ops::Placeholder(scope.WithOpName("x"), DT_FLOAT);
+  auto neg = ops::Neg(scope.WithOpName("neg"), x);
+  ops::Square(scope.WithOpName("square"), neg);
+  RunPass(scope);
+
+  EXPECT_EQ(CountNodes("_FusedElementwise"), 0);
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -37,6 +37,8 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/propagator_state.h"
 #include "tensorflow/core/common_runtime/renamed_device.h"
 #include "tensorflow/core/common_runtime/simple_propagator_state.h"
+#include "tensorflow/core/common_runtime/step_arena_allocator.h"
+#include "tensorflow/core/common_runtime/step_memory_plan.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/cancellation.h"
@@ -57,6 +59,7 @@ limitations under the License.
 #include "tensorflow/core/graph/graph_node_util.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/notification.h"
+#include "tensorflow/core/lib/core/refcount.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/flatmap.h"
@@ -184,6 +187,17 @@ class ExecutorImpl : public Executor {
   absl::Status Initialize(const Graph& graph) {
     TF_RETURN_IF_ERROR(immutable_state_.Initialize(graph));
     kernel_stats_.Initialize(immutable_state_.graph_view());
+    Device* device = immutable_state_.params().device;
+    if (StepArenaEnabled() && device->device_type() == DEVICE_CPU) {
+      step_arena_pool_.reset(new StepArenaAllocator::BlockPool(
+          device->GetAllocator(AllocatorAttributes())));
+    }
+    if (StaticMemoryPlanEnabled() && device->device_type() == DEVICE_CPU &&
+        !immutable_state_.requires_control_flow_support()) {
+      memory_plan_ =
+          StepMemoryPlan::Build(graph, immutable_state_.graph_view(),
+                                device->GetAllocator(AllocatorAttributes()));
+    }
     return absl::OkStatus();
   }
 
@@ -204,8 +218,11 @@ class ExecutorImpl : public Executor {
           std::make_unique<std::atomic_uint_fast64_t[]>(gview.num_nodes());
       for (int32_t i = 0; i < gview.num_nodes(); ++i) {
         if (gview.node(i)) {
+          // Lazy kernels start out expensive, like most kernels, until their
+          // cost estimate says otherwise.
           is_expensive_[i] =
-              gview.node(i)->kernel && gview.node(i)->kernel->IsExpensive();
+              gview.node(i)->kernel_is_lazy ||
+              (gview.node(i)->kernel && gview.node(i)->kernel->IsExpensive());
           cost_estimates_[i] = kInitialCostEstimateCycles;
         }
       }
@@ -262,6 +279,11 @@ class ExecutorImpl : public Executor {
 
   ImmutableExecutorState immutable_state_;
   KernelStats kernel_stats_;
+  // Recycles step arena blocks across runs. Null if step arenas are disabled.
+  core::RefCountPtr<StepArenaAllocator::BlockPool> step_arena_pool_;
+  // Memory plan for the outputs with static shapes. Null if static memory
+  // plans are disabled or nothing could be planned.
+  core::RefCountPtr<StepMemoryPlan> memory_plan_;
 
   ExecutorImpl(const ExecutorImpl&) = delete;
   void operator=(const ExecutorImpl&) = delete;
@@ -321,7 +343,9 @@ class ExecutorState {
  public:
   ExecutorState(const Executor::Args& args,
                 const ImmutableExecutorState& immutable_state_,
-                ExecutorImpl::KernelStats* kernel_stats_);
+                ExecutorImpl::KernelStats* kernel_stats_,
+                StepArenaAllocator::BlockPool* step_arena_pool,
+                StepMemoryPlan* memory_plan);
   ~ExecutorState();
 
   void RunAsync(Executor::DoneCallback done);
@@ -437,6 +461,14 @@ class ExecutorState {
   bool sync_on_finish_;
   const bool run_all_kernels_inline_;
 
+  // Allocates outputs and temporaries that do not outlive this step. Released
+  // when the step finishes. May be null.
+  StepArenaAllocator* step_arena_ = nullptr;
+
+  // Holds the planned outputs of this step. Released when the step
+  // finishes. May be null.
+  StepMemoryPlan::StepBuffer* planned_buffer_ = nullptr;
+
   PropagatorStateType propagator_;
 
   // Invoked when the execution finishes.
@@ -457,7 +489,8 @@ class ExecutorState {
 template <class PropagatorStateType>
 ExecutorState<PropagatorStateType>::ExecutorState(
     const Executor::Args& args, const ImmutableExecutorState& immutable_state,
-    ExecutorImpl::KernelStats* kernel_stats)
+    ExecutorImpl::KernelStats* kernel_stats,
+    StepArenaAllocator::BlockPool* step_arena_pool, StepMemoryPlan* memory_plan)
     : vlog_(VLOG_IS_ON(1)),
       log_memory_(LogMemory::IsEnabled()),
       step_id_(args.step_id),
@@ -493,6 +526,12 @@ ExecutorState<PropagatorStateType>::ExecutorState(
     user_device_ = RenamedDevice::NewRenamedDevice(
         device->name(), device, false, false, args.user_intra_op_threadpool);
   }
+  if (step_arena_pool != nullptr) {
+    step_arena_ = new StepArenaAllocator(step_arena_pool);
+  }
+  if (memory_plan != nullptr) {
+    planned_buffer_ = memory_plan->AcquireBuffer();
+  }
 }
 
 template <class PropagatorStateType>
@@ -500,6 +539,12 @@ ExecutorState<PropagatorStateType>::~ExecutorState() {
   if (device_context_) {
     device_context_->Unref();
   }
+  if (step_arena_) {
+    step_arena_->Release();
+  }
+  if (planned_buffer_) {
+    planned_buffer_->Release();
+  }
   delete slice_reader_cache_;
 }
 
@@ -816,6 +861,10 @@ void ExecutorState<PropagatorStateType>::ProcessInline(
   params->runner = &runner_;
   params->run_all_kernels_inline = run_all_kernels_inline_;
   params->stats_collector = stats_collector_;
+  if (step_arena_) {
+    params->step_allocator = step_arena_;
+    params->step_allocator_max_bytes = StepArenaAllocator::kMaxAllocationSize;
+  }
   params->inc_num_deferred_ops_function = [this]() {
     mutex_lock lock(num_deferred_ops_mu_);
     num_deferred_ops_++;
@@ -869,6 +918,7 @@ void ExecutorState<PropagatorStateType>::ProcessInline(
     }
     inline_ready->pop_front();
     const NodeItem& item = tagged_node.get_node_item();
+    const NodeDef& node_def = immutable_state_.node_def(item);
     const int id = item.node_id;
 
     propagator_.MaybeMarkStarted(tagged_node);
@@ -879,22 +929,19 @@ void ExecutorState<PropagatorStateType>::ProcessInline(
                   "ExecutorState::Process",
                   activity_watcher::ActivityCategory::kMisc,
                   activity_watcher::Activity::Attributes{
-                      {"node_name", item.kernel->def().name()},
-                      {"op", item.kernel->def().op()},
+                      {"node_name", node_def.name()},
+                      {"op", node_def.op()},
                       {"iter_num", absl::StrCat(tagged_node.get_iter_num())},
                       {"step_id", absl::StrCat(params->step_id)},
                       {"node_id", absl::StrCat(id)},
                       {"device", device->name()},
-                      {"inputs",
-                       absl::StrJoin(item.kernel->def().input(), "; ")},
+                      {"inputs", absl::StrJoin(node_def.input(), "; ")},
                       {"original_node_names",
-                       absl::StrJoin(item.kernel->def()
-                                         .experimental_debug_info()
+                       absl::StrJoin(node_def.experimental_debug_info()
                                          .original_node_names(),
                                      "; ")},
                       {"original_func_names",
-                       absl::StrJoin(item.kernel->def()
-                                         .experimental_debug_info()
+                       absl::StrJoin(node_def.experimental_debug_info()
                                          .original_func_names(),
                                      "; ")},
                   });
@@ -904,7 +951,7 @@ void ExecutorState<PropagatorStateType>::ProcessInline(
     params->track_allocations = false;
     stats = nullptr;
     if (stats_collector_ && !tagged_node.get_is_dead()) {
-      stats = stats_collector_->CreateNodeExecStats(&item.kernel->def());
+      stats = stats_collector_->CreateNodeExecStats(&node_def);
       // Track allocations if and only if we are collecting statistics, and
       // `stats` object is expecting allocations to be tracked.
       params->track_allocations = stats ? stats->TrackAllocations() : false;
@@ -914,7 +961,7 @@ void ExecutorState<PropagatorStateType>::ProcessInline(
 
     if (vlog_) {
       VLOG(1) << "Process node: " << id << " step " << params->step_id << " "
-              << SummarizeNodeDef(item.kernel->def())
+              << SummarizeNodeDef(node_def)
               << (tagged_node.get_is_dead() ? " is dead" : "")
               << " device: " << device->name();
     }
@@ -932,10 +979,15 @@ void ExecutorState<PropagatorStateType>::ProcessInline(
     } else if (item.const_tensor != nullptr && !params->track_allocations) {
       ProcessConstTensor(item, &outputs, stats);
     } else {
-      // Prepares inputs.
+      // Creates the kernel if it is lazy, and prepares inputs.
       bool is_input_dead = false;
-      s = PrepareInputs(item, first_input, inputs.get(), &input_alloc_attrs,
-                        &is_input_dead);
+      s = TF_PREDICT_FALSE(item.kernel_is_lazy)
+              ? immutable_state_.EnsureKernel(item)
+              : absl::OkStatus();
+      if (s.ok()) {
+        s = PrepareInputs(item, first_input, inputs.get(), &input_alloc_attrs,
+                          &is_input_dead);
+      }
       if (!s.ok()) {
         // Clear inputs.
         const int num_inputs = item.num_inputs;
@@ -956,10 +1008,15 @@ void ExecutorState<PropagatorStateType>::ProcessInline(
       params->output_attr_array = item.output_attrs();
       params->forward_from_array = item.forward_from();
       params->outputs_required_array = item.outputs_required.get();
+      params->outputs_step_local_array = item.outputs_step_local.get();
+      params->planned_output_allocators =
+          planned_buffer_ ? planned_buffer_->output_allocators(item.node_id)
+                          : nullptr;
       params->inputs = *inputs;
       params->input_alloc_attrs = input_alloc_attrs;
 
-      if (item.kernel_is_async) {
+      if (item.kernel_is_async || (TF_PREDICT_FALSE(item.kernel_is_lazy) &&
+                                   item.kernel->AsAsync() != nullptr)) {
         ProcessAsync(item, *params, tagged_node, first_input, stats,
                      activity_id);
         launched_asynchronously = true;
@@ -971,8 +1028,7 @@ void ExecutorState<PropagatorStateType>::ProcessInline(
     if (!launched_asynchronously) {
       if (vlog_) {
         VLOG(2) << "Synchronous kernel done: " << id << " step "
-                << params->step_id << " "
-                << SummarizeNodeDef(item.kernel->def())
+                << params->step_id << " " << SummarizeNodeDef(node_def)
                 << (tagged_node.get_is_dead() ? " is dead: " : "")
                 << " device: " << device->name();
       }
@@ -1553,14 +1609,20 @@ void ExecutorState<PropagatorStateType>::Finish() {
 void ExecutorImpl::RunAsyncInternal(const Args& args, DoneCallback done) {
   if (OpOrderDeterminismRequired()) {
     (new ExecutorState<OrderedPropagatorState>(args, immutable_state_,
-                                               &kernel_stats_))
+                                               &kernel_stats_,
+                                               step_arena_pool_.get(),
+                                               memory_plan_.get()))
         ->RunAsync(std::move(done));
   } else if (immutable_state_.requires_control_flow_support()) {
-    (new ExecutorState<PropagatorState>(args, immutable_state_, &kernel_stats_))
+    (new ExecutorState<PropagatorState>(args, immutable_state_, &kernel_stats_,
+                                        step_arena_pool_.get(),
+                                        memory_plan_.get()))
         ->RunAsync(std::move(done));
   } else {
     (new ExecutorState<SimplePropagatorState>(args, immutable_state_,
-                                              &kernel_stats_))
+                                              &kernel_stats_,
+                                              step_arena_pool_.get(),
+                                              memory_plan_.get()))
         ->RunAsync(std::move(done));
   }
 }
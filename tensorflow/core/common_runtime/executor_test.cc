@@ -17,6 +17,8 @@ limitations under the License.
 
 #include <algorithm>
 
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
 #include "tensorflow/cc/framework/ops.h"
 #include "tensorflow/cc/ops/array_ops.h"
 #include "tensorflow/cc/ops/const_op.h"
@@ -33,11 +35,13 @@ limitations under the License.
 #include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/framework/local_rendezvous.h"
 #include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/rendezvous.h"
 #include "tensorflow/core/framework/step_stats.pb.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/framework/versions.pb.h"
 #include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/graph/node_builder.h"
 #include "tensorflow/core/graph/testlib.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
@@ -77,10 +81,12 @@ class ExecutorTest : public ::testing::Test {
   }
 
   // Resets executor_ with a new executor based on a graph 'gdef'.
-  void Create(std::unique_ptr<const Graph> graph) {
+  void Create(std::unique_ptr<const Graph> graph,
+              bool lazy_kernel_creation = false) {
     const int version = graph->versions().producer();
     LocalExecutorParams params;
     params.device = device_.get();
+    params.lazy_kernel_creation = lazy_kernel_creation;
     params.create_kernel =
         [this, version](const std::shared_ptr<const NodeProperties>& props,
                         OpKernel** kernel) {
@@ -324,6 +330,56 @@ TEST_F(ExecutorTest, RandomTree) {
   EXPECT_EQ(4096.0, V(out));
 }
 
+TEST_F(ExecutorTest, RandomTreeWithLazyKernels) {
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  BuildTree(4096, g.get());
+  Create(std::move(g), /*lazy_kernel_creation=*/true);
+  Rendezvous::Args args;
+  // The second step reuses the kernels created by the first one.
+  for (int step = 0; step < 2; ++step) {
+    TF_ASSERT_OK(
+        rendez_->Send(Key(ALICE, kIncarnation, BOB, "a"), args, V(1.0), false));
+    TF_ASSERT_OK(Run(rendez_));
+    Tensor out = V(-1);
+    bool is_dead = false;
+    TF_ASSERT_OK(rendez_->Recv(Key(BOB, kIncarnation, ALICE, "b"), args, &out,
+                               &is_dead));
+    EXPECT_EQ(4096.0, V(out));
+  }
+}
+
+REGISTER_OP("ExecutorTestFailingConstruction")
+    .Input("x: float")
+    .Output("y: float");
+
+class FailingConstructionOp : public OpKernel {
+ public:
+  explicit FailingConstructionOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
+    OP_REQUIRES(ctx, false, errors::InvalidArgument("Failed to construct"));
+  }
+  void Compute(OpKernelContext* ctx) override {}
+};
+
+REGISTER_KERNEL_BUILDER(
+    Name("ExecutorTestFailingConstruction").Device(DEVICE_CPU),
+    FailingConstructionOp);
+
+TEST_F(ExecutorTest, LazyKernelCreationErrorIsReturnedByRun) {
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  Node* in = test::graph::Constant(g.get(), V(1.0));
+  Node* failing;
+  TF_ASSERT_OK(NodeBuilder("failing", "ExecutorTestFailingConstruction")
+                   .Input(in)
+                   .Finalize(g.get(), &failing));
+  // Creating the executor succeeds, since the failing kernel is not created
+  // until it runs.
+  Create(std::move(g), /*lazy_kernel_creation=*/true);
+  absl::Status s = Run(rendez_);
+  EXPECT_TRUE(absl::IsInvalidArgument(s)) << s;
+  EXPECT_TRUE(absl::StrContains(s.message(), "Failed to construct")) << s;
+  EXPECT_TRUE(absl::StrContains(s.message(), "failing")) << s;
+}
+
 void BuildConcurrentAddAssign(Graph* g) {
   auto one = test::graph::Constant(g, V(1.0));
   // A variable holds one float.
@@ -602,6 +658,43 @@ static void BM_FeedInputFetchOutput(::testing::benchmark::State& state) {
 }
 BENCHMARK(BM_FeedInputFetchOutput);
 
+// Measures the time to create an executor for a tree of `num_nodes` Add
+// nodes, with and without lazy kernel creation.
+static void BM_ExecutorCreation(::testing::benchmark::State& state) {
+  const int num_nodes = state.range(0);
+  const bool lazy_kernel_creation = state.range(1);
+
+  Graph g(OpRegistry::Global());
+  BuildTree(num_nodes, &g);
+  std::unique_ptr<Device> device(DeviceFactory::NewDevice(
+      "CPU", {}, "/job:localhost/replica:0/task:0"));
+  const int version = g.versions().producer();
+  LocalExecutorParams params;
+  params.device = device.get();
+  params.create_kernel =
+      [&device, version](const std::shared_ptr<const NodeProperties>& props,
+                         OpKernel** kernel) {
+        return CreateNonCachedKernel(device.get(), nullptr, props, version,
+                                     kernel);
+      };
+  params.delete_kernel = [](OpKernel* kernel) {
+    DeleteNonCachedKernel(kernel);
+  };
+  params.lazy_kernel_creation = lazy_kernel_creation;
+
+  for (auto s : state) {
+    Executor* exec;
+    TF_CHECK_OK(NewLocalExecutor(params, g, &exec));
+    delete exec;
+  }
+  state.SetItemsProcessed(num_nodes * static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_ExecutorCreation)
+    ->ArgPair(1024, false)
+    ->ArgPair(1024, true)
+    ->ArgPair(16384, false)
+    ->ArgPair(16384, true);
+
 absl::Status ReplaceEdgeWithSendRecv(Graph* g, const Edge* edge,
                                      const std::string& tensor,
                                      const std::string& sender,
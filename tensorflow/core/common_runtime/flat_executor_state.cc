@@ -0,0 +1,384 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/flat_executor_state.h"
+
+#include <cstdint>
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/macros.h"
+
+namespace tensorflow {
+
+FlatExecutorState::~FlatExecutorState() {
+  for (const KernelState& kernel_state : kernels_) {
+    params_.delete_kernel(kernel_state.kernel);
+  }
+  for (const ConstTensorKernelState& kernel_state : const_tensor_kernels_) {
+    params_.delete_kernel(kernel_state.kernel);
+  }
+  for (const auto& node_and_kernel : pending_kernels_) {
+    params_.delete_kernel(node_and_kernel.second);
+  }
+}
+
+absl::Status FlatExecutorState::AddNode(const Node* n, bool* needs_kernel) {
+  *needs_kernel = false;
+  if (n->IsArg()) {
+    int32_t arg_index;
+    TF_RETURN_IF_ERROR(GetNodeAttr(n->attrs(), "index", &arg_index));
+    if (arg_index < 0) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Invalid argument index ", arg_index, " in node ", n->name()));
+    }
+    arg_index_to_node_map_[arg_index] = n;
+    // We do not create a kernel for Arg nodes, and instead inline the
+    // argument handling directly in the executor code.
+    return absl::OkStatus();
+  }
+
+  OpKernel* kernel;
+  TF_RETURN_IF_ERROR(params_.create_kernel(n->properties(), &kernel));
+
+  const Tensor* const_tensor;
+  if (n->num_outputs() == 1 && (const_tensor = kernel->const_tensor())) {
+    // Nodes that produce a single constant tensor are handled specially:
+    // we evaluate the tensor once, and propagate it to its consumers as
+    // a `const Tensor*`, to avoid refcount manipulation.
+    ConstTensorKernelState& kernel_state = const_tensor_kernels_.emplace_back();
+    kernel_state.kernel = kernel;
+    kernel_state.const_tensor = *const_tensor;
+    nodes_with_const_tensor_kernels_.push_back(n);
+    return absl::OkStatus();
+  }
+
+  pending_kernels_[n] = kernel;
+  *needs_kernel = true;
+  return absl::OkStatus();
+}
+
+absl::Status FlatExecutorState::Finalize(
+    const std::vector<const Node*>& nodes) {
+  // Create the input-related structures for each kernel, in the given order.
+  kernels_.reserve(nodes.size());
+  absl::flat_hash_map<const Node*, size_t> node_to_index_map;
+  for (const Node* n : nodes) {
+    auto it = pending_kernels_.find(n);
+    if (it == pending_kernels_.end()) {
+      return absl::InternalError(
+          absl::StrCat("No kernel was created for node ", n->name()));
+    }
+    const size_t kernel_index = kernels_.size();
+    KernelState& kernel_state = kernels_.emplace_back();
+    kernel_state.kernel = it->second;
+    pending_kernels_.erase(it);
+    kernel_state.num_inputs = n->num_inputs();
+    kernel_state.num_outputs = n->num_outputs();
+    node_to_index_map[n] = kernel_index;
+    if (kernel_index == 0) {
+      kernel_state.input_start_index = 0;
+    } else {
+      const KernelState& previous_kernel_state = kernels_[kernel_index - 1];
+      kernel_state.input_start_index = previous_kernel_state.input_start_index +
+                                       previous_kernel_state.num_inputs;
+    }
+  }
+
+  // Build the mapping from each Arg node output to the input slot for the
+  // corresponding destination node.
+  if (!arg_index_to_node_map_.empty()) {
+    const size_t num_args = arg_index_to_node_map_.rbegin()->first + 1;
+    arg_output_locations_.resize(num_args);
+    for (const auto& arg_index_node_pair : arg_index_to_node_map_) {
+      const size_t arg_index = arg_index_node_pair.first;
+      const Node* arg_node = arg_index_node_pair.second;
+      arg_output_locations_[arg_index].reserve(arg_node->out_edges().size());
+      for (const Edge* e : arg_node->out_edges()) {
+        if (e->src_output() == Graph::kControlSlot) {
+          continue;
+        } else if (e->src_output() != 0) {
+          return absl::InternalError(
+              absl::StrCat("Invalid output index ", e->src_output(),
+                           " from argument node ", arg_index));
+        }
+        arg_output_locations_[arg_index].push_back(
+            kernels_[node_to_index_map[e->dst()]].input_start_index +
+            e->dst_input());
+      }
+    }
+  }
+
+  // Build the mapping from each const tensor kernel to the input slot for the
+  // corresponding destination node.
+  for (size_t i = 0; i < const_tensor_kernels_.size(); ++i) {
+    const Node* n = nodes_with_const_tensor_kernels_[i];
+    ConstTensorKernelState& kernel_state = const_tensor_kernels_[i];
+    for (const Edge* e : n->out_edges()) {
+      if (e->src_output() == Graph::kControlSlot) {
+        continue;
+      } else if (e->src_output() != 0) {
+        return absl::InternalError(
+            absl::StrCat("Invalid output index ", e->src_output(),
+                         " from node ", n->DebugString()));
+      }
+      kernel_state.output_locations.push_back(
+          kernels_[node_to_index_map[e->dst()]].input_start_index +
+          e->dst_input());
+    }
+  }
+
+  // Build the mapping from each node output to the input slot for the
+  // corresponding destination node.
+  for (size_t i = 0; i < kernels_.size(); ++i) {
+    const Node* n = nodes[i];
+    KernelState& kernel_state = kernels_[i];
+    kernel_state.output_locations.resize(kernel_state.num_outputs);
+    for (const Edge* e : n->out_edges()) {
+      if (!e->IsControlEdge()) {
+        kernel_state.output_locations[e->src_output()].push_back(
+            kernels_[node_to_index_map[e->dst()]].input_start_index +
+            e->dst_input());
+      }
+    }
+
+    // Compute allocator attributes for each node output, and corresponding
+    // node input.
+    kernel_state.output_alloc_attrs.resize(kernel_state.num_outputs);
+    AllocatorAttributes* attrs = kernel_state.output_alloc_attrs.data();
+
+    OpKernel* op_kernel = kernel_state.kernel;
+    for (int out = 0; out < n->num_outputs(); out++) {
+      DCHECK_LT(out, op_kernel->output_memory_types().size());
+      bool on_host = op_kernel->output_memory_types()[out] == HOST_MEMORY;
+      if (on_host) {
+        AllocatorAttributes h;
+        h.set_on_host(on_host);
+        attrs[out].Merge(h);
+      }
+    }
+  }
+
+  if (!kernels_.empty()) {
+    const KernelState& last_kernel_state = kernels_.back();
+    total_num_inputs_ =
+        last_kernel_state.input_start_index + last_kernel_state.num_inputs;
+    input_alloc_attrs_.resize(total_num_inputs_);
+    for (size_t i = 0; i < kernels_.size(); ++i) {
+      for (size_t j = 0; j < kernels_[i].output_locations.size(); ++j) {
+        for (size_t output_location : kernels_[i].output_locations[j]) {
+          input_alloc_attrs_[output_location] =
+              kernels_[i].output_alloc_attrs[j];
+        }
+      }
+    }
+  } else {
+    total_num_inputs_ = 0;
+  }
+  return absl::OkStatus();
+}
+
+void FlatExecutorState::InitializeParams(
+    const Executor::Args& args, Device* device, Executor::Args::Runner* runner,
+    const std::string* executor_type, OpKernelContext::Params* params) const {
+  params->step_id = args.step_id;
+  params->device = device;
+  params->log_memory = false;  // TODO(mrry): Too severe?
+  params->rendezvous = args.rendezvous;
+  params->session_state = args.session_state;
+  params->session_metadata = params_.session_metadata;
+  params->tensor_store = args.tensor_store;
+  params->cancellation_manager = args.cancellation_manager;
+  params->session_config = args.session_config;
+  params->call_frame = args.call_frame;
+  params->function_library = params_.function_library;
+  params->resource_manager = device->resource_manager();
+  params->step_container = args.step_container;
+  params->collective_executor = args.collective_executor;
+  params->stack_trace = args.stack_trace;
+  params->slice_reader_cache = nullptr;  // TODO(mrry): Too severe?
+
+  params->runner = runner;
+  params->run_all_kernels_inline = args.run_all_kernels_inline;
+  params->stats_collector = args.stats_collector;
+  params->executor_type = executor_type;
+
+  // NOTE(mrry): We are assuming that the graph is loopless and condless.
+  params->frame_iter = FrameAndIter(0, 0);
+  params->is_input_dead = false;
+
+  device->TryGetDeviceContext(&params->op_device_context).IgnoreError();
+
+  // TODO(mrry): Consider implementing forwarding.
+  params->forward_from_array = nullptr;
+}
+
+absl::Status FlatExecutorState::ForwardArgsAndConsts(
+    const Executor::Args& args, Entry* inputs) const {
+  const size_t received_args =
+      args.call_frame ? args.call_frame->num_args() : 0;
+  if (TF_PREDICT_FALSE(arg_output_locations_.size() > received_args)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Expected ", arg_output_locations_.size(),
+                     " arguments, but only received ", received_args, "."));
+  }
+
+  // ArgOp is a relatively expensive OpKernel due to the Tensor
+  // allocations that it performs. Therefore we specialize its implementation
+  // and forward arguments directly to the inputs of kernels that consume
+  // them.
+  for (size_t i = 0; i < arg_output_locations_.size(); ++i) {
+    const size_t num_destinations = arg_output_locations_[i].size();
+    if (num_destinations > 0) {
+      if (args.call_frame->CanConsumeArg(i)) {
+        // The first destination input can consume the argument.
+        Entry& first_input = inputs[arg_output_locations_[i][0]];
+        first_input.state = Entry::State::HAS_VALUE;
+        first_input.val.Init();
+        args.call_frame->ConsumeArg(i, first_input.val.get());
+        // All subsequent destination inputs get a shallow copy of the first
+        // destination input.
+        //
+        // NOTE: If we had metadata about which kernels might attempt to
+        // forward their input, we could arrange the kernel order so that
+        // one of those kernels was executed last.
+        for (size_t j = 1; j < num_destinations; ++j) {
+          Entry& input = inputs[arg_output_locations_[i][j]];
+          input.state = Entry::State::HAS_VALUE;
+          input.val.Init(*first_input.val);
+        }
+      } else {
+        const Tensor* arg;
+        TF_RETURN_IF_ERROR(args.call_frame->GetArg(i, &arg));
+        for (size_t j = 0; j < num_destinations; ++j) {
+          Entry& input = inputs[arg_output_locations_[i][j]];
+          // NOTE: We must make at least one shallow copy of the argument
+          // tensor that remains live until all consuming kernels have
+          // executed, to keep the reference count > 1, and inhibit buffer
+          // forwarding. For simplicity, we shallow copy into the input entry
+          // for each consuming kernel.
+          input.state = Entry::State::HAS_VALUE;
+          input.val.Init(*arg);
+        }
+      }
+    }
+  }
+
+  // Kernels that return a constant value (e.g. ConstOp) are relatively
+  // expensive due to the Tensor allocations that they perform. Therefore we
+  // specialize their implementation and forward their constant value directly
+  // to the inputs of kernels that consume them.
+  for (const ConstTensorKernelState& kernel_state : const_tensor_kernels_) {
+    for (size_t i = 0; i < kernel_state.output_locations.size(); ++i) {
+      Entry& input = inputs[kernel_state.output_locations[i]];
+      input.state = Entry::State::HAS_CONST_TENSOR;
+      input.const_tensor = &kernel_state.const_tensor;
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status FlatExecutorState::RunKernels(size_t begin, size_t end,
+                                           Device* device,
+                                           KernelRunState* state,
+                                           Entry* inputs) const {
+  // TODO(mrry): Can we avoid copying into these vectors? Consider modifying
+  // OpKernelContext to take the TensorValueVec as a pointer into `inputs`.
+  OpKernelContext::Params& params = state->params;
+  TensorValueVec& node_inputs = state->node_inputs;
+  AllocatorAttributeVec& input_alloc_attrs = state->input_alloc_attrs;
+  for (size_t i = begin; i < end; ++i) {
+    const KernelState& kernel_state = kernels_[i];
+
+    // Prepare the per-kernel parameters.
+    const size_t input_start_index = kernel_state.input_start_index;
+    const size_t num_inputs = kernel_state.num_inputs;
+    const size_t num_outputs = kernel_state.num_outputs;
+
+    node_inputs.clear();
+    node_inputs.resize(num_inputs);
+    input_alloc_attrs.clear();
+    input_alloc_attrs.resize(num_inputs);
+    for (size_t j = 0; j < num_inputs; ++j) {
+      Entry& input = inputs[input_start_index + j];
+      switch (input.state) {
+        case Entry::State::HAS_CONST_TENSOR:
+          // NOTE(mrry): This `const_cast` is necessary because `TensorValue`
+          // stores a non-const `Tensor*`, and relies on the `OpKernelContext`
+          // accessors making dynamic checks that prevent using an immutable
+          // tensor as a mutable tensor.
+          node_inputs[j].tensor = const_cast<Tensor*>(input.const_tensor);
+          break;
+        case Entry::State::HAS_VALUE:
+          node_inputs[j].tensor = input.val.get();
+          break;
+        default:
+          DCHECK(false) << "Input did not have a valid value.";
+      }
+      input_alloc_attrs[j] = input_alloc_attrs_[input_start_index + j];
+    }
+    params.inputs = node_inputs;
+    params.input_alloc_attrs = input_alloc_attrs;
+    params.op_kernel = kernel_state.kernel;
+    params.output_attr_array = kernel_state.output_alloc_attrs.data();
+    OpKernelContext ctx(&params, num_outputs);
+
+    // Actually execute the kernel.
+    device->Compute(kernel_state.kernel, &ctx);
+    TF_RETURN_IF_ERROR(ctx.status());
+
+    // Free the inputs to the current kernel.
+    for (size_t j = 0; j < num_inputs; ++j) {
+      inputs[input_start_index + j].ClearVal();
+    }
+
+    // Forward the outputs of the kernel to the inputs of subsequent kernels.
+    for (size_t j = 0; j < num_outputs; ++j) {
+      TensorValue val = ctx.release_output(j);
+      const size_t num_destinations = kernel_state.output_locations[j].size();
+      if (num_destinations > 0) {
+        // TODO(mrry): Consider flattening the `output_locations` vector
+        // to improve the cache-friendliness of this loop.
+        for (size_t k = 0; k < num_destinations - 1; ++k) {
+          // TODO(mrry): Validate that the types match the expected values or
+          // ensure that the necessary validation has already happened.
+          Entry& input = inputs[kernel_state.output_locations[j][k]];
+          input.state = Entry::State::HAS_VALUE;
+          if (val.tensor != nullptr) {
+            input.val.Init(*val.tensor);
+          } else {
+            input.val.Init(Tensor(kernel_state.kernel->output_type(j)));
+          }
+        }
+        // Move `arg` to the last consumer to avoid the cost of copying it.
+        Entry& input =
+            inputs[kernel_state.output_locations[j][num_destinations - 1]];
+        input.state = Entry::State::HAS_VALUE;
+        if (val.tensor != nullptr) {
+          input.val.Init(std::move(*val.tensor));
+        } else {
+          input.val.Init(Tensor(kernel_state.kernel->output_type(j)));
+        }
+      }
+      delete val.tensor;
+    }
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace tensorflow
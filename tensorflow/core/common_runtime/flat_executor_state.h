@@ -0,0 +1,191 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_FLAT_EXECUTOR_STATE_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_FLAT_EXECUTOR_STATE_H_
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/status/status.h"
+#include "tensorflow/core/common_runtime/entry.h"
+#include "tensorflow/core/common_runtime/executor.h"
+#include "tensorflow/core/common_runtime/local_executor_params.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/graph/graph.h"
+
+namespace tensorflow {
+
+// The kernels of a graph without control flow, laid out in a fixed order, and
+// the code that runs them. Shared by the executors that run such graphs
+// without per-node scheduling: the single-threaded executor and the
+// static-schedule executor.
+//
+// The inputs of all kernels of a step are stored contiguously in a flat array
+// of `Entry` of length `total_num_inputs()`. The inputs of kernel `i` are the
+// `kernels()[i].num_inputs` entries starting at
+// `kernels()[i].input_start_index`:
+//
+// * Kernel 0, input 0.
+// * ...
+// * Kernel 0, input `kernels()[0].num_inputs - 1`.
+// * Kernel 1, input 0.
+// * ...
+// * Kernel `kernels().size() - 1`, input `kernels().back().num_inputs - 1`.
+//
+// Kernels with zero inputs do not correspond to any elements in the array.
+// Elements are initialized when the arguments and constants are forwarded at
+// the start of a step, or when the outputs of a kernel are propagated to the
+// inputs of the kernels that depend on them. The inputs of kernel `i` are
+// destroyed after kernel `i` executes.
+//
+// Usage: call `AddNode()` for every node of the graph except _SOURCE and
+// _SINK, then `Finalize()` with the nodes that need a kernel in the order in
+// which they run.
+class FlatExecutorState {
+ public:
+  typedef absl::InlinedVector<TensorValue, 4UL> TensorValueVec;
+  typedef absl::InlinedVector<AllocatorAttributes, 4UL> AllocatorAttributeVec;
+
+  // Represents cached graph structure state for each kernel.
+  struct KernelState {
+    // The kernel object. Not owned.
+    //
+    // This pointer is managed by `params.create_kernel()` and
+    // `params.delete_kernel()`.
+    OpKernel* kernel;
+
+    // These fields determine the range of elements in `inputs` that corresponds
+    // to the inputs of `kernel`.
+    size_t input_start_index;
+    size_t num_inputs;
+
+    size_t num_outputs;
+
+    // For the `j`th output of `kernel`, `output_locations[j]` contains the
+    // locations in the flat `inputs` array to which that output must be
+    // copied.
+    std::vector<std::vector<size_t>>
+        output_locations;  // Length = `num_outputs`.
+
+    // Memory space information for each output of `kernel`.
+    std::vector<AllocatorAttributes>
+        output_alloc_attrs;  // Length = `num_outputs`.
+  };
+
+  // The per-thread scratch space of `RunKernels()`.
+  struct KernelRunState {
+    OpKernelContext::Params params;
+    TensorValueVec node_inputs;
+    AllocatorAttributeVec input_alloc_attrs;
+  };
+
+  explicit FlatExecutorState(const LocalExecutorParams& params)
+      : params_(params) {}
+  ~FlatExecutorState();
+
+  // Records `n`. Sets `*needs_kernel` to true if `n` must be passed to
+  // `Finalize()`, and to false if the executor does not run `n` itself: the
+  // values of _Arg nodes and of nodes that produce a single constant tensor
+  // are forwarded to their consumers at the start of each step.
+  absl::Status AddNode(const Node* n, bool* needs_kernel);
+
+  // Lays out the kernels of `nodes`, which must be the nodes for which
+  // `AddNode()` set `needs_kernel`, in the order given.
+  absl::Status Finalize(const std::vector<const Node*>& nodes);
+
+  // Prepares the parameters that are the same for all kernels of a step.
+  // The caller must `Unref()` `params->op_device_context` if it is set.
+  void InitializeParams(const Executor::Args& args, Device* device,
+                        Executor::Args::Runner* runner,
+                        const std::string* executor_type,
+                        OpKernelContext::Params* params) const;
+
+  // Forwards the arguments and constants of a step to the flat `inputs` array
+  // of length `total_num_inputs()`.
+  absl::Status ForwardArgsAndConsts(const Executor::Args& args,
+                                    Entry* inputs) const;
+
+  // Runs `kernels()[begin]` up to `kernels()[end]` one at a time, reading
+  // their inputs from and propagating their outputs to `inputs`.
+  absl::Status RunKernels(size_t begin, size_t end, Device* device,
+                          KernelRunState* state, Entry* inputs) const;
+
+  const std::vector<KernelState>& kernels() const { return kernels_; }
+  size_t total_num_inputs() const { return total_num_inputs_; }
+
+ private:
+  // Represents cached graph structure state for each kernel that produces
+  // a single constant-valued tensor.
+  struct ConstTensorKernelState {
+    // The kernel object. Not owned.
+    //
+    // This pointer is managed by `params.create_kernel()` and
+    // `params.delete_kernel()`.
+    OpKernel* kernel;
+
+    // The cached value of `kernel->const_tensor()`.
+    //
+    // NOTE: We keep a `Tensor` rather than a `const Tensor*` here in order to
+    // keep the reference count on the underlying buffer above 1. Otherwise, a
+    // kernel could interpret the input as a forwardable tensor, and mutate the
+    // underlying constant tensor.
+    Tensor const_tensor;
+
+    // The locations in the flat `inputs` array to which the single output of
+    // `kernel` must be copied.
+    std::vector<size_t> output_locations;
+  };
+
+  const LocalExecutorParams params_;
+
+  // The state below is built by `AddNode()` and `Finalize()`, and read-only
+  // afterwards.
+
+  // The kernels created by `AddNode()` that `Finalize()` has not laid out
+  // yet.
+  absl::flat_hash_map<const Node*, OpKernel*> pending_kernels_;
+  std::map<size_t, const Node*> arg_index_to_node_map_;
+  std::vector<const Node*> nodes_with_const_tensor_kernels_;
+
+  // The sum of the number of inputs for each kernel. This determines the
+  // length of the flat `inputs` array.
+  size_t total_num_inputs_ = 0;
+
+  std::vector<KernelState> kernels_;
+
+  // For the `i`th argument, `arg_output_locations_[i]` contains the locations
+  // in the flat `inputs` array to which that argument must be copied.
+  std::vector<std::vector<size_t>>
+      arg_output_locations_;  // Length = `num_args`.
+
+  std::vector<ConstTensorKernelState> const_tensor_kernels_;
+
+  // Memory space information for each input, in the same order as the flat
+  // `inputs` array.
+  std::vector<AllocatorAttributes>
+      input_alloc_attrs_;  // Length = `total_num_inputs_`.
+
+  FlatExecutorState(const FlatExecutorState&) = delete;
+  void operator=(const FlatExecutorState&) = delete;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_FLAT_EXECUTOR_STATE_H_
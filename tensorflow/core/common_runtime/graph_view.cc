@@ -26,6 +26,7 @@ limitations under the License.
 
 #include "absl/log/check.h"
 #include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/framework/memory_types.h"
 #include "tensorflow/core/framework/node_def_util.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -41,6 +42,9 @@ limitations under the License.
 namespace tensorflow {
 
 std::string NodeItem::DebugString() const {
+  if (kernel == nullptr) {
+    return absl::StrCat("{id:", node_id, " kernel not created}");
+  }
   std::string ret = absl::StrCat("{name:'", kernel->name(), "' id:", node_id);
   if (is_source) {
     absl::StrAppend(&ret, " source}");
@@ -152,6 +156,7 @@ char* GraphView::InitializeNode(char* ptr, const Node* n) {
   const int num_outputs = n->num_outputs();
 
   new (item) NodeItem();
+  item->kernel_is_lazy = false;
   item->num_inputs = num_inputs;
   item->num_outputs = num_outputs;
   item->num_output_edges = num_output_edges;
@@ -448,10 +453,22 @@ absl::Status GraphView::SetAllocAttrs(const Graph* g, const Device* device) {
       }
     }
 
+    // A lazily created kernel does not exist yet, so compute its memory
+    // types the same way CreateOpKernel() does.
+    MemoryTypeVector lazy_output_memory_types;
+    if (item->kernel == nullptr && n->num_outputs() > 0) {
+      MemoryTypeVector input_memory_types;
+      s = MemoryTypesForNode(OpRegistry::Global(),
+                             DeviceType(device->device_type()), n->def(),
+                             &input_memory_types, &lazy_output_memory_types);
+      if (!s.ok()) return s;
+    }
+    const MemoryTypeSlice output_memory_types =
+        item->kernel != nullptr ? item->kernel->output_memory_types()
+                                : MemoryTypeSlice(lazy_output_memory_types);
     for (int out = 0; out < n->num_outputs(); out++) {
-      const OpKernel* op_kernel = item->kernel;
-      DCHECK_LT(out, op_kernel->output_memory_types().size());
-      bool on_host = op_kernel->output_memory_types()[out] == HOST_MEMORY;
+      DCHECK_LT(out, output_memory_types.size());
+      bool on_host = output_memory_types[out] == HOST_MEMORY;
       if (on_host) {
         AllocatorAttributes h;
         h.set_on_host(on_host);
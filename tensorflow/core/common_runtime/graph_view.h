@@ -85,8 +85,13 @@ struct NodeItem {
                                     // node's input types.
   bool is_distributed_communication : 1;  // True iff the op is registered to
                                           // use distributed communication.
+  // True iff the kernel is created when the node first runs. See
+  // ImmutableExecutorState::EnsureKernel().
+  bool kernel_is_lazy : 1;
 
-  // The kernel for this node.
+  // The kernel for this node. If `kernel_is_lazy`, this is null until
+  // ImmutableExecutorState::EnsureKernel() has succeeded, and
+  // `kernel_is_async` is false.
   OpKernel* kernel = nullptr;
 
   // If the kernel is a Const op, this containts points to the constant tensor.
@@ -111,6 +116,11 @@ struct NodeItem {
   // is true if and only if the ith output is consumed by another node.
   std::unique_ptr<bool[]> outputs_required;
 
+  // If non-null, contains an array of num_outputs bools, where the ith bool
+  // is true if the ith output is not expected to outlive the step, and may be
+  // allocated from the step arena.
+  std::unique_ptr<bool[]> outputs_step_local;
+
   absl::Span<EdgeInfo> mutable_output_edges() {
     return absl::Span<EdgeInfo>(output_edge_base(), num_output_edges);
   }
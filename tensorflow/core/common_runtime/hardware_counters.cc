@@ -0,0 +1,124 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/hardware_counters.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // defined(__linux__)
+
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+
+#if defined(__linux__)
+namespace {
+
+// Opens a user-space counter of the calling thread for the hardware event
+// `config`, in the group led by `group_fd` (or as a new leader if -1).
+int OpenCounter(uint64_t config, int group_fd) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = config;
+  attr.read_format = PERF_FORMAT_GROUP;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  return syscall(__NR_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1, group_fd,
+                 /*flags=*/0);
+}
+
+}  // namespace
+
+ThreadHardwareCounters::~ThreadHardwareCounters() {
+  for (int fd : fds_) {
+    if (fd >= 0) close(fd);
+  }
+}
+
+ThreadHardwareCounters* ThreadHardwareCounters::ForCurrentThread() {
+  thread_local std::unique_ptr<ThreadHardwareCounters> counters = [] {
+    std::unique_ptr<ThreadHardwareCounters> counters(
+        new ThreadHardwareCounters);
+    if (!counters->Open()) {
+      LOG_FIRST_N(WARNING, 1)
+          << "Hardware performance counters are not available: "
+          << strerror(errno)
+          << ". Check /proc/sys/kernel/perf_event_paranoid.";
+      counters.reset();
+    }
+    return counters;
+  }();
+  return counters.get();
+}
+
+bool ThreadHardwareCounters::Open() {
+  static constexpr uint64_t kConfigs[kNumEvents] = {
+      PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+      // Usually the misses of the last level cache.
+      PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+  fds_[kCycles] = OpenCounter(kConfigs[kCycles], /*group_fd=*/-1);
+  if (fds_[kCycles] < 0) return false;
+  slots_[kCycles] = num_slots_++;
+  for (int event = kCycles + 1; event < kNumEvents; ++event) {
+    fds_[event] = OpenCounter(kConfigs[event], fds_[kCycles]);
+    if (fds_[event] >= 0) slots_[event] = num_slots_++;
+  }
+  return true;
+}
+
+bool ThreadHardwareCounters::Read(HardwareCounterValues* values) const {
+  // With PERF_FORMAT_GROUP the leader returns the number of counters followed
+  // by their values, in the order they were opened.
+  uint64_t buffer[1 + kNumEvents];
+  const ssize_t size = sizeof(uint64_t) * (1 + num_slots_);
+  if (read(fds_[kCycles], buffer, size) != size ||
+      buffer[0] != static_cast<uint64_t>(num_slots_)) {
+    return false;
+  }
+  auto value = [&](Event event) -> int64_t {
+    return slots_[event] < 0 ? 0 : buffer[1 + slots_[event]];
+  };
+  values->cycles = value(kCycles);
+  values->instructions = value(kInstructions);
+  values->llc_misses = value(kLlcMisses);
+  values->branch_misses = value(kBranchMisses);
+  return true;
+}
+
+#else  // defined(__linux__)
+
+ThreadHardwareCounters::~ThreadHardwareCounters() = default;
+
+ThreadHardwareCounters* ThreadHardwareCounters::ForCurrentThread() {
+  return nullptr;
+}
+
+bool ThreadHardwareCounters::Open() { return false; }
+
+bool ThreadHardwareCounters::Read(HardwareCounterValues* values) const {
+  return false;
+}
+
+#endif  // defined(__linux__)
+
+}  // namespace tensorflow
@@ -0,0 +1,68 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_HARDWARE_COUNTERS_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_HARDWARE_COUNTERS_H_
+
+#include <cstdint>
+
+namespace tensorflow {
+
+// Values of the hardware performance counters of one thread.
+struct HardwareCounterValues {
+  int64_t cycles = 0;
+  int64_t instructions = 0;
+  int64_t llc_misses = 0;
+  int64_t branch_misses = 0;
+};
+
+// The hardware performance counters of one thread, read with
+// perf_event_open(2) on Linux. Only user-space events of the thread itself
+// are counted, so work that a kernel hands to other threads (e.g. the
+// intra-op thread pool) is not included.
+//
+// Counters that the machine does not support are reported as 0. If the
+// kernel overcommits the PMU the counts are not scaled, and may be low.
+class ThreadHardwareCounters {
+ public:
+  ~ThreadHardwareCounters();
+
+  // Returns the counters of the calling thread, which are opened on first use
+  // and closed when the thread exits. Returns nullptr if they are not
+  // available, e.g. on other platforms or when perf_event_paranoid forbids
+  // them.
+  static ThreadHardwareCounters* ForCurrentThread();
+
+  // Reads the current values of the counters. Must be called from the thread
+  // that owns them. Returns false on failure.
+  bool Read(HardwareCounterValues* values) const;
+
+ private:
+  ThreadHardwareCounters() = default;
+
+  // Opens the counters. Returns false if the cycle counter, which leads the
+  // group, cannot be opened.
+  bool Open();
+
+  enum Event { kCycles, kInstructions, kLlcMisses, kBranchMisses, kNumEvents };
+
+  int fds_[kNumEvents] = {-1, -1, -1, -1};
+  // Position of each event in the group read, or -1 if it is not counted.
+  int slots_[kNumEvents] = {-1, -1, -1, -1};
+  int num_slots_ = 0;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_HARDWARE_COUNTERS_H_
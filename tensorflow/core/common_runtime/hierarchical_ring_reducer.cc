@@ -0,0 +1,416 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/hierarchical_ring_reducer.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/check.h"
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/notification.h"
+#include "tensorflow/core/common_runtime/collective_rma_local.h"
+#include "tensorflow/core/common_runtime/collective_util.h"
+#include "tensorflow/core/common_runtime/device_mgr.h"
+#include "tensorflow/core/common_runtime/dma_helper.h"
+#include "tensorflow/core/common_runtime/ring_reducer.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/profiler/lib/traceme.h"
+
+namespace tensorflow {
+
+namespace {
+// Phases of the transfers between a leader and the other devices of its task.
+constexpr char kReducePhase[] = "hr_reduce";
+constexpr char kBroadcastPhase[] = "hr_bcast";
+
+// The number of values of other devices of its task that a leader receives
+// ahead of reducing them, which bounds its temporary memory.
+constexpr int kMaxLocalRecvsAhead = 2;
+
+// Key to be used for BufRendezvous by HierarchicalRingReducer, for the
+// transfer between a leader and the device at `local_rank` in its task.  The
+// ring among leaders uses the RingAlg keys under the same exec_key, which
+// cannot collide with these.
+std::string HierarchicalRingBufKey(const std::string& exec_key,
+                                   const char* phase, int local_rank) {
+  return strings::StrCat(exec_key, ":", phase, ":", local_rank);
+}
+}  // namespace
+
+HierarchicalRingReducer::HierarchicalRingReducer()
+    : col_ctx_(nullptr), col_params_(nullptr) {}
+
+absl::Status HierarchicalRingReducer::InitializeCollectiveParams(
+    CollectiveParams* col_params) {
+  CHECK_EQ(col_params->instance.type, REDUCTION_COLLECTIVE);
+  CHECK_EQ(col_params->instance.impl_details.collective_name,
+           "HierarchicalRingReduce");
+  if (col_params->group.device_type != DEVICE_CPU) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "HierarchicalRingReduce only supports CPU devices, got ",
+        col_params->group.device_type.type_string()));
+  }
+
+  // Group the members by task, in the order of their first device.
+  std::vector<std::vector<int>> task_members;
+  absl::flat_hash_map<std::string, int> task_index;
+  for (int di = 0; di < col_params->group.group_size; ++di) {
+    const int next_index = static_cast<int>(task_members.size());
+    auto it =
+        task_index.emplace(col_params->group.members[di].task, next_index)
+            .first;
+    if (it->second == next_index) task_members.emplace_back();
+    task_members[it->second].push_back(di);
+  }
+  std::vector<int> leaders;
+  leaders.reserve(task_members.size());
+  for (const std::vector<int>& members : task_members) {
+    leaders.push_back(members[0]);
+  }
+
+  auto& perms = col_params->instance.impl_details.subdiv_permutations;
+  perms.clear();
+  perms.push_back(std::move(leaders));
+  for (std::vector<int>& members : task_members) {
+    perms.push_back(std::move(members));
+  }
+  col_params->subdiv_rank.assign(perms.size(), -1);
+  for (int sdi = 0; sdi < perms.size(); ++sdi) {
+    for (int rank = 0; rank < perms[sdi].size(); ++rank) {
+      if (perms[sdi][rank] == col_params->default_rank) {
+        col_params->subdiv_rank[sdi] = rank;
+      }
+    }
+  }
+  VLOG(2) << collective_util::SubdivPermDebugString(*col_params);
+  return absl::OkStatus();
+}
+
+absl::Status HierarchicalRingReducer::InitializeCollectiveContext(
+    std::shared_ptr<CollectiveContext> col_ctx) {
+  CHECK(col_ctx->dev_mgr);
+  col_ctx_ = col_ctx;
+  col_params_ = col_ctx->col_params.get();
+  return collective_util::InitializeDeviceAndLocality(
+      col_ctx->dev_mgr, col_ctx->device_name, &col_ctx->device,
+      &col_ctx->device_locality);
+}
+
+void HierarchicalRingReducer::Run(StatusCallback done) {
+  CHECK(col_ctx_);
+  CHECK(col_params_);
+  col_ctx_->col_exec->UnblockDependencies(*col_params_);
+
+  // Start by copying input to output if they're not already the same, i.e. if
+  // we're not computing in-place on the input tensor.
+  absl::Status status;
+  if ((col_ctx_->input != col_ctx_->output) &&
+      (DMAHelper::base(col_ctx_->input) != DMAHelper::base(col_ctx_->output))) {
+    absl::Notification note;
+    CollectiveRemoteAccessLocal::MemCpyAsync(
+        col_ctx_->op_ctx->op_device_context(),
+        col_ctx_->op_ctx->op_device_context(), col_ctx_->device,
+        col_ctx_->device, col_ctx_->op_ctx->input_alloc_attr(0),
+        col_ctx_->op_ctx->output_alloc_attr(0), col_ctx_->input,
+        col_ctx_->output, 0 /*dev_to_dev_stream_index*/,
+        [&note, &status](const absl::Status& s) {
+          status.Update(s);
+          note.Notify();
+        });
+    note.WaitForNotification();
+  }
+
+  if (status.ok()) {
+    // The task-local subdiv this device belongs to.
+    int task_subdiv = 1;
+    while (col_params_->subdiv_rank[task_subdiv] < 0) ++task_subdiv;
+    if (col_params_->subdiv_rank[task_subdiv] == 0) {
+      status = RunLeader(task_subdiv);
+    } else {
+      status = RunFollower(task_subdiv);
+    }
+  }
+  if (!status.ok()) StartAbort(status);
+  {
+    mutex_lock l(status_mu_);
+    status = status_;
+  }
+  done(status);
+}
+
+absl::Status HierarchicalRingReducer::RunLeader(int task_subdiv) {
+  const std::vector<int>& perm =
+      col_params_->instance.impl_details.subdiv_permutations[task_subdiv];
+  const int num_local = static_cast<int>(perm.size());
+  VLOG(1) << "HierarchicalRingReducer leader device=" << col_ctx_->device_name
+          << " reducing " << num_local << " local values";
+
+  // Receive the values of the other devices of the task into a bounded set of
+  // buffers, and reduce them in rank order as they arrive. The fixed order
+  // makes the result independent of the timing of the transfers.
+  absl::Status status;
+  {
+    tsl::profiler::TraceMe activity("LocalReduce",
+                                    tsl::profiler::TraceMeLevel::kInfo);
+    Allocator* allocator = col_ctx_->device->GetAllocator(
+        col_ctx_->op_ctx->output_alloc_attr(0));
+    const int num_buffers = std::min(kMaxLocalRecvsAhead, num_local - 1);
+    std::vector<Tensor> buffers;
+    buffers.reserve(num_buffers);
+    for (int i = 0; i < num_buffers; ++i) {
+      buffers.emplace_back(allocator, col_ctx_->output->dtype(),
+                           col_ctx_->output->shape());
+    }
+    mutex mu;
+    condition_variable arrival;
+    std::vector<bool> received(num_local, false);  // TF_GUARDED_BY(mu)
+    absl::Status recv_status;                      // TF_GUARDED_BY(mu)
+    // The value of local rank `lr` is received into
+    // `buffers[(lr - 1) % num_buffers]`.
+    auto start_recv = [&](int lr) {
+      DispatchRecv(
+          perm[lr],
+          HierarchicalRingBufKey(col_ctx_->exec_key, kReducePhase, lr),
+          &buffers[(lr - 1) % num_buffers],
+          [lr, &mu, &arrival, &received, &recv_status](const absl::Status& s) {
+            mutex_lock l(mu);
+            recv_status.Update(s);
+            received[lr] = true;
+            arrival.notify_all();
+          });
+    };
+    int next_recv = 1;
+    for (; next_recv <= num_buffers; ++next_recv) start_recv(next_recv);
+    // Every callback must be fielded before returning, even after an error,
+    // but no more receives are started then.
+    for (int lr = 1; lr < next_recv; ++lr) {
+      {
+        mutex_lock l(mu);
+        while (!received[lr]) arrival.wait(l);
+        status.Update(recv_status);
+      }
+      if (status.ok()) {
+        status = collective_util::ComputeBinOp(
+            col_ctx_->op_ctx, col_ctx_->op_params, col_ctx_->device,
+            col_params_->merge_op, col_ctx_->output,
+            &buffers[(lr - 1) % num_buffers]);
+      }
+      if (!status.ok()) {
+        StartAbort(status);
+      } else if (next_recv < num_local) {
+        // The buffer of `lr` is free again.
+        start_recv(next_recv++);
+      }
+    }
+  }
+
+  if (status.ok()) {
+    tsl::profiler::TraceMe activity("LeaderRing",
+                                    tsl::profiler::TraceMeLevel::kInfo);
+    status = RunLeaderRing();
+  }
+
+  if (status.ok() && col_params_->final_op) {
+    // The value now holds the reduction over all devices of the group.
+    std::unique_ptr<CollectiveAdapter> ca(MakeCollectiveAdapter(
+        col_ctx_->output, 1,
+        col_ctx_->device->GetAllocator(
+            col_ctx_->op_ctx->output_alloc_attr(0))));
+    Tensor group_size = ca->Scalar(col_params_->group.group_size);
+    status = collective_util::ComputeBinOp(
+        col_ctx_->op_ctx, col_ctx_->op_params, col_ctx_->device,
+        col_params_->final_op, col_ctx_->output, &group_size);
+  }
+  if (!status.ok()) return status;
+
+  tsl::profiler::TraceMe activity("LocalBroadcast",
+                                  tsl::profiler::TraceMeLevel::kInfo);
+  mutex mu;
+  int pending_count = num_local - 1;  // TF_GUARDED_BY(mu)
+  condition_variable all_done;
+  for (int lr = 1; lr < num_local; ++lr) {
+    DispatchSend(
+        perm[lr],
+        HierarchicalRingBufKey(col_ctx_->exec_key, kBroadcastPhase, lr),
+        col_ctx_->output,
+        [&mu, &pending_count, &all_done, &status](const absl::Status& s) {
+          mutex_lock l(mu);
+          status.Update(s);
+          if (--pending_count == 0) all_done.notify_all();
+        });
+  }
+  mutex_lock l(mu);
+  while (pending_count > 0) all_done.wait(l);
+  return status;
+}
+
+absl::Status HierarchicalRingReducer::RunFollower(int task_subdiv) {
+  const int leader_idx =
+      col_params_->instance.impl_details.subdiv_permutations[task_subdiv][0];
+  const int local_rank = col_params_->subdiv_rank[task_subdiv];
+  absl::Status status;
+  {
+    tsl::profiler::TraceMe activity("SendToLeader",
+                                    tsl::profiler::TraceMeLevel::kInfo);
+    absl::Notification note;
+    DispatchSend(leader_idx,
+                 HierarchicalRingBufKey(col_ctx_->exec_key, kReducePhase,
+                                        local_rank),
+                 col_ctx_->output, [&status, &note](const absl::Status& s) {
+                   status.Update(s);
+                   note.Notify();
+                 });
+    note.WaitForNotification();
+  }
+  if (!status.ok()) return status;
+  tsl::profiler::TraceMe activity("RecvFromLeader",
+                                  tsl::profiler::TraceMeLevel::kInfo);
+  absl::Notification note;
+  DispatchRecv(leader_idx,
+               HierarchicalRingBufKey(col_ctx_->exec_key, kBroadcastPhase,
+                                      local_rank),
+               col_ctx_->output, [&status, &note](const absl::Status& s) {
+                 status.Update(s);
+                 note.Notify();
+               });
+  note.WaitForNotification();
+  return status;
+}
+
+absl::Status HierarchicalRingReducer::RunLeaderRing() {
+  const std::vector<int>& leaders =
+      col_params_->instance.impl_details.subdiv_permutations[0];
+  if (leaders.size() < 2) return absl::OkStatus();
+
+  // The ring is a RingReduce instance whose group is the leaders.
+  core::RefCountPtr<CollectiveParams> ring_params(new CollectiveParams());
+  ring_params->name = col_params_->name;
+  ring_params->group.group_key = col_params_->group.group_key;
+  ring_params->group.group_size = static_cast<int32_t>(leaders.size());
+  ring_params->group.device_type = col_params_->group.device_type;
+  ring_params->group.num_tasks = static_cast<int32_t>(leaders.size());
+  ring_params->group.same_num_devices_per_task = true;
+  ring_params->group.runtime_details = col_params_->group.runtime_details;
+  for (int idx : leaders) {
+    const CollGroupMember& member = col_params_->group.members[idx];
+    if (idx == col_params_->default_rank) {
+      ring_params->default_rank =
+          static_cast<int>(ring_params->group.members.size());
+    }
+    ring_params->group.members.push_back(member);
+    ring_params->group.num_devices_per_task[member.task] = 1;
+  }
+  ring_params->instance = col_params_->instance;
+  CollImplDetails& impl = ring_params->instance.impl_details;
+  impl.collective_name = "RingReduce";
+  impl.subdiv_permutations.clear();
+  impl.subdiv_offsets.clear();
+  impl.subdiv_source_rank.clear();
+  ring_params->merge_op = col_params_->merge_op;
+  // The final op is applied once the leader holds the reduction over all
+  // devices, not just over the leaders.
+  ring_params->final_op = nullptr;
+
+  core::RefCountPtr<RingReducer> ring(new RingReducer());
+  // This instance already unblocked the dependencies on this collective.
+  ring->unblock_dependencies_ = false;
+  absl::Status status = ring->InitializeCollectiveParams(ring_params.get());
+  if (status.ok()) {
+    auto ring_ctx = std::make_shared<CollectiveContext>(
+        col_ctx_->col_exec, col_ctx_->nccl_communicator, col_ctx_->dev_mgr,
+        col_ctx_->op_ctx, col_ctx_->op_params, ring_params.get(),
+        col_ctx_->exec_key, col_ctx_->step_id, col_ctx_->output,
+        col_ctx_->output);
+    status = ring->InitializeCollectiveContext(ring_ctx);
+  }
+  if (!status.ok()) {
+    ring->group_size_tensor_ready_.Notify();  // To unblock destructor.
+    return status;
+  }
+  absl::Notification note;
+  ring->Run([&status, &note](const absl::Status& s) {
+    status = s;
+    note.Notify();
+  });
+  note.WaitForNotification();
+  return status;
+}
+
+void HierarchicalRingReducer::DispatchSend(int peer_idx,
+                                           const std::string& buf_key,
+                                           const Tensor* tensor,
+                                           const StatusCallback& done) {
+  const CollGroupMember& peer = col_params_->group.members[peer_idx];
+  VLOG(3) << "DispatchSend " << buf_key << " from_device "
+          << col_ctx_->device_name << " to_device " << peer.device.name();
+  col_ctx_->col_exec->remote_access()->PostToPeer(
+      peer.device.name(), peer.task, buf_key, col_ctx_->device,
+      col_ctx_->op_ctx->op_device_context(),
+      col_ctx_->op_ctx->output_alloc_attr(0), tensor,
+      col_ctx_->device_locality, col_ctx_->op_ctx->cancellation_manager(),
+      done);
+}
+
+void HierarchicalRingReducer::DispatchRecv(int peer_idx,
+                                           const std::string& buf_key,
+                                           Tensor* tensor,
+                                           const StatusCallback& done) {
+  const CollGroupMember& peer = col_params_->group.members[peer_idx];
+  VLOG(3) << "DispatchRecv " << buf_key << " from_device "
+          << peer.device.name() << " to_device " << col_ctx_->device_name;
+  col_ctx_->col_exec->remote_access()->RecvFromPeer(
+      peer.device.name(), peer.task, peer.is_local, buf_key, col_ctx_->device,
+      col_ctx_->op_ctx->op_device_context(),
+      col_ctx_->op_ctx->output_alloc_attr(0), tensor,
+      col_ctx_->device_locality, 0 /*stream_index*/,
+      col_ctx_->op_ctx->cancellation_manager(), done);
+}
+
+void HierarchicalRingReducer::StartAbort(const absl::Status& s) {
+  bool abort_started = false;
+  {
+    mutex_lock l(status_mu_);
+    if (status_.ok()) {
+      LOG(ERROR) << "Aborting HierarchicalRingReduce with " << s;
+      abort_started = true;
+      status_.Update(s);
+    }
+  }
+  // As in RingAlg, pending transfers are already being cancelled if the op
+  // was cancelled; otherwise abort them through the CollectiveExecutor.
+  if (abort_started) {
+    CancellationManager* cancel_mgr = col_ctx_->op_ctx->cancellation_manager();
+    if (cancel_mgr == nullptr ||
+        (!cancel_mgr->IsCancelled() && !cancel_mgr->IsCancelling())) {
+      col_ctx_->col_exec->StartAbort(s);
+    }
+  }
+}
+
+namespace {
+REGISTER_COLLECTIVE(HierarchicalRingReduce, HierarchicalRingReducer);
+}  // namespace
+
+}  // namespace tensorflow
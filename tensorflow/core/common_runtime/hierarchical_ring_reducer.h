@@ -0,0 +1,88 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_HIERARCHICAL_RING_REDUCER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_HIERARCHICAL_RING_REDUCER_H_
+
+#include <memory>
+#include <string>
+
+#include "absl/status/status.h"
+#include "tensorflow/core/common_runtime/base_collective_executor.h"
+#include "tensorflow/core/framework/collective.h"
+#include "tensorflow/core/platform/mutex.h"
+
+namespace tensorflow {
+
+// Two-level implementation of collective all-reduce for CPU devices.  The
+// devices of each task first reduce their values into one leader device per
+// task, through local memory.  The leaders then run a RingReducer among
+// themselves, and finally send the result back to the other devices of their
+// task.  Compared to RingReduce over all devices this divides the traffic
+// between tasks by the number of devices per task.
+//
+// Selected for an instance with communication_hint "hierarchical_ring".
+class HierarchicalRingReducer : public CollectiveImplementationInterface {
+ public:
+  HierarchicalRingReducer();
+  ~HierarchicalRingReducer() override = default;
+
+  // Establishes the two levels of the reduction as subdiv permutations.
+  // Subdiv 0 comprises the leader of each task, in task order.  Subdiv i+1
+  // comprises the devices of task i, starting with its leader.  The leader of
+  // a task is its first device in the group order.
+  absl::Status InitializeCollectiveParams(
+      CollectiveParams* col_params) override;
+
+  // Initializes members of CollectiveContext not yet initialized, i.e. device
+  // and device_locality.  Also saves the CollectiveContext in this object.
+  absl::Status InitializeCollectiveContext(
+      std::shared_ptr<CollectiveContext> col_ctx) override;
+
+  // Begins async execution of the hierarchical reduction.
+  // Must be called in a blockable thread.
+  void Run(StatusCallback done) override;
+
+ private:
+  // Reduces the values of the other devices of the task into the output,
+  // runs the ring among leaders, then sends the result to the other devices.
+  // The local values are reduced in local rank order, so the result does not
+  // depend on the order in which they arrive.
+  absl::Status RunLeader(int task_subdiv);
+
+  // Sends the value of this device to its leader and receives the result.
+  absl::Status RunFollower(int task_subdiv);
+
+  // All-reduces the output among the leaders of all tasks.
+  absl::Status RunLeaderRing();
+
+  // Sends `tensor` to, or receives `tensor` from, the group member at
+  // `peer_idx` under `buf_key`.
+  void DispatchSend(int peer_idx, const std::string& buf_key,
+                    const Tensor* tensor, const StatusCallback& done);
+  void DispatchRecv(int peer_idx, const std::string& buf_key, Tensor* tensor,
+                    const StatusCallback& done);
+
+  // Records the first error and aborts the pending transfers of the
+  // collective executor.
+  void StartAbort(const absl::Status& s);
+
+  std::shared_ptr<CollectiveContext> col_ctx_;
+  const CollectiveParams* col_params_;  // Not owned
+  mutex status_mu_;
+  absl::Status status_ TF_GUARDED_BY(status_mu_);
+};
+
+}  // namespace tensorflow
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_HIERARCHICAL_RING_REDUCER_H_
@@ -0,0 +1,174 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/hierarchical_ring_reducer.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/collective_test_util.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/device_mgr.h"
+#include "tensorflow/core/common_runtime/process_util.h"
+#include "tensorflow/core/framework/collective.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/public/version.h"
+
+namespace tensorflow {
+namespace {
+
+std::unique_ptr<OpKernel> GetBinOp(const std::string& op, DataType dtype,
+                                   Device* device) {
+  NodeDef node_def;
+  TF_CHECK_OK(NodeDefBuilder("bin_op", op)
+                  .Attr("T", dtype)
+                  .Input(FakeInput(dtype))
+                  .Input(FakeInput(dtype))
+                  .Finalize(&node_def));
+  absl::Status status;
+  std::unique_ptr<OpKernel> kernel = CreateOpKernel(
+      DEVICE_CPU, device, device->GetAllocator(AllocatorAttributes()),
+      node_def, TF_GRAPH_DEF_VERSION, &status);
+  TF_CHECK_OK(status);
+  return kernel;
+}
+
+class HierarchicalRingReducerTest : public ::testing::Test {
+ protected:
+  // Computes the mean of the values of all devices, where the value of the
+  // device at `rank` is 10 * rank + i at index i.
+  void RunTest(int num_workers, int num_devices, int tensor_len,
+               int fail_after) {
+    test_env_ = CreateCollectiveTestEnv(num_workers, num_devices, DEVICE_CPU);
+    test_env_->remote_access->set_fail_after(fail_after);
+    const int group_size = num_workers * num_devices;
+    std::vector<float> expected(tensor_len, 0.0f);
+    for (int rank = 0; rank < group_size; ++rank) {
+      instances_.push_back(std::make_unique<DeviceInstance>(
+          rank, TensorShape({tensor_len}), test_env_.get()));
+      test::FillFn<float>(&instances_[rank]->tensor_, [rank](int i) {
+        return static_cast<float>(10 * rank + i);
+      });
+      for (int i = 0; i < tensor_len; ++i) expected[i] += 10 * rank + i;
+    }
+    for (float& value : expected) value /= group_size;
+
+    BlockingCounter counter(group_size);
+    for (auto& instance : instances_) {
+      SchedClosure([&instance, &counter] {
+        instance->DoReduce();
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+
+    for (auto& instance : instances_) {
+      if (fail_after > 0) {
+        EXPECT_NE(instance->status_.message().find("Deliberate failure"),
+                  std::string::npos)
+            << instance->status_;
+      } else {
+        TF_EXPECT_OK(instance->status_);
+        test::ExpectTensorEqual<float>(test::AsTensor<float>(expected),
+                                       instance->tensor_);
+      }
+    }
+  }
+
+  struct DeviceInstance {
+    DeviceInstance(int rank, const TensorShape& shape,
+                   CollectiveTestEnv* test_env)
+        : test_env(test_env), tensor_(DT_FLOAT, shape) {
+      col_params =
+          CreateCollectiveParams(*test_env, rank, "HierarchicalRingReduce",
+                                 REDUCTION_COLLECTIVE, DT_FLOAT, shape);
+      TF_CHECK_OK(test_env->device_mgr->LookupDevice(
+          col_params->group.members[rank].device.name(), &device));
+      merge_op = GetBinOp("Add", DT_FLOAT, device);
+      final_op = GetBinOp("Div", DT_FLOAT, device);
+      col_params->merge_op = merge_op.get();
+      col_params->final_op = final_op.get();
+    }
+
+    void DoReduce() {
+      status_ = RunCollective(test_env, col_params.get(), device, &tensor_,
+                              &tensor_);
+    }
+
+    CollectiveTestEnv* test_env;
+    Tensor tensor_;
+    Device* device;
+    core::RefCountPtr<CollectiveParams> col_params;
+    std::unique_ptr<OpKernel> merge_op;
+    std::unique_ptr<OpKernel> final_op;
+    absl::Status status_;
+  };
+
+  std::unique_ptr<CollectiveTestEnv> test_env_;
+  std::vector<std::unique_ptr<DeviceInstance>> instances_;
+};
+
+TEST_F(HierarchicalRingReducerTest, InitializeParams) {
+  auto test_env = CreateCollectiveTestEnv(/*num_workers=*/3,
+                                          /*num_devices_per_worker=*/2,
+                                          DEVICE_CPU);
+  auto cp = CreateCollectiveParams(*test_env, /*rank=*/3,
+                                   "HierarchicalRingReduce",
+                                   REDUCTION_COLLECTIVE, DT_FLOAT,
+                                   TensorShape({8}));
+  core::RefCountPtr<HierarchicalRingReducer> reducer(
+      new HierarchicalRingReducer());
+  TF_ASSERT_OK(reducer->InitializeCollectiveParams(cp.get()));
+  std::vector<std::vector<int>> expected_perms = {
+      {0, 2, 4}, {0, 1}, {2, 3}, {4, 5}};
+  EXPECT_EQ(cp->instance.impl_details.subdiv_permutations, expected_perms);
+  EXPECT_EQ(cp->subdiv_rank, std::vector<int>({-1, -1, 1, -1}));
+
+  cp->default_rank = 2;
+  TF_ASSERT_OK(reducer->InitializeCollectiveParams(cp.get()));
+  EXPECT_EQ(cp->instance.impl_details.subdiv_permutations, expected_perms);
+  EXPECT_EQ(cp->subdiv_rank, std::vector<int>({1, -1, 0, -1}));
+}
+
+TEST_F(HierarchicalRingReducerTest, SingleTask) { RunTest(1, 4, 1001, 0); }
+
+TEST_F(HierarchicalRingReducerTest, OneDevicePerTask) {
+  RunTest(3, 1, 1001, 0);
+}
+
+TEST_F(HierarchicalRingReducerTest, MultipleDevicesPerTask) {
+  RunTest(2, 3, 1001, 0);
+}
+
+TEST_F(HierarchicalRingReducerTest, FewerElementsThanTasks) {
+  RunTest(3, 2, 2, 0);
+}
+
+TEST_F(HierarchicalRingReducerTest, LargeTensor) {
+  RunTest(3, 4, 1045991, 0);
+}
+
+TEST_F(HierarchicalRingReducerTest, Abort) { RunTest(2, 3, 1001, 5); }
+
+}  // namespace
+}  // namespace tensorflow
@@ -15,10 +15,19 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/immutable_executor_state.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "absl/base/call_once.h"
 #include "absl/memory/memory.h"
+#include "tensorflow/core/common_runtime/step_arena_allocator.h"
+#include "tensorflow/core/common_runtime/step_memory_plan.h"
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/graph/edgeset.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/graph/graph_node_util.h"
@@ -31,6 +40,69 @@ namespace {
 bool IsInitializationOp(const Node* node) {
   return node->op_def().allows_uninitialized_input();
 }
+
+// Returns true if a tensor consumed by `node` may be kept beyond the step.
+bool ConsumerMayRetain(const Node* node) {
+  return IsSink(node) || node->IsRetval() || node->IsFunctionCall() ||
+         IsTransferNode(node) || node->op_def().is_stateful();
+}
+
+// Marks the outputs of each node in `gview` that are not expected to outlive
+// the step. An output escapes if it is produced by a stateful op, has a type
+// that cannot live in the step arena, or is consumed by a node that may
+// retain it. Because kernels may forward an input buffer to an output of the
+// same type, the inputs of an escaping output escape as well.
+void ComputeStepLocalOutputs(const Graph& graph, GraphView* gview) {
+  std::vector<std::vector<bool>> escapes(graph.num_node_ids());
+  std::vector<std::pair<const Node*, int>> worklist;
+  auto mark_escaping = [&escapes, &worklist](const Node* n, int output) {
+    if (!escapes[n->id()][output]) {
+      escapes[n->id()][output] = true;
+      worklist.emplace_back(n, output);
+    }
+  };
+  for (const Node* n : graph.nodes()) {
+    escapes[n->id()].resize(n->num_outputs(), false);
+  }
+  for (const Node* n : graph.nodes()) {
+    if (IsSink(n)) continue;
+    const bool is_stateful = n->op_def().is_stateful();
+    for (int i = 0; i < n->num_outputs(); ++i) {
+      const DataType dtype = n->output_type(i);
+      if (is_stateful || IsRefType(dtype) || !DataTypeCanUseMemcpy(dtype)) {
+        mark_escaping(n, i);
+      }
+    }
+    for (const Edge* e : n->out_edges()) {
+      if (e->IsControlEdge()) continue;
+      if (ConsumerMayRetain(e->dst())) mark_escaping(n, e->src_output());
+    }
+  }
+  while (!worklist.empty()) {
+    auto [n, output] = worklist.back();
+    worklist.pop_back();
+    const DataType dtype = BaseType(n->output_type(output));
+    for (const Edge* e : n->in_edges()) {
+      if (e->IsControlEdge()) continue;
+      if (BaseType(e->src()->output_type(e->src_output())) == dtype) {
+        mark_escaping(e->src(), e->src_output());
+      }
+    }
+  }
+  for (const Node* n : graph.nodes()) {
+    if (IsSink(n)) continue;
+    const std::vector<bool>& node_escapes = escapes[n->id()];
+    if (std::find(node_escapes.begin(), node_escapes.end(), false) ==
+        node_escapes.end()) {
+      continue;
+    }
+    NodeItem* item = gview->node(n->id());
+    item->outputs_step_local.reset(new bool[n->num_outputs()]);
+    for (int i = 0; i < n->num_outputs(); ++i) {
+      item->outputs_step_local[i] = !node_escapes[i];
+    }
+  }
+}
 }  // namespace
 
 ImmutableExecutorState::~ImmutableExecutorState() {
@@ -81,6 +153,48 @@ ImmutableExecutorState::FrameInfo* ImmutableExecutorState::EnsureFrameInfo(
   }
 }
 
+bool ImmutableExecutorState::CanCreateKernelLazily(const Node* n) const {
+  // Constants must expose their tensor up front, control flow nodes are
+  // handled by the propagator, and stateful kernels may own resources that
+  // other executors look up by name.
+  if (!n->IsOp() || n->IsConstant() || n->IsControlFlow() ||
+      n->IsFunctionCall() || n->op_def().is_stateful()) {
+    return false;
+  }
+  // Function kernels instantiate their function in their constructor.
+  if (params_.function_library != nullptr &&
+      params_.function_library->GetFunctionLibraryDefinition()->Find(
+          n->type_string()) != nullptr) {
+    return false;
+  }
+  for (const auto& attr : n->attrs()) {
+    if (attr.second.has_func() || attr.second.list().func_size() > 0) {
+      return false;
+    }
+  }
+  // Only defer kernels that are known to exist, so that a missing kernel is
+  // still reported when the executor is created.
+  return FindKernelDef(DeviceType(params_.device->device_type()), n->def(),
+                       /*def=*/nullptr, /*kernel_class_name=*/nullptr)
+      .ok();
+}
+
+absl::Status ImmutableExecutorState::EnsureKernel(const NodeItem& item) const {
+  LazyKernel* lazy_kernel = lazy_kernels_[item.node_id].get();
+  DCHECK(lazy_kernel != nullptr);
+  absl::call_once(lazy_kernel->once, [this, &item, lazy_kernel]() {
+    OpKernel* kernel = nullptr;
+    absl::Status s = params_.create_kernel(lazy_kernel->props, &kernel);
+    if (!s.ok()) {
+      params_.delete_kernel(kernel);
+      lazy_kernel->status = AttachDef(s, lazy_kernel->props->node_def);
+      return;
+    }
+    gview_.node(item.node_id)->kernel = kernel;
+  });
+  return lazy_kernel->status;
+}
+
 absl::Status ImmutableExecutorState::Initialize(const Graph& graph) {
   TF_RETURN_IF_ERROR(gview_.Initialize(&graph));
 
@@ -98,6 +212,7 @@ absl::Status ImmutableExecutorState::Initialize(const Graph& graph) {
 
   // Preprocess every node in the graph to create an instance of op
   // kernel for each node.
+  const bool lazy_kernels = params_.lazy_kernel_creation;
   requires_control_flow_ = false;
   for (const Node* n : graph.nodes()) {
     if (IsSink(n)) continue;
@@ -129,15 +244,23 @@ absl::Status ImmutableExecutorState::Initialize(const Graph& graph) {
     item->input_start = frame_info->total_inputs;
     frame_info->total_inputs += n->num_inputs();
 
-    absl::Status s = params_.create_kernel(n->properties(), &item->kernel);
-    if (!s.ok()) {
-      params_.delete_kernel(item->kernel);
-      item->kernel = nullptr;
-      s = AttachDef(s, *n);
-      return s;
+    if (lazy_kernels && CanCreateKernelLazily(n)) {
+      if (lazy_kernels_.empty()) lazy_kernels_.resize(gview_.num_nodes());
+      lazy_kernels_[id] = std::make_unique<LazyKernel>();
+      lazy_kernels_[id]->props = n->properties();
+      item->kernel_is_lazy = true;
+      item->kernel_is_async = false;
+    } else {
+      absl::Status s = params_.create_kernel(n->properties(), &item->kernel);
+      if (!s.ok()) {
+        params_.delete_kernel(item->kernel);
+        item->kernel = nullptr;
+        s = AttachDef(s, *n);
+        return s;
+      }
+      CHECK(item->kernel);
+      item->kernel_is_async = (item->kernel->AsAsync() != nullptr);
     }
-    CHECK(item->kernel);
-    item->kernel_is_async = (item->kernel->AsAsync() != nullptr);
     item->is_merge = IsMerge(n);
     item->is_any_consumer_merge_or_control_trigger = false;
     for (const Node* consumer : n->out_nodes()) {
@@ -146,7 +269,8 @@ absl::Status ImmutableExecutorState::Initialize(const Graph& graph) {
         break;
       }
     }
-    const Tensor* const_tensor = item->kernel->const_tensor();
+    const Tensor* const_tensor =
+        item->kernel_is_lazy ? nullptr : item->kernel->const_tensor();
     if (const_tensor) {
       // Hold onto a shallow copy of the constant tensor in `*this` so that the
       // reference count does not drop to 1. This prevents the constant tensor
@@ -154,7 +278,7 @@ absl::Status ImmutableExecutorState::Initialize(const Graph& graph) {
       const_tensors_.emplace_back(*const_tensor);
     }
     item->const_tensor = const_tensor;
-    item->is_noop = (item->kernel->type_string_view() == "NoOp");
+    item->is_noop = (n->type_string() == "NoOp");
     item->is_enter = IsEnter(n);
     if (item->is_enter) {
       bool is_constant_enter;
@@ -256,6 +380,11 @@ absl::Status ImmutableExecutorState::Initialize(const Graph& graph) {
     }
   }
 
+  if ((StepArenaEnabled() || StaticMemoryPlanEnabled()) &&
+      params_.device->device_type() == DEVICE_CPU) {
+    ComputeStepLocalOutputs(graph, &gview_);
+  }
+
   // Initialize PendingCounts only after pending_ids_[node.id] is initialized
   // for all nodes.
   InitializePending(&graph, cf_info);
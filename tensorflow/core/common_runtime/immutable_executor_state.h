@@ -20,10 +20,14 @@ limitations under the License.
 #include <memory>
 #include <vector>
 
+#include "absl/base/call_once.h"
 #include "absl/container/flat_hash_map.h"
 #include "tensorflow/core/common_runtime/graph_view.h"
 #include "tensorflow/core/common_runtime/local_executor_params.h"
 #include "tensorflow/core/common_runtime/pending_counts.h"
+#include "tensorflow/core/framework/node_def.pb.h"
+#include "tensorflow/core/framework/node_properties.h"
+#include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/gtl/flatmap.h"
@@ -101,6 +105,22 @@ class ImmutableExecutorState {
 
   bool requires_control_flow_support() const { return requires_control_flow_; }
 
+  // Creates the kernel of `item` if it is lazy and not created yet. Safe to
+  // call concurrently; the kernel is created at most once, and a failure is
+  // returned by every call.
+  //
+  // REQUIRES: `item.kernel_is_lazy`.
+  absl::Status EnsureKernel(const NodeItem& item) const;
+
+  // Returns the NodeDef of `item`, which is valid even if its kernel has not
+  // been created.
+  const NodeDef& node_def(const NodeItem& item) const {
+    if (TF_PREDICT_FALSE(item.kernel_is_lazy)) {
+      return lazy_kernels_[item.node_id]->props->node_def;
+    }
+    return item.kernel->def();
+  }
+
   // Copies the pending counts for nodes in this graph to the given array.
   //
   // This method provides a more efficient way of initializing
@@ -128,6 +148,15 @@ class ImmutableExecutorState {
 
   FrameInfo* EnsureFrameInfo(const std::string& fname);
 
+  // Returns true if the kernel of `n` may be created when it first runs.
+  bool CanCreateKernelLazily(const Node* n) const;
+
+  struct LazyKernel {
+    std::shared_ptr<const NodeProperties> props;
+    absl::once_flag once;
+    absl::Status status;
+  };
+
   // Owned.
   LocalExecutorParams params_;
   GraphView gview_;
@@ -155,6 +184,9 @@ class ImmutableExecutorState {
   // Shallow copies of the constant tensors used in the graph.
   std::vector<Tensor> const_tensors_;
 
+  // Indexed by node ID. Non-null for the nodes whose kernel is lazy.
+  std::vector<std::unique_ptr<LazyKernel>> lazy_kernels_;
+
   ImmutableExecutorState(const ImmutableExecutorState&) = delete;
   void operator=(const ImmutableExecutorState&) = delete;
 };
@@ -50,6 +50,12 @@ struct LocalExecutorParams {
 
   // Whether control flow nodes are allowed to be executed synchronously.
   bool allow_control_flow_sync_execution = false;
+
+  // Whether the executor may defer creating the kernels of stateless nodes
+  // until they first run. Only supported by the default executor. When set,
+  // create_kernel may be called concurrently from the threads that run the
+  // graph.
+  bool lazy_kernel_creation = false;
 };
 
 }  // end namespace tensorflow
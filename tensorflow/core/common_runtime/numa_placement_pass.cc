@@ -0,0 +1,206 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/numa_placement_pass.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/common_runtime/device_set.h"
+#include "tensorflow/core/common_runtime/optimization_registry.h"
+#include "tensorflow/core/framework/device.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/public/session_options.h"
+#include "tensorflow/core/util/device_name_utils.h"
+#include "tensorflow/core/util/dump_graph.h"
+
+namespace tensorflow {
+namespace {
+
+// Union-find over node ids.
+class Components {
+ public:
+  explicit Components(int num_ids) : parent_(num_ids) {
+    for (int i = 0; i < num_ids; ++i) parent_[i] = i;
+  }
+
+  int Find(int id) {
+    while (parent_[id] != id) {
+      parent_[id] = parent_[parent_[id]];
+      id = parent_[id];
+    }
+    return id;
+  }
+
+  void Union(int a, int b) { parent_[Find(a)] = Find(b); }
+
+ private:
+  std::vector<int> parent_;
+};
+
+// Returns true if `node` is ignored when building components.
+bool IsIgnored(const Node* node) {
+  return !node->IsOp() || node->IsArg() || node->IsRetval();
+}
+
+// Returns true if `node` consumes a resource or reference argument. Such
+// arguments live on the device of their resource, so their consumers stay
+// with it.
+bool ConsumesResourceArg(const Node* node) {
+  for (const Edge* edge : node->in_edges()) {
+    if (edge->IsControlEdge() || !edge->src()->IsArg()) continue;
+    const DataType dtype = edge->src()->output_type(edge->src_output());
+    if (dtype == DT_RESOURCE || IsRefType(dtype)) return true;
+  }
+  return false;
+}
+
+// Returns true if the component of `node` must be left to the placer.
+bool IsFixed(const Node* node) {
+  return !node->requested_device().empty() ||
+         node->has_assigned_device_name() || node->op_def().is_stateful() ||
+         ConsumesResourceArg(node);
+}
+
+// Returns the CPU devices to spread over, or an empty vector if the pass
+// should not run.
+std::vector<Device*> GetNumaDevices(
+    const GraphOptimizationPassOptions& options) {
+  if (options.graph == nullptr || options.device_set == nullptr ||
+      options.session_options == nullptr ||
+      !options.session_options->config.experimental().use_numa_affinity()) {
+    return {};
+  }
+  const std::vector<Device*>& all_devices = options.device_set->devices();
+  if (all_devices.empty()) return {};
+  // Only spread over the devices of the client's process, with the client
+  // device first, since the placer prefers it.
+  Device* client = options.device_set->client_device() != nullptr
+                       ? options.device_set->client_device()
+                       : all_devices[0];
+  std::vector<Device*> devices = {client};
+  for (Device* device : all_devices) {
+    if (device->device_type() != DEVICE_CPU) return {};
+    if (device != client &&
+        DeviceNameUtils::IsSameAddressSpace(client->name(), device->name())) {
+      devices.push_back(device);
+    }
+  }
+  if (devices.size() < 2) return {};
+  return devices;
+}
+
+}  // namespace
+
+absl::Status NumaPlacementPass::Run(
+    const GraphOptimizationPassOptions& options) {
+  const std::vector<Device*> devices = GetNumaDevices(options);
+  if (devices.empty()) return absl::OkStatus();
+  Graph* graph = options.graph->get();
+  if (VLOG_IS_ON(1)) {
+    VLOG(1) << DumpGraphToFile("before_numa_placement_pass", *graph,
+                               options.flib_def);
+  }
+
+  Components components(graph->num_node_ids());
+  absl::flat_hash_map<absl::string_view, int> colocation_groups;
+  for (const Node* node : graph->op_nodes()) {
+    if (IsIgnored(node)) continue;
+    for (const Edge* edge : node->in_edges()) {
+      if (!IsIgnored(edge->src())) {
+        components.Union(edge->src()->id(), node->id());
+      }
+    }
+    const AttrValue* groups = node->attrs().Find(kColocationAttrName);
+    if (groups == nullptr) continue;
+    for (const std::string& group : groups->list().s()) {
+      absl::string_view name = group;
+      if (!absl::ConsumePrefix(&name, kColocationGroupPrefix)) continue;
+      auto inserted = colocation_groups.emplace(name, node->id());
+      if (!inserted.second) {
+        components.Union(inserted.first->second, node->id());
+      }
+    }
+  }
+  // Colocation groups are named after one of their nodes.
+  for (const Node* node : graph->op_nodes()) {
+    auto it = colocation_groups.find(node->name());
+    if (it != colocation_groups.end() && !IsIgnored(node)) {
+      components.Union(it->second, node->id());
+    }
+  }
+
+  struct Component {
+    int64_t size = 0;
+    bool fixed = false;
+    std::vector<Node*> nodes;
+  };
+  absl::flat_hash_map<int, Component> by_root;
+  for (Node* node : graph->op_nodes()) {
+    if (IsIgnored(node)) continue;
+    Component& component = by_root[components.Find(node->id())];
+    ++component.size;
+    component.fixed |= IsFixed(node);
+    component.nodes.push_back(node);
+  }
+
+  // The placer puts the fixed components on the first device by default.
+  std::vector<int64_t> load(devices.size(), 0);
+  std::vector<Component*> movable;
+  for (auto& entry : by_root) {
+    if (entry.second.fixed) {
+      load[0] += entry.second.size;
+    } else {
+      movable.push_back(&entry.second);
+    }
+  }
+  // Sorting by the id of the first node keeps the placement deterministic.
+  std::sort(movable.begin(), movable.end(),
+            [](const Component* a, const Component* b) {
+              if (a->size != b->size) return a->size > b->size;
+              return a->nodes[0]->id() < b->nodes[0]->id();
+            });
+  for (Component* component : movable) {
+    const int device = std::distance(
+        load.begin(), std::min_element(load.begin(), load.end()));
+    load[device] += component->size;
+    for (Node* node : component->nodes) {
+      node->set_requested_device(devices[device]->name());
+    }
+  }
+  VLOG(1) << "numa_placement_pass spread " << movable.size()
+          << " components over " << devices.size() << " CPU devices.";
+
+  if (VLOG_IS_ON(1)) {
+    VLOG(1) << DumpGraphToFile("after_numa_placement_pass", *graph,
+                               options.flib_def);
+  }
+  return absl::OkStatus();
+}
+
+REGISTER_OPTIMIZATION(OptimizationPassRegistry::PRE_PLACEMENT, 60,
+                      NumaPlacementPass);
+
+}  // namespace tensorflow
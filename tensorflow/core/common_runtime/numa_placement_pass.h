@@ -0,0 +1,50 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_NUMA_PLACEMENT_PASS_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_NUMA_PLACEMENT_PASS_H_
+
+#include "absl/status/status.h"
+#include "tensorflow/core/common_runtime/optimization_registry.h"
+
+// Spreads independent subgraphs over the CPU devices of a NUMA host.
+//
+// With `ConfigProto.experimental.use_numa_affinity`, there is one CPU device
+// per NUMA node, each with its own pinned intra-op thread pool and a
+// NUMA-local allocator. The placer would put every unconstrained op on the
+// first of them, so this pass requests a device for the ops of each weakly
+// connected component of the graph, assigning the largest components first
+// to the least loaded device.
+//
+// _Arg and _Retval nodes do not join components, since feeding and fetching
+// on another CPU device of the same process does not copy. A component is
+// left to the placer, and counted as load of the first device, if one of its
+// nodes already requests a device or is stateful, since stateful ops may
+// share state with other components by name. Nodes with the same colocation
+// group belong to the same component.
+//
+// The pass only runs if all devices are CPU devices, and only spreads over
+// the devices in the process of the client device.
+
+namespace tensorflow {
+
+class NumaPlacementPass : public GraphOptimizationPass {
+ public:
+  absl::Status Run(const GraphOptimizationPassOptions& options) override;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_NUMA_PLACEMENT_PASS_H_
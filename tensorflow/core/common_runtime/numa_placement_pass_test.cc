@@ -0,0 +1,150 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/numa_placement_pass.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/cc/framework/ops.h"
+#include "tensorflow/cc/framework/scope.h"
+#include "tensorflow/cc/ops/array_ops.h"
+#include "tensorflow/cc/ops/function_ops.h"
+#include "tensorflow/cc/ops/math_ops.h"
+#include "tensorflow/cc/ops/random_ops.h"
+#include "tensorflow/core/common_runtime/device_factory.h"
+#include "tensorflow/core/common_runtime/device_set.h"
+#include "tensorflow/core/common_runtime/optimization_registry.h"
+#include "tensorflow/core/framework/device.h"
+#include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/public/session_options.h"
+
+namespace tensorflow {
+namespace {
+
+class NumaPlacementPassTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    session_options_.config.mutable_device_count()->insert({"CPU", 2});
+    TF_ASSERT_OK(DeviceFactory::GetFactory(DEVICE_CPU)->CreateDevices(
+        session_options_, "/job:localhost/replica:0/task:0", &devices_));
+    ASSERT_EQ(devices_.size(), 2);
+    for (const auto& device : devices_) {
+      device_set_.AddDevice(device.get());
+    }
+    device_set_.set_client_device(devices_[0].get());
+  }
+
+  // Builds the graph from `scope` and runs the pass.
+  void RunPass(const Scope& scope, bool use_numa_affinity = true) {
+    session_options_.config.mutable_experimental()->set_use_numa_affinity(
+        use_numa_affinity);
+    graph_ = std::make_unique<Graph>(OpRegistry::Global());
+    TF_ASSERT_OK(scope.ToGraph(graph_.get()));
+    GraphOptimizationPassOptions options;
+    options.graph = &graph_;
+    options.device_set = &device_set_;
+    options.session_options = &session_options_;
+    NumaPlacementPass pass;
+    TF_ASSERT_OK(pass.Run(options));
+  }
+
+  std::string RequestedDevice(const std::string& name) {
+    for (const Node* node : graph_->op_nodes()) {
+      if (node->name() == name) return node->requested_device();
+    }
+    return "<missing>";
+  }
+
+  std::string DeviceName(int i) { return devices_[i]->name(); }
+
+  SessionOptions session_options_;
+  std::vector<std::unique_ptr<Device>> devices_;
+  DeviceSet device_set_;
+  std::unique_ptr<Graph> graph_;
+};
+
+TEST_F(NumaPlacementPassTest, SpreadsIndependentSubgraphs) {
+  Scope scope = Scope::NewRootScope().ExitOnError();
+  auto a = ops::Const(scope.WithOpName("a"), 1.0f, {2, 2});
+  auto a_out = ops::MatMul(scope.WithOpName("a_matmul"), a, a);
+  ops::Neg(scope.WithOpName("a_neg"), a_out);
+  auto b = ops::Const(scope.WithOpName("b"), 1.0f, {2, 2});
+  ops::MatMul(scope.WithOpName("b_matmul"), b, b);
+  RunPass(scope);
+
+  // The larger component goes first, to the first device.
+  EXPECT_EQ(RequestedDevice("a"), DeviceName(0));
+  EXPECT_EQ(RequestedDevice("a_matmul"), DeviceName(0));
+  EXPECT_EQ(RequestedDevice("a_neg"), DeviceName(0));
+  EXPECT_EQ(RequestedDevice("b"), DeviceName(1));
+  EXPECT_EQ(RequestedDevice("b_matmul"), DeviceName(1));
+}
+
+TEST_F(NumaPlacementPassTest, LeavesStatefulAndPlacedSubgraphs) {
+  Scope scope = Scope::NewRootScope().ExitOnError();
+  auto shape = ops::Const(scope.WithOpName("shape"), {2, 2});
+  auto random = ops::RandomUniform(scope.WithOpName("random"), shape,
+                                   DT_FLOAT);
+  ops::Neg(scope.WithOpName("random_neg"), random);
+  auto c = ops::Const(scope.WithOpName("c").WithDevice(DeviceName(1)), 1.0f);
+  ops::Neg(scope.WithOpName("c_neg"), c);
+  auto d = ops::Const(scope.WithOpName("d"), 1.0f);
+  ops::Neg(scope.WithOpName("d_neg"), d);
+  RunPass(scope);
+
+  EXPECT_EQ(RequestedDevice("random"), "");
+  EXPECT_EQ(RequestedDevice("random_neg"), "");
+  EXPECT_EQ(RequestedDevice("c_neg"), "");
+  // The fixed subgraphs count as load of the first device.
+  EXPECT_EQ(RequestedDevice("d"), DeviceName(1));
+  EXPECT_EQ(RequestedDevice("d_neg"), DeviceName(1));
+}
+
+TEST_F(NumaPlacementPassTest, LeavesConsumersOfResourceArgs) {
+  Scope scope = Scope::NewRootScope().ExitOnError();
+  auto resource = ops::_Arg(scope.WithOpName("resource"), DT_RESOURCE, 0);
+  ops::Identity(scope.WithOpName("resource_identity"), resource);
+  auto value = ops::_Arg(scope.WithOpName("value"), DT_FLOAT, 1);
+  ops::Neg(scope.WithOpName("value_neg"), value);
+  auto d = ops::Const(scope.WithOpName("d"), 1.0f);
+  ops::Neg(scope.WithOpName("d_neg"), d);
+  RunPass(scope);
+
+  EXPECT_EQ(RequestedDevice("resource_identity"), "");
+  // Other arguments do not fix their consumers.
+  EXPECT_NE(RequestedDevice("value_neg"), "");
+  EXPECT_NE(RequestedDevice("d_neg"), "");
+}
+
+TEST_F(NumaPlacementPassTest, DisabledWithoutNumaAffinity) {
+  Scope scope = Scope::NewRootScope().ExitOnError();
+  auto a = ops::Const(scope.WithOpName("a"), 1.0f);
+  ops::Neg(scope.WithOpName("a_neg"), a);
+  auto b = ops::Const(scope.WithOpName("b"), 1.0f);
+  ops::Neg(scope.WithOpName("b_neg"), b);
+  RunPass(scope, /*use_numa_affinity=*/false);
+
+  for (const Node* node : graph_->op_nodes()) {
+    EXPECT_EQ(node->requested_device(), "") << node->name();
+  }
+}
+
+}  // namespace
+}  // namespace tensorflow
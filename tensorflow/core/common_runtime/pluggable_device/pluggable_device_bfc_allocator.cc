@@ -21,6 +21,7 @@ limitations under the License.
 
 #include "absl/log/log.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/numbers.h"
 #include "xla/tsl/framework/bfc_allocator.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/protobuf/config.pb.h"
@@ -94,6 +95,25 @@ bool PluggableDeviceBFCAllocator::GetGarbageCollectionValue() {
   return true;
 }
 
+size_t PluggableDeviceBFCAllocator::GetThreadCacheBytesValue() {
+  const char* thread_cache_bytes =
+      std::getenv("TF_PLUGGABLE_DEVICE_BFC_THREAD_CACHE_BYTES");
+  if (thread_cache_bytes == nullptr) {
+    // By default, there is no per-thread cache.
+    return 0;
+  }
+  size_t value = 0;
+  if (absl::SimpleAtoi(thread_cache_bytes, &value)) {
+    return value;
+  }
+
+  LOG(ERROR)
+      << "The TF_PLUGGABLE_DEVICE_BFC_THREAD_CACHE_BYTES environment variable"
+      << " is set but could not be parsed: \"" << thread_cache_bytes << "\"."
+      << " Disabling the per-thread cache.";
+  return 0;
+}
+
 PluggableDeviceBFCAllocator::PluggableDeviceBFCAllocator(
     tsl::SubAllocator* sub_allocator, size_t total_memory,
     const std::string& name, bool force_memory_growth_requested)
@@ -110,6 +130,8 @@ PluggableDeviceBFCAllocator::PluggableDeviceBFCAllocator(
             gpu_options, force_memory_growth_requested);
         o.garbage_collection =
             PluggableDeviceBFCAllocator::GetGarbageCollectionValue();
+        o.thread_cache_bytes =
+            PluggableDeviceBFCAllocator::GetThreadCacheBytesValue();
         return o;
       }()) {}
 
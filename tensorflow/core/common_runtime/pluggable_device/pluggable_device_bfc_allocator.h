@@ -46,6 +46,7 @@ class PluggableDeviceBFCAllocator : public BFCAllocator {
   static bool GetAllowGrowthValue(const GPUOptions& gpu_options,
                                   bool force_memory_growth_requested);
   static bool GetGarbageCollectionValue();
+  static size_t GetThreadCacheBytesValue();
 };
 
 }  // namespace tensorflow
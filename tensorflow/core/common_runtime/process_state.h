@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_COMMON_RUNTIME_PROCESS_STATE_H_
 #define TENSORFLOW_CORE_COMMON_RUNTIME_PROCESS_STATE_H_
 
+#include <atomic>
 #include <functional>
 #include <map>
 #include <unordered_map>
@@ -57,7 +58,14 @@ class ProcessState : public ProcessStateInterface {
 
   // If NUMA Allocators are desired, call this before calling any
   // Allocator accessor.
-  void EnableNUMA() { numa_enabled_ = true; }
+  //
+  // This is a process-wide switch that cannot be turned off: once any
+  // session enables it, e.g. by creating CPU devices with
+  // `ConfigProto.experimental.use_numa_affinity`, the CPU allocators of all
+  // sessions in the process are NUMA allocators. Safe to call concurrently
+  // with the allocator accessors, but allocators created before the call
+  // are not NUMA allocators.
+  void EnableNUMA() { numa_enabled_.store(true, std::memory_order_relaxed); }
 
   // Returns what we know about the memory at ptr.
   // If we know nothing, it's called CPU 0 with no other attributes.
@@ -93,7 +101,7 @@ class ProcessState : public ProcessStateInterface {
   void TestOnlyReset();
 
   static ProcessState* instance_;
-  bool numa_enabled_;
+  std::atomic<bool> numa_enabled_;
 
   mutex mu_;
 
@@ -80,7 +80,8 @@ void PropagatorState::PropagateOutputs(const TaggedNode& tagged_node,
       [&]() {
         return strings::StrCat(
             "ExecutorPropagateOutputs#", "id=", step_id_,
-            ",kernel_name=", tagged_node.node_item->kernel->name_view(),
+            ",kernel_name=",
+            immutable_state_.node_def(*tagged_node.node_item).name(),
             ",num_output_edges=", tagged_node.node_item->num_output_edges,
             ",num_output_control_edges=",
             tagged_node.node_item->num_output_control_edges,
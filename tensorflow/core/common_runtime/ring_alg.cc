@@ -16,9 +16,11 @@ limitations under the License.
 
 #include <stdlib.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -46,6 +48,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 
 // Set true for greater intelligibility of debug mode log messages.
 #define READABLE_KEYS false
@@ -60,6 +63,9 @@ constexpr size_t kMaxChunkSizeBytes = (4 * 1024 * 1024);
 // through the collectives API. A reasonable value would be a small
 // multiple of the number of NICs adjacent to each device.
 constexpr int kMaxSubdivsPerDeviceDefault = 2;
+// Upper bound on the number of pipeline stages added per subdivision by
+// TF_COLLECTIVE_RING_PIPELINE_CHUNK_BYTES.
+constexpr int kMaxPipelineDepth = 16;
 
 namespace tensorflow {
 namespace {
@@ -114,6 +120,42 @@ RingAlg::RingAlg(CollectiveType type, const std::string& name)
       num_subdivs_(-1) {}
 
 namespace {
+// Returns the number of times each subdivision is repeated along the same
+// ring so that the chunks of a CPU reduction are streamed as a pipeline of
+// sub-chunks of at most TF_COLLECTIVE_RING_PIPELINE_CHUNK_BYTES.  While one
+// sub-chunk is being reduced the next one is in flight.
+//
+// The chunking must be identical on every member of the group, since each
+// device derives it independently, so the sub-chunk size is a fixed setting
+// rather than tuned from the bandwidth each device observes.  It must be set
+// to the same value in every task.
+int PipelineDepth(const CollectiveParams& col_params, int num_subdivs,
+                  size_t chunk_size) {
+  if (col_params.instance.type != REDUCTION_COLLECTIVE ||
+      col_params.group.device_type != DEVICE_CPU) {
+    return 1;
+  }
+  int64_t sub_chunk_bytes;
+  absl::Status status = ReadInt64FromEnvVar(
+      "TF_COLLECTIVE_RING_PIPELINE_CHUNK_BYTES", 0, &sub_chunk_bytes);
+  if (!status.ok()) {
+    LOG(ERROR) << "RingAlg: " << status.message();
+    return 1;
+  }
+  const int64_t chunk_bytes = static_cast<int64_t>(chunk_size);
+  if (sub_chunk_bytes <= 0 || chunk_bytes <= sub_chunk_bytes) return 1;
+  int depth = std::min<int64_t>(
+      kMaxPipelineDepth, (chunk_bytes + sub_chunk_bytes - 1) / sub_chunk_bytes);
+  // RingField indices are 16 bit.
+  const int64_t max_fields = std::numeric_limits<int16_t>::max();
+  while (depth > 1 && static_cast<int64_t>(col_params.group.group_size) *
+                              num_subdivs * depth >
+                          max_fields) {
+    --depth;
+  }
+  return depth;
+}
+
 absl::Status GenerateSubdivsInCollectiveParams(CollectiveParams* col_params) {
   // This function generates subdivision_offsets. Expect it to be empty when
   // called.
@@ -169,6 +211,16 @@ absl::Status GenerateSubdivsInCollectiveParams(CollectiveParams* col_params) {
     if (sdi % 2 == 1) subdiv_offset *= -1;
     col_params->instance.impl_details.subdiv_offsets.push_back(subdiv_offset);
   }
+  const int pipeline_depth =
+      PipelineDepth(*col_params, num_subdivs, chunk_size);
+  for (int stage = 1; stage < pipeline_depth; ++stage) {
+    for (int sdi = 0; sdi < num_subdivs; ++sdi) {
+      col_params->instance.impl_details.subdiv_offsets.push_back(
+          col_params->instance.impl_details.subdiv_offsets[sdi]);
+    }
+  }
+  num_subdivs *= pipeline_depth;
+  chunk_size /= pipeline_depth;
 
   if (VLOG_IS_ON(2)) {
     std::string subdiv_buf;
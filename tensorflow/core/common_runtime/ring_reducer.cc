@@ -12,10 +12,13 @@ WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
+#define EIGEN_USE_THREADS
+
 #include "tensorflow/core/common_runtime/ring_reducer.h"
 
 #include <stdlib.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cstdint>
 #include <functional>
@@ -28,6 +31,7 @@ limitations under the License.
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/synchronization/notification.h"
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "tensorflow/core/common_runtime/collective_rma_local.h"
 #include "tensorflow/core/common_runtime/collective_util.h"
 #include "tensorflow/core/common_runtime/copy_tensor.h"
@@ -45,10 +49,79 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/profiler/lib/traceme.h"
 
 namespace tensorflow {
+namespace {
+
+// Returns true if ReduceInPlace handles `op` for tensors of `dtype`.
+bool CanReduceInPlace(const OpKernel& merge_op, DataType dtype) {
+  const std::string& op = merge_op.type_string();
+  if (op != "Add" && op != "AddV2" && op != "Mul" && op != "Maximum" &&
+      op != "Minimum") {
+    return false;
+  }
+  switch (dtype) {
+    case DT_FLOAT:
+    case DT_DOUBLE:
+    case DT_INT32:
+    case DT_INT64:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Computes output = merge_op(output, input) with an Eigen expression, which
+// is vectorized the same way as the kernel of the merge op but skips its
+// dispatch.  That overhead adds up when a tensor is reduced in many small
+// pipelined chunks.  Returns false if the op is not handled here.
+template <typename T, typename Device>
+bool ReduceInPlace(const Device& d, const std::string& op, const Tensor& input,
+                   Tensor* output) {
+  auto out = output->flat<T>();
+  auto in = input.flat<T>();
+  if (op == "Add" || op == "AddV2") {
+    out.device(d) = out + in;
+  } else if (op == "Mul") {
+    out.device(d) = out * in;
+  } else if (op == "Maximum") {
+    out.device(d) = out.binaryExpr(
+        in, Eigen::internal::scalar_max_op<T, T, Eigen::PropagateNaN>());
+  } else if (op == "Minimum") {
+    out.device(d) = out.binaryExpr(
+        in, Eigen::internal::scalar_min_op<T, T, Eigen::PropagateNaN>());
+  } else {
+    return false;
+  }
+  return true;
+}
+
+template <typename Device>
+bool ReduceInPlace(const Device& d, const OpKernel& merge_op,
+                   const Tensor& input, Tensor* output) {
+  if (input.dtype() != output->dtype() ||
+      input.NumElements() != output->NumElements()) {
+    return false;
+  }
+  const std::string& op = merge_op.type_string();
+  switch (output->dtype()) {
+    case DT_FLOAT:
+      return ReduceInPlace<float>(d, op, input, output);
+    case DT_DOUBLE:
+      return ReduceInPlace<double>(d, op, input, output);
+    case DT_INT32:
+      return ReduceInPlace<int32_t>(d, op, input, output);
+    case DT_INT64:
+      return ReduceInPlace<int64_t>(d, op, input, output);
+    default:
+      return false;
+  }
+}
+
+}  // namespace
 
 RingReducer::~RingReducer() { group_size_tensor_ready_.WaitForNotification(); }
 
@@ -65,7 +138,9 @@ void RingReducer::Run(StatusCallback done) {
   CHECK(col_params_);
   // Since `RingReducer` doesn't require non-overlapping collectives, unblock
   // any collective that is blocked on this instance.
-  col_ctx_->col_exec->UnblockDependencies(*col_params_);
+  if (unblock_dependencies_) {
+    col_ctx_->col_exec->UnblockDependencies(*col_params_);
+  }
 
   done_ = std::move(done);
   group_size_ = col_params_->group.group_size;
@@ -184,6 +259,26 @@ void RingReducer::InitRingField(RingField* rf, int chunk_idx, int subdiv_idx,
   }
 }
 
+absl::Status RingReducer::Reduce(RingField* rf, bool on_worker_thread) {
+  if (on_worker_thread) {
+    // Already running on the intra-op pool, where a nested parallel
+    // evaluation on the same pool can deadlock once every worker blocks on
+    // its own barrier.  The chunks reduced concurrently keep the pool busy.
+    if (ReduceInPlace(Eigen::DefaultDevice(), *col_params_->merge_op,
+                      rf->tmp_chunk, &rf->chunk)) {
+      return absl::OkStatus();
+    }
+  } else if (col_params_->group.device_type == DEVICE_CPU &&
+             ReduceInPlace(*col_ctx_->device->eigen_cpu_device(),
+                           *col_params_->merge_op, rf->tmp_chunk,
+                           &rf->chunk)) {
+    return absl::OkStatus();
+  }
+  return collective_util::ComputeBinOp(
+      col_ctx_->op_ctx, col_ctx_->op_params, col_ctx_->device,
+      col_params_->merge_op, &rf->chunk, &rf->tmp_chunk);
+}
+
 // At the beginning of the algorithm initialize a RingField struct for
 // every independent field of the tensor.
 bool RingReducer::RunAsyncParts() {
@@ -224,9 +319,23 @@ bool RingReducer::RunAsyncParts() {
     }
   }
 
+  // On CPU the reductions run on the worker threads of the device, so that
+  // this loop keeps dispatching the transfers of the other fields meanwhile.
+  // Only merge ops evaluated inline by ReduceInPlace are offloaded: an op
+  // kernel would evaluate on the same pool and could wait on itself.
+  thread::ThreadPool* reduce_pool = nullptr;
+  if (!gpu_info && col_params_->group.device_type == DEVICE_CPU &&
+      CanReduceInPlace(*col_params_->merge_op,
+                       col_params_->instance.data_type)) {
+    reduce_pool = col_ctx_->device->tensorflow_cpu_worker_threads()->workers;
+  }
+
   int field_done_count = 0;
   int send_pending_count = 0;
   int recv_pending_count = 0;
+  int reduce_pending_count = 0;
+  int64_t recv_bytes = 0;
+  const uint64_t start_micros = Env::Default()->NowMicros();
   std::atomic<bool> aborted(false);
 
   {
@@ -268,20 +377,37 @@ bool RingReducer::RunAsyncParts() {
           case RF_RECV:
             CHECK_GT(recv_pending_count, 0);
             --recv_pending_count;
+            recv_bytes += rf->chunk.TotalBytes();
             if (!rf->second_pass) {
               rf->action = RF_REDUCE;
-              absl::Status s = collective_util::ComputeBinOp(
-                  col_ctx_->op_ctx, col_ctx_->op_params, col_ctx_->device,
-                  col_params_->merge_op, &rf->chunk, &rf->tmp_chunk);
-              if (!s.ok()) {
-                aborted = true;
-                StartAbort(s);
+              if (reduce_pool != nullptr) {
+                auto reduce = [this, rf, &ready_queue, &aborted]() {
+                  absl::Status s = Reduce(rf, /*on_worker_thread=*/true);
+                  if (!s.ok()) {
+                    aborted = true;
+                    StartAbort(s);
+                  }
+                  ready_queue.Enqueue(rf);
+                };
+                reduce_pool->Schedule(std::move(reduce));
+                dispatched = true;
+                ++reduce_pending_count;
+              } else {
+                absl::Status s = Reduce(rf, /*on_worker_thread=*/false);
+                if (!s.ok()) {
+                  aborted = true;
+                  StartAbort(s);
+                }
               }
             } else {
               rf->action = RF_SEND_READY;
             }
             break;
           case RF_REDUCE:
+            if (reduce_pool != nullptr) {
+              CHECK_GT(reduce_pending_count, 0);
+              --reduce_pending_count;
+            }
             if (!rf->second_pass && col_params_->final_op && rf->is_final) {
               rf->action = RF_FINALIZE;
               group_size_tensor_ready_.WaitForNotification();
@@ -340,12 +466,16 @@ bool RingReducer::RunAsyncParts() {
     if (aborted) {
       // All of the pending data actions should be aborted; field the
       // callbacks and clear the queue before quitting.
-      while ((send_pending_count > 0) || (recv_pending_count > 0)) {
+      while ((send_pending_count > 0) || (recv_pending_count > 0) ||
+             (reduce_pending_count > 0)) {
         RingField* rf = ready_queue.Dequeue();
         switch (rf->action) {
           case RF_RECV:
             --recv_pending_count;
             break;
+          case RF_REDUCE:
+            if (reduce_pool != nullptr) --reduce_pending_count;
+            break;
           case RF_SEND:
             --send_pending_count;
             break;
@@ -358,6 +488,14 @@ bool RingReducer::RunAsyncParts() {
 
   CHECK_EQ(send_pending_count, 0);
   CHECK_EQ(recv_pending_count, 0);
+  CHECK_EQ(reduce_pending_count, 0);
+
+  // Reported to help choose TF_COLLECTIVE_RING_PIPELINE_CHUNK_BYTES.
+  const uint64_t elapsed_micros = Env::Default()->NowMicros() - start_micros;
+  VLOG(1) << "RingReducer device=" << col_ctx_->device_name << " received "
+          << recv_bytes << " bytes in " << rfv_.size() << " fields in "
+          << elapsed_micros << " us ("
+          << recv_bytes / std::max<uint64_t>(elapsed_micros, 1) << " MB/s)";
 
   VLOG(2) << this << " device=" << col_ctx_->device_name << " finish;"
           << " final value " << TensorDebugString(ca_->Value());
@@ -51,10 +51,18 @@ class RingReducer : public RingAlg {
  private:
   void ContinueAfterInputCopy();
   bool RunAsyncParts();
+  // Merges rf->tmp_chunk into rf->chunk with the merge op.  If
+  // `on_worker_thread`, the caller runs on the intra-op pool of the device
+  // and the merge is evaluated on the calling thread alone.
+  absl::Status Reduce(RingField* rf, bool on_worker_thread);
 
   Tensor group_size_tensor_;
   absl::Notification group_size_tensor_ready_;
+  // False when the ring runs as a stage of another collective, which
+  // unblocks the dependencies on the instance itself.
+  bool unblock_dependencies_ = true;
 
+  friend class HierarchicalRingReducer;
   friend class RingReducerTest;
   friend class RingReducerInitParamsTest;
 };
@@ -15,6 +15,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/ring_reducer.h"
 
 #include <algorithm>
+#include <cstdlib>
 
 #include "absl/memory/memory.h"
 #include "tensorflow/core/common_runtime/base_collective_executor.h"
@@ -84,7 +85,9 @@ class RingReducerTest : public ::testing::Test {
   void Init(int num_workers, int num_devices, DataType dtype,
             const TensorShape& shape, const DeviceType& device_type,
             int num_subdivs, int fail_after) {
-    test_env_ = CreateCollectiveTestEnv(num_workers, num_devices, device_type);
+    test_env_ = CreateCollectiveTestEnv(num_workers, num_devices, device_type,
+                                        /*use_nccl=*/false,
+                                        num_intra_op_threads_);
     test_env_->remote_access->set_fail_after(fail_after);
     for (int wi = 0; wi < num_workers; ++wi) {
       for (int di = 0; di < num_devices; ++di) {
@@ -164,6 +167,9 @@ class RingReducerTest : public ::testing::Test {
         col_params_->instance.impl_details.subdiv_offsets =
             GenerateEvenSubdivOffsets(test_env->num_devices_per_worker,
                                       num_subdivs);
+      } else {
+        // Let the RingReducer generate the subdivisions.
+        col_params_->instance.impl_details.max_subdivs_per_device = 0;
       }
       std::string dev_name = col_params_->group.members[rank].device.name();
       TF_CHECK_OK(test_env_->device_mgr->LookupDevice(dev_name, &device_))
@@ -197,6 +203,8 @@ class RingReducerTest : public ::testing::Test {
     absl::Status status_;
   };
 
+  // If positive, the size of the intra-op pool of every device.
+  int num_intra_op_threads_ = 0;
   std::unique_ptr<CollectiveTestEnv> test_env_;
   std::vector<std::unique_ptr<DeviceInstance>> instances_;
   mutex mu_;
@@ -374,6 +382,32 @@ TEST_F(RingReducerInitParamsTest, AutomaticSubdivDisabled) {
   RunSubdivPermsTest(cp.get(), {{0, 1, 2, 3}}, {0});
 }
 
+TEST_F(RingReducerInitParamsTest, AutomaticSubdivPipelinesChunks) {
+  const int kNumDevsPerWorker = 1;
+  const int kNumWorkers = 4;
+  auto test_env =
+      CreateCollectiveTestEnv(kNumWorkers, kNumDevsPerWorker, DEVICE_CPU);
+  auto cp =
+      CreateCollectiveParams(*test_env, /*rank*/ 0, "RingReduce",
+                             REDUCTION_COLLECTIVE, DT_FLOAT, TensorShape({1}));
+
+  // A 4 MiB tensor needs a single subdivision, of 1 MiB chunks.  Streaming
+  // them in 256 KiB sub-chunks repeats it 4 times along the same ring.
+  cp->default_rank = 0;
+  cp->instance.impl_details.subdiv_offsets.clear();
+  cp->instance.impl_details.max_subdivs_per_device = 0;
+  cp->instance.shape = TensorShape({4194304 / DataTypeSize(DT_FLOAT)});
+  setenv("TF_COLLECTIVE_RING_PIPELINE_CHUNK_BYTES", "262144", 1);
+  RunSubdivPermsTest(cp.get(),
+                     {{0, 1, 2, 3}, {0, 1, 2, 3}, {0, 1, 2, 3}, {0, 1, 2, 3}},
+                     {0, 0, 0, 0});
+
+  // Explicit subdivisions are left alone.
+  cp->instance.impl_details.subdiv_offsets = {0};
+  RunSubdivPermsTest(cp.get(), {{0, 1, 2, 3}}, {0});
+  unsetenv("TF_COLLECTIVE_RING_PIPELINE_CHUNK_BYTES");
+}
+
 // TODO(b/113171733): change to use TEST_P.
 #define DEF_TEST(B, T, W, D, S, L, A)                                         \
   TEST_F(RingReducerTest,                                                     \
@@ -427,6 +461,28 @@ DEF_TEST(INT64, CPU, 2, 8, 3, 4095, 0)
 DEF_TEST(FLOAT, CPU, 2, 8, 1, 9408, 1)
 DEF_TEST(FLOAT, CPU, 2, 8, 1, 9408, 7)
 DEF_TEST(FLOAT, CPU, 2, 8, 2, 9408, 11)
+
+TEST_F(RingReducerTest, PipelinedChunks) {
+  // Each 4704 byte chunk is streamed as 5 sub-chunks.
+  setenv("TF_COLLECTIVE_RING_PIPELINE_CHUNK_BYTES", "1024", 1);
+  RunTest<float>(DT_FLOAT, DEVICE_CPU, 2, 4, 0, 9408, 0);
+  unsetenv("TF_COLLECTIVE_RING_PIPELINE_CHUNK_BYTES");
+}
+
+TEST_F(RingReducerTest, LargeChunksOnSmallIntraOpPool) {
+  // Every worker thread of a device runs a reduction of a large chunk, which
+  // must not wait on the same pool for a parallel evaluation.
+  num_intra_op_threads_ = 2;
+  setenv("TF_COLLECTIVE_RING_PIPELINE_CHUNK_BYTES", "262144", 1);
+  RunTest<float>(DT_FLOAT, DEVICE_CPU, 2, 4, 2, 1045991, 0);
+  unsetenv("TF_COLLECTIVE_RING_PIPELINE_CHUNK_BYTES");
+}
+
+TEST_F(RingReducerTest, PipelinedChunksAbort) {
+  setenv("TF_COLLECTIVE_RING_PIPELINE_CHUNK_BYTES", "1024", 1);
+  RunTest<float>(DT_FLOAT, DEVICE_CPU, 2, 4, 0, 9408, 7);
+  unsetenv("TF_COLLECTIVE_RING_PIPELINE_CHUNK_BYTES");
+}
 #endif
 
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
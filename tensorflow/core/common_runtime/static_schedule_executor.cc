@@ -0,0 +1,302 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/static_schedule_executor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/common_runtime/entry.h"
+#include "tensorflow/core/common_runtime/executor.h"
+#include "tensorflow/core/common_runtime/executor_factory.h"
+#include "tensorflow/core/common_runtime/flat_executor_state.h"
+#include "tensorflow/core/common_runtime/renamed_device.h"
+#include "tensorflow/core/common_runtime/single_threaded_executor.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/lib/gtl/cleanup.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace {
+
+static const std::string& kStaticScheduleExecutor =
+    *new std::string("STATIC_SCHEDULE_EXECUTOR");
+
+// A wave is only split into lanes if every lane gets at least this many nodes.
+// Handing a lane to another thread costs about as much as running a few dozen
+// small kernels.
+constexpr size_t kMinNodesPerLane = 16;
+// The maximum number of lanes of a wave.
+constexpr size_t kMaxLanes = 16;
+
+class StaticScheduleExecutorImpl : public Executor {
+ public:
+  explicit StaticScheduleExecutorImpl(const LocalExecutorParams& params)
+      : params_(params),
+        max_lanes_(std::clamp<size_t>(port::MaxParallelism(), 1, kMaxLanes)),
+        state_(params) {}
+
+  absl::Status Initialize(const Graph& graph) {
+    std::vector<Node*> ordered_nodes;
+    ordered_nodes.reserve(graph.num_nodes());
+    GetReversePostOrder(graph, &ordered_nodes);
+    int ordered_nodes_size = ordered_nodes.size();
+    if (ordered_nodes_size != graph.num_nodes()) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Graph had ", graph.num_nodes(),
+                       " but reverse post-order had ", ordered_nodes.size()));
+    }
+
+    // The wave of each node that the schedule runs, indexed by node id.
+    // Arguments and constants are available before the first wave, so their
+    // wave is -1.
+    std::vector<int> node_waves(graph.num_node_ids(), -1);
+    std::vector<std::vector<const Node*>> waves;
+
+    // Create the kernel of each node in `graph` and assign it to a wave. Since
+    // the nodes are visited in topological order, the waves of the inputs of a
+    // node are known when the node is visited.
+    for (Node* n : ordered_nodes) {
+      if (n->IsSource() || n->IsSink()) {
+        continue;
+      }
+      TF_RETURN_IF_ERROR(ValidateOpIsSafeForSyncExecution(
+          *n, /*allow_control_flow_sync_execution=*/false));
+      bool needs_kernel;
+      TF_RETURN_IF_ERROR(state_.AddNode(n, &needs_kernel));
+      if (!needs_kernel) {
+        continue;
+      }
+
+      int wave = 0;
+      for (const Edge* e : n->in_edges()) {
+        wave = std::max(wave, node_waves[e->src()->id()] + 1);
+      }
+      node_waves[n->id()] = wave;
+      if (static_cast<size_t>(wave) >= waves.size()) {
+        waves.resize(wave + 1);
+      }
+      waves[wave].push_back(n);
+    }
+
+    // Lay out the kernels in the order of the schedule and split each wave
+    // into lanes of consecutive kernels.
+    std::vector<const Node*> nodes_with_kernels;
+    nodes_with_kernels.reserve(ordered_nodes.size());
+    max_wave_lanes_ = 1;
+    for (const std::vector<const Node*>& wave : waves) {
+      const size_t num_lanes =
+          std::clamp<size_t>(wave.size() / kMinNodesPerLane, 1, max_lanes_);
+      const size_t wave_start = nodes_with_kernels.size();
+      nodes_with_kernels.insert(nodes_with_kernels.end(), wave.begin(),
+                                wave.end());
+      if (num_lanes == 1 && !schedule_.empty() &&
+          schedule_.back().lane_starts.size() == 2) {
+        // Consecutive waves that run on the calling thread are merged, since
+        // their kernels run one after the other either way.
+        schedule_.back().lane_starts.back() = nodes_with_kernels.size();
+        continue;
+      }
+      Wave& scheduled_wave = schedule_.emplace_back();
+      for (size_t lane = 0; lane <= num_lanes; ++lane) {
+        scheduled_wave.lane_starts.push_back(wave_start +
+                                             lane * wave.size() / num_lanes);
+      }
+      max_wave_lanes_ = std::max(max_wave_lanes_, num_lanes);
+    }
+    TF_RETURN_IF_ERROR(state_.Finalize(nodes_with_kernels));
+
+    VLOG(2) << "Scheduled " << nodes_with_kernels.size() << " kernels in "
+            << schedule_.size() << " waves with up to " << max_wave_lanes_
+            << " lanes.";
+    return absl::OkStatus();
+  }
+
+  absl::Status Run(const Args& args) override {
+    // The inputs of each kernel are stored contiguously in `inputs`. See
+    // `FlatExecutorState` for the layout. Kernels of the same wave read and
+    // write disjoint ranges of `inputs`, so the lanes of a wave do not
+    // synchronize with each other.
+    std::vector<Entry> inputs(state_.total_num_inputs());
+
+    // Override intra op thread pool if requested.
+    Device* device = params_.device;
+    std::unique_ptr<Device> user_device;
+    if (args.user_intra_op_threadpool != nullptr) {
+      user_device = RenamedDevice::NewRenamedDevice(
+          device->name(), device, /*owns_underlying=*/false,
+          /*isolate_session_state=*/false, args.user_intra_op_threadpool);
+      device = user_device.get();
+    }
+
+    Args::Runner runner_copy = args.runner;
+    std::vector<Lane> lanes(max_wave_lanes_);
+    for (Lane& lane : lanes) {
+      state_.InitializeParams(args, device, &runner_copy,
+                              &kStaticScheduleExecutor, &lane.state.params);
+    }
+    auto context_cleanup = gtl::MakeCleanup([&lanes] {
+      for (Lane& lane : lanes) {
+        if (lane.state.params.op_device_context != nullptr) {
+          lane.state.params.op_device_context->Unref();
+        }
+      }
+    });
+
+    TF_RETURN_IF_ERROR(state_.ForwardArgsAndConsts(args, inputs.data()));
+
+    // Replay the schedule.
+    for (const Wave& wave : schedule_) {
+      const size_t num_lanes = wave.lane_starts.size() - 1;
+      if (num_lanes == 1 || !args.runner) {
+        TF_RETURN_IF_ERROR(state_.RunKernels(wave.lane_starts.front(),
+                                             wave.lane_starts.back(), device,
+                                             &lanes[0].state, inputs.data()));
+      } else {
+        TF_RETURN_IF_ERROR(
+            RunLanes(args.runner, wave, device, lanes.data(), inputs.data()));
+      }
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  // A group of kernels of a wave that run on one thread.
+  struct Wave {
+    // The kernels of lane `i` are `state_.kernels()[lane_starts[i]]` up to
+    // `state_.kernels()[lane_starts[i + 1]]`.
+    std::vector<size_t> lane_starts;
+  };
+
+  // The per-thread state of a lane.
+  struct Lane {
+    FlatExecutorState::KernelRunState state;
+    absl::Status status;
+  };
+
+  // Runs the lanes of `wave` in parallel. Lanes are claimed by whichever
+  // thread gets to them first, so the calling thread runs all of them if the
+  // runner is busy. Closures that the runner starts after all lanes have been
+  // claimed only touch `claims`, which they share ownership of, and return.
+  absl::Status RunLanes(const Args::Runner& runner, const Wave& wave,
+                        Device* device, Lane* lanes, Entry* inputs) const {
+    struct Claims {
+      Claims(const FlatExecutorState* state, const Wave* wave, Device* device,
+             Lane* lanes, Entry* inputs)
+          : state(state),
+            wave(wave),
+            device(device),
+            lanes(lanes),
+            inputs(inputs),
+            num_lanes(wave->lane_starts.size() - 1),
+            pending(num_lanes) {}
+
+      // Runs unclaimed lanes until there are none left.
+      void Run() {
+        for (size_t lane = next_lane.fetch_add(1); lane < num_lanes;
+             lane = next_lane.fetch_add(1)) {
+          lanes[lane].status = state->RunKernels(
+              wave->lane_starts[lane], wave->lane_starts[lane + 1], device,
+              &lanes[lane].state, inputs);
+          pending.DecrementCount();
+        }
+      }
+
+      // Only dereferenced while a lane is unclaimed, i.e. before `RunLanes()`
+      // returns.
+      const FlatExecutorState* const state;
+      const Wave* const wave;
+      Device* const device;
+      Lane* const lanes;
+      Entry* const inputs;
+
+      const size_t num_lanes;
+      std::atomic<size_t> next_lane{0};
+      BlockingCounter pending;
+    };
+    auto claims =
+        std::make_shared<Claims>(&state_, &wave, device, lanes, inputs);
+    for (size_t i = 1; i < claims->num_lanes; ++i) {
+      runner([claims]() { claims->Run(); });
+    }
+    claims->Run();
+    claims->pending.Wait();
+    for (size_t i = 0; i < claims->num_lanes; ++i) {
+      TF_RETURN_IF_ERROR(lanes[i].status);
+    }
+    return absl::OkStatus();
+  }
+
+  // Runs the step on the runner, like the single-threaded executor, so that
+  // callers may do expensive work on the calling thread.
+  void RunAsyncInternal(const Args& args, DoneCallback done) override {
+    args.runner([this, args, done]() { done(Run(args)); });
+  }
+
+  const LocalExecutorParams params_;
+  const size_t max_lanes_;
+
+  // All following members are read-only after Initialize().
+
+  // The kernels in the order of the schedule.
+  FlatExecutorState state_;
+
+  // The waves of the schedule, in the order in which they run.
+  std::vector<Wave> schedule_;
+  // The largest number of lanes of a wave in `schedule_`.
+  size_t max_wave_lanes_;
+};
+
+class StaticScheduleExecutorRegistrar {
+ public:
+  StaticScheduleExecutorRegistrar() {
+    ExecutorFactory::Register(kStaticScheduleExecutor, new Factory());
+  }
+
+ private:
+  class Factory : public ExecutorFactory {
+    absl::Status NewExecutor(const LocalExecutorParams& params,
+                             const Graph& graph,
+                             std::unique_ptr<Executor>* out_executor) override {
+      Executor* ret;
+      TF_RETURN_IF_ERROR(NewStaticScheduleExecutor(params, graph, &ret));
+      out_executor->reset(ret);
+      return absl::OkStatus();
+    }
+  };
+};
+static StaticScheduleExecutorRegistrar registrar;
+
+}  // namespace
+
+absl::Status NewStaticScheduleExecutor(const LocalExecutorParams& params,
+                                       const Graph& graph,
+                                       Executor** executor) {
+  auto impl = std::make_unique<StaticScheduleExecutorImpl>(params);
+  TF_RETURN_IF_ERROR(impl->Initialize(graph));
+  *executor = impl.release();
+  return absl::OkStatus();
+}
+
+}  // namespace tensorflow
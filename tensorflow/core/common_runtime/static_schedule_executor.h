@@ -0,0 +1,56 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_SCHEDULE_EXECUTOR_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_SCHEDULE_EXECUTOR_H_
+
+#include "absl/status/status.h"
+#include "tensorflow/core/common_runtime/executor.h"
+#include "tensorflow/core/common_runtime/local_executor_params.h"
+#include "tensorflow/core/graph/graph.h"
+
+namespace tensorflow {
+
+// Creates a new `Executor` for executing `graph` by replaying a schedule that
+// is computed once, when the executor is created. The executor is registered
+// as "STATIC_SCHEDULE_EXECUTOR".
+//
+// The schedule groups the nodes of `graph` into waves: a node belongs to wave
+// `k` if the longest chain of edges from the arguments and constants to the
+// node passes through `k` other nodes. Nodes of the same wave do not depend on
+// each other, so each wave is split into lanes of consecutive nodes that run
+// in parallel, one on the calling thread and the others on
+// `Executor::Args::runner`. Waves that are too narrow to amortize the hand-off
+// to another thread run on the calling thread.
+//
+// Compared to the default executor, a step does not decrement pending counts,
+// push to ready queues, or make scheduling decisions per node. This pays off
+// for graphs without control flow that consist of many small ops, e.g. in
+// inference, where the executor's per-node overhead exceeds the kernel time.
+// The executor still allocates per step: the flat array of kernel inputs, the
+// kernel parameters of each lane, and, for each wave that runs on more than
+// one thread, the state shared by its lanes and the closures passed to the
+// runner.
+//
+// Because the schedule is static, the executor has the same limitations as the
+// executor returned by `NewSingleThreadedExecutor()`: it does not support
+// reference-typed tensors, control flow, partitioned graphs, memory logging,
+// allocation forwarding, or non-default device contexts.
+absl::Status NewStaticScheduleExecutor(const LocalExecutorParams& params,
+                                       const Graph& graph, Executor** executor);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_SCHEDULE_EXECUTOR_H_
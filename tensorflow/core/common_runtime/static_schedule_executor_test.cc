@@ -0,0 +1,336 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/static_schedule_executor.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/device_factory.h"
+#include "tensorflow/core/common_runtime/executor.h"
+#include "tensorflow/core/common_runtime/executor_factory.h"
+#include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/function.h"
+#include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/random/simple_philox.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/platform/threadpool.h"
+
+namespace tensorflow {
+namespace {
+
+class StaticScheduleMockOp : public OpKernel {
+ public:
+  using OpKernel::OpKernel;
+
+  void SetCompute(std::function<void(OpKernelContext*)> compute) {
+    compute_ = std::move(compute);
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    OP_REQUIRES(ctx, compute_ != nullptr,
+                absl::FailedPreconditionError("Compute() is not set"));
+    compute_(ctx);
+  }
+
+ private:
+  std::function<void(OpKernelContext* ctx)> compute_;
+};
+REGISTER_OP("StaticScheduleMock")
+    .Input("x: float")
+    .Output("y: float")
+    .SetIsStateful();
+REGISTER_KERNEL_BUILDER(Name("StaticScheduleMock").Device(DEVICE_CPU),
+                        StaticScheduleMockOp);
+
+class StaticScheduleExecutorTest : public ::testing::TestWithParam<bool> {
+ protected:
+  StaticScheduleExecutorTest()
+      : device_(DeviceFactory::NewDevice("CPU", {},
+                                         "/job:localhost/replica:0/task:0")),
+        pool_(Env::Default(), "runner", 4) {
+    if (GetParam()) {
+      runner_ = [this](std::function<void()> fn) {
+        pool_.Schedule(std::move(fn));
+      };
+    } else {
+      runner_ = [](const std::function<void()>& fn) { fn(); };
+    }
+  }
+
+  // Resets `exec_` with a new executor for `graph`.
+  void Create(std::unique_ptr<const Graph> graph,
+              std::function<void(OpKernelContext*)> mock_fn = nullptr) {
+    const int version = graph->versions().producer();
+    LocalExecutorParams params;
+    params.device = device_.get();
+    params.create_kernel =
+        [this, mock_fn = std::move(mock_fn), version](
+            const std::shared_ptr<const NodeProperties>& props,
+            OpKernel** kernel) {
+          TF_RETURN_IF_ERROR(CreateNonCachedKernel(device_.get(), nullptr,
+                                                   props, version, kernel));
+          if ((*kernel)->type_string_view() == "StaticScheduleMock") {
+            absl::down_cast<StaticScheduleMockOp*>(*kernel)->SetCompute(
+                mock_fn);
+          }
+          return absl::OkStatus();
+        };
+    params.delete_kernel = [](OpKernel* kernel) {
+      DeleteNonCachedKernel(kernel);
+    };
+    TF_CHECK_OK(
+        NewExecutor("STATIC_SCHEDULE_EXECUTOR", params, *graph, &exec_));
+  }
+
+  absl::Status Run(CallFrameInterface* call_frame) {
+    Executor::Args args;
+    args.call_frame = call_frame;
+    args.runner = runner_;
+    return exec_->Run(args);
+  }
+
+  std::unique_ptr<Device> device_;
+  thread::ThreadPool pool_;
+  std::unique_ptr<Executor> exec_ = nullptr;
+  Executor::Args::Runner runner_;
+};
+
+// A float val -> Tensor<float>
+Tensor V(const float val) {
+  Tensor tensor(DT_FLOAT, TensorShape({}));
+  tensor.scalar<float>()() = val;
+  return tensor;
+}
+
+// Tensor<float> -> a float val.
+float V(const Tensor& tensor) {
+  CHECK_EQ(tensor.dtype(), DT_FLOAT);
+  CHECK(TensorShapeUtils::IsScalar(tensor.shape()));
+  return tensor.scalar<float>()();
+}
+
+TEST_P(StaticScheduleExecutorTest, SimpleAdd) {
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  auto in0 = test::graph::Arg(g.get(), 0, DT_FLOAT);
+  auto in1 = test::graph::Arg(g.get(), 1, DT_FLOAT);
+  auto tmp = test::graph::Add(g.get(), in0, in1);
+  auto ret = test::graph::Retval(g.get(), 0, tmp);
+  g->AddControlEdge(in1, ret);
+  FixupSourceAndSinkEdges(g.get());
+  Create(std::move(g));
+  FunctionCallFrame call_frame({DT_FLOAT, DT_FLOAT}, {DT_FLOAT});
+  TF_ASSERT_OK(call_frame.SetArgs({V(1.0), V(2.0)}));
+  TF_ASSERT_OK(Run(&call_frame));
+  std::vector<Tensor> retvals;
+  TF_ASSERT_OK(call_frame.ConsumeRetvals(&retvals, false));
+  EXPECT_EQ(3.0, V(retvals[0]));
+}
+
+TEST_P(StaticScheduleExecutorTest, SelfAdd) {
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  auto v = test::graph::Arg(g.get(), 0, DT_FLOAT);
+  for (int i = 0; i < 10; ++i) {
+    v = test::graph::Add(g.get(), v, v);
+  }
+  test::graph::Retval(g.get(), 0, v);
+  FixupSourceAndSinkEdges(g.get());
+  Create(std::move(g));
+  FunctionCallFrame call_frame({DT_FLOAT}, {DT_FLOAT});
+  TF_ASSERT_OK(call_frame.SetArgs({V(1.0)}));
+  TF_ASSERT_OK(Run(&call_frame));
+  std::vector<Tensor> retvals;
+  TF_ASSERT_OK(call_frame.ConsumeRetvals(&retvals, false));
+  EXPECT_EQ(1024.0, V(retvals[0]));
+}
+
+// Builds a graph that adds `n` copies of its argument in a random tree, so
+// that the first waves are wide enough to be split into lanes.
+void BuildTree(int n, Graph* g) {
+  auto in = test::graph::Arg(g, 0, DT_FLOAT);
+  std::vector<Node*> nodes;
+  for (int i = 0; i < n; ++i) {
+    nodes.push_back(test::graph::Identity(g, in, 0));
+  }
+  random::PhiloxRandom philox(0, 17);
+  random::SimplePhilox rnd(&philox);
+  while (nodes.size() > 1) {
+    int x = rnd.Uniform(nodes.size());
+    auto in0 = nodes[x];
+    nodes[x] = nodes.back();
+    nodes.resize(nodes.size() - 1);
+    x = rnd.Uniform(nodes.size());
+    auto in1 = nodes[x];
+    nodes[x] = test::graph::Add(g, in0, in1);
+  }
+  test::graph::Retval(g, 0, nodes.back());
+  FixupSourceAndSinkEdges(g);
+}
+
+TEST_P(StaticScheduleExecutorTest, RandomTree) {
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  BuildTree(4096, g.get());
+  Create(std::move(g));
+  for (int step = 0; step < 10; ++step) {
+    FunctionCallFrame call_frame({DT_FLOAT}, {DT_FLOAT});
+    TF_ASSERT_OK(call_frame.SetArgs({V(1.0)}));
+    TF_ASSERT_OK(Run(&call_frame));
+    std::vector<Tensor> retvals;
+    TF_ASSERT_OK(call_frame.ConsumeRetvals(&retvals, false));
+    EXPECT_EQ(4096.0, V(retvals[0]));
+  }
+}
+
+TEST_P(StaticScheduleExecutorTest, ControlDependenciesOrderKernels) {
+  // A chain of mock ops connected only by control edges, next to a wide wave
+  // of independent mock ops.
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  auto in = test::graph::Arg(g.get(), 0, DT_FLOAT);
+  constexpr int kChainLength = 8;
+  std::vector<Node*> chain;
+  for (int i = 0; i < kChainLength; ++i) {
+    Node* n;
+    TF_ASSERT_OK(NodeBuilder(absl::StrCat("chain", i), "StaticScheduleMock")
+                     .Input(in)
+                     .Finalize(g.get(), &n));
+    if (!chain.empty()) {
+      g->AddControlEdge(chain.back(), n);
+    }
+    chain.push_back(n);
+  }
+  for (int i = 0; i < 256; ++i) {
+    Node* n;
+    TF_ASSERT_OK(NodeBuilder(absl::StrCat("wide", i), "StaticScheduleMock")
+                     .Input(in)
+                     .Finalize(g.get(), &n));
+  }
+  FixupSourceAndSinkEdges(g.get());
+
+  std::atomic<int> next_chain_index = 0;
+  std::atomic<int> num_out_of_order = 0;
+  std::atomic<int> num_calls = 0;
+  Create(std::move(g), [&](OpKernelContext* ctx) {
+    ++num_calls;
+    absl::string_view name = ctx->op_kernel().name();
+    if (absl::ConsumePrefix(&name, "chain")) {
+      int index = name[0] - '0';
+      if (next_chain_index.fetch_add(1) != index) {
+        ++num_out_of_order;
+      }
+    }
+    ctx->set_output(0, ctx->input(0));
+  });
+  FunctionCallFrame call_frame({DT_FLOAT}, {});
+  TF_ASSERT_OK(call_frame.SetArgs({V(1.0)}));
+  TF_ASSERT_OK(Run(&call_frame));
+  EXPECT_EQ(num_calls, kChainLength + 256);
+  EXPECT_EQ(num_out_of_order, 0);
+}
+
+TEST_P(StaticScheduleExecutorTest, OpErrorInLane) {
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  auto in = test::graph::Arg(g.get(), 0, DT_FLOAT);
+  for (int i = 0; i < 256; ++i) {
+    Node* n;
+    TF_ASSERT_OK(NodeBuilder(absl::StrCat("wide", i), "StaticScheduleMock")
+                     .Input(in)
+                     .Finalize(g.get(), &n));
+  }
+  FixupSourceAndSinkEdges(g.get());
+  Create(std::move(g), [](OpKernelContext* ctx) {
+    if (ctx->op_kernel().name() == "wide200") {
+      ctx->SetStatus(absl::InvalidArgumentError("wide200 failed"));
+      return;
+    }
+    ctx->set_output(0, ctx->input(0));
+  });
+  FunctionCallFrame call_frame({DT_FLOAT}, {});
+  TF_ASSERT_OK(call_frame.SetArgs({V(1.0)}));
+  EXPECT_TRUE(absl::IsInvalidArgument(Run(&call_frame)));
+}
+
+TEST_P(StaticScheduleExecutorTest, RejectsControlFlow) {
+  auto g = std::make_unique<Graph>(OpRegistry::Global());
+  auto in = test::graph::Arg(g.get(), 0, DT_FLOAT);
+  auto pred = test::graph::Constant(g.get(), Tensor(true));
+  test::graph::Switch(g.get(), in, pred);
+  FixupSourceAndSinkEdges(g.get());
+  LocalExecutorParams params;
+  params.device = device_.get();
+  params.create_kernel = [this, version = g->versions().producer()](
+                             const std::shared_ptr<const NodeProperties>& props,
+                             OpKernel** kernel) {
+    return CreateNonCachedKernel(device_.get(), nullptr, props, version,
+                                 kernel);
+  };
+  params.delete_kernel = [](OpKernel* kernel) {
+    DeleteNonCachedKernel(kernel);
+  };
+  Executor* executor;
+  EXPECT_TRUE(absl::IsFailedPrecondition(
+      NewStaticScheduleExecutor(params, *g, &executor)));
+}
+
+INSTANTIATE_TEST_SUITE_P(Runners, StaticScheduleExecutorTest,
+                         ::testing::Bool());
+
+// Arguments: number of independent Identity ops per wave, number of waves.
+void BM_StaticScheduleExecutor(::testing::benchmark::State& state) {
+  const int width = state.range(0);
+  const int depth = state.range(1);
+  Graph* g = new Graph(OpRegistry::Global());
+  std::vector<Node*> nodes;
+  Tensor one(1.0f);
+  for (int i = 0; i < width; ++i) {
+    nodes.push_back(test::graph::Constant(g, one));
+  }
+  for (int i = 0; i < depth; ++i) {
+    for (Node*& n : nodes) {
+      n = test::graph::Identity(g, n);
+    }
+  }
+  FixupSourceAndSinkEdges(g);
+  test::Benchmark("cpu", g, nullptr, nullptr, nullptr,
+                  "STATIC_SCHEDULE_EXECUTOR", /*old_benchmark_api=*/false)
+      .Run(state);
+  state.SetLabel(absl::StrCat("Nodes = ", width * (depth + 1)));
+  state.SetItemsProcessed(width * depth *
+                          static_cast<int64_t>(state.iterations()));
+}
+
+BENCHMARK(BM_StaticScheduleExecutor)->UseRealTime()->ArgPair(1, 1024);
+BENCHMARK(BM_StaticScheduleExecutor)->UseRealTime()->ArgPair(16, 64);
+BENCHMARK(BM_StaticScheduleExecutor)->UseRealTime()->ArgPair(256, 16);
+BENCHMARK(BM_StaticScheduleExecutor)->UseRealTime()->ArgPair(4096, 4);
+
+}  // namespace
+}  // namespace tensorflow
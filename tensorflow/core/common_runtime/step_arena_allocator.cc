@@ -0,0 +1,177 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/step_arena_allocator.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/log/log.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+
+bool StepArenaEnabled() {
+  static const bool step_arena_enabled = [] {
+    bool flag;
+    auto status = ReadBoolFromEnvVar("TF_CPU_STEP_ARENA",
+                                     /*default_val=*/false, &flag);
+    if (!status.ok()) {
+      LOG(ERROR) << "StepArenaEnabled: " << status.message();
+      return false;
+    }
+    return flag;
+  }();
+  return step_arena_enabled;
+}
+
+StepArenaAllocator::BlockPool::~BlockPool() {
+  mutex_lock l(mu_);
+  for (void* block : free_blocks_) {
+    base_->DeallocateRaw(block);
+  }
+}
+
+void* StepArenaAllocator::BlockPool::Get() {
+  if (disabled_.load(std::memory_order_relaxed)) {
+    return nullptr;
+  }
+  {
+    mutex_lock l(mu_);
+    if (!free_blocks_.empty()) {
+      void* block = free_blocks_.back();
+      free_blocks_.pop_back();
+      return block;
+    }
+  }
+  void* block = base_->AllocateRaw(kBlockSize, kBlockSize);
+  if (block != nullptr &&
+      reinterpret_cast<uintptr_t>(block) % kBlockSize != 0) {
+    LOG_FIRST_N(WARNING, 1) << base_->Name()
+                            << " does not honor the alignment of step arena "
+                               "blocks; step arenas are disabled.";
+    disabled_.store(true, std::memory_order_relaxed);
+    base_->DeallocateRaw(block);
+    return nullptr;
+  }
+  return block;
+}
+
+void StepArenaAllocator::BlockPool::Put(void* block) {
+  {
+    mutex_lock l(mu_);
+    if (free_blocks_.size() < kMaxPooledBlocks) {
+      free_blocks_.push_back(block);
+      return;
+    }
+  }
+  base_->DeallocateRaw(block);
+}
+
+StepArenaAllocator::StepArenaAllocator(BlockPool* pool) : pool_(pool) {
+  pool_->Ref();
+}
+
+StepArenaAllocator::~StepArenaAllocator() { pool_->Unref(); }
+
+void* StepArenaAllocator::AllocateRaw(size_t alignment, size_t num_bytes) {
+  if (num_bytes == 0 || num_bytes > kMaxAllocationSize ||
+      alignment > kMaxAlignment) {
+    return nullptr;
+  }
+  while (true) {
+    Block* block = current_.load(std::memory_order_acquire);
+    if (block != nullptr) {
+      size_t offset = block->offset.load(std::memory_order_relaxed);
+      while (true) {
+        const size_t begin = (offset + alignment - 1) & ~(alignment - 1);
+        const size_t end = begin + num_bytes;
+        if (end > kBlockSize) break;
+        if (block->offset.compare_exchange_weak(offset, end,
+                                                std::memory_order_relaxed)) {
+          // The arena's own reference keeps the block alive until Release(),
+          // so the count cannot have dropped to zero in the meantime.
+          block->refs.fetch_add(1, std::memory_order_relaxed);
+          return reinterpret_cast<char*>(block) + begin;
+        }
+      }
+    }
+    if (!AddBlock(block)) {
+      return nullptr;
+    }
+  }
+}
+
+bool StepArenaAllocator::AddBlock(Block* full) {
+  mutex_lock l(mu_);
+  if (current_.load(std::memory_order_relaxed) != full) {
+    // Another thread already replaced the full block.
+    return true;
+  }
+  void* memory = pool_->Get();
+  if (memory == nullptr) {
+    return false;
+  }
+  Block* block = new (memory) Block;
+  block->refs.store(1, std::memory_order_relaxed);
+  block->offset.store(kBlockHeaderSize, std::memory_order_relaxed);
+  block->arena = this;
+  blocks_.push_back(block);
+  refs_.fetch_add(1, std::memory_order_relaxed);
+  current_.store(block, std::memory_order_release);
+  return true;
+}
+
+void StepArenaAllocator::DeallocateRaw(void* ptr) {
+  Block* block = reinterpret_cast<Block*>(reinterpret_cast<uintptr_t>(ptr) &
+                                          ~(kBlockSize - 1));
+  DCHECK_EQ(block->arena, this);
+  UnrefBlock(block);
+}
+
+void StepArenaAllocator::Release() {
+  std::vector<Block*> blocks;
+  {
+    mutex_lock l(mu_);
+    blocks.swap(blocks_);
+    current_.store(nullptr, std::memory_order_relaxed);
+  }
+  for (Block* block : blocks) {
+    UnrefBlock(block);
+  }
+  UnrefArena();
+}
+
+void StepArenaAllocator::UnrefBlock(Block* block) {
+  if (block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    block->~Block();
+    pool_->Put(block);
+    UnrefArena();
+  }
+}
+
+void StepArenaAllocator::UnrefArena() {
+  if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete this;
+  }
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,132 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_STEP_ARENA_ALLOCATOR_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_STEP_ARENA_ALLOCATOR_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/lib/core/refcount.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// Returns true if the TF_CPU_STEP_ARENA environment variable enables step
+// arenas for CPU executors.
+bool StepArenaEnabled();
+
+// An allocator for small tensors that are not expected to outlive one step of
+// an executor. It bump-allocates from fixed-size blocks, never reuses memory
+// within the step, and recycles all of its blocks at once after the step.
+//
+// Each block counts its live allocations plus one reference that the arena
+// holds until Release(). A block goes back to the BlockPool when its count
+// drops to zero. A tensor that does outlive the step therefore stays valid;
+// it only keeps its block from being recycled until it is freed. The
+// allocator deletes itself once it has been released and all of its blocks
+// have been recycled.
+//
+// AllocateRaw() is thread-safe and lock-free except when a block fills up.
+// It only serves requests of up to kMaxAllocationSize bytes and returns
+// nullptr for larger ones or when no block is available, so callers must be
+// prepared to fall back to the device allocator.
+class StepArenaAllocator : public Allocator {
+ public:
+  static constexpr size_t kBlockSize = 1 << 20;
+  static constexpr size_t kMaxAllocationSize = 64 << 10;
+  static constexpr size_t kMaxAlignment = 4096;
+
+  // Recycles arena blocks across the steps of one executor. Blocks are
+  // allocated from `base` aligned to kBlockSize, so that the block of any
+  // pointer can be found by masking.
+  class BlockPool : public core::RefCounted {
+   public:
+    explicit BlockPool(Allocator* base) : base_(base) {}
+    ~BlockPool() override;
+
+    // Returns a block of kBlockSize bytes, or nullptr if `base` cannot
+    // provide a suitably aligned one. The first misaligned block disables the
+    // pool for good, so that later calls do not allocate from `base` again.
+    void* Get();
+    void Put(void* block);
+
+    Allocator* base() const { return base_; }
+
+   private:
+    // Blocks beyond this many are returned to `base_`.
+    static constexpr size_t kMaxPooledBlocks = 16;
+
+    Allocator* const base_;  // Not owned.
+    // Set once `base_` has returned a block that is not aligned to
+    // kBlockSize.
+    std::atomic<bool> disabled_{false};
+    mutex mu_;
+    std::vector<void*> free_blocks_ TF_GUARDED_BY(mu_);
+  };
+
+  // Takes a reference on `pool`.
+  explicit StepArenaAllocator(BlockPool* pool);
+
+  // Called at the end of the step. The allocator must not be used for new
+  // allocations afterwards, and may have been deleted when this returns.
+  void Release();
+
+  std::string Name() override { return "step_arena"; }
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override;
+  void DeallocateRaw(void* ptr) override;
+  AllocatorMemoryType GetMemoryType() const override {
+    return pool_->base()->GetMemoryType();
+  }
+
+ private:
+  // Header at the start of every block.
+  struct Block {
+    // Live allocations, plus one until the arena is released.
+    std::atomic<int64_t> refs;
+    // Offset of the first free byte from the start of the block.
+    std::atomic<size_t> offset;
+    StepArenaAllocator* arena;
+  };
+  static constexpr size_t kBlockHeaderSize = 64;
+  static_assert(sizeof(Block) <= kBlockHeaderSize);
+
+  ~StepArenaAllocator() override;
+
+  // Installs a fresh block if `full` is still the current block.
+  bool AddBlock(Block* full);
+  void UnrefBlock(Block* block);
+  void UnrefArena();
+
+  BlockPool* const pool_;
+  std::atomic<Block*> current_{nullptr};
+  // Blocks in the arena, plus one until the arena is released.
+  std::atomic<int64_t> refs_{1};
+
+  mutex mu_;
+  std::vector<Block*> blocks_ TF_GUARDED_BY(mu_);
+
+  StepArenaAllocator(const StepArenaAllocator&) = delete;
+  void operator=(const StepArenaAllocator&) = delete;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_STEP_ARENA_ALLOCATOR_H_
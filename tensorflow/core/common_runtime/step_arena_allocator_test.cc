@@ -0,0 +1,191 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/step_arena_allocator.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/refcount.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/threadpool.h"
+
+namespace tensorflow {
+namespace {
+
+// Counts the blocks handed out by the base allocator.
+class CountingAllocator : public Allocator {
+ public:
+  std::string Name() override { return "counting"; }
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    ++num_allocations_;
+    return cpu_allocator()->AllocateRaw(alignment, num_bytes);
+  }
+  void DeallocateRaw(void* ptr) override {
+    ++num_deallocations_;
+    cpu_allocator()->DeallocateRaw(ptr);
+  }
+
+  int num_allocations_ = 0;
+  int num_deallocations_ = 0;
+};
+
+// Ignores the requested alignment, like a BFCAllocator that caps it.
+class MisalignedAllocator : public CountingAllocator {
+ public:
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    char* p = static_cast<char*>(
+        CountingAllocator::AllocateRaw(alignment, num_bytes + 256));
+    return p + 256;
+  }
+  void DeallocateRaw(void* ptr) override {
+    CountingAllocator::DeallocateRaw(static_cast<char*>(ptr) - 256);
+  }
+};
+
+TEST(StepArenaAllocatorTest, MisalignedBaseDisablesPool) {
+  MisalignedAllocator base;
+  core::RefCountPtr<StepArenaAllocator::BlockPool> pool(
+      new StepArenaAllocator::BlockPool(&base));
+  for (int step = 0; step < 3; ++step) {
+    auto* arena = new StepArenaAllocator(pool.get());
+    EXPECT_EQ(arena->AllocateRaw(64, 1024), nullptr);
+    arena->Release();
+  }
+  // Only the first block was requested from the base allocator.
+  EXPECT_EQ(base.num_allocations_, 1);
+  EXPECT_EQ(base.num_deallocations_, 1);
+}
+
+TEST(StepArenaAllocatorTest, BumpAllocatesAligned) {
+  CountingAllocator base;
+  core::RefCountPtr<StepArenaAllocator::BlockPool> pool(
+      new StepArenaAllocator::BlockPool(&base));
+  auto* arena = new StepArenaAllocator(pool.get());
+
+  std::vector<void*> ptrs;
+  for (size_t alignment : {1, 8, 64, 256, 4096}) {
+    void* p = arena->AllocateRaw(alignment, 100);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % alignment, 0);
+    memset(p, 0xab, 100);
+    ptrs.push_back(p);
+  }
+  EXPECT_EQ(base.num_allocations_, 1);
+  for (void* p : ptrs) arena->DeallocateRaw(p);
+  arena->Release();
+
+  // The block is kept by the pool for the next step.
+  EXPECT_EQ(base.num_deallocations_, 0);
+  arena = new StepArenaAllocator(pool.get());
+  void* p = arena->AllocateRaw(64, 1024);
+  EXPECT_NE(p, nullptr);
+  EXPECT_EQ(base.num_allocations_, 1);
+  arena->DeallocateRaw(p);
+  arena->Release();
+}
+
+TEST(StepArenaAllocatorTest, RejectsLargeRequests) {
+  core::RefCountPtr<StepArenaAllocator::BlockPool> pool(
+      new StepArenaAllocator::BlockPool(cpu_allocator()));
+  auto* arena = new StepArenaAllocator(pool.get());
+  EXPECT_EQ(arena->AllocateRaw(64, StepArenaAllocator::kMaxAllocationSize + 1),
+            nullptr);
+  EXPECT_EQ(arena->AllocateRaw(2 * StepArenaAllocator::kMaxAlignment, 64),
+            nullptr);
+  EXPECT_EQ(arena->AllocateRaw(64, 0), nullptr);
+  arena->Release();
+}
+
+TEST(StepArenaAllocatorTest, SpansMultipleBlocks) {
+  CountingAllocator base;
+  core::RefCountPtr<StepArenaAllocator::BlockPool> pool(
+      new StepArenaAllocator::BlockPool(&base));
+  auto* arena = new StepArenaAllocator(pool.get());
+  const int kNumAllocations = 3 * StepArenaAllocator::kBlockSize /
+                              StepArenaAllocator::kMaxAllocationSize;
+  std::vector<void*> ptrs;
+  for (int i = 0; i < kNumAllocations; ++i) {
+    void* p = arena->AllocateRaw(64, StepArenaAllocator::kMaxAllocationSize);
+    ASSERT_NE(p, nullptr);
+    ptrs.push_back(p);
+  }
+  EXPECT_GE(base.num_allocations_, 3);
+  for (void* p : ptrs) arena->DeallocateRaw(p);
+  arena->Release();
+  EXPECT_EQ(base.num_deallocations_, 0);
+  pool.reset();
+  EXPECT_EQ(base.num_deallocations_, base.num_allocations_);
+}
+
+TEST(StepArenaAllocatorTest, TensorOutlivesStep) {
+  CountingAllocator base;
+  core::RefCountPtr<StepArenaAllocator::BlockPool> pool(
+      new StepArenaAllocator::BlockPool(&base));
+  auto* arena = new StepArenaAllocator(pool.get());
+  Tensor escaped(arena, DT_FLOAT, TensorShape({16}));
+  {
+    Tensor temp(arena, DT_FLOAT, TensorShape({16}));
+    temp.flat<float>().setConstant(1.0f);
+  }
+  escaped.flat<float>().setConstant(2.0f);
+  arena->Release();
+
+  // The block stays alive, and is not reused, while `escaped` is.
+  auto* next = new StepArenaAllocator(pool.get());
+  Tensor other(next, DT_FLOAT, TensorShape({16}));
+  other.flat<float>().setConstant(3.0f);
+  test::ExpectTensorEqual<float>(
+      escaped, test::AsTensor<float>(std::vector<float>(16, 2.0f)));
+  EXPECT_EQ(base.num_allocations_, 2);
+  other = Tensor();
+  next->Release();
+
+  escaped = Tensor();
+  pool.reset();
+  EXPECT_EQ(base.num_deallocations_, base.num_allocations_);
+}
+
+TEST(StepArenaAllocatorTest, ConcurrentAllocations) {
+  core::RefCountPtr<StepArenaAllocator::BlockPool> pool(
+      new StepArenaAllocator::BlockPool(cpu_allocator()));
+  auto* arena = new StepArenaAllocator(pool.get());
+  {
+    thread::ThreadPool threads(Env::Default(), "step_arena_test", 8);
+    for (int t = 0; t < 8; ++t) {
+      threads.Schedule([arena, t]() {
+        std::vector<char*> ptrs;
+        for (int i = 0; i < 1000; ++i) {
+          char* p = static_cast<char*>(arena->AllocateRaw(16, 256));
+          ASSERT_NE(p, nullptr);
+          memset(p, t, 256);
+          ptrs.push_back(p);
+        }
+        for (char* p : ptrs) {
+          for (int j = 0; j < 256; ++j) ASSERT_EQ(p[j], t);
+          arena->DeallocateRaw(p);
+        }
+      });
+    }
+  }
+  arena->Release();
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -0,0 +1,385 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/step_memory_plan.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/log/log.h"
+#include "tensorflow/core/framework/node_def_util.h"
+#include "tensorflow/core/framework/op.h"
+#include "tensorflow/core/framework/shape_inference.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+
+namespace {
+
+// Graphs with more nodes are not planned, to bound the cost of the
+// reachability analysis in Build().
+constexpr int kMaxPlannedNodes = 8192;
+// At most this many outputs are planned, largest first.
+constexpr size_t kMaxPlannedOutputs = 4096;
+// Constants with at most this many elements are passed to shape functions,
+// which may need their values (e.g. the shape input of Reshape).
+constexpr int64_t kMaxShapeConstantElements = 1024;
+
+size_t AlignSlot(size_t bytes) {
+  constexpr size_t kAlignment = Allocator::kAllocatorAlignment;
+  return (bytes + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+// Infers the output shapes of the nodes in `order`, which must be
+// topologically sorted, with the registered shape functions. Shapes that
+// cannot be inferred are left unknown.
+void InferOutputShapes(const Graph& graph, const std::vector<Node*>& order,
+                       std::vector<std::vector<PartialTensorShape>>* shapes) {
+  shapes->resize(graph.num_node_ids());
+  std::vector<std::unique_ptr<Tensor>> constants(graph.num_node_ids());
+  for (const Node* n : order) {
+    std::vector<PartialTensorShape>& output_shapes = (*shapes)[n->id()];
+    output_shapes.resize(n->num_outputs());
+
+    if (n->IsConstant()) {
+      const TensorProto* proto;
+      TensorShape shape;
+      if (!GetNodeAttr(n->attrs(), "value", &proto).ok() ||
+          !TensorShape::BuildTensorShape(proto->tensor_shape(), &shape).ok()) {
+        continue;
+      }
+      output_shapes[0] = shape;
+      if (shape.num_elements() <= kMaxShapeConstantElements) {
+        auto constant = std::make_unique<Tensor>();
+        if (constant->FromProto(*proto)) {
+          constants[n->id()] = std::move(constant);
+        }
+      }
+      continue;
+    }
+
+    std::vector<PartialTensorShape> attr_shapes;
+    if (n->attrs().Find("_output_shapes") != nullptr &&
+        GetNodeAttr(n->attrs(), "_output_shapes", &attr_shapes).ok() &&
+        attr_shapes.size() == n->num_outputs()) {
+      output_shapes = attr_shapes;
+      if (std::all_of(output_shapes.begin(), output_shapes.end(),
+                      [](const PartialTensorShape& shape) {
+                        return shape.IsFullyDefined();
+                      })) {
+        continue;
+      }
+    }
+
+    const OpRegistrationData* op_reg_data;
+    if (!graph.op_registry()->LookUp(n->type_string(), &op_reg_data).ok() ||
+        op_reg_data->shape_inference_fn == nullptr) {
+      continue;
+    }
+    std::vector<PartialTensorShape> input_shapes(n->num_inputs());
+    std::vector<const Tensor*> input_tensors(n->num_inputs(), nullptr);
+    for (const Edge* e : n->in_edges()) {
+      if (e->IsControlEdge()) continue;
+      input_shapes[e->dst_input()] =
+          (*shapes)[e->src()->id()][e->src_output()];
+      if (e->src_output() == 0) {
+        input_tensors[e->dst_input()] = constants[e->src()->id()].get();
+      }
+    }
+    shape_inference::InferenceContext c(
+        graph.versions().producer(), n->attrs(), n->op_def(), input_shapes,
+        input_tensors, /*input_tensors_as_shapes=*/{},
+        /*input_handle_shapes_and_types=*/{});
+    if (!c.construction_status().ok() ||
+        !c.Run(op_reg_data->shape_inference_fn).ok()) {
+      continue;
+    }
+    for (int i = 0; i < n->num_outputs(); ++i) {
+      if (output_shapes[i].IsFullyDefined()) continue;
+      TensorShapeProto proto;
+      c.ShapeHandleToProto(c.output(i), &proto);
+      PartialTensorShape shape;
+      if (PartialTensorShape::BuildPartialTensorShape(proto, &shape).ok()) {
+        output_shapes[i] = std::move(shape);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+bool StaticMemoryPlanEnabled() {
+  static const bool static_memory_plan_enabled = [] {
+    bool flag;
+    auto status = ReadBoolFromEnvVar("TF_CPU_STATIC_MEMORY_PLAN",
+                                     /*default_val=*/false, &flag);
+    if (!status.ok()) {
+      LOG(ERROR) << "StaticMemoryPlanEnabled: " << status.message();
+      return false;
+    }
+    return flag;
+  }();
+  return static_memory_plan_enabled;
+}
+
+// Serves the allocation of whichever planned output currently owns a slot.
+class StepMemoryPlan::StepBuffer::SlotAllocator : public Allocator {
+ public:
+  std::string Name() override { return "step_memory_plan"; }
+
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    if (num_bytes > size_ || reinterpret_cast<uintptr_t>(ptr_) % alignment) {
+      return nullptr;
+    }
+    bool expected = false;
+    if (!in_use_.compare_exchange_strong(expected, true,
+                                         std::memory_order_acquire)) {
+      return nullptr;
+    }
+    buffer_->Ref();
+    return ptr_;
+  }
+
+  void DeallocateRaw(void* ptr) override {
+    DCHECK_EQ(ptr, ptr_);
+    in_use_.store(false, std::memory_order_release);
+    buffer_->Unref();
+  }
+
+  AllocatorMemoryType GetMemoryType() const override {
+    return buffer_->plan_->base_->GetMemoryType();
+  }
+
+ private:
+  friend class StepBuffer;
+
+  StepBuffer* buffer_ = nullptr;
+  char* ptr_ = nullptr;
+  size_t size_ = 0;
+  std::atomic<bool> in_use_{false};
+};
+
+StepMemoryPlan::StepBuffer::StepBuffer(StepMemoryPlan* plan, char* memory)
+    : plan_(plan),
+      memory_(memory),
+      slot_allocators_(new SlotAllocator[plan->num_slots()]) {
+  for (int i = 0; i < plan_->num_slots(); ++i) {
+    slot_allocators_[i].buffer_ = this;
+    slot_allocators_[i].ptr_ = memory_ + plan_->slot_offsets_[i];
+    slot_allocators_[i].size_ = plan_->slot_sizes_[i];
+  }
+  output_allocators_.reserve(plan_->output_slots_.size());
+  for (int32_t slot : plan_->output_slots_) {
+    output_allocators_.push_back(slot < 0 ? nullptr : &slot_allocators_[slot]);
+  }
+}
+
+StepMemoryPlan::StepBuffer::~StepBuffer() {
+  plan_->base_->DeallocateRaw(memory_);
+}
+
+void StepMemoryPlan::StepBuffer::Unref() {
+  if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    StepMemoryPlan* plan = plan_;
+    plan->Recycle(this);
+    plan->Unref();
+  }
+}
+
+StepMemoryPlan::~StepMemoryPlan() {
+  mutex_lock l(mu_);
+  for (StepBuffer* buffer : free_buffers_) {
+    delete buffer;
+  }
+}
+
+StepMemoryPlan::StepBuffer* StepMemoryPlan::AcquireBuffer() {
+  StepBuffer* buffer = nullptr;
+  {
+    mutex_lock l(mu_);
+    if (!free_buffers_.empty()) {
+      buffer = free_buffers_.back();
+      free_buffers_.pop_back();
+    }
+  }
+  if (buffer != nullptr) {
+    buffer->refs_.store(1, std::memory_order_relaxed);
+  } else {
+    void* memory =
+        base_->AllocateRaw(Allocator::kAllocatorAlignment, total_bytes_);
+    if (memory == nullptr) {
+      return nullptr;
+    }
+    buffer = new StepBuffer(this, static_cast<char*>(memory));
+  }
+  Ref();
+  return buffer;
+}
+
+void StepMemoryPlan::Recycle(StepBuffer* buffer) {
+  {
+    mutex_lock l(mu_);
+    if (free_buffers_.size() < kMaxPooledBuffers) {
+      free_buffers_.push_back(buffer);
+      return;
+    }
+  }
+  delete buffer;
+}
+
+core::RefCountPtr<StepMemoryPlan> StepMemoryPlan::Build(const Graph& graph,
+                                                        const GraphView& gview,
+                                                        Allocator* base) {
+  const int num_node_ids = graph.num_node_ids();
+  if (num_node_ids > kMaxPlannedNodes) {
+    VLOG(1) << "Not planning memory for a graph with " << num_node_ids
+            << " nodes";
+    return nullptr;
+  }
+  std::vector<Node*> order;
+  GetReversePostOrder(graph, &order);
+  std::vector<std::vector<PartialTensorShape>> shapes;
+  InferOutputShapes(graph, order, &shapes);
+
+  struct PlannedOutput {
+    const Node* node;
+    int output;
+    size_t bytes;
+  };
+  std::vector<PlannedOutput> outputs;
+  for (const Node* n : order) {
+    // Constants and arguments set their outputs without allocating them, and
+    // identities forward their input.
+    if (n->IsSource() || n->IsSink() || n->IsConstant() || n->IsArg() ||
+        n->IsIdentity()) {
+      continue;
+    }
+    const NodeItem* item = gview.node(n->id());
+    if (item == nullptr || item->outputs_step_local == nullptr) continue;
+    for (int i = 0; i < n->num_outputs(); ++i) {
+      const PartialTensorShape& shape = shapes[n->id()][i];
+      if (!item->outputs_step_local[i] || !shape.IsFullyDefined()) continue;
+      const int64_t bytes =
+          DataTypeSize(BaseType(n->output_type(i))) * shape.num_elements();
+      if (bytes <= 0) continue;
+      outputs.push_back({n, i, AlignSlot(bytes)});
+    }
+  }
+  if (outputs.empty()) {
+    return nullptr;
+  }
+  std::stable_sort(outputs.begin(), outputs.end(),
+                   [](const PlannedOutput& a, const PlannedOutput& b) {
+                     return a.bytes > b.bytes;
+                   });
+  if (outputs.size() > kMaxPlannedOutputs) {
+    outputs.resize(kMaxPlannedOutputs);
+  }
+
+  // ancestors[id] has bit j set if node j must finish before node id starts.
+  const int num_words = (num_node_ids + 63) / 64;
+  std::vector<uint64_t> ancestors(static_cast<size_t>(num_node_ids) *
+                                  num_words);
+  auto ancestors_of = [&](int id) {
+    return &ancestors[static_cast<size_t>(id) * num_words];
+  };
+  auto is_ancestor = [&](int id, const uint64_t* bits) {
+    return (bits[id / 64] >> (id % 64)) & 1;
+  };
+  for (const Node* n : order) {
+    uint64_t* bits = ancestors_of(n->id());
+    for (const Edge* e : n->in_edges()) {
+      const int src_id = e->src()->id();
+      const uint64_t* src_bits = ancestors_of(src_id);
+      for (int w = 0; w < num_words; ++w) bits[w] |= src_bits[w];
+      bits[src_id / 64] |= uint64_t{1} << (src_id % 64);
+    }
+  }
+
+  // Returns true if `a` is dead before the producer of `b` starts, i.e. if
+  // all of its consumers, or its producer if it has none, are ancestors of
+  // that producer.
+  auto dead_before = [&](const PlannedOutput& a, const PlannedOutput& b) {
+    const uint64_t* bits = ancestors_of(b.node->id());
+    bool has_consumer = false;
+    for (const Edge* e : a.node->out_edges()) {
+      if (e->IsControlEdge() || e->src_output() != a.output) continue;
+      has_consumer = true;
+      if (!is_ancestor(e->dst()->id(), bits)) return false;
+    }
+    return has_consumer || is_ancestor(a.node->id(), bits);
+  };
+
+  // Greedy by size: place each output in the first slot whose outputs are
+  // all dead before it is produced, or produced after it is dead. Slots are
+  // created by their largest output, so every later output fits.
+  std::vector<std::vector<int>> slot_outputs;
+  std::vector<int> output_slot(outputs.size());
+  for (int i = 0; i < outputs.size(); ++i) {
+    int slot = 0;
+    for (; slot < slot_outputs.size(); ++slot) {
+      if (std::all_of(slot_outputs[slot].begin(), slot_outputs[slot].end(),
+                      [&](int j) {
+                        return dead_before(outputs[j], outputs[i]) ||
+                               dead_before(outputs[i], outputs[j]);
+                      })) {
+        break;
+      }
+    }
+    if (slot == slot_outputs.size()) slot_outputs.emplace_back();
+    slot_outputs[slot].push_back(i);
+    output_slot[i] = slot;
+  }
+
+  core::RefCountPtr<StepMemoryPlan> plan(new StepMemoryPlan(base));
+  size_t unplanned_bytes = 0;
+  for (const std::vector<int>& members : slot_outputs) {
+    const size_t size = outputs[members.front()].bytes;
+    plan->slot_offsets_.push_back(plan->total_bytes_);
+    plan->slot_sizes_.push_back(size);
+    plan->total_bytes_ += size;
+    for (int i : members) unplanned_bytes += outputs[i].bytes;
+  }
+  plan->num_planned_outputs_ = outputs.size();
+  plan->node_output_start_.assign(num_node_ids, -1);
+  for (int i = 0; i < outputs.size(); ++i) {
+    const Node* n = outputs[i].node;
+    int32_t& start = plan->node_output_start_[n->id()];
+    if (start < 0) {
+      start = plan->output_slots_.size();
+      plan->output_slots_.resize(start + n->num_outputs(), -1);
+    }
+    plan->output_slots_[start + outputs[i].output] = output_slot[i];
+  }
+  VLOG(1) << "Planned " << outputs.size() << " outputs into "
+          << slot_outputs.size() << " slots of " << plan->total_bytes_
+          << " bytes in total, instead of " << unplanned_bytes << " bytes";
+  return plan;
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,134 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_STEP_MEMORY_PLAN_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_STEP_MEMORY_PLAN_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/graph_view.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/lib/core/refcount.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// Returns true if the TF_CPU_STATIC_MEMORY_PLAN environment variable enables
+// static memory plans for CPU executors.
+bool StaticMemoryPlanEnabled();
+
+// An ahead-of-time memory plan for the outputs of a graph without control
+// flow, similar to the TFLite arena planner.
+//
+// Build() infers the static shape of every output marked in
+// `NodeItem::outputs_step_local`, and assigns each such output to a slot of
+// one contiguous buffer, greedily by decreasing size. Two outputs share a
+// slot only if every consumer of one is an ancestor of the producer of the
+// other, so the executor can never run them at the same time.
+//
+// Each step acquires a StepBuffer, which reserves one allocator per slot.
+// A slot allocator serves a single allocation at a time and returns nullptr
+// while its slot is in use, e.g. when a kernel forwarded a planned buffer to
+// an output that outlives its planned lifetime. Callers must then fall back
+// to another allocator.
+class StepMemoryPlan : public core::RefCounted {
+ public:
+  class StepBuffer;
+
+  // Returns a plan for the outputs of `graph` that can be planned, or null
+  // if there are none. `gview` must have been initialized from `graph`.
+  // Buffers are allocated from `base`.
+  static core::RefCountPtr<StepMemoryPlan> Build(const Graph& graph,
+                                                 const GraphView& gview,
+                                                 Allocator* base);
+
+  // Returns a buffer for one step, or nullptr if it cannot be allocated.
+  StepBuffer* AcquireBuffer();
+
+  size_t total_bytes() const { return total_bytes_; }
+  int num_slots() const { return slot_offsets_.size(); }
+  int num_planned_outputs() const { return num_planned_outputs_; }
+
+ private:
+  // Buffers beyond this many are returned to `base_` when released.
+  static constexpr size_t kMaxPooledBuffers = 4;
+
+  explicit StepMemoryPlan(Allocator* base) : base_(base) {}
+  ~StepMemoryPlan() override;
+
+  void Recycle(StepBuffer* buffer);
+
+  Allocator* const base_;  // Not owned.
+  size_t total_bytes_ = 0;
+  int num_planned_outputs_ = 0;
+  std::vector<size_t> slot_offsets_;
+  std::vector<size_t> slot_sizes_;
+  // For each node id, the index in `output_slots_` of the node's first
+  // output, or -1 if none of its outputs is planned.
+  std::vector<int32_t> node_output_start_;
+  // The slot of each output, or -1 if the output is not planned.
+  std::vector<int32_t> output_slots_;
+
+  mutex mu_;
+  std::vector<StepBuffer*> free_buffers_ TF_GUARDED_BY(mu_);
+
+  StepMemoryPlan(const StepMemoryPlan&) = delete;
+  void operator=(const StepMemoryPlan&) = delete;
+};
+
+// The memory of a StepMemoryPlan for one step. The buffer stays alive until
+// the step has released it and every allocation in it has been freed.
+class StepMemoryPlan::StepBuffer {
+ public:
+  // If non-null, the ith entry is the allocator reserved for output i of
+  // node `node_id`, or null if that output is not planned.
+  Allocator* const* output_allocators(int node_id) const {
+    const int32_t start = plan_->node_output_start_[node_id];
+    return start < 0 ? nullptr : &output_allocators_[start];
+  }
+
+  // Called at the end of the step.
+  void Release() { Unref(); }
+
+ private:
+  friend class StepMemoryPlan;
+  class SlotAllocator;
+
+  StepBuffer(StepMemoryPlan* plan, char* memory);
+  ~StepBuffer();
+
+  void Ref() { refs_.fetch_add(1, std::memory_order_relaxed); }
+  void Unref();
+
+  StepMemoryPlan* const plan_;
+  char* const memory_;
+  std::unique_ptr<SlotAllocator[]> slot_allocators_;
+  std::vector<Allocator*> output_allocators_;
+  // Live allocations, plus one while a step uses the buffer.
+  std::atomic<int64_t> refs_{1};
+
+  StepBuffer(const StepBuffer&) = delete;
+  void operator=(const StepBuffer&) = delete;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_STEP_MEMORY_PLAN_H_
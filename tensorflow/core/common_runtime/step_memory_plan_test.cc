@@ -0,0 +1,138 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/step_memory_plan.h"
+
+#include <memory>
+
+#include "tensorflow/core/common_runtime/graph_view.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class StepMemoryPlanTest : public ::testing::Test {
+ protected:
+  StepMemoryPlanTest() : graph_(new Graph(OpRegistry::Global())) {}
+
+  // Initializes `gview_` and marks every output as step-local.
+  void InitializeGraphView() {
+    TF_ASSERT_OK(gview_.Initialize(graph_.get()));
+    for (const Node* n : graph_->nodes()) {
+      NodeItem* item = gview_.node(n->id());
+      if (item == nullptr || n->num_outputs() == 0) continue;
+      item->outputs_step_local.reset(new bool[n->num_outputs()]);
+      for (int i = 0; i < n->num_outputs(); ++i) {
+        item->outputs_step_local[i] = true;
+      }
+    }
+  }
+
+  std::unique_ptr<Graph> graph_;
+  GraphView gview_;
+};
+
+TEST_F(StepMemoryPlanTest, ReusesSlotsAlongAChain) {
+  Node* c = test::graph::Constant(graph_.get(),
+                                  Tensor(DT_FLOAT, TensorShape({1024})));
+  Node* a = test::graph::Unary(graph_.get(), "Neg", c);
+  Node* b = test::graph::Unary(graph_.get(), "Neg", a);
+  Node* d = test::graph::Unary(graph_.get(), "Neg", b);
+  Node* e = test::graph::Unary(graph_.get(), "Neg", d);
+  InitializeGraphView();
+
+  core::RefCountPtr<StepMemoryPlan> plan =
+      StepMemoryPlan::Build(*graph_, gview_, cpu_allocator());
+  ASSERT_NE(plan.get(), nullptr);
+  EXPECT_EQ(plan->num_planned_outputs(), 4);
+  // Each output is only live together with its producer's input.
+  EXPECT_EQ(plan->num_slots(), 2);
+  EXPECT_EQ(plan->total_bytes(), 2 * 1024 * sizeof(float));
+
+  StepMemoryPlan::StepBuffer* buffer = plan->AcquireBuffer();
+  ASSERT_NE(buffer, nullptr);
+  EXPECT_EQ(buffer->output_allocators(c->id()), nullptr);
+  Allocator* a_allocator = buffer->output_allocators(a->id())[0];
+  Allocator* b_allocator = buffer->output_allocators(b->id())[0];
+  ASSERT_NE(a_allocator, nullptr);
+  ASSERT_NE(b_allocator, nullptr);
+  EXPECT_NE(a_allocator, b_allocator);
+  EXPECT_EQ(buffer->output_allocators(d->id())[0], a_allocator);
+  EXPECT_EQ(buffer->output_allocators(e->id())[0], b_allocator);
+  buffer->Release();
+}
+
+TEST_F(StepMemoryPlanTest, SlotServesOneAllocationAtATime) {
+  Node* c = test::graph::Constant(graph_.get(),
+                                  Tensor(DT_FLOAT, TensorShape({256})));
+  Node* a = test::graph::Unary(graph_.get(), "Neg", c);
+  Node* b = test::graph::Unary(graph_.get(), "Neg", a);
+  Node* d = test::graph::Unary(graph_.get(), "Neg", b);
+  test::graph::Unary(graph_.get(), "Neg", d);
+  InitializeGraphView();
+
+  core::RefCountPtr<StepMemoryPlan> plan =
+      StepMemoryPlan::Build(*graph_, gview_, cpu_allocator());
+  ASSERT_NE(plan.get(), nullptr);
+  StepMemoryPlan::StepBuffer* buffer = plan->AcquireBuffer();
+  ASSERT_NE(buffer, nullptr);
+  Allocator* a_allocator = buffer->output_allocators(a->id())[0];
+  Allocator* d_allocator = buffer->output_allocators(d->id())[0];
+  ASSERT_EQ(a_allocator, d_allocator);
+
+  Tensor a_out(a_allocator, DT_FLOAT, TensorShape({256}));
+  ASSERT_TRUE(a_out.IsInitialized());
+  // `a_out` outlives its planned lifetime, so `d` cannot use the slot.
+  Tensor d_out(d_allocator, DT_FLOAT, TensorShape({256}));
+  EXPECT_FALSE(d_out.IsInitialized());
+  // Requests larger than the slot are rejected.
+  Tensor too_large(a_allocator, DT_FLOAT, TensorShape({257}));
+  EXPECT_FALSE(too_large.IsInitialized());
+
+  a_out.flat<float>().setConstant(1.0f);
+  buffer->Release();
+  // The buffer stays alive while `a_out` is.
+  EXPECT_EQ(a_out.flat<float>()(255), 1.0f);
+  a_out = Tensor();
+
+  // The released buffer is reused for the next step.
+  StepMemoryPlan::StepBuffer* next = plan->AcquireBuffer();
+  EXPECT_EQ(next, buffer);
+  Tensor d_next(next->output_allocators(d->id())[0], DT_FLOAT,
+                TensorShape({256}));
+  EXPECT_TRUE(d_next.IsInitialized());
+  d_next = Tensor();
+  next->Release();
+}
+
+TEST_F(StepMemoryPlanTest, SkipsUnknownShapes) {
+  Node* p;
+  TF_ASSERT_OK(NodeBuilder("p", "Placeholder")
+                   .Attr("dtype", DT_FLOAT)
+                   .Attr("shape", PartialTensorShape({-1, 4}))
+                   .Finalize(graph_.get(), &p));
+  test::graph::Unary(graph_.get(), "Neg", p);
+  InitializeGraphView();
+  EXPECT_EQ(StepMemoryPlan::Build(*graph_, gview_, cpu_allocator()).get(),
+            nullptr);
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -15,6 +15,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
 
 #include <memory>
+#include <thread>  // NOLINT(build/c++11)
 
 #include "tensorflow/core/common_runtime/costmodel_manager.h"
 #include "tensorflow/core/framework/allocation_description.pb.h"
@@ -29,6 +30,8 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/scanner.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/device_name_utils.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace {
@@ -49,6 +52,12 @@ bool IsSend(const NodeDef* node) {
   return node->op() == "_Send" || node->op() == "_HostSend";
 }
 
+bool IsCpuDevice(const std::string& device) {
+  DeviceNameUtils::ParsedName parsed;
+  return DeviceNameUtils::ParseFullName(device, &parsed) &&
+         parsed.type == DEVICE_CPU;
+}
+
 }  // namespace
 
 NodeExecStatsWrapper::NodeExecStatsWrapper(
@@ -106,6 +115,11 @@ void NodeExecStatsWrapper::Done(const std::string& device) {
                            absl::StrJoin(node_->input(), ", "), ")");
   }
   stats_->set_timeline_label(text);
+  // The counters only describe the work of CPU kernels; other kernels merely
+  // enqueue theirs.
+  if (stats_->has_hardware_counters() && !IsCpuDevice(device)) {
+    stats_->clear_hardware_counters();
+  }
   step_stats_collector_->Save(device, this);
 }
 
@@ -122,6 +136,15 @@ void NodeExecStatsWrapper::RecordComputeStarted() {
   stats_->set_op_start_rel_micros(now_nanos / EnvTime::kMicrosToNanos -
                                   stats_->all_start_micros());
   stats_->set_op_start_rel_nanos(now_nanos - stats_->all_start_nanos());
+  if (step_stats_collector_ != nullptr &&
+      step_stats_collector_->collect_hardware_counters()) {
+    hardware_counters_ = ThreadHardwareCounters::ForCurrentThread();
+    hardware_counters_thread_ = std::this_thread::get_id();
+    if (hardware_counters_ != nullptr &&
+        !hardware_counters_->Read(&hardware_counters_start_)) {
+      hardware_counters_ = nullptr;
+    }
+  }
 }
 
 void NodeExecStatsWrapper::RecordComputeEnded() {
@@ -131,6 +154,24 @@ void NodeExecStatsWrapper::RecordComputeEnded() {
   stats_->set_op_end_rel_micros(now_nanos / EnvTime::kMicrosToNanos -
                                 stats_->all_start_micros());
   stats_->set_op_end_rel_nanos(now_nanos - stats_->all_start_nanos());
+  if (hardware_counters_ != nullptr) {
+    // Asynchronous kernels may finish on another thread, whose counters are
+    // unrelated to the ones read at the start. Comparing thread ids avoids
+    // opening counters on threads that never start kernels.
+    HardwareCounterValues end;
+    if (std::this_thread::get_id() == hardware_counters_thread_ &&
+        hardware_counters_->Read(&end)) {
+      HardwareCounters* counters = stats_->mutable_hardware_counters();
+      counters->set_cycles(end.cycles - hardware_counters_start_.cycles);
+      counters->set_instructions(end.instructions -
+                                 hardware_counters_start_.instructions);
+      counters->set_llc_misses(end.llc_misses -
+                               hardware_counters_start_.llc_misses);
+      counters->set_branch_misses(end.branch_misses -
+                                  hardware_counters_start_.branch_misses);
+    }
+    hardware_counters_ = nullptr;
+  }
 }
 
 void NodeExecStatsWrapper::RecordExecutorEnded() {
@@ -195,7 +236,20 @@ void NodeExecStatsWrapper::Finalize() {
 }
 
 StepStatsCollector::StepStatsCollector(StepStats* step_stats)
-    : finalized_(false), step_stats_(step_stats) {}
+    : finalized_(false), step_stats_(step_stats) {
+  // A collector is created for every traced step, so the variable is only
+  // read once.
+  static const bool collect_hardware_counters = [] {
+    bool collect = false;
+    absl::Status status =
+        ReadBoolFromEnvVar("TF_STEP_STATS_HARDWARE_COUNTERS", false, &collect);
+    if (!status.ok()) {
+      LOG(ERROR) << "StepStatsCollector: " << status.message();
+    }
+    return collect;
+  }();
+  collect_hardware_counters_ = collect_hardware_counters;
+}
 
 static int ExtractGpuWithStreamAll(std::string device_name) {
   // Check if the device name matches the ".*gpu:(\\d+)/stream:all$" regexp,
@@ -16,9 +16,11 @@ limitations under the License.
 #define TENSORFLOW_CORE_COMMON_RUNTIME_STEP_STATS_COLLECTOR_H_
 
 #include <memory>
+#include <thread>  // NOLINT(build/c++11)
 #include <unordered_map>
 #include <vector>
 
+#include "tensorflow/core/common_runtime/hardware_counters.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/step_stats.pb.h"
 #include "tensorflow/core/framework/tracking_allocator.h"
@@ -129,6 +131,12 @@ class NodeExecStatsWrapper : public NodeExecStatsInterface {
   std::unique_ptr<NodeExecStats> stats_;
   const NodeDef* const node_;                       // Not owned.
   StepStatsCollector* const step_stats_collector_;  // Not owned.
+
+  // The counters of the thread that started the kernel, that thread, and the
+  // values of the counters then. Null unless hardware counters are collected.
+  ThreadHardwareCounters* hardware_counters_ = nullptr;  // Not owned.
+  std::thread::id hardware_counters_thread_;
+  HardwareCounterValues hardware_counters_start_;
 };
 
 // Statistics collection interface for step execution.
@@ -172,6 +180,11 @@ class StepStatsCollector : public StepStatsCollectorInterface {
   void Save(const std::string& device, NodeExecStats* node_stats_pb);
   void Save(const std::string& device, NodeExecStatsWrapper* node_stats);
 
+  // Returns true if hardware performance counters should be recorded for the
+  // kernels of this step, which is enabled with the
+  // TF_STEP_STATS_HARDWARE_COUNTERS environment variable.
+  bool collect_hardware_counters() const { return collect_hardware_counters_; }
+
   // Saves thread name.
   void SaveThreadName(const std::string& device, const uint32_t thread_id,
                       const std::string& thread_name);
@@ -196,6 +209,8 @@ class StepStatsCollector : public StepStatsCollectorInterface {
 
   void FinalizeInternal() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  bool collect_hardware_counters_ = false;
+
   mutex mu_;
   bool finalized_ TF_GUARDED_BY(mu_);
   std::unordered_map<std::string, NodeStatsVector> dev_stats_
@@ -0,0 +1,334 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/batch_slab.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/util/batch_util.h"
+
+namespace tensorflow {
+namespace data {
+
+// Owns the memory of one batch component.
+class BatchSlab::SlabBuffer : public TensorBuffer {
+ public:
+  SlabBuffer(Allocator* allocator, void* data, size_t size)
+      : TensorBuffer(data), allocator_(allocator), size_(size) {}
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocator_name(allocator_->Name());
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+
+ private:
+  ~SlabBuffer() override { allocator_->DeallocateRaw(data()); }
+
+  Allocator* const allocator_;  // Not owned.
+  const size_t size_;
+};
+
+// Hands out the slices of the element that is being produced. Each allocation
+// holds a reference on the allocator, which holds references on the slab
+// buffers, so the slab memory outlives all tensors that point into it.
+class BatchSlab::SliceAllocator : public Allocator, public core::RefCounted {
+ public:
+  SliceAllocator(Allocator* base_allocator,
+                 std::vector<core::RefCountPtr<SlabBuffer>> buffers,
+                 std::vector<size_t> slice_bytes, int64_t batch_size)
+      : base_allocator_(base_allocator),
+        buffers_(std::move(buffers)),
+        slice_bytes_(std::move(slice_bytes)),
+        batch_size_(batch_size),
+        slices_(batch_size * buffers_.size(), SliceState::kFree),
+        detached_(buffers_.size(), false) {
+    for (size_t i = 0; i < buffers_.size(); ++i) {
+      if (buffers_[i] == nullptr) {
+        detached_[i] = true;
+      }
+    }
+  }
+
+  std::string Name() override { return "tf_data_batch_slab"; }
+
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    {
+      mutex_lock l(mu_);
+      if (num_bytes > 0 && element_ < batch_size_) {
+        for (size_t i = 0; i < buffers_.size(); ++i) {
+          const int64_t slice = element_ * buffers_.size() + i;
+          if (detached_[i] || slice_bytes_[i] != num_bytes ||
+              slices_[slice] != SliceState::kFree) {
+            continue;
+          }
+          char* ptr = buffers_[i]->base<char>() + element_ * slice_bytes_[i];
+          if (reinterpret_cast<uintptr_t>(ptr) % alignment != 0) {
+            continue;
+          }
+          slices_[slice] = SliceState::kHeld;
+          held_slices_[ptr] = slice;
+          Ref();
+          return ptr;
+        }
+      }
+    }
+    void* ptr = base_allocator_->AllocateRaw(alignment, num_bytes);
+    if (ptr != nullptr) {
+      Ref();
+    }
+    return ptr;
+  }
+
+  void DeallocateRaw(void* ptr) override {
+    bool is_slice = false;
+    {
+      mutex_lock l(mu_);
+      auto it = held_slices_.find(ptr);
+      if (it != held_slices_.end()) {
+        slices_[it->second] = SliceState::kReleased;
+        held_slices_.erase(it);
+        is_slice = true;
+      }
+    }
+    if (!is_slice) {
+      base_allocator_->DeallocateRaw(ptr);
+    }
+    Unref();
+  }
+
+  // Makes subsequent allocations use the slices of `element`. Slices are no
+  // longer handed out once `element` reaches the batch size.
+  void SetElement(int64_t element) {
+    mutex_lock l(mu_);
+    element_ = element;
+  }
+
+  // Whether the slice of `component` in `element` is held by a tensor.
+  bool IsSliceHeld(int64_t element, int64_t component) {
+    mutex_lock l(mu_);
+    return slices_[element * buffers_.size() + component] == SliceState::kHeld;
+  }
+
+  // Stops handing out the slices of `component`.
+  void Detach(int64_t component) {
+    mutex_lock l(mu_);
+    detached_[component] = true;
+  }
+
+  bool IsDetached(int64_t component) {
+    mutex_lock l(mu_);
+    return detached_[component];
+  }
+
+ private:
+  enum class SliceState { kFree, kHeld, kReleased };
+
+  Allocator* const base_allocator_;  // Not owned.
+  const std::vector<core::RefCountPtr<SlabBuffer>> buffers_;
+  const std::vector<size_t> slice_bytes_;
+  const int64_t batch_size_;
+
+  mutex mu_;
+  int64_t element_ TF_GUARDED_BY(mu_) = 0;
+  // Indexed by `element * num_components + component`.
+  std::vector<SliceState> slices_ TF_GUARDED_BY(mu_);
+  absl::flat_hash_map<void*, int64_t> held_slices_ TF_GUARDED_BY(mu_);
+  std::vector<bool> detached_ TF_GUARDED_BY(mu_);
+};
+
+bool BatchSlab::IsSupported(const DataTypeVector& dtypes,
+                            const std::vector<PartialTensorShape>& shapes) {
+  if (dtypes.size() != shapes.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < dtypes.size(); ++i) {
+    if (!DataTypeCanUseMemcpy(dtypes[i]) || !shapes[i].IsFullyDefined()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+absl::StatusOr<std::unique_ptr<BatchSlab>> BatchSlab::Create(
+    Allocator* allocator, const DataTypeVector& dtypes,
+    const std::vector<PartialTensorShape>& element_shapes,
+    int64_t batch_size) {
+  if (!IsSupported(dtypes, element_shapes)) {
+    return absl::InvalidArgumentError(
+        "Batch slabs require fully defined shapes and types that can be "
+        "copied with memcpy.");
+  }
+  std::vector<TensorShape> shapes(element_shapes.size());
+  for (size_t i = 0; i < element_shapes.size(); ++i) {
+    element_shapes[i].AsTensorShape(&shapes[i]);
+  }
+  auto slab = absl::WrapUnique(
+      new BatchSlab(allocator, dtypes, std::move(shapes), batch_size));
+
+  std::vector<core::RefCountPtr<SlabBuffer>> buffers;
+  std::vector<size_t> slice_bytes;
+  for (size_t i = 0; i < dtypes.size(); ++i) {
+    TensorShape batch_shape({batch_size});
+    batch_shape.AppendShape(slab->element_shapes_[i]);
+    const size_t bytes =
+        slab->element_shapes_[i].num_elements() * DataTypeSize(dtypes[i]);
+    slice_bytes.push_back(bytes);
+    if (bytes == 0) {
+      buffers.emplace_back(nullptr);
+      slab->batch_.emplace_back(allocator, dtypes[i], batch_shape);
+      continue;
+    }
+    void* data =
+        allocator->AllocateRaw(Allocator::kAllocatorAlignment, bytes * batch_size);
+    if (data == nullptr) {
+      return absl::ResourceExhaustedError(absl::StrCat(
+          "Failed to allocate memory for the batch of component ", i));
+    }
+    buffers.emplace_back(new SlabBuffer(allocator, data, bytes * batch_size));
+    slab->batch_.emplace_back(dtypes[i], batch_shape, buffers.back().get());
+  }
+  slab->slice_allocator_ = new SliceAllocator(allocator, std::move(buffers),
+                                              std::move(slice_bytes),
+                                              batch_size);
+  return slab;
+}
+
+BatchSlab::BatchSlab(Allocator* allocator, const DataTypeVector& dtypes,
+                     std::vector<TensorShape> element_shapes,
+                     int64_t batch_size)
+    : base_allocator_(allocator),
+      dtypes_(dtypes),
+      element_shapes_(std::move(element_shapes)),
+      batch_size_(batch_size),
+      slice_allocator_(nullptr) {}
+
+BatchSlab::~BatchSlab() {
+  if (slice_allocator_ != nullptr) {
+    slice_allocator_->SetElement(batch_size_);
+    slice_allocator_->Unref();
+  }
+}
+
+Allocator* BatchSlab::allocator() const { return slice_allocator_; }
+
+absl::Status BatchSlab::AddElement(std::vector<Tensor>&& element) {
+  if (finished_ || num_elements_ >= batch_size_) {
+    return absl::FailedPreconditionError("The batch slab is full.");
+  }
+  if (element.size() != dtypes_.size()) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Expected an element with ", dtypes_.size(),
+                     " components but got ", element.size(), "."));
+  }
+  const int64_t index = num_elements_;
+  // Slices of this element must not be handed out while it is copied.
+  slice_allocator_->SetElement(index + 1);
+  for (size_t i = 0; i < element.size(); ++i) {
+    Tensor& tensor = element[i];
+    if (tensor.dtype() != dtypes_[i]) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Cannot batch tensors of type ", DataTypeString(tensor.dtype()),
+          " in component ", i, " of type ", DataTypeString(dtypes_[i]), "."));
+    }
+    if (tensor.shape() != element_shapes_[i]) {
+      return absl::InvalidArgumentError(absl::StrCat(
+          "Cannot batch tensors with different shapes in component ", i,
+          ". First element had shape ", element_shapes_[i].DebugString(),
+          " and element ", index, " had shape ", tensor.shape().DebugString(),
+          "."));
+    }
+    if (!slice_allocator_->IsDetached(i)) {
+      const char* slice = batch_[i].tensor_data().data() +
+                          index * batch_[i].tensor_data().size() / batch_size_;
+      if (tensor.tensor_data().data() == slice) {
+        // The element was produced in place. It can stay there unless some
+        // other tensor shares its buffer and could later be modified in place.
+        if (tensor.RefCountIsOne()) {
+          ++num_tensors_in_place_;
+          continue;
+        }
+        TF_RETURN_IF_ERROR(DetachComponent(i));
+      } else if (slice_allocator_->IsSliceHeld(index, i)) {
+        TF_RETURN_IF_ERROR(DetachComponent(i));
+      }
+    }
+    TF_RETURN_IF_ERROR(
+        batch_util::CopyElementToSlice(std::move(tensor), &batch_[i], index));
+  }
+  element.clear();
+  ++num_elements_;
+  return absl::OkStatus();
+}
+
+absl::Status BatchSlab::Finish(std::vector<Tensor>* out_tensors) {
+  if (finished_) {
+    return absl::FailedPreconditionError(
+        "The batch slab has already been finished.");
+  }
+  finished_ = true;
+  slice_allocator_->SetElement(batch_size_);
+  out_tensors->reserve(batch_.size());
+  for (Tensor& component : batch_) {
+    if (num_elements_ < batch_size_) {
+      out_tensors->push_back(component.Slice(0, num_elements_));
+    } else {
+      out_tensors->push_back(std::move(component));
+    }
+  }
+  batch_.clear();
+  return absl::OkStatus();
+}
+
+absl::Status BatchSlab::DetachComponent(int64_t component) {
+  Tensor detached(base_allocator_, dtypes_[component],
+                  batch_[component].shape());
+  if (!detached.IsInitialized()) {
+    return absl::ResourceExhaustedError(absl::StrCat(
+        "Failed to allocate memory for the batch of component ", component));
+  }
+  const size_t slice_bytes =
+      batch_[component].tensor_data().size() / batch_size_;
+  if (num_elements_ > 0) {
+    std::memcpy(const_cast<char*>(detached.tensor_data().data()),
+                batch_[component].tensor_data().data(),
+                num_elements_ * slice_bytes);
+  }
+  batch_[component] = std::move(detached);
+  slice_allocator_->Detach(component);
+  return absl::OkStatus();
+}
+
+}  // namespace data
+}  // namespace tensorflow
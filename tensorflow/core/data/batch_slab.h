@@ -0,0 +1,125 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_BATCH_SLAB_H_
+#define TENSORFLOW_CORE_DATA_BATCH_SLAB_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/partial_tensor_shape.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+
+namespace tensorflow {
+namespace data {
+
+// A `BatchSlab` preallocates the output tensors of one batch and lets the
+// iterators that produce its elements allocate their outputs directly in the
+// slices of those tensors.
+//
+// Iterators that allocate through `IteratorContext::allocator()` while
+// producing element `i` get the memory of slice `i` of the first component
+// with the requested size that has not been handed out yet. When the element
+// is added and its tensors are found in place, they are not copied. All other
+// element tensors are copied into their slices as usual.
+//
+// A component whose slice is still held by some other tensor when the element
+// is added is moved to a separately allocated batch tensor, so that tensors
+// in the slab never alias memory that is being written to. The slab memory
+// stays alive as long as any tensor refers to it.
+//
+// Example usage:
+//
+// ```
+// TF_ASSIGN_OR_RETURN(std::unique_ptr<BatchSlab> slab,
+//                     BatchSlab::Create(ctx->allocator({}), dtypes, shapes,
+//                                       batch_size));
+// // Produce each element with `slab->allocator()` as the context allocator.
+// TF_RETURN_IF_ERROR(slab->AddElement(std::move(element)));
+// ...
+// TF_RETURN_IF_ERROR(slab->Finish(out_tensors));
+// ```
+class BatchSlab {
+ public:
+  // Whether elements with the given component types and shapes can be batched
+  // in a slab. This requires fully defined shapes and types that can be
+  // copied with `memcpy`.
+  static bool IsSupported(const DataTypeVector& dtypes,
+                          const std::vector<PartialTensorShape>& shapes);
+
+  // Allocates a slab for `batch_size` elements using `allocator`.
+  //
+  // REQUIRES: `IsSupported(dtypes, element_shapes)`.
+  static absl::StatusOr<std::unique_ptr<BatchSlab>> Create(
+      Allocator* allocator, const DataTypeVector& dtypes,
+      const std::vector<PartialTensorShape>& element_shapes,
+      int64_t batch_size);
+
+  ~BatchSlab();
+
+  // Allocator for the element that is produced next. Allocations that do not
+  // match a free slice are served by the allocator passed to `Create()`. It is
+  // safe to use after the slab is destroyed.
+  Allocator* allocator() const;
+
+  // Places `element` at the next position of the batch.
+  absl::Status AddElement(std::vector<Tensor>&& element);
+
+  // Moves the batch of the elements added so far to `out_tensors`. No slices
+  // are handed out afterwards.
+  absl::Status Finish(std::vector<Tensor>* out_tensors);
+
+  // The number of elements added so far.
+  int64_t num_elements() const { return num_elements_; }
+
+  // The number of element tensors that were found in place, for testing.
+  int64_t num_tensors_in_place() const { return num_tensors_in_place_; }
+
+ private:
+  class SlabBuffer;
+  class SliceAllocator;
+
+  BatchSlab(Allocator* allocator, const DataTypeVector& dtypes,
+            std::vector<TensorShape> element_shapes, int64_t batch_size);
+
+  // Moves component `component` to a batch tensor that is not part of the slab.
+  absl::Status DetachComponent(int64_t component);
+
+  Allocator* const base_allocator_;
+  const DataTypeVector dtypes_;
+  const std::vector<TensorShape> element_shapes_;
+  const int64_t batch_size_;
+
+  // Not owned. Reference counted by the slab and by the tensors allocated from
+  // it.
+  SliceAllocator* slice_allocator_;
+  // One tensor per component with the shape of a full batch.
+  std::vector<Tensor> batch_;
+  int64_t num_elements_ = 0;
+  int64_t num_tensors_in_place_ = 0;
+  bool finished_ = false;
+
+  BatchSlab(const BatchSlab&) = delete;
+  void operator=(const BatchSlab&) = delete;
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_BATCH_SLAB_H_
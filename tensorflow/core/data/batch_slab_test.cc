@@ -0,0 +1,200 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/batch_slab.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include "absl/status/status.h"
+#include "xla/tsl/platform/status_matchers.h"
+#include "xla/tsl/platform/statusor.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/partial_tensor_shape.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using ::testing::HasSubstr;
+using ::tsl::testing::StatusIs;
+
+constexpr int64_t kBatchSize = 4;
+// Element components of 64 bytes, so that every slice is aligned.
+constexpr int64_t kNumInts = 8;
+constexpr int64_t kNumFloats = 16;
+
+absl::StatusOr<std::unique_ptr<BatchSlab>> CreateSlab() {
+  return BatchSlab::Create(
+      cpu_allocator(), {DT_INT64, DT_FLOAT},
+      {PartialTensorShape({kNumInts}), PartialTensorShape({kNumFloats})},
+      kBatchSize);
+}
+
+std::vector<int64_t> Ints(int64_t i) {
+  std::vector<int64_t> ints;
+  for (int64_t j = 0; j < kNumInts; ++j) {
+    ints.push_back(i + j);
+  }
+  return ints;
+}
+
+std::vector<float> Floats(int64_t i) {
+  std::vector<float> floats;
+  for (int64_t j = 0; j < kNumFloats; ++j) {
+    floats.push_back(i * 0.5f + j);
+  }
+  return floats;
+}
+
+// Allocates element `i` with `allocator`.
+std::vector<Tensor> MakeElement(Allocator* allocator, int64_t i) {
+  Tensor ints(allocator, DT_INT64, TensorShape({kNumInts}));
+  Tensor floats(allocator, DT_FLOAT, TensorShape({kNumFloats}));
+  std::vector<int64_t> int_values = Ints(i);
+  std::vector<float> float_values = Floats(i);
+  std::copy(int_values.begin(), int_values.end(), ints.flat<int64_t>().data());
+  std::copy(float_values.begin(), float_values.end(),
+            floats.flat<float>().data());
+  return {ints, floats};
+}
+
+void ExpectBatch(const std::vector<Tensor>& batch, int64_t num_elements) {
+  ASSERT_EQ(batch.size(), 2);
+  std::vector<int64_t> ints;
+  std::vector<float> floats;
+  for (int64_t i = 0; i < num_elements; ++i) {
+    std::vector<int64_t> element_ints = Ints(i);
+    std::vector<float> element_floats = Floats(i);
+    ints.insert(ints.end(), element_ints.begin(), element_ints.end());
+    floats.insert(floats.end(), element_floats.begin(), element_floats.end());
+  }
+  test::ExpectEqual(batch[0],
+                    test::AsTensor<int64_t>(ints, {num_elements, kNumInts}));
+  test::ExpectEqual(batch[1],
+                    test::AsTensor<float>(floats, {num_elements, kNumFloats}));
+}
+
+TEST(BatchSlabTest, IsSupported) {
+  EXPECT_TRUE(BatchSlab::IsSupported(
+      {DT_INT64, DT_FLOAT}, {PartialTensorShape({3}), PartialTensorShape({})}));
+  EXPECT_FALSE(
+      BatchSlab::IsSupported({DT_INT64}, {PartialTensorShape({-1})}));
+  EXPECT_FALSE(
+      BatchSlab::IsSupported({DT_STRING}, {PartialTensorShape({1})}));
+  EXPECT_FALSE(BatchSlab::IsSupported({DT_INT64}, {}));
+}
+
+TEST(BatchSlabTest, ElementsAllocatedInPlace) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BatchSlab> slab, CreateSlab());
+  for (int64_t i = 0; i < kBatchSize; ++i) {
+    TF_ASSERT_OK(slab->AddElement(MakeElement(slab->allocator(), i)));
+  }
+  EXPECT_EQ(slab->num_tensors_in_place(), 2 * kBatchSize);
+  std::vector<Tensor> batch;
+  TF_ASSERT_OK(slab->Finish(&batch));
+  ExpectBatch(batch, kBatchSize);
+}
+
+TEST(BatchSlabTest, ElementsAllocatedElsewhere) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BatchSlab> slab, CreateSlab());
+  for (int64_t i = 0; i < kBatchSize; ++i) {
+    TF_ASSERT_OK(slab->AddElement(MakeElement(cpu_allocator(), i)));
+  }
+  EXPECT_EQ(slab->num_tensors_in_place(), 0);
+  std::vector<Tensor> batch;
+  TF_ASSERT_OK(slab->Finish(&batch));
+  ExpectBatch(batch, kBatchSize);
+}
+
+TEST(BatchSlabTest, PartialBatch) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BatchSlab> slab, CreateSlab());
+  TF_ASSERT_OK(slab->AddElement(MakeElement(slab->allocator(), 0)));
+  TF_ASSERT_OK(slab->AddElement(MakeElement(cpu_allocator(), 1)));
+  std::vector<Tensor> batch;
+  TF_ASSERT_OK(slab->Finish(&batch));
+  ExpectBatch(batch, 2);
+}
+
+TEST(BatchSlabTest, SliceHeldByAnotherTensor) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BatchSlab> slab, CreateSlab());
+  // Takes the slices of element 0, but is not part of the element.
+  std::vector<Tensor> other = MakeElement(slab->allocator(), 100);
+  TF_ASSERT_OK(slab->AddElement(MakeElement(cpu_allocator(), 0)));
+  for (int64_t i = 1; i < kBatchSize; ++i) {
+    TF_ASSERT_OK(slab->AddElement(MakeElement(slab->allocator(), i)));
+  }
+  std::vector<Tensor> batch;
+  TF_ASSERT_OK(slab->Finish(&batch));
+  ExpectBatch(batch, kBatchSize);
+  // The other tensors were not overwritten.
+  test::ExpectEqual(other[0], test::AsTensor<int64_t>(Ints(100)));
+  test::ExpectEqual(other[1], test::AsTensor<float>(Floats(100)));
+}
+
+TEST(BatchSlabTest, SharedElementIsCopied) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BatchSlab> slab, CreateSlab());
+  std::vector<Tensor> element = MakeElement(slab->allocator(), 0);
+  std::vector<Tensor> shared = element;
+  TF_ASSERT_OK(slab->AddElement(std::move(element)));
+  EXPECT_EQ(slab->num_tensors_in_place(), 0);
+  std::vector<Tensor> batch;
+  TF_ASSERT_OK(slab->Finish(&batch));
+  ExpectBatch(batch, 1);
+  EXPECT_NE(batch[0].tensor_data().data(), shared[0].tensor_data().data());
+}
+
+TEST(BatchSlabTest, AllocatorOutlivesSlab) {
+  Allocator* allocator;
+  std::vector<Tensor> element;
+  {
+    TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BatchSlab> slab, CreateSlab());
+    allocator = slab->allocator();
+    element = MakeElement(allocator, 7);
+  }
+  // After the slab is gone, allocations are served by the base allocator.
+  std::vector<Tensor> later = MakeElement(allocator, 8);
+  test::ExpectEqual(element[0], test::AsTensor<int64_t>(Ints(7)));
+  test::ExpectEqual(later[0], test::AsTensor<int64_t>(Ints(8)));
+}
+
+TEST(BatchSlabTest, ShapeMismatch) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BatchSlab> slab, CreateSlab());
+  std::vector<Tensor> element = {test::AsTensor<int64_t>({1, 2}),
+                                 test::AsTensor<float>(Floats(0))};
+  EXPECT_THAT(slab->AddElement(std::move(element)),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Cannot batch tensors with different shapes "
+                                 "in component 0")));
+}
+
+TEST(BatchSlabTest, FullSlab) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<BatchSlab> slab, CreateSlab());
+  for (int64_t i = 0; i < kBatchSize; ++i) {
+    TF_ASSERT_OK(slab->AddElement(MakeElement(cpu_allocator(), i)));
+  }
+  EXPECT_THAT(slab->AddElement(MakeElement(cpu_allocator(), kBatchSize)),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
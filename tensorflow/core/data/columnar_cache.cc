@@ -0,0 +1,406 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/columnar_cache.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/platform/snappy.h"
+#include "tensorflow/core/platform/tstring.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// Set in `Entry::stored_bytes` if the stored bytes are compressed.
+constexpr uint32_t kCompressedBit = uint32_t{1} << 31;
+// Tensors of this size or larger are kept as tensors.
+constexpr size_t kMaxStoredBytes = kCompressedBit - 1;
+
+size_t RoundUp(size_t offset, size_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+// Serializes the strings of `tensor` as their lengths followed by their bytes.
+std::string EncodeStrings(const Tensor& tensor) {
+  auto strings = tensor.flat<tstring>();
+  size_t size = strings.size() * sizeof(uint64_t);
+  for (int64_t i = 0; i < strings.size(); ++i) {
+    size += strings(i).size();
+  }
+  std::string encoded(size, '\0');
+  char* lengths = encoded.data();
+  char* bytes = lengths + strings.size() * sizeof(uint64_t);
+  for (int64_t i = 0; i < strings.size(); ++i) {
+    uint64_t length = strings(i).size();
+    std::memcpy(lengths + i * sizeof(uint64_t), &length, sizeof(length));
+    std::memcpy(bytes, strings(i).data(), length);
+    bytes += length;
+  }
+  return encoded;
+}
+
+absl::Status DecodeStrings(absl::string_view encoded, Tensor* tensor) {
+  auto strings = tensor->flat<tstring>();
+  size_t lengths_size = strings.size() * sizeof(uint64_t);
+  if (encoded.size() < lengths_size) {
+    return absl::DataLossError("Corrupted string tensor in columnar cache.");
+  }
+  absl::string_view bytes = encoded.substr(lengths_size);
+  for (int64_t i = 0; i < strings.size(); ++i) {
+    uint64_t length;
+    std::memcpy(&length, encoded.data() + i * sizeof(uint64_t),
+                sizeof(length));
+    if (length > bytes.size()) {
+      return absl::DataLossError("Corrupted string tensor in columnar cache.");
+    }
+    strings(i).assign(bytes.data(), length);
+    bytes.remove_prefix(length);
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+// Owns the memory that the tensors of a component are appended to.
+class ColumnarCache::Arena : public TensorBuffer {
+ public:
+  Arena(void* data, size_t capacity)
+      : TensorBuffer(data), capacity_(capacity) {}
+
+  size_t size() const override { return capacity_; }
+  TensorBuffer* root_buffer() override { return this; }
+
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(capacity_);
+    proto->set_allocator_name(cpu_allocator()->Name());
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+
+  // Number of bytes handed out so far.
+  size_t used = 0;
+
+ private:
+  ~Arena() override { cpu_allocator()->DeallocateRaw(data()); }
+
+  const size_t capacity_;
+};
+
+namespace {
+
+// A tensor buffer that aliases part of an arena and keeps it alive. It does not
+// own its memory, so kernels never forward it to their outputs and overwrite
+// the cached contents.
+class ArenaSlice : public TensorBuffer {
+ public:
+  ArenaSlice(TensorBuffer* arena, const char* data, size_t size)
+      : TensorBuffer(const_cast<char*>(data)), arena_(arena), size_(size) {
+    arena_->Ref();
+  }
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return arena_->root_buffer(); }
+  bool OwnsMemory() const override { return false; }
+
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    arena_->FillAllocationDescription(proto);
+    proto->set_requested_bytes(size_);
+  }
+
+ private:
+  ~ArenaSlice() override { arena_->Unref(); }
+
+  TensorBuffer* const arena_;
+  const size_t size_;
+};
+
+}  // namespace
+
+ColumnarCache::ColumnarCache(const Options& options) : options_(options) {
+  DCHECK_LE(options_.arena_bytes, kMaxStoredBytes);
+}
+
+ColumnarCache::~ColumnarCache() = default;
+
+absl::Status ColumnarCache::Put(int64_t index,
+                                const std::vector<Tensor>& element) {
+  if (index < 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Expected index >= 0; Received index: ", index));
+  }
+  mutex_lock l(mu_);
+  return PutLocked(index, element);
+}
+
+absl::Status ColumnarCache::Append(const std::vector<Tensor>& element) {
+  mutex_lock l(mu_);
+  return PutLocked(present_.size(), element);
+}
+
+absl::Status ColumnarCache::PutLocked(int64_t index,
+                                      const std::vector<Tensor>& element) {
+  if (num_components_ < 0) {
+    num_components_ = element.size();
+    components_.resize(num_components_);
+  }
+  if (element.size() != num_components_) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Expected an element with ", num_components_,
+        " components but got one with ", element.size(), " components."));
+  }
+  if (index < present_.size() && present_[index]) {
+    return absl::AlreadyExistsError(
+        absl::StrCat("An element is already cached at position ", index, "."));
+  }
+  std::vector<Entry> element_entries(num_components_);
+  for (size_t i = 0; i < element.size(); ++i) {
+    TF_RETURN_IF_ERROR(PutTensor(i, element[i], &element_entries[i]));
+  }
+  if (present_.size() <= index) {
+    present_.resize(index + 1, false);
+    entries_.resize(present_.size() * num_components_,
+                    Entry{kNoArena, 0, 0, 0});
+  }
+  present_[index] = true;
+  std::copy(element_entries.begin(), element_entries.end(),
+            entries_.begin() + index * num_components_);
+  return absl::OkStatus();
+}
+
+bool ColumnarCache::Contains(int64_t index) const {
+  tf_shared_lock l(mu_);
+  return index >= 0 && index < present_.size() && present_[index];
+}
+
+absl::Status ColumnarCache::Get(int64_t index,
+                                std::vector<Tensor>* element) const {
+  tf_shared_lock l(mu_);
+  if (index < 0 || index >= size_locked()) {
+    return absl::OutOfRangeError(absl::StrCat(
+        "Index out of range [0, ", size_locked(), "):", index));
+  }
+  if (!present_[index]) {
+    return absl::NotFoundError(
+        absl::StrCat("No element is cached at position ", index, "."));
+  }
+  element->clear();
+  element->resize(num_components_);
+  for (size_t i = 0; i < num_components_; ++i) {
+    TF_RETURN_IF_ERROR(
+        GetTensor(i, entries_[index * num_components_ + i], &(*element)[i]));
+  }
+  return absl::OkStatus();
+}
+
+int64_t ColumnarCache::size() const {
+  tf_shared_lock l(mu_);
+  return size_locked();
+}
+
+int64_t ColumnarCache::AllocatedBytes() const {
+  tf_shared_lock l(mu_);
+  int64_t bytes = entries_.capacity() * sizeof(Entry) +
+                  present_.capacity() / 8 + tensor_bytes_;
+  for (const auto& arena : arenas_) {
+    bytes += arena->size();
+  }
+  for (const auto& component : components_) {
+    bytes += component.layouts.capacity() * sizeof(Layout);
+  }
+  return bytes;
+}
+
+uint32_t ColumnarCache::GetLayoutId(Component& component,
+                                    const Tensor& tensor) {
+  // Elements of a component usually share their type and shape, so the last
+  // layout is checked before building the key.
+  if (!component.layouts.empty()) {
+    const Layout& last = component.layouts[component.last_layout];
+    if (last.dtype == tensor.dtype() && last.shape == tensor.shape()) {
+      return component.last_layout;
+    }
+  }
+  std::string key =
+      absl::StrCat(static_cast<int>(tensor.dtype()), ":",
+                   absl::StrJoin(tensor.shape().dim_sizes(), ","));
+  auto [it, inserted] =
+      component.layout_ids.try_emplace(key, component.layouts.size());
+  if (inserted) {
+    component.layouts.push_back(Layout{tensor.dtype(), tensor.shape()});
+  }
+  component.last_layout = it->second;
+  return it->second;
+}
+
+char* ColumnarCache::Allocate(Component& component, size_t size,
+                              size_t alignment, uint32_t* arena,
+                              uint32_t* offset) {
+  if (component.arena != kNoArena) {
+    Arena* current = arenas_[component.arena].get();
+    size_t aligned = RoundUp(current->used, alignment);
+    if (aligned + size <= current->size()) {
+      current->used = aligned + size;
+      *arena = component.arena;
+      *offset = aligned;
+      return current->base<char>() + aligned;
+    }
+  }
+  size_t capacity = std::max(options_.arena_bytes, size);
+  void* data =
+      cpu_allocator()->AllocateRaw(Allocator::kAllocatorAlignment, capacity);
+  if (data == nullptr) return nullptr;
+  arenas_.emplace_back(new Arena(data, capacity));
+  arenas_.back()->used = size;
+  *arena = arenas_.size() - 1;
+  *offset = 0;
+  // Oversized tensors get an arena of their own, which is full right away.
+  if (size <= options_.arena_bytes) {
+    component.arena = *arena;
+  }
+  return arenas_.back()->base<char>();
+}
+
+absl::Status ColumnarCache::PutTensor(size_t component, const Tensor& tensor,
+                                      Entry* entry) {
+  entry->layout = GetLayoutId(components_[component], tensor);
+  std::string encoded;
+  absl::string_view bytes;
+  size_t alignment = 1;
+  if (tensor.dtype() == DT_STRING) {
+    encoded = EncodeStrings(tensor);
+    bytes = encoded;
+    alignment = sizeof(uint64_t);
+  } else if (DataTypeCanUseMemcpy(tensor.dtype())) {
+    bytes = tensor.tensor_data();
+    alignment = bytes.size() >= kMinAlignedBytes
+                    ? Allocator::kAllocatorAlignment
+                    : DataTypeSize(tensor.dtype());
+  } else {
+    bytes = absl::string_view();
+  }
+  const bool is_columnar =
+      tensor.dtype() == DT_STRING || DataTypeCanUseMemcpy(tensor.dtype());
+  if (is_columnar && bytes.empty()) {
+    // Empty tensors are recreated from their layout.
+    entry->arena = kNoArena;
+    entry->offset = 0;
+    entry->stored_bytes = 0;
+    return absl::OkStatus();
+  }
+  if (!is_columnar || bytes.size() > kMaxStoredBytes) {
+    entry->arena = kTensorArena;
+    entry->offset = tensors_.size();
+    entry->stored_bytes = 0;
+    tensors_.push_back(tensor);
+    tensor_bytes_ += tensor.AllocatedBytes();
+    return absl::OkStatus();
+  }
+  std::string compressed;
+  bool is_compressed = false;
+  if (options_.compress && bytes.size() >= kMinCompressedBytes &&
+      port::Snappy_Compress(bytes.data(), bytes.size(), &compressed) &&
+      compressed.size() <= bytes.size() - bytes.size() / 8) {
+    bytes = compressed;
+    alignment = 1;
+    is_compressed = true;
+  }
+  char* data = Allocate(components_[component], bytes.size(),
+                        std::max<size_t>(alignment, 1), &entry->arena,
+                        &entry->offset);
+  if (data == nullptr) {
+    return absl::ResourceExhaustedError(
+        absl::StrCat("Failed to allocate ", bytes.size(),
+                     " bytes for the columnar cache."));
+  }
+  std::memcpy(data, bytes.data(), bytes.size());
+  entry->stored_bytes = bytes.size() | (is_compressed ? kCompressedBit : 0);
+  return absl::OkStatus();
+}
+
+absl::Status ColumnarCache::GetTensor(size_t component, const Entry& entry,
+                                      Tensor* tensor) const {
+  if (entry.arena == kTensorArena) {
+    *tensor = tensors_[entry.offset];
+    return absl::OkStatus();
+  }
+  const Layout& layout = components_[component].layouts[entry.layout];
+  if (entry.arena == kNoArena) {
+    *tensor = Tensor(layout.dtype, layout.shape);
+    return absl::OkStatus();
+  }
+  Arena* arena = arenas_[entry.arena].get();
+  const char* data = arena->base<const char>() + entry.offset;
+  const size_t stored_bytes = entry.stored_bytes & ~kCompressedBit;
+  const bool is_compressed = entry.stored_bytes & kCompressedBit;
+
+  if (layout.dtype == DT_STRING) {
+    std::string uncompressed;
+    absl::string_view encoded(data, stored_bytes);
+    if (is_compressed) {
+      size_t size;
+      if (!port::Snappy_GetUncompressedLength(data, stored_bytes, &size)) {
+        return absl::DataLossError("Corrupted tensor in columnar cache.");
+      }
+      uncompressed.resize(size);
+      if (!port::Snappy_Uncompress(data, stored_bytes, uncompressed.data())) {
+        return absl::DataLossError("Corrupted tensor in columnar cache.");
+      }
+      encoded = uncompressed;
+    }
+    *tensor = Tensor(DT_STRING, layout.shape);
+    return DecodeStrings(encoded, tensor);
+  }
+
+  if (!is_compressed && stored_bytes >= kMinAlignedBytes) {
+    core::RefCountPtr<TensorBuffer> slice(
+        new ArenaSlice(arena, data, stored_bytes));
+    *tensor = Tensor(layout.dtype, layout.shape, std::move(slice));
+    return absl::OkStatus();
+  }
+  *tensor = Tensor(layout.dtype, layout.shape);
+  char* out = const_cast<char*>(tensor->tensor_data().data());
+  if (is_compressed) {
+    size_t size;
+    if (!port::Snappy_GetUncompressedLength(data, stored_bytes, &size) ||
+        size != tensor->TotalBytes() ||
+        !port::Snappy_Uncompress(data, stored_bytes, out)) {
+      return absl::DataLossError("Corrupted tensor in columnar cache.");
+    }
+  } else {
+    std::memcpy(out, data, stored_bytes);
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,186 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_COLUMNAR_CACHE_H_
+#define TENSORFLOW_CORE_DATA_COLUMNAR_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/refcount.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+namespace data {
+
+// Experiment that makes the memory cache of `CacheDataset` store its elements
+// in a `ColumnarCache`.
+inline constexpr char kColumnarMemoryCacheExperiment[] =
+    "columnar_memory_cache";
+
+// Experiment that additionally compresses the larger tensors of the columnar
+// memory cache.
+inline constexpr char kColumnarMemoryCacheCompressionExperiment[] =
+    "columnar_memory_cache_compression";
+
+// An in-memory store of dataset elements that keeps the contents of the
+// tensors in large, contiguous arenas instead of one allocation per tensor.
+//
+// The bytes of each tensor are appended to the arena of its component, and an
+// index records where each tensor lives together with its type and shape.
+// Distinct types and shapes are stored once per component, so the per-tensor
+// overhead of the index is 16 bytes. String tensors are stored as their
+// lengths followed by their bytes. Tensors of other types that cannot be
+// copied with `memcpy`, such as variants, are kept as tensors.
+//
+// Elements can be stored at arbitrary positions in any order, which supports
+// filling the cache in the order of a global shuffle. Reading a tensor of at
+// least `kMinAlignedBytes` returns a tensor that aliases the arena. Smaller
+// tensors and compressed tensors are copied out.
+//
+// The cache is thread-safe.
+class ColumnarCache {
+ public:
+  struct Options {
+    // Whether to compress tensors of at least `kMinCompressedBytes` with
+    // snappy. A tensor is only stored compressed if this saves at least 1/8
+    // of its size.
+    bool compress = false;
+    // Size of the arenas in bytes. Tensors larger than this get an arena of
+    // their own.
+    size_t arena_bytes = 1 << 20;
+  };
+
+  // Tensors of at least this size are aligned in the arena and returned
+  // without a copy.
+  static constexpr size_t kMinAlignedBytes = 256;
+  // Tensors of at least this size are compressed if `Options::compress` is set.
+  static constexpr size_t kMinCompressedBytes = 1024;
+
+  ColumnarCache() : ColumnarCache(Options()) {}
+  explicit ColumnarCache(const Options& options);
+  ~ColumnarCache();
+
+  // Stores `element` at position `index`. All elements must have the same
+  // number of components.
+  absl::Status Put(int64_t index, const std::vector<Tensor>& element)
+      TF_LOCKS_EXCLUDED(mu_);
+
+  // Stores `element` at position `size()`.
+  absl::Status Append(const std::vector<Tensor>& element)
+      TF_LOCKS_EXCLUDED(mu_);
+
+  // Whether an element is stored at position `index`.
+  bool Contains(int64_t index) const TF_LOCKS_EXCLUDED(mu_);
+
+  // Reads the element at position `index` into `element`.
+  absl::Status Get(int64_t index, std::vector<Tensor>* element) const
+      TF_LOCKS_EXCLUDED(mu_);
+
+  // One past the largest position at which an element is stored.
+  int64_t size() const TF_LOCKS_EXCLUDED(mu_);
+
+  // The number of bytes of memory held by the arenas, the index, and the
+  // tensors kept as tensors.
+  int64_t AllocatedBytes() const TF_LOCKS_EXCLUDED(mu_);
+
+ private:
+  class Arena;
+
+  // Where the contents of one tensor are stored.
+  struct Entry {
+    // Index into `arenas_`, `kTensorArena` if the tensor is kept in
+    // `tensors_`, or `kNoArena` if the tensor has no bytes.
+    uint32_t arena;
+    // Index into the layouts of the component.
+    uint32_t layout;
+    // Offset into the arena or index into `tensors_`.
+    uint32_t offset;
+    // Number of bytes stored in the arena. The top bit is set if the bytes are
+    // compressed.
+    uint32_t stored_bytes;
+  };
+  static_assert(sizeof(Entry) == 16);
+
+  // The type and shape of tensors of one component.
+  struct Layout {
+    DataType dtype;
+    TensorShape shape;
+  };
+
+  struct Component {
+    std::vector<Layout> layouts;
+    // Index into `layouts`, keyed by the type and dimensions.
+    absl::flat_hash_map<std::string, uint32_t> layout_ids;
+    // The layout of the last tensor that was stored.
+    uint32_t last_layout = 0;
+    // The arena that tensors of this component are appended to.
+    uint32_t arena = kNoArena;
+  };
+
+  static constexpr uint32_t kNoArena = ~uint32_t{0};
+  static constexpr uint32_t kTensorArena = kNoArena - 1;
+
+  int64_t size_locked() const TF_SHARED_LOCKS_REQUIRED(mu_) {
+    return present_.size();
+  }
+
+  absl::Status PutLocked(int64_t index, const std::vector<Tensor>& element)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Stores `tensor` of component `component` and returns where it is stored.
+  absl::Status PutTensor(size_t component, const Tensor& tensor, Entry* entry)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Returns the layout id of `tensor` in `component`.
+  uint32_t GetLayoutId(Component& component, const Tensor& tensor)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  // Appends `size` bytes to the arena of `component`, aligned to `alignment`,
+  // and sets `arena` and `offset` to where they are placed. Returns nullptr
+  // if a new arena is needed and cannot be allocated.
+  char* Allocate(Component& component, size_t size, size_t alignment,
+                 uint32_t* arena, uint32_t* offset)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  absl::Status GetTensor(size_t component, const Entry& entry,
+                         Tensor* tensor) const TF_SHARED_LOCKS_REQUIRED(mu_);
+
+  const Options options_;
+
+  mutable mutex mu_;
+  // Number of components of the elements, or -1 before the first element.
+  int64_t num_components_ TF_GUARDED_BY(mu_) = -1;
+  std::vector<Component> components_ TF_GUARDED_BY(mu_);
+  // The entries of the element at position `i` are at
+  // `[i * num_components_, (i + 1) * num_components_)`.
+  std::vector<Entry> entries_ TF_GUARDED_BY(mu_);
+  // Whether an element is stored at position `i`.
+  std::vector<bool> present_ TF_GUARDED_BY(mu_);
+  std::vector<core::RefCountPtr<Arena>> arenas_ TF_GUARDED_BY(mu_);
+  std::vector<Tensor> tensors_ TF_GUARDED_BY(mu_);
+  int64_t tensor_bytes_ TF_GUARDED_BY(mu_) = 0;
+
+  ColumnarCache(const ColumnarCache&) = delete;
+  void operator=(const ColumnarCache&) = delete;
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_COLUMNAR_CACHE_H_
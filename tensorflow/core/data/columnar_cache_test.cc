@@ -0,0 +1,199 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/columnar_cache.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include "absl/status/status.h"
+#include "xla/tsl/platform/status_matchers.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/framework/variant.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/tstring.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+using ::tsl::testing::StatusIs;
+
+// An element with a scalar, a small vector, a vector that is large enough to
+// be aliased, and a string vector whose length depends on `i`.
+std::vector<Tensor> MakeElement(int64_t i) {
+  std::vector<float> large(128);
+  for (int64_t j = 0; j < large.size(); ++j) {
+    large[j] = i + j * 0.5f;
+  }
+  std::vector<tstring> strings;
+  for (int64_t j = 0; j <= i % 3; ++j) {
+    strings.push_back(std::string(i % 5 + j, 'a' + j));
+  }
+  return {test::AsScalar<int64_t>(i),
+          test::AsTensor<int32_t>({static_cast<int32_t>(i), -1, 7}),
+          test::AsTensor<float>(large),
+          test::AsTensor<tstring>(strings,
+                                  {static_cast<int64_t>(strings.size())})};
+}
+
+void ExpectElement(const std::vector<Tensor>& element, int64_t i) {
+  std::vector<Tensor> expected = MakeElement(i);
+  ASSERT_EQ(element.size(), expected.size());
+  for (int64_t j = 0; j < element.size(); ++j) {
+    test::ExpectEqual(element[j], expected[j]);
+  }
+}
+
+TEST(ColumnarCacheTest, AppendAndGet) {
+  ColumnarCache cache;
+  constexpr int64_t kNumElements = 1000;
+  for (int64_t i = 0; i < kNumElements; ++i) {
+    TF_ASSERT_OK(cache.Append(MakeElement(i)));
+  }
+  EXPECT_EQ(cache.size(), kNumElements);
+  for (int64_t i = kNumElements - 1; i >= 0; --i) {
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(cache.Get(i, &element));
+    ExpectElement(element, i);
+  }
+}
+
+TEST(ColumnarCacheTest, PutOutOfOrder) {
+  ColumnarCache cache;
+  TF_ASSERT_OK(cache.Put(5, MakeElement(5)));
+  TF_ASSERT_OK(cache.Put(2, MakeElement(2)));
+  EXPECT_EQ(cache.size(), 6);
+  EXPECT_TRUE(cache.Contains(5));
+  EXPECT_TRUE(cache.Contains(2));
+  EXPECT_FALSE(cache.Contains(3));
+  EXPECT_FALSE(cache.Contains(6));
+
+  std::vector<Tensor> element;
+  TF_ASSERT_OK(cache.Get(2, &element));
+  ExpectElement(element, 2);
+  TF_ASSERT_OK(cache.Get(5, &element));
+  ExpectElement(element, 5);
+  EXPECT_THAT(cache.Get(3, &element), StatusIs(absl::StatusCode::kNotFound));
+  EXPECT_THAT(cache.Get(6, &element),
+              StatusIs(absl::StatusCode::kOutOfRange));
+  EXPECT_THAT(cache.Put(5, MakeElement(5)),
+              StatusIs(absl::StatusCode::kAlreadyExists));
+}
+
+TEST(ColumnarCacheTest, LargeTensorsAliasTheArena) {
+  ColumnarCache cache;
+  TF_ASSERT_OK(cache.Append(MakeElement(0)));
+  std::vector<Tensor> first, second;
+  TF_ASSERT_OK(cache.Get(0, &first));
+  TF_ASSERT_OK(cache.Get(0, &second));
+  // The large component is not copied, the small ones are.
+  EXPECT_EQ(first[2].tensor_data().data(), second[2].tensor_data().data());
+  EXPECT_NE(first[1].tensor_data().data(), second[1].tensor_data().data());
+  // Aliased tensors must not be forwarded by kernels.
+  EXPECT_FALSE(first[2].RefCountIsOne());
+}
+
+TEST(ColumnarCacheTest, TensorsOutliveCache) {
+  std::vector<Tensor> element;
+  {
+    ColumnarCache cache;
+    TF_ASSERT_OK(cache.Append(MakeElement(3)));
+    TF_ASSERT_OK(cache.Get(0, &element));
+  }
+  ExpectElement(element, 3);
+}
+
+TEST(ColumnarCacheTest, Compression) {
+  ColumnarCache::Options options;
+  options.compress = true;
+  ColumnarCache compressed(options);
+  // Compressible tensors above the compression threshold.
+  Tensor zeros(DT_INT64, TensorShape({1024}));
+  zeros.flat<int64_t>().setZero();
+  std::vector<tstring> repeated(256, "repeated string");
+  Tensor strings = test::AsTensor<tstring>(repeated, {256});
+  for (int64_t i = 0; i < 16; ++i) {
+    TF_ASSERT_OK(compressed.Append({zeros, strings}));
+  }
+  for (int64_t i = 0; i < 16; ++i) {
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(compressed.Get(i, &element));
+    test::ExpectEqual(element[0], zeros);
+    test::ExpectEqual(element[1], strings);
+  }
+
+  ColumnarCache::Options small_arenas;
+  small_arenas.compress = true;
+  small_arenas.arena_bytes = 4096;
+  ColumnarCache compressed_small(small_arenas);
+  small_arenas.compress = false;
+  ColumnarCache uncompressed_small(small_arenas);
+  for (int64_t i = 0; i < 64; ++i) {
+    TF_ASSERT_OK(compressed_small.Append({zeros}));
+    TF_ASSERT_OK(uncompressed_small.Append({zeros}));
+  }
+  EXPECT_LT(compressed_small.AllocatedBytes() * 4,
+            uncompressed_small.AllocatedBytes());
+}
+
+TEST(ColumnarCacheTest, EmptyAndVariantTensors) {
+  ColumnarCache cache;
+  Tensor variant(DT_VARIANT, TensorShape({}));
+  variant.scalar<Variant>()() = test::AsScalar<int64_t>(42);
+  Tensor empty(DT_FLOAT, TensorShape({0, 3}));
+  Tensor empty_strings(DT_STRING, TensorShape({0}));
+  TF_ASSERT_OK(cache.Append({variant, empty, empty_strings}));
+  std::vector<Tensor> element;
+  TF_ASSERT_OK(cache.Get(0, &element));
+  ASSERT_EQ(element.size(), 3);
+  EXPECT_EQ(element[0].dtype(), DT_VARIANT);
+  ASSERT_NE(element[0].scalar<Variant>()().get<Tensor>(), nullptr);
+  test::ExpectEqual(*element[0].scalar<Variant>()().get<Tensor>(),
+                    test::AsScalar<int64_t>(42));
+  EXPECT_EQ(element[1].shape(), TensorShape({0, 3}));
+  EXPECT_EQ(element[2].dtype(), DT_STRING);
+  EXPECT_EQ(element[2].NumElements(), 0);
+}
+
+TEST(ColumnarCacheTest, VaryingShapes) {
+  ColumnarCache cache;
+  for (int64_t i = 0; i < 10; ++i) {
+    std::vector<int64_t> values(i % 4, i);
+    TF_ASSERT_OK(cache.Append(
+        {test::AsTensor<int64_t>(values, {static_cast<int64_t>(i % 4)})}));
+  }
+  for (int64_t i = 0; i < 10; ++i) {
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(cache.Get(i, &element));
+    std::vector<int64_t> values(i % 4, i);
+    test::ExpectEqual(element[0], test::AsTensor<int64_t>(
+                                      values, {static_cast<int64_t>(i % 4)}));
+  }
+}
+
+TEST(ColumnarCacheTest, ComponentMismatch) {
+  ColumnarCache cache;
+  TF_ASSERT_OK(cache.Append(MakeElement(0)));
+  EXPECT_THAT(cache.Append({test::AsScalar<int64_t>(1)}),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
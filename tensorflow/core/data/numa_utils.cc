@@ -0,0 +1,118 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/numa_utils.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/numa.h"
+#include "tensorflow/core/platform/refcount.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// `port::NUMAMalloc` requires the size of the allocation when it is freed, so
+// the buffer frees its own memory instead of going through an `Allocator`.
+class NUMABuffer : public TensorBuffer {
+ public:
+  // Takes ownership of `data`, which `port::NUMAMalloc` returned for `size`
+  // bytes.
+  NUMABuffer(void* data, size_t size) : TensorBuffer(data), size_(size) {}
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocator_name("numa");
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+
+ private:
+  ~NUMABuffer() override { port::NUMAFree(data(), size_); }
+
+  const size_t size_;
+};
+
+}  // namespace
+
+bool IsMultiNUMANode() {
+  static const bool is_multi_numa_node =
+      port::NUMAEnabled() && port::NUMANumNodes() > 1;
+  return is_multi_numa_node;
+}
+
+int GetCurrentNUMANode() {
+  if (!port::NUMAEnabled()) {
+    return port::kNUMANoAffinity;
+  }
+  const int numa_node = port::NUMAGetThreadNodeAffinity();
+  if (numa_node != port::kNUMANoAffinity) {
+    return numa_node;
+  }
+  volatile char on_stack = 0;
+  return port::NUMAGetMemAffinity(const_cast<const char*>(&on_stack));
+}
+
+Tensor CopyToNUMANode(const Tensor& tensor, int numa_node) {
+  DCHECK(DataTypeCanUseMemcpy(tensor.dtype()));
+  const absl::string_view bytes = tensor.tensor_data();
+  void* data =
+      port::NUMAMalloc(numa_node, bytes.size(), Allocator::kAllocatorAlignment);
+  if (data == nullptr) {
+    LOG_FIRST_N(WARNING, 1) << "Cannot allocate " << bytes.size()
+                            << " bytes on NUMA node " << numa_node
+                            << "; keeping the tensor where it is.";
+    return tensor;
+  }
+  core::RefCountPtr<TensorBuffer> buffer(new NUMABuffer(data, bytes.size()));
+  std::memcpy(buffer->data(), bytes.data(), bytes.size());
+  return Tensor(tensor.dtype(), tensor.shape(), std::move(buffer));
+}
+
+int64_t MoveToNUMANode(int numa_node, size_t min_bytes,
+                       std::vector<Tensor>* element) {
+  int64_t bytes_copied = 0;
+  for (Tensor& tensor : *element) {
+    if (!DataTypeCanUseMemcpy(tensor.dtype()) ||
+        tensor.TotalBytes() < min_bytes) {
+      continue;
+    }
+    const int tensor_node =
+        port::NUMAGetMemAffinity(tensor.tensor_data().data());
+    if (tensor_node == port::kNUMANoAffinity || tensor_node == numa_node) {
+      continue;
+    }
+    Tensor copy = CopyToNUMANode(tensor, numa_node);
+    if (!copy.SharesBufferWith(tensor)) {
+      bytes_copied += tensor.TotalBytes();
+      tensor = std::move(copy);
+    }
+  }
+  return bytes_copied;
+}
+
+}  // namespace data
+}  // namespace tensorflow
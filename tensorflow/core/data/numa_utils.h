@@ -0,0 +1,59 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_NUMA_UTILS_H_
+#define TENSORFLOW_CORE_DATA_NUMA_UTILS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "tensorflow/core/framework/tensor.h"
+
+namespace tensorflow {
+namespace data {
+
+// Experiment that makes `PrefetchDataset` produce its buffered elements on the
+// NUMA node of the thread that consumes them.
+inline constexpr char kNumaAwarePrefetchExperiment[] = "numa_aware_prefetch";
+
+// Tensors smaller than this are not moved between NUMA nodes, because the copy
+// costs more than reading them from a remote node once.
+inline constexpr size_t kMinNUMAMoveBytes = 64 << 10;
+
+// Whether the machine has more than one NUMA node and the NUMA functions of
+// `port` are supported.
+bool IsMultiNUMANode();
+
+// Returns the NUMA node of the calling thread. This is the node the thread is
+// bound to or, for threads that are not bound, the node that holds the stack
+// of the thread, which is where the thread was running when the stack was
+// first touched. Returns `port::kNUMANoAffinity` if the node is not known.
+int GetCurrentNUMANode();
+
+// Returns a copy of `tensor` whose buffer is allocated on `numa_node`, or
+// `tensor` itself if the memory cannot be allocated. The type of `tensor` must
+// support `memcpy`.
+Tensor CopyToNUMANode(const Tensor& tensor, int numa_node);
+
+// Replaces the tensors of `element` that have at least `min_bytes` bytes and
+// are known to reside on a NUMA node other than `numa_node` with copies on
+// `numa_node`. Returns the number of bytes copied.
+int64_t MoveToNUMANode(int numa_node, size_t min_bytes,
+                       std::vector<Tensor>* element);
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_NUMA_UTILS_H_
@@ -0,0 +1,113 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/numa_utils.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/numa.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/platform/tstring.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+TEST(NumaUtilsTest, CopyToNUMANode) {
+  Tensor tensor(DT_FLOAT, TensorShape({128, 64}));
+  tensor.flat<float>().setRandom();
+  Tensor copy = CopyToNUMANode(tensor, 0);
+  test::ExpectEqual(copy, tensor);
+  EXPECT_NE(copy.tensor_data().data(), tensor.tensor_data().data());
+  EXPECT_TRUE(copy.RefCountIsOne());
+  if (IsMultiNUMANode()) {
+    EXPECT_EQ(port::NUMAGetMemAffinity(copy.tensor_data().data()), 0);
+  }
+}
+
+TEST(NumaUtilsTest, MoveToNUMANode) {
+  if (!IsMultiNUMANode()) {
+    GTEST_SKIP() << "Requires more than one NUMA node.";
+  }
+  Tensor remote = CopyToNUMANode(test::AsTensor<int64_t>(std::vector<int64_t>(
+                                     kMinNUMAMoveBytes / sizeof(int64_t), 7)),
+                                 1);
+  Tensor small = CopyToNUMANode(test::AsTensor<int64_t>({1, 2, 3}), 1);
+  Tensor local = CopyToNUMANode(remote, 0);
+  std::vector<Tensor> element = {remote, small, local,
+                                 test::AsTensor<tstring>({"a", "b"})};
+  EXPECT_EQ(MoveToNUMANode(0, kMinNUMAMoveBytes, &element),
+            remote.TotalBytes());
+  test::ExpectEqual(element[0], remote);
+  EXPECT_EQ(port::NUMAGetMemAffinity(element[0].tensor_data().data()), 0);
+  // Small, local, and non-memcpy tensors are left alone.
+  EXPECT_EQ(element[1].tensor_data().data(), small.tensor_data().data());
+  EXPECT_EQ(element[2].tensor_data().data(), local.tensor_data().data());
+}
+
+TEST(NumaUtilsTest, MoveToNUMANodeWithoutAffinity) {
+  // Without NUMA support the node of a tensor is unknown and nothing moves.
+  if (port::NUMAEnabled()) {
+    GTEST_SKIP() << "Requires NUMA support to be disabled.";
+  }
+  std::vector<Tensor> element = {Tensor(DT_INT64, TensorShape({1 << 16}))};
+  EXPECT_EQ(MoveToNUMANode(0, 0, &element), 0);
+  EXPECT_EQ(GetCurrentNUMANode(), port::kNUMANoAffinity);
+}
+
+// Reads a prefetched element of `state.range(0)` bytes from a thread bound to
+// NUMA node 0. With `state.range(1) == 0` the element is on the node of the
+// reader, as `numa_aware_prefetch` places it; otherwise it is on the last node,
+// which is where a producer thread on another socket would leave it. The
+// difference in bandwidth is what placing the buffers saves per byte read.
+void BM_ReadPrefetchedElement(::testing::benchmark::State& state) {
+  if (!IsMultiNUMANode()) {
+    state.SkipWithError("Requires more than one NUMA node.");
+    return;
+  }
+  const int64_t num_bytes = state.range(0);
+  const int element_node = state.range(1) ? port::NUMANumNodes() - 1 : 0;
+  port::NUMASetThreadNodeAffinity(0);
+  Tensor element = CopyToNUMANode(
+      Tensor(DT_INT64, TensorShape({num_bytes / int64_t{sizeof(int64_t)}})),
+      element_node);
+  auto values = element.flat<int64_t>();
+  values.setConstant(1);
+  for (auto s : state) {
+    int64_t sum = 0;
+    for (int64_t i = 0; i < values.size(); ++i) {
+      sum += values(i);
+    }
+    ::testing::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          num_bytes);
+  port::NUMASetThreadNodeAffinity(port::kNUMANoAffinity);
+}
+
+BENCHMARK(BM_ReadPrefetchedElement)
+    ->ArgPair(1 << 20, 0)
+    ->ArgPair(1 << 20, 1)
+    ->ArgPair(64 << 20, 0)
+    ->ArgPair(64 << 20, 1);
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -146,9 +146,7 @@ absl::Status ReadElementsFromCheckpoint(
 
 absl::Status WriteElement(IteratorStateWriter* writer,
                           absl::string_view key_prefix,
-                          const std::vector<std::vector<Tensor>>& elements,
-                          int64_t index) {
-  const std::vector<Tensor>& element = elements[index];
+                          const std::vector<Tensor>& element, int64_t index) {
   std::string element_prefix = absl::StrCat(key_prefix, "::", index);
   TF_RETURN_IF_ERROR(
       writer->WriteScalar(element_prefix, kNumComponents, element.size()));
@@ -165,7 +163,20 @@ absl::Status WriteElementsToCheckpoint(
   TF_RETURN_IF_ERROR(
       writer->WriteScalar(key_prefix, kNumElements, elements.size()));
   for (int i = 0; i < elements.size(); ++i) {
-    TF_RETURN_IF_ERROR(WriteElement(writer, key_prefix, elements, i));
+    TF_RETURN_IF_ERROR(WriteElement(writer, key_prefix, elements[i], i));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status WriteElementsToCheckpoint(
+    IteratorStateWriter* writer, absl::string_view key_prefix,
+    int64_t num_elements, const CheckpointElementGetter& get_element) {
+  TF_RETURN_IF_ERROR(
+      writer->WriteScalar(key_prefix, kNumElements, num_elements));
+  std::vector<Tensor> element;
+  for (int64_t i = 0; i < num_elements; ++i) {
+    TF_RETURN_IF_ERROR(get_element(i, &element));
+    TF_RETURN_IF_ERROR(WriteElement(writer, key_prefix, element, i));
   }
   return absl::OkStatus();
 }
@@ -177,7 +188,22 @@ absl::Status UpdateCheckpointElements(
   TF_RETURN_IF_ERROR(
       writer->WriteScalar(key_prefix, kNumElements, elements.size()));
   for (int64_t i : checkpoint_indices) {
-    TF_RETURN_IF_ERROR(WriteElement(writer, key_prefix, elements, i));
+    TF_RETURN_IF_ERROR(WriteElement(writer, key_prefix, elements[i], i));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status UpdateCheckpointElements(
+    IteratorStateWriter* writer, absl::string_view key_prefix,
+    int64_t num_elements,
+    const absl::flat_hash_set<int64_t>& checkpoint_indices,
+    const CheckpointElementGetter& get_element) {
+  TF_RETURN_IF_ERROR(
+      writer->WriteScalar(key_prefix, kNumElements, num_elements));
+  std::vector<Tensor> element;
+  for (int64_t i : checkpoint_indices) {
+    TF_RETURN_IF_ERROR(get_element(i, &element));
+    TF_RETURN_IF_ERROR(WriteElement(writer, key_prefix, element, i));
   }
   return absl::OkStatus();
 }
@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -63,6 +64,23 @@ absl::Status UpdateCheckpointElements(
     const std::vector<std::vector<Tensor>>& elements,
     const absl::flat_hash_set<int64_t>& checkpoint_indices);
 
+// Variants of `WriteElementsToCheckpoint` and `UpdateCheckpointElements` for
+// callers that do not keep all `num_elements` elements in memory.
+// `get_element` is called once for each element that is written and stores
+// the element at the given index in its output argument.
+using CheckpointElementGetter =
+    std::function<absl::Status(int64_t index, std::vector<Tensor>* element)>;
+
+absl::Status WriteElementsToCheckpoint(
+    IteratorStateWriter* writer, absl::string_view key_prefix,
+    int64_t num_elements, const CheckpointElementGetter& get_element);
+
+absl::Status UpdateCheckpointElements(
+    IteratorStateWriter* writer, absl::string_view key_prefix,
+    int64_t num_elements,
+    const absl::flat_hash_set<int64_t>& checkpoint_indices,
+    const CheckpointElementGetter& get_element);
+
 // Helper class for reading data from a vector of VariantTensorData objects.
 class VariantTensorDataReader : public IteratorStateReader {
  public:
@@ -0,0 +1,86 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/work_stealing_runner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/resource.h"
+#include "tensorflow/core/platform/threadpool.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// Number of workers whose queues receive the functions that a runner schedules
+// from outside of the pool.
+constexpr int kWorkerGroupSize = 4;
+
+// Assigns worker groups to runners round-robin.
+std::atomic<int64_t> next_worker_group{0};
+
+void ScheduleOnWorkerGroup(thread::ThreadPool* pool, int start, int limit,
+                           std::function<void()> fn) {
+  pool->ScheduleWithHint(
+      [fn = std::move(fn)]() {
+        tensorflow::ResourceTagger tag(kTFDataResourceTag, "ThreadPool");
+        fn();
+      },
+      start, limit);
+}
+
+}  // namespace
+
+thread::ThreadPool* GetWorkStealingThreadPool() {
+  static thread::ThreadPool* pool = new thread::ThreadPool(
+      Env::Default(), ThreadOptions(), "tf_data_work_stealing",
+      std::max(1, port::MaxParallelism()), /*low_latency_hint=*/false);
+  return pool;
+}
+
+WorkStealingRunner::WorkStealingRunner()
+    : WorkStealingRunner(GetWorkStealingThreadPool()) {}
+
+WorkStealingRunner::WorkStealingRunner(thread::ThreadPool* pool)
+    : pool_(pool) {
+  const int num_threads = pool_->NumThreads();
+  const int group_size = std::min(kWorkerGroupSize, num_threads);
+  const int num_groups = num_threads / group_size;
+  const int group = next_worker_group.fetch_add(1) % num_groups;
+  group_start_ = group * group_size;
+  group_limit_ =
+      group == num_groups - 1 ? num_threads : group_start_ + group_size;
+}
+
+void WorkStealingRunner::Schedule(std::function<void()> fn) const {
+  ScheduleOnWorkerGroup(pool_, group_start_, group_limit_, std::move(fn));
+}
+
+std::function<void(std::function<void()>)>
+WorkStealingRunner::AsRunnerFunction() const {
+  return [pool = pool_, start = group_start_,
+          limit = group_limit_](std::function<void()> fn) {
+    ScheduleOnWorkerGroup(pool, start, limit, std::move(fn));
+  };
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,75 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_DATA_WORK_STEALING_RUNNER_H_
+#define TENSORFLOW_CORE_DATA_WORK_STEALING_RUNNER_H_
+
+#include <functional>
+
+#include "tensorflow/core/platform/threadpool.h"
+
+namespace tensorflow {
+namespace data {
+
+// Experiment that makes the parallel tf.data transformations run their
+// functions on the work-stealing thread pool below.
+inline constexpr char kWorkStealingRunnerExperiment[] = "work_stealing_runner";
+
+// Returns the process-wide thread pool that the parallel tf.data
+// transformations share when `kWorkStealingRunnerExperiment` is enabled.
+// It has one worker per schedulable core, and each worker has its own task
+// queue that idle workers steal from.
+thread::ThreadPool* GetWorkStealingThreadPool();
+
+// Schedules the functions of one iterator on a work-stealing thread pool.
+//
+// Functions scheduled from outside of the pool are placed on the queues of a
+// small group of workers assigned to the runner, so that the work of one
+// iterator tends to stay on the same cores. Functions scheduled from a worker
+// of the pool, such as the ops of a function that is already running, go to
+// that worker's own queue. Idle workers steal from any queue, so a busy group
+// does not leave the other cores idle.
+//
+// Functions run on a fixed number of threads, so they must not block waiting
+// for other functions scheduled on the same pool.
+class WorkStealingRunner {
+ public:
+  // Uses the pool returned by `GetWorkStealingThreadPool()`.
+  WorkStealingRunner();
+
+  // Uses `pool`, which must outlive the runner and the functions returned by
+  // `AsRunnerFunction()`.
+  explicit WorkStealingRunner(thread::ThreadPool* pool);
+
+  void Schedule(std::function<void()> fn) const;
+
+  // Returns a function that can be used as a function library runner. It does
+  // not refer to this object.
+  std::function<void(std::function<void()>)> AsRunnerFunction() const;
+
+  // The range of pool workers whose queues receive the functions scheduled from
+  // outside of the pool.
+  int group_start() const { return group_start_; }
+  int group_limit() const { return group_limit_; }
+
+ private:
+  thread::ThreadPool* const pool_;  // Not owned.
+  int group_start_;
+  int group_limit_;
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DATA_WORK_STEALING_RUNNER_H_
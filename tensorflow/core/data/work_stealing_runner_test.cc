@@ -0,0 +1,167 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/data/work_stealing_runner.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/data/unbounded_thread_pool.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/platform/threadpool.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+TEST(WorkStealingRunnerTest, RunsAllFunctions) {
+  WorkStealingRunner runner;
+  const int kNumFunctions = 1000;
+  std::atomic<int> count(0);
+  BlockingCounter counter(kNumFunctions);
+  for (int i = 0; i < kNumFunctions; ++i) {
+    runner.Schedule([&count, &counter]() {
+      ++count;
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+  EXPECT_EQ(count, kNumFunctions);
+}
+
+TEST(WorkStealingRunnerTest, NestedFunctions) {
+  thread::ThreadPool pool(Env::Default(), "test", /*num_threads=*/4);
+  WorkStealingRunner runner(&pool);
+  auto runner_fn = runner.AsRunnerFunction();
+  const int kNumFunctions = 10;
+  BlockingCounter counter(kNumFunctions * kNumFunctions);
+  for (int i = 0; i < kNumFunctions; ++i) {
+    runner_fn([&runner_fn, &counter]() {
+      for (int j = 0; j < kNumFunctions; ++j) {
+        runner_fn([&counter]() { counter.DecrementCount(); });
+      }
+    });
+  }
+  counter.Wait();
+}
+
+TEST(WorkStealingRunnerTest, WorkerGroupsCoverThePool) {
+  thread::ThreadPool pool(Env::Default(), "test", /*num_threads=*/10);
+  std::vector<bool> covered(pool.NumThreads(), false);
+  for (int i = 0; i < 8; ++i) {
+    WorkStealingRunner runner(&pool);
+    ASSERT_LT(runner.group_start(), runner.group_limit());
+    ASSERT_LE(runner.group_limit(), pool.NumThreads());
+    for (int j = runner.group_start(); j < runner.group_limit(); ++j) {
+      covered[j] = true;
+    }
+  }
+  for (int i = 0; i < pool.NumThreads(); ++i) {
+    EXPECT_TRUE(covered[i]) << i;
+  }
+}
+
+TEST(WorkStealingRunnerTest, SingleThreadPool) {
+  thread::ThreadPool pool(Env::Default(), "test", /*num_threads=*/1);
+  WorkStealingRunner runner(&pool);
+  EXPECT_EQ(runner.group_start(), 0);
+  EXPECT_EQ(runner.group_limit(), 1);
+  BlockingCounter counter(1);
+  runner.Schedule([&counter]() { counter.DecrementCount(); });
+  counter.Wait();
+}
+
+// Simulates the function invocations of `num_iterators` parallel map
+// iterators, which each schedule `kFunctionsPerIterator` small functions.
+constexpr int kFunctionsPerIterator = 64;
+
+void SpinFor(int64_t iterations) {
+  std::atomic<int64_t> sink(0);
+  for (int64_t i = 0; i < iterations; ++i) {
+    sink.fetch_add(i, std::memory_order_relaxed);
+  }
+}
+
+void RunIterators(
+    const std::vector<std::function<void(std::function<void()>)>>& runners) {
+  BlockingCounter counter(runners.size() * kFunctionsPerIterator);
+  for (int i = 0; i < kFunctionsPerIterator; ++i) {
+    for (const auto& runner : runners) {
+      runner([&counter]() {
+        SpinFor(1000);
+        counter.DecrementCount();
+      });
+    }
+  }
+  counter.Wait();
+}
+
+// Arguments: number of cores, i.e. pool threads and parallel iterators.
+void BM_WorkStealingRunner(::testing::benchmark::State& state) {
+  const int num_cores = state.range(0);
+  thread::ThreadPool pool(Env::Default(), "bench", num_cores);
+  std::vector<std::function<void(std::function<void()>)>> runners;
+  for (int i = 0; i < num_cores; ++i) {
+    runners.push_back(WorkStealingRunner(&pool).AsRunnerFunction());
+  }
+  for (auto s : state) {
+    RunIterators(runners);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          num_cores * kFunctionsPerIterator);
+}
+
+// Baseline: every iterator schedules its functions on its own thread pool.
+void BM_PerIteratorThreadPools(::testing::benchmark::State& state) {
+  const int num_cores = state.range(0);
+  std::vector<std::unique_ptr<UnboundedThreadPool>> pools;
+  std::vector<std::function<void(std::function<void()>)>> runners;
+  for (int i = 0; i < num_cores; ++i) {
+    pools.push_back(std::make_unique<UnboundedThreadPool>(Env::Default(),
+                                                          "bench"));
+    runners.push_back([pool = pools.back().get()](std::function<void()> fn) {
+      pool->Schedule(std::move(fn));
+    });
+  }
+  for (auto s : state) {
+    RunIterators(runners);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) *
+                          num_cores * kFunctionsPerIterator);
+}
+
+BENCHMARK(BM_WorkStealingRunner)
+    ->Arg(8)
+    ->Arg(16)
+    ->Arg(32)
+    ->Arg(64)
+    ->Arg(96)
+    ->UseRealTime();
+BENCHMARK(BM_PerIteratorThreadPools)
+    ->Arg(8)
+    ->Arg(16)
+    ->Arg(32)
+    ->Arg(64)
+    ->Arg(96)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
@@ -15,6 +15,7 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/collective_rma_distributed.h"
 
 #include <memory>
+#include <string>
 
 #include "absl/status/status.h"
 #include "tensorflow/core/common_runtime/base_collective_executor.h"
@@ -25,6 +26,7 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/call_options.h"
 #include "tensorflow/core/distributed_runtime/cancellable_call.h"
 #include "tensorflow/core/distributed_runtime/request_id.h"
+#include "tensorflow/core/distributed_runtime/tensor_compression.h"
 #include "tensorflow/core/distributed_runtime/worker_cache.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -57,6 +59,9 @@ class RecvBufCall : public CancellableCall {
     req_.set_src_incarnation(server_attributes.incarnation());
     req_.set_dst_device(to_device->name());
     req_.set_request_id(GetUniqueRequestId());
+    // Lossy codecs would round the partial results differently on each
+    // worker and make the replicas diverge.
+    AcceptLosslessTensorCodecs(req_.mutable_accepted_codecs());
   }
 
   ~RecvBufCall() override {}
@@ -98,6 +103,15 @@ absl::Status PopulateTensorFromResponse(const RecvBufResponse& response,
     num_bytes += chunk.size();
   }
 
+  if (extra.codec() != TENSOR_CODEC_NONE) {
+    std::string content;
+    content.reserve(num_bytes);
+    for (const auto& chunk : extra.tensor_content()) {
+      content.append(chunk);
+    }
+    return DecompressTensor(extra.codec(), content, extra.scale(), cpu_tensor);
+  }
+
   if (num_bytes != total_bytes) {
     return absl::InternalError(absl::StrCat(
         "Tensor Size Mismatch: RecvBufResponse returned ", num_bytes,
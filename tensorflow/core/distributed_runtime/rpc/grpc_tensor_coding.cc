@@ -256,5 +256,27 @@ absl::Status EncodeTensorToByteBuffer(bool is_dead, const Tensor& val,
   return absl::OkStatus();
 }
 
+void EncodeOutOfBandTensorToByteBuffer(
+    const Tensor& val, const protobuf::Message& transport_options,
+    bool require_ack, ::grpc::ByteBuffer* result) {
+  RecvTensorResponse header;
+  header.mutable_transport_options()->PackFrom(transport_options);
+  header.set_require_ack(require_ack);
+  header.set_send_start_micros(Env::Default()->NowMicros());
+
+  // Concatenated encodings parse as the merged message.
+  RecvTensorResponse skeleton;
+  skeleton.mutable_tensor()->set_dtype(val.dtype());
+  val.shape().AsProto(skeleton.mutable_tensor()->mutable_tensor_shape());
+
+  const size_t header_size = header.ByteSizeLong();
+  ::grpc::Slice slice(header_size + skeleton.ByteSizeLong());
+  uint8_t* data = const_cast<uint8_t*>(slice.begin());
+  header.SerializeWithCachedSizesToArray(data);
+  skeleton.SerializeWithCachedSizesToArray(data + header_size);
+  ::grpc::ByteBuffer tmp(&slice, 1);
+  result->Swap(&tmp);
+}
+
 }  // namespace grpc
 }  // namespace tensorflow
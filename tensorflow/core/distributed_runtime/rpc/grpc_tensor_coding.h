@@ -18,6 +18,7 @@ limitations under the License.
 
 #include "grpcpp/impl/codegen/byte_buffer.h"
 #include "absl/status/status.h"
+#include "tensorflow/core/platform/protobuf.h"
 
 namespace tensorflow {
 class Tensor;
@@ -51,6 +52,18 @@ absl::Status EncodeTensorToByteBuffer(bool is_dead, const Tensor& val,
                                       bool require_ack,
                                       ::grpc::ByteBuffer* result);
 
+// Encode the dtype and shape of "val" into a byte buffer in a format that is
+// parseable as a RecvTensorResponse protocol buffer whose content is sent out
+// of band, as described by "transport_options", e.g. a shared memory segment
+// or a compressed encoding. The transport options are encoded before the
+// tensor, so that the receiver knows not to allocate the tensor when it
+// parses it.
+//
+// Discards original contents of *result.
+void EncodeOutOfBandTensorToByteBuffer(
+    const Tensor& val, const protobuf::Message& transport_options,
+    bool require_ack, ::grpc::ByteBuffer* result);
+
 }  // namespace grpc
 }  // namespace tensorflow
 
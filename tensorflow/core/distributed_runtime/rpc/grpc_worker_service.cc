@@ -43,6 +43,8 @@ limitations under the License.
 #include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_worker_service_impl.h"
 #include "tensorflow/core/distributed_runtime/rpc/rpc_response_cache.h"
+#include "tensorflow/core/distributed_runtime/shared_memory_transport.h"
+#include "tensorflow/core/distributed_runtime/tensor_compression.h"
 #include "tensorflow/core/distributed_runtime/worker.h"
 #include "tensorflow/core/distributed_runtime/worker_cache.h"
 #include "tensorflow/core/distributed_runtime/worker_session.h"
@@ -462,7 +464,22 @@ void GrpcWorker::GrpcRecvTensorAsync(CallOptions* opts,
                          const Tensor& tensor, bool is_dead,
                          const absl::Status& status) {
     absl::Status updated_status;
-    if (status.ok()) {
+    SharedMemoryRecvResponseExtra shared_memory;
+    CompressedTensor compressed;
+    if (status.ok() && !is_dead &&
+        ExportToSharedMemory(*request, tensor, &shared_memory)) {
+      grpc::EncodeOutOfBandTensorToByteBuffer(tensor, shared_memory,
+                                              cache_enabled, response);
+    } else if (status.ok() && !is_dead &&
+               CompressTensor(request->accepted_codecs(), tensor,
+                              request->rendezvous_key(), &compressed)) {
+      CompressedRecvResponseExtra extra;
+      extra.set_codec(compressed.codec);
+      extra.set_content(std::move(compressed.content));
+      extra.set_scale(compressed.scale);
+      grpc::EncodeOutOfBandTensorToByteBuffer(tensor, extra, cache_enabled,
+                                              response);
+    } else if (status.ok()) {
       updated_status = grpc::EncodeTensorToByteBuffer(is_dead, tensor,
                                                       cache_enabled, response);
       if (!updated_status.ok()) {
@@ -591,10 +608,19 @@ namespace {
 // RecvBufRespExtra.tensor_content to a cord instead of a repeated string,
 // and remove this function.
 void SetTensorInRecvBufResp(int64_t max_chunk_bytes, const Tensor* tensor,
+                            const RecvBufRequest* request,
                             RecvBufResponse* response) {
   RecvBufRespExtra extra;
   int64_t num_bytes = tensor->TotalBytes();
   const char* head = reinterpret_cast<const char*>(DMAHelper::base(tensor));
+  CompressedTensor compressed;
+  if (CompressTensor(request->accepted_codecs(), *tensor,
+                     request->buf_rendezvous_key(), &compressed)) {
+    extra.set_codec(compressed.codec);
+    extra.set_scale(compressed.scale);
+    num_bytes = compressed.content.size();
+    head = compressed.content.data();
+  }
   while (num_bytes > 0) {
     int64_t bytes =
         max_chunk_bytes > 0 ? std::min(num_bytes, max_chunk_bytes) : num_bytes;
@@ -612,11 +638,11 @@ void GrpcWorker::RecvBufAsync(CallOptions* opts, const RecvBufRequest* request,
   const int64_t step_id = request->step_id();
   bool cache_enabled = (response_cache_ != nullptr && request_id != 0);
 
-  auto do_response = [this, response, done, cache_enabled](
+  auto do_response = [this, request, response, done, cache_enabled](
                          const Tensor& tensor, bool is_dead,
                          const absl::Status& status) {
     if (status.ok()) {
-      SetTensorInRecvBufResp(recv_buf_max_chunk_, &tensor, response);
+      SetTensorInRecvBufResp(recv_buf_max_chunk_, &tensor, request, response);
     }
     response->set_send_start_micros(env_->env->NowMicros());
     response->set_require_ack(cache_enabled);
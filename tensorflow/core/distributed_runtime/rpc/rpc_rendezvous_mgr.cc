@@ -23,6 +23,8 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/dma_helper.h"
 #include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/distributed_runtime/request_id.h"
+#include "tensorflow/core/distributed_runtime/shared_memory_transport.h"
+#include "tensorflow/core/distributed_runtime/tensor_compression.h"
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
 #include "tensorflow/core/distributed_runtime/worker_cache.h"
 #include "tensorflow/core/distributed_runtime/worker_interface.h"
@@ -72,6 +74,14 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
     req_.set_step_id(step_id);
     req_.set_rendezvous_key(key.data(), key.size());
     req_.set_request_id(GetUniqueRequestId());
+    // Content sent out of band is only handled for tensors received in host
+    // memory, which is where TensorResponse maps or decodes it.
+    if (alloc_attrs.on_host() || dst_device->device_type() == DEVICE_CPU) {
+      if (SharedMemoryTransportEnabled()) {
+        OfferSharedMemoryTransport(req_.mutable_transport_options());
+      }
+      AcceptTensorCodecs(req_.mutable_accepted_codecs());
+    }
   }
 
   void Reset() {
@@ -0,0 +1,347 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/shared_memory_transport.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // defined(__linux__)
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/random.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+
+bool SharedMemoryTransportEnabled() {
+  static const bool enabled = [] {
+    bool enabled;
+    absl::Status status = ReadBoolFromEnvVar("TF_RPC_SHARED_MEMORY_TRANSPORT",
+                                             false, &enabled);
+    if (!status.ok()) {
+      LOG(ERROR) << "SharedMemoryTransportEnabled: " << status.message();
+      return false;
+    }
+    return enabled;
+  }();
+  return enabled;
+}
+
+#if defined(__linux__)
+namespace {
+
+// Smaller tensors are cheaper to send in the response than through a new
+// segment.
+constexpr int64_t kMinSharedMemoryBytes = 64 << 10;
+
+// Segments not claimed by a receiver after this time are unlinked.
+constexpr int64_t kSegmentTimeoutMicros = 60 * 1000 * 1000;
+
+constexpr char kProbePrefix[] = "/tf_probe_";
+constexpr char kSegmentPrefix[] = "/tf_shm_";
+
+// The probe segment of this process, which holds a random nonce.
+class Probe {
+ public:
+  Probe() : nonce_(random::New64()) {
+    name_ = absl::StrCat(kProbePrefix, getpid(), "_",
+                         absl::Hex(random::New64()));
+    const int fd = shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+      LOG(WARNING) << "Cannot create shared memory probe " << name_ << ": "
+                   << strerror(errno);
+      name_.clear();
+      return;
+    }
+    const bool written =
+        pwrite(fd, &nonce_, sizeof(nonce_), 0) == sizeof(nonce_);
+    close(fd);
+    if (!written) {
+      shm_unlink(name_.c_str());
+      name_.clear();
+    }
+  }
+
+  ~Probe() {
+    if (!name_.empty()) shm_unlink(name_.c_str());
+  }
+
+  // Empty if the probe could not be created.
+  const std::string& name() const { return name_; }
+  uint64_t nonce() const { return nonce_; }
+
+ private:
+  std::string name_;
+  const uint64_t nonce_;
+};
+
+const Probe& GetProbe() {
+  // Not leaked, so that the probe is unlinked when the process exits.
+  static const Probe probe;
+  return probe;
+}
+
+// Returns true if this process can read the probe of the receiver that made
+// `offer`.
+bool ReadProbe(const SharedMemoryRecvRequestExtra& offer) {
+  const std::string& name = offer.probe_name();
+  if (!absl::StartsWith(name, kProbePrefix) ||
+      name.find('/', 1) != std::string::npos) {
+    return false;
+  }
+  const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) return false;
+  uint64_t nonce = 0;
+  const bool read = pread(fd, &nonce, sizeof(nonce), 0) == sizeof(nonce);
+  close(fd);
+  return read && nonce == offer.probe_nonce();
+}
+
+// The buffer of a tensor received through a shared memory segment.
+class SharedMemoryBuffer : public TensorBuffer {
+ public:
+  SharedMemoryBuffer(void* data, size_t size)
+      : TensorBuffer(data), size_(size) {}
+
+  ~SharedMemoryBuffer() override {
+    if (size_ > 0) munmap(data(), size_);
+  }
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocator_name("shared_memory");
+  }
+
+ private:
+  const size_t size_;
+};
+
+// Sender-side state.
+class Exporter {
+ public:
+  static Exporter* Get() {
+    // Not leaked, so that unclaimed segments are unlinked when the process
+    // exits.
+    static Exporter exporter;
+    return &exporter;
+  }
+
+  Exporter() {
+    reaper_.reset(Env::Default()->StartThread(
+        ThreadOptions(), "shared_memory_reaper", [this]() { ReapLoop(); }));
+  }
+
+  // Unlinks all unclaimed segments. Receivers that have not claimed theirs
+  // yet fail to open them.
+  ~Exporter() {
+    {
+      mutex_lock l(mu_);
+      stopping_ = true;
+      reaper_cv_.notify_all();
+    }
+    reaper_.reset();
+    mutex_lock l(mu_);
+    for (const auto& segment : segments_) {
+      shm_unlink(segment.first.c_str());
+    }
+    segments_.clear();
+  }
+
+  bool CanReach(const SharedMemoryRecvRequestExtra& offer) {
+    mutex_lock l(mu_);
+    auto it = reachable_.find(offer.probe_name());
+    if (it == reachable_.end()) {
+      const bool reachable = ReadProbe(offer);
+      VLOG(1) << "Shared memory probe " << offer.probe_name()
+              << (reachable ? " is" : " is not") << " reachable.";
+      it = reachable_.emplace(offer.probe_name(), reachable).first;
+    }
+    return it->second;
+  }
+
+  bool Export(const Tensor& tensor, SharedMemoryRecvResponseExtra* extra) {
+    const absl::string_view data = tensor.tensor_data();
+    const std::string name = absl::StrCat(kSegmentPrefix, getpid(), "_",
+                                          absl::Hex(random::New64()));
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) return false;
+    // Reserve the memory up front: writing to a mapping beyond the space left
+    // in /dev/shm would raise SIGBUS instead of failing.
+    bool ok = posix_fallocate(fd, 0, data.size()) == 0;
+    void* addr = MAP_FAILED;
+    if (ok) {
+      addr = mmap(nullptr, data.size(), PROT_WRITE, MAP_SHARED, fd, 0);
+      ok = addr != MAP_FAILED;
+    }
+    close(fd);
+    if (!ok) {
+      LOG_FIRST_N(WARNING, 1) << "Cannot create shared memory segment of "
+                              << data.size() << " bytes: " << strerror(errno);
+      shm_unlink(name.c_str());
+      return false;
+    }
+    memcpy(addr, data.data(), data.size());
+    munmap(addr, data.size());
+
+    const int64_t now = Env::Default()->NowMicros();
+    {
+      mutex_lock l(mu_);
+      if (segments_.empty()) {
+        // The reaper waits for the whole timeout when there are no segments.
+        reaper_cv_.notify_all();
+      }
+      segments_.emplace_back(name, now);
+    }
+    extra->set_segment_name(name);
+    extra->set_num_bytes(data.size());
+    return true;
+  }
+
+ private:
+  // Unlinks the segments that have not been claimed in time, waking up when
+  // the oldest segment expires.
+  void ReapLoop() {
+    mutex_lock l(mu_);
+    while (!stopping_) {
+      const int64_t now = Env::Default()->NowMicros();
+      while (!segments_.empty() &&
+             segments_.front().second + kSegmentTimeoutMicros < now) {
+        // Fails harmlessly if the receiver already unlinked the segment.
+        shm_unlink(segments_.front().first.c_str());
+        segments_.pop_front();
+      }
+      const int64_t wait_micros =
+          segments_.empty()
+              ? kSegmentTimeoutMicros
+              : segments_.front().second + kSegmentTimeoutMicros - now + 1;
+      reaper_cv_.wait_for(l, std::chrono::microseconds(wait_micros));
+    }
+  }
+
+  mutex mu_;
+  absl::flat_hash_map<std::string, bool> reachable_ TF_GUARDED_BY(mu_);
+  // Names and creation times of the segments, oldest first.
+  std::deque<std::pair<std::string, int64_t>> segments_ TF_GUARDED_BY(mu_);
+  condition_variable reaper_cv_;
+  bool stopping_ TF_GUARDED_BY(mu_) = false;
+  std::unique_ptr<Thread> reaper_;
+};
+
+}  // namespace
+
+void OfferSharedMemoryTransport(protobuf::Any* transport_options) {
+  const Probe& probe = GetProbe();
+  if (probe.name().empty()) return;
+  SharedMemoryRecvRequestExtra offer;
+  offer.set_probe_name(probe.name());
+  offer.set_probe_nonce(probe.nonce());
+  transport_options->PackFrom(offer);
+}
+
+bool ExportToSharedMemory(const RecvTensorRequest& request,
+                          const Tensor& tensor,
+                          SharedMemoryRecvResponseExtra* extra) {
+  SharedMemoryRecvRequestExtra offer;
+  if (!SharedMemoryTransportEnabled() || !request.has_transport_options() ||
+      !request.transport_options().UnpackTo(&offer) ||
+      !tensor.IsInitialized() || !DataTypeCanUseMemcpy(tensor.dtype()) ||
+      tensor.TotalBytes() < kMinSharedMemoryBytes) {
+    return false;
+  }
+  Exporter* exporter = Exporter::Get();
+  return exporter->CanReach(offer) && exporter->Export(tensor, extra);
+}
+
+absl::Status ImportFromSharedMemory(const SharedMemoryRecvResponseExtra& extra,
+                                    DataType dtype, const TensorShape& shape,
+                                    Tensor* tensor) {
+  const std::string& name = extra.segment_name();
+  if (!absl::StartsWith(name, kSegmentPrefix) ||
+      name.find('/', 1) != std::string::npos) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Invalid shared memory segment name: ", name));
+  }
+  if (!DataTypeCanUseMemcpy(dtype) ||
+      extra.num_bytes() != shape.num_elements() * DataTypeSize(dtype)) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Shared memory segment ", name, " of ", extra.num_bytes(),
+        " bytes does not match a ", DataTypeString(dtype), " tensor of shape ",
+        shape.DebugString()));
+  }
+  const int fd = shm_open(name.c_str(), O_RDWR, 0);
+  if (fd < 0) {
+    return absl::InternalError(absl::StrCat(
+        "Cannot open shared memory segment ", name, ": ", strerror(errno)));
+  }
+  shm_unlink(name.c_str());
+  struct stat st;
+  void* addr = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && st.st_size == extra.num_bytes()) {
+    addr = mmap(nullptr, extra.num_bytes(), PROT_READ | PROT_WRITE, MAP_SHARED,
+                fd, 0);
+  }
+  close(fd);
+  if (addr == MAP_FAILED) {
+    return absl::InternalError(
+        absl::StrCat("Cannot map shared memory segment ", name));
+  }
+  auto* buffer = new SharedMemoryBuffer(addr, extra.num_bytes());
+  *tensor = Tensor(dtype, shape, buffer);
+  buffer->Unref();
+  return absl::OkStatus();
+}
+
+#else  // defined(__linux__)
+
+void OfferSharedMemoryTransport(protobuf::Any* transport_options) {}
+
+bool ExportToSharedMemory(const RecvTensorRequest& request,
+                          const Tensor& tensor,
+                          SharedMemoryRecvResponseExtra* extra) {
+  return false;
+}
+
+absl::Status ImportFromSharedMemory(const SharedMemoryRecvResponseExtra& extra,
+                                    DataType dtype, const TensorShape& shape,
+                                    Tensor* tensor) {
+  return absl::UnimplementedError(
+      "The shared memory transport is only supported on Linux.");
+}
+
+#endif  // defined(__linux__)
+
+}  // namespace tensorflow
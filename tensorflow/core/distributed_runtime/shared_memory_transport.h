@@ -0,0 +1,71 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_SHARED_MEMORY_TRANSPORT_H_
+#define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_SHARED_MEMORY_TRANSPORT_H_
+
+#include "absl/status/status.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow/core/protobuf/transport_options.pb.h"
+#include "tensorflow/core/protobuf/worker.pb.h"
+
+// Passes the content of large RecvTensor responses between processes on the
+// same host through POSIX shared memory instead of the RPC:
+//
+// 1. The receiver offers shared memory in the request, naming a small probe
+//    segment that it created and the random nonce stored in it.
+// 2. The sender checks that it can read the nonce from the probe, copies the
+//    tensor into a new segment, and replies with the segment name in place of
+//    the tensor content.
+// 3. The receiver maps the segment, unlinks it, and uses the mapping as the
+//    buffer of the received tensor, without copying it again.
+//
+// Segments are only readable by the user that created them, so both
+// processes must run as the same user. Segments that are never claimed by a
+// receiver, e.g. because the step was aborted, are unlinked by the sender
+// after a minute, or when the sender exits normally, whichever comes first.
+//
+// Enabled by setting the TF_RPC_SHARED_MEMORY_TRANSPORT environment variable
+// to true. Only supported on Linux.
+
+namespace tensorflow {
+
+// Returns true if the shared memory transport is enabled.
+bool SharedMemoryTransportEnabled();
+
+// Called by the receiver: offers the shared memory transport in the
+// `transport_options` of a RecvTensorRequest.
+void OfferSharedMemoryTransport(protobuf::Any* transport_options);
+
+// Called by the sender: if `request` offers the shared memory transport and
+// `tensor` is worth sending that way, copies `tensor` into a new segment,
+// fills `extra` and returns true. Otherwise returns false, and the tensor
+// should be sent in the response as usual.
+bool ExportToSharedMemory(const RecvTensorRequest& request,
+                          const Tensor& tensor,
+                          SharedMemoryRecvResponseExtra* extra);
+
+// Called by the receiver: maps the segment described by `extra` as the buffer
+// of a tensor with the given `dtype` and `shape`.
+absl::Status ImportFromSharedMemory(const SharedMemoryRecvResponseExtra& extra,
+                                    DataType dtype, const TensorShape& shape,
+                                    Tensor* tensor);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_SHARED_MEMORY_TRANSPORT_H_
@@ -0,0 +1,99 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/shared_memory_transport.h"
+
+#include <cstdlib>
+
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/protobuf/transport_options.pb.h"
+#include "tensorflow/core/protobuf/worker.pb.h"
+
+namespace tensorflow {
+namespace {
+
+#if defined(__linux__)
+
+class SharedMemoryTransportTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    setenv("TF_RPC_SHARED_MEMORY_TRANSPORT", "true", 1);
+    ASSERT_TRUE(SharedMemoryTransportEnabled());
+    OfferSharedMemoryTransport(request_.mutable_transport_options());
+  }
+
+  RecvTensorRequest request_;
+};
+
+TEST_F(SharedMemoryTransportTest, RoundTrip) {
+  ASSERT_TRUE(request_.has_transport_options());
+  Tensor src(DT_FLOAT, TensorShape({128, 256}));
+  test::FillIota<float>(&src, 0.0f);
+
+  SharedMemoryRecvResponseExtra extra;
+  ASSERT_TRUE(ExportToSharedMemory(request_, src, &extra));
+  EXPECT_EQ(extra.num_bytes(), src.TotalBytes());
+
+  Tensor dst;
+  TF_ASSERT_OK(ImportFromSharedMemory(extra, src.dtype(), src.shape(), &dst));
+  test::ExpectTensorEqual<float>(dst, src);
+
+  // The segment is unlinked once imported.
+  Tensor again;
+  EXPECT_FALSE(
+      ImportFromSharedMemory(extra, src.dtype(), src.shape(), &again).ok());
+}
+
+TEST_F(SharedMemoryTransportTest, SendsSmallTensorsInResponse) {
+  Tensor src(DT_FLOAT, TensorShape({16}));
+  test::FillIota<float>(&src, 0.0f);
+  SharedMemoryRecvResponseExtra extra;
+  EXPECT_FALSE(ExportToSharedMemory(request_, src, &extra));
+}
+
+TEST_F(SharedMemoryTransportTest, RequiresOffer) {
+  Tensor src(DT_FLOAT, TensorShape({128, 256}));
+  test::FillIota<float>(&src, 0.0f);
+  SharedMemoryRecvResponseExtra extra;
+  EXPECT_FALSE(ExportToSharedMemory(RecvTensorRequest(), src, &extra));
+
+  // An offer whose probe cannot be read is declined.
+  SharedMemoryRecvRequestExtra offer;
+  offer.set_probe_name("/tf_probe_0_missing");
+  RecvTensorRequest request;
+  request.mutable_transport_options()->PackFrom(offer);
+  EXPECT_FALSE(ExportToSharedMemory(request, src, &extra));
+}
+
+TEST_F(SharedMemoryTransportTest, RejectsMismatchedShape) {
+  Tensor src(DT_FLOAT, TensorShape({128, 256}));
+  test::FillIota<float>(&src, 0.0f);
+  SharedMemoryRecvResponseExtra extra;
+  ASSERT_TRUE(ExportToSharedMemory(request_, src, &extra));
+
+  Tensor dst;
+  EXPECT_FALSE(
+      ImportFromSharedMemory(extra, DT_FLOAT, TensorShape({128}), &dst).ok());
+  TF_ASSERT_OK(ImportFromSharedMemory(extra, src.dtype(), src.shape(), &dst));
+}
+
+#endif  // defined(__linux__)
+
+}  // namespace
+}  // namespace tensorflow
@@ -19,11 +19,14 @@ limitations under the License.
 #include "absl/status/status.h"
 #include "xla/tsl/platform/errors.h"
 #include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/distributed_runtime/shared_memory_transport.h"
+#include "tensorflow/core/distributed_runtime/tensor_compression.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
 #include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/protobuf/transport_options.pb.h"
 
 namespace tensorflow {
 
@@ -109,10 +112,29 @@ absl::Status TensorResponse::ParseFrom(Source* source) {
     ClearTensor();
   }
   already_used_ = true;
-  if (ParseFast(source)) return absl::OkStatus();
-  meta_.Clear();
-  if (ParseSlow(source)) return absl::OkStatus();
-  return absl::InvalidArgumentError("Cannot parse tensor from response");
+  if (!ParseFast(source)) {
+    meta_.Clear();
+    if (!ParseSlow(source)) {
+      return absl::InvalidArgumentError("Cannot parse tensor from response");
+    }
+  }
+  SharedMemoryRecvResponseExtra shared_memory;
+  CompressedRecvResponseExtra compressed;
+  if (meta_.transport_options().UnpackTo(&shared_memory)) {
+    // The content was sent through shared memory.
+    Tensor t;
+    TF_RETURN_IF_ERROR(ImportFromSharedMemory(shared_memory, tensor_.dtype(),
+                                              tensor_.shape(), &t));
+    tensor_ = std::move(t);
+  } else if (meta_.transport_options().UnpackTo(&compressed)) {
+    Tensor t(allocator_, tensor_.dtype(), tensor_.shape());
+    TF_RETURN_IF_ERROR(DecompressTensor(
+        compressed.codec(), compressed.content(), compressed.scale(), &t));
+    tensor_ = std::move(t);
+    // Reduce memory usage for big tensors.
+    meta_.clear_transport_options();
+  }
+  return absl::OkStatus();
 }
 
 // Define some helper routines for decoding protocol buffer wire format data
@@ -167,8 +189,16 @@ bool TensorResponse::ParseTensorSubmessage(
                  .ok()) {
           return false;
         }
-        Tensor t(allocator_, tensor_meta->dtype(), shape);
-        tensor_ = std::move(t);
+        if (meta_.transport_options().Is<SharedMemoryRecvResponseExtra>() ||
+            meta_.transport_options().Is<CompressedRecvResponseExtra>()) {
+          // The content is sent out of band and set by ParseFrom, so only
+          // keep the dtype and shape here.
+          tensor_ = Tensor(tensor_meta->dtype(), shape,
+                           static_cast<TensorBuffer*>(nullptr));
+        } else {
+          Tensor t(allocator_, tensor_meta->dtype(), shape);
+          tensor_ = std::move(t);
+        }
       }
       return ok;
     }
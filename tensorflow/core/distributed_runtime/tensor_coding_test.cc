@@ -15,19 +15,24 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
 
+#include <cstdlib>
+
 #include "absl/status/status.h"
+#include "tensorflow/core/distributed_runtime/shared_memory_transport.h"
 #include "tensorflow/core/framework/device_attributes.pb.h"
 #include "tensorflow/core/framework/device_base.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/protobuf/transport_options.pb.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
 #include "tensorflow/core/public/session_options.h"
 
@@ -180,6 +185,37 @@ TEST_F(TensorResponseTest, InitPartialOverflow) {
   EXPECT_TRUE(absl::IsInvalidArgument(s));
 }
 
+#if defined(__linux__)
+TEST_F(TensorResponseTest, SharedMemoryTensor) {
+  setenv("TF_RPC_SHARED_MEMORY_TRANSPORT", "true", 1);
+  RecvTensorRequest request;
+  OfferSharedMemoryTransport(request.mutable_transport_options());
+  Tensor src(DT_FLOAT, TensorShape({64, 1024}));
+  test::FillIota<float>(&src, 1.0f);
+  SharedMemoryRecvResponseExtra extra;
+  ASSERT_TRUE(ExportToSharedMemory(request, src, &extra));
+
+  // The sender writes the transport options before the tensor metadata.
+  RecvTensorResponse header;
+  header.mutable_transport_options()->PackFrom(extra);
+  header.set_send_start_micros(123456);
+  RecvTensorResponse skeleton;
+  skeleton.mutable_tensor()->set_dtype(src.dtype());
+  src.shape().AsProto(skeleton.mutable_tensor()->mutable_tensor_shape());
+  std::string encoded;
+  header.AppendToString(&encoded);
+  skeleton.AppendToString(&encoded);
+
+  StringSource source(&encoded, 1024);
+  TensorResponse response;
+  DummyDevice cpu_device(Env::Default());
+  response.InitAlloc(&cpu_device, AllocatorAttributes());
+  TF_ASSERT_OK(response.ParseFrom(&source));
+  EXPECT_EQ(response.metadata().send_start_micros(), 123456);
+  test::ExpectTensorEqual<float>(response.tensor(), src);
+}
+#endif  // defined(__linux__)
+
 std::string MakeFloatTensorTestCase(int num_elems) {
   std::vector<int8_t> v(num_elems);
   for (int i = 0; i < num_elems; i++) {
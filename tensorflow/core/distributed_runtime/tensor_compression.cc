@@ -0,0 +1,428 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/tensor_compression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/algorithm/container.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/monitoring/sampler.h"
+#include "tensorflow/core/platform/bfloat16.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/snappy.h"
+#include "tensorflow/core/util/env_var.h"
+
+// NOTE: The way zstd is packaged in TF, we cannot include it as <zstd.h>.
+#include "zstd.h"  // NOLINT(build/include)
+
+namespace tensorflow {
+namespace {
+
+auto* tensor_compression_ratio = monitoring::Sampler<1>::New(
+    {"/tensorflow/rpc/tensor_compression/ratio",
+     "The uncompressed size of tensors divided by the size of their "
+     "compressed encoding.",
+     "codec"},
+    {monitoring::Buckets::Explicit(
+        {1.0, 1.25, 1.5, 2.0, 3.0, 4.0, 6.0, 8.0, 16.0, 32.0})});
+
+auto* tensor_compression_encode_usecs = monitoring::Sampler<1>::New(
+    {"/tensorflow/rpc/tensor_compression/encode_usecs",
+     "Microseconds spent encoding a tensor.", "codec"},
+    // Power of 2 with bucket count 20 (> 1 second)
+    {monitoring::Buckets::Exponential(1, 2, 20)});
+
+auto* tensor_compression_decode_usecs = monitoring::Sampler<1>::New(
+    {"/tensorflow/rpc/tensor_compression/decode_usecs",
+     "Microseconds spent decoding a tensor.", "codec"},
+    // Power of 2 with bucket count 20 (> 1 second)
+    {monitoring::Buckets::Exponential(1, 2, 20)});
+
+// Fast levels suit compression on the critical path of a step.
+constexpr int kZstdLevel = 1;
+
+// Bound the memory used for error feedback. The oldest errors are evicted
+// first, which drops those of keys that are not sent again, e.g. keys that
+// only exist for one step.
+constexpr int64_t kMaxErrorFeedbackBytes = 1LL << 30;
+constexpr int64_t kMaxErrorFeedbackEntries = 1 << 14;
+
+struct Config {
+  std::vector<TensorCodec> codecs;
+  int64_t min_bytes = 16 << 10;
+  bool error_feedback = true;
+};
+
+const Config& GetConfig() {
+  static const Config* config = [] {
+    Config* config = new Config;
+    std::string codecs;
+    absl::Status status =
+        ReadStringFromEnvVar("TF_RPC_TENSOR_COMPRESSION", "", &codecs);
+    for (absl::string_view name :
+         absl::StrSplit(codecs, ',', absl::SkipWhitespace())) {
+      TensorCodec codec;
+      if (!TensorCodec_Parse(
+              absl::StrCat("TENSOR_CODEC_",
+                           absl::AsciiStrToUpper(
+                               absl::StripAsciiWhitespace(name))),
+              &codec) ||
+          codec == TENSOR_CODEC_NONE) {
+        LOG(ERROR) << "TensorCompression: unknown codec " << name
+                   << " in TF_RPC_TENSOR_COMPRESSION.";
+        continue;
+      }
+      config->codecs.push_back(codec);
+    }
+    status = ReadInt64FromEnvVar("TF_RPC_TENSOR_COMPRESSION_MIN_BYTES",
+                                 config->min_bytes, &config->min_bytes);
+    if (!status.ok()) {
+      LOG(ERROR) << "TensorCompression: " << status.message();
+    }
+    status = ReadBoolFromEnvVar("TF_RPC_TENSOR_COMPRESSION_ERROR_FEEDBACK",
+                                true, &config->error_feedback);
+    if (!status.ok()) {
+      LOG(ERROR) << "TensorCompression: " << status.message();
+    }
+    return config;
+  }();
+  return *config;
+}
+
+std::string CodecName(TensorCodec codec) {
+  return absl::AsciiStrToLower(
+      absl::StripPrefix(TensorCodec_Name(codec), "TENSOR_CODEC_"));
+}
+
+bool Suits(TensorCodec codec, const Tensor& tensor) {
+  if (IsLossyTensorCodec(codec)) return tensor.dtype() == DT_FLOAT;
+  return DataTypeCanUseMemcpy(tensor.dtype());
+}
+
+// The rounding errors of the last transfer with lossy codecs, by key.
+class ErrorFeedback {
+ public:
+  static ErrorFeedback* Get() {
+    static ErrorFeedback* error_feedback = new ErrorFeedback;
+    return error_feedback;
+  }
+
+  // Returns the error for `key`, or an empty vector if there is none with
+  // `size` elements.
+  std::vector<float> Take(absl::string_view key, int64_t size) {
+    mutex_lock l(mu_);
+    auto it = errors_.find(key);
+    if (it == errors_.end()) return {};
+    std::vector<float> error = std::move(it->second.error);
+    Erase(it);
+    if (static_cast<int64_t>(error.size()) != size) return {};
+    return error;
+  }
+
+  void Put(absl::string_view key, std::vector<float> error) {
+    mutex_lock l(mu_);
+    auto it = errors_.find(key);
+    if (it != errors_.end()) {
+      // Another transfer with the same key finished first.
+      Erase(it);
+    }
+    const int64_t bytes = error.size() * sizeof(float);
+    if (bytes > kMaxErrorFeedbackBytes) {
+      LOG_FIRST_N(WARNING, 1)
+          << "Dropping the error feedback of lossy tensor compression, which "
+             "exceeds "
+          << kMaxErrorFeedbackBytes << " bytes.";
+      return;
+    }
+    while (!order_.empty() &&
+           (bytes_ + bytes > kMaxErrorFeedbackBytes ||
+            static_cast<int64_t>(errors_.size()) >= kMaxErrorFeedbackEntries)) {
+      Erase(errors_.find(order_.front()));
+    }
+    bytes_ += bytes;
+    order_.emplace_back(key);
+    errors_.emplace(key, Entry{std::move(error), std::prev(order_.end())});
+  }
+
+ private:
+  struct Entry {
+    std::vector<float> error;
+    // The position of the key in `order_`.
+    std::list<std::string>::iterator order;
+  };
+
+  void Erase(absl::flat_hash_map<std::string, Entry>::iterator it)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    bytes_ -= it->second.error.size() * sizeof(float);
+    order_.erase(it->second.order);
+    errors_.erase(it);
+  }
+
+  mutex mu_;
+  absl::flat_hash_map<std::string, Entry> errors_ TF_GUARDED_BY(mu_);
+  // The keys of `errors_`, oldest first.
+  std::list<std::string> order_ TF_GUARDED_BY(mu_);
+  int64_t bytes_ TF_GUARDED_BY(mu_) = 0;
+};
+
+// Groups the bytes of `n` elements of `size` bytes by their position in the
+// element, which makes exponents and high-order bytes compress better.
+void Shuffle(const char* in, int64_t n, int size, char* out) {
+  for (int64_t i = 0; i < n; ++i) {
+    for (int b = 0; b < size; ++b) out[b * n + i] = in[i * size + b];
+  }
+}
+
+void Unshuffle(const char* in, int64_t n, int size, char* out) {
+  for (int64_t i = 0; i < n; ++i) {
+    for (int b = 0; b < size; ++b) out[i * size + b] = in[b * n + i];
+  }
+}
+
+absl::Status EncodeLossless(TensorCodec codec, const Tensor& tensor,
+                            CompressedTensor* compressed) {
+  const absl::string_view data = tensor.tensor_data();
+  if (codec == TENSOR_CODEC_SNAPPY) {
+    if (!port::Snappy_Compress(data.data(), data.size(),
+                               &compressed->content)) {
+      return absl::UnimplementedError("Snappy is not available.");
+    }
+    return absl::OkStatus();
+  }
+  const int size = DataTypeSize(tensor.dtype());
+  std::string shuffled;
+  const char* input = data.data();
+  if (size > 1) {
+    shuffled.resize(data.size());
+    Shuffle(data.data(), tensor.NumElements(), size, &shuffled[0]);
+    input = shuffled.data();
+  }
+  compressed->content.resize(ZSTD_compressBound(data.size()));
+  const size_t compressed_size =
+      ZSTD_compress(&compressed->content[0], compressed->content.size(), input,
+                    data.size(), kZstdLevel);
+  if (ZSTD_isError(compressed_size)) {
+    return absl::InternalError(absl::StrCat(
+        "zstd compression failed: ", ZSTD_getErrorName(compressed_size)));
+  }
+  compressed->content.resize(compressed_size);
+  return absl::OkStatus();
+}
+
+absl::Status EncodeLossy(TensorCodec codec, const Tensor& tensor,
+                         absl::string_view key, CompressedTensor* compressed) {
+  const float* x = tensor.flat<float>().data();
+  const int64_t n = tensor.NumElements();
+  const bool feedback = !key.empty() && GetConfig().error_feedback;
+  // The error of the previous transfer, added to the values to send.
+  const std::vector<float> previous_error =
+      feedback ? ErrorFeedback::Get()->Take(key, n) : std::vector<float>();
+  auto value = [&](int64_t i) {
+    return previous_error.empty() ? x[i] : x[i] + previous_error[i];
+  };
+  std::vector<float> error(feedback ? n : 0);
+  auto set_error = [&](int64_t i, float e) {
+    // Non-finite values would poison all later transfers.
+    if (feedback) error[i] = std::isfinite(e) ? e : 0.0f;
+  };
+
+  if (codec == TENSOR_CODEC_BF16) {
+    compressed->content.resize(n * sizeof(bfloat16));
+    bfloat16* out = reinterpret_cast<bfloat16*>(&compressed->content[0]);
+    for (int64_t i = 0; i < n; ++i) {
+      const float v = value(i);
+      out[i] = static_cast<bfloat16>(v);
+      set_error(i, v - static_cast<float>(out[i]));
+    }
+  } else {
+    float max_abs = 0.0f;
+    for (int64_t i = 0; i < n; ++i) {
+      max_abs = std::max(max_abs, std::abs(value(i)));
+    }
+    if (!std::isfinite(max_abs)) {
+      return absl::InvalidArgumentError(
+          "Cannot quantize a tensor with non-finite values to int8.");
+    }
+    const float scale = max_abs / 127.0f;
+    compressed->scale = scale;
+    compressed->content.resize(n);
+    int8_t* out = reinterpret_cast<int8_t*>(&compressed->content[0]);
+    for (int64_t i = 0; i < n; ++i) {
+      const float v = value(i);
+      const float q =
+          scale > 0.0f ? std::clamp(std::round(v / scale), -127.0f, 127.0f)
+                       : 0.0f;
+      out[i] = static_cast<int8_t>(q);
+      set_error(i, v - q * scale);
+    }
+  }
+  if (feedback) ErrorFeedback::Get()->Put(key, std::move(error));
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+bool IsLossyTensorCodec(TensorCodec codec) {
+  return codec == TENSOR_CODEC_BF16 || codec == TENSOR_CODEC_INT8;
+}
+
+void AcceptTensorCodecs(protobuf::RepeatedField<int>* accepted_codecs) {
+  for (TensorCodec codec : GetConfig().codecs) accepted_codecs->Add(codec);
+}
+
+void AcceptLosslessTensorCodecs(
+    protobuf::RepeatedField<int>* accepted_codecs) {
+  for (TensorCodec codec : GetConfig().codecs) {
+    if (!IsLossyTensorCodec(codec)) accepted_codecs->Add(codec);
+  }
+}
+
+bool CompressTensor(const protobuf::RepeatedField<int>& accepted_codecs,
+                    const Tensor& tensor, absl::string_view key,
+                    CompressedTensor* compressed) {
+  const Config& config = GetConfig();
+  if (accepted_codecs.empty() || !tensor.IsInitialized() ||
+      static_cast<int64_t>(tensor.TotalBytes()) < config.min_bytes) {
+    return false;
+  }
+  for (TensorCodec codec : config.codecs) {
+    if (!Suits(codec, tensor) ||
+        !absl::c_linear_search(accepted_codecs, codec)) {
+      continue;
+    }
+    const uint64_t start_micros = Env::Default()->NowMicros();
+    absl::Status status = EncodeTensor(codec, tensor, key, compressed);
+    if (!status.ok()) {
+      VLOG(1) << "Cannot encode tensor with " << CodecName(codec) << ": "
+              << status;
+      continue;
+    }
+    if (!IsLossyTensorCodec(codec) &&
+        compressed->content.size() >= tensor.TotalBytes()) {
+      continue;
+    }
+    const std::string name = CodecName(codec);
+    tensor_compression_encode_usecs->GetCell(name)->Add(
+        Env::Default()->NowMicros() - start_micros);
+    tensor_compression_ratio->GetCell(name)->Add(
+        static_cast<double>(tensor.TotalBytes()) /
+        std::max<size_t>(compressed->content.size(), 1));
+    return true;
+  }
+  return false;
+}
+
+absl::Status EncodeTensor(TensorCodec codec, const Tensor& tensor,
+                          absl::string_view key, CompressedTensor* compressed) {
+  if (codec == TENSOR_CODEC_NONE || !TensorCodec_IsValid(codec) ||
+      !Suits(codec, tensor)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Cannot encode a ", DataTypeString(tensor.dtype()),
+                     " tensor with codec ", static_cast<int>(codec)));
+  }
+  compressed->codec = codec;
+  compressed->scale = 0.0f;
+  compressed->content.clear();
+  if (IsLossyTensorCodec(codec)) {
+    return EncodeLossy(codec, tensor, key, compressed);
+  }
+  return EncodeLossless(codec, tensor, compressed);
+}
+
+absl::Status DecompressTensor(TensorCodec codec, absl::string_view content,
+                              float scale, Tensor* tensor) {
+  const uint64_t start_micros = Env::Default()->NowMicros();
+  if (codec == TENSOR_CODEC_NONE || !TensorCodec_IsValid(codec) ||
+      !Suits(codec, *tensor)) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Cannot decode a ", DataTypeString(tensor->dtype()),
+                     " tensor with codec ", static_cast<int>(codec)));
+  }
+  char* out = const_cast<char*>(tensor->tensor_data().data());
+  const size_t num_bytes = tensor->TotalBytes();
+  const int64_t n = tensor->NumElements();
+  auto corrupt = [&]() {
+    return absl::DataLossError(absl::StrCat(
+        "Corrupt ", CodecName(codec), " encoding of a ",
+        DataTypeString(tensor->dtype()), " tensor of shape ",
+        tensor->shape().DebugString()));
+  };
+  switch (codec) {
+    case TENSOR_CODEC_SNAPPY: {
+      size_t uncompressed_size;
+      if (!port::Snappy_GetUncompressedLength(content.data(), content.size(),
+                                              &uncompressed_size) ||
+          uncompressed_size != num_bytes ||
+          !port::Snappy_Uncompress(content.data(), content.size(), out)) {
+        return corrupt();
+      }
+      break;
+    }
+    case TENSOR_CODEC_SHUFFLE_ZSTD: {
+      const int size = DataTypeSize(tensor->dtype());
+      std::string shuffled;
+      char* dst = out;
+      if (size > 1) {
+        shuffled.resize(num_bytes);
+        dst = &shuffled[0];
+      }
+      const size_t uncompressed_size =
+          ZSTD_decompress(dst, num_bytes, content.data(), content.size());
+      if (ZSTD_isError(uncompressed_size) || uncompressed_size != num_bytes) {
+        return corrupt();
+      }
+      if (size > 1) Unshuffle(shuffled.data(), n, size, out);
+      break;
+    }
+    case TENSOR_CODEC_BF16: {
+      if (content.size() != n * sizeof(bfloat16)) return corrupt();
+      const bfloat16* in = reinterpret_cast<const bfloat16*>(content.data());
+      float* values = reinterpret_cast<float*>(out);
+      for (int64_t i = 0; i < n; ++i) values[i] = static_cast<float>(in[i]);
+      break;
+    }
+    case TENSOR_CODEC_INT8: {
+      if (static_cast<int64_t>(content.size()) != n) return corrupt();
+      const int8_t* in = reinterpret_cast<const int8_t*>(content.data());
+      float* values = reinterpret_cast<float*>(out);
+      for (int64_t i = 0; i < n; ++i) values[i] = in[i] * scale;
+      break;
+    }
+    default:
+      return corrupt();
+  }
+  tensor_compression_decode_usecs->GetCell(CodecName(codec))
+      ->Add(Env::Default()->NowMicros() - start_micros);
+  return absl::OkStatus();
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,93 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_TENSOR_COMPRESSION_H_
+#define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_TENSOR_COMPRESSION_H_
+
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow/core/protobuf/transport_options.pb.h"
+
+// Compresses the tensor content sent by RecvTensor and RecvBuf, for links
+// where bandwidth is scarcer than CPU time. Lossy codecs only apply to
+// RecvTensor: collectives exchange partial results over RecvBuf, and
+// rounding them differently on each hop would make the replicas diverge.
+//
+// The TF_RPC_TENSOR_COMPRESSION environment variable lists the codecs enabled
+// in a process in order of preference, e.g. "bf16,shuffle_zstd". A receiver
+// accepts the codecs enabled in its process. For each transfer, the sender
+// uses the first codec enabled in its process that the receiver accepts and
+// that suits the tensor:
+//
+// - "snappy" and "shuffle_zstd" are lossless and suit any dtype that can be
+//   copied with memcpy. They are skipped if they do not make the tensor
+//   smaller.
+// - "bf16" and "int8" are lossy and only suit DT_FLOAT. The sender keeps the
+//   rounding error of each transfer and adds it to the next transfer with the
+//   same key (error feedback), so that errors do not build up when the
+//   receiver accumulates what it receives over steps, as for gradients. Set
+//   TF_RPC_TENSOR_COMPRESSION_ERROR_FEEDBACK to false to disable it.
+//
+// Tensors smaller than TF_RPC_TENSOR_COMPRESSION_MIN_BYTES (16 KiB by
+// default) are sent uncompressed. The compression ratio and the time spent
+// encoding and decoding are exported as /tensorflow/rpc/tensor_compression/*
+// metrics, by codec.
+
+namespace tensorflow {
+
+// The encoded content of a tensor.
+struct CompressedTensor {
+  TensorCodec codec = TENSOR_CODEC_NONE;
+  std::string content;
+  // The quantization scale for TENSOR_CODEC_INT8.
+  float scale = 0.0f;
+};
+
+// Returns true if `codec` does not restore the exact sent values.
+bool IsLossyTensorCodec(TensorCodec codec);
+
+// Called by the receiver: adds the codecs enabled in this process to the
+// `accepted_codecs` of a RecvTensorRequest.
+void AcceptTensorCodecs(protobuf::RepeatedField<int>* accepted_codecs);
+
+// Same as AcceptTensorCodecs, but only adds the lossless codecs, for the
+// RecvBufRequest of collectives.
+void AcceptLosslessTensorCodecs(protobuf::RepeatedField<int>* accepted_codecs);
+
+// Called by the sender: if a codec enabled in this process is accepted by the
+// receiver and suits `tensor`, encodes `tensor` into `*compressed` and returns
+// true. Otherwise returns false, and the tensor should be sent uncompressed.
+// `key` identifies the transfer across steps, for error feedback.
+bool CompressTensor(const protobuf::RepeatedField<int>& accepted_codecs,
+                    const Tensor& tensor, absl::string_view key,
+                    CompressedTensor* compressed);
+
+// Encodes `tensor` with `codec`. Lossy codecs apply the error feedback of
+// `key`, unless it is empty.
+absl::Status EncodeTensor(TensorCodec codec, const Tensor& tensor,
+                          absl::string_view key, CompressedTensor* compressed);
+
+// Called by the receiver: decodes `content` into `tensor`, which must already
+// be allocated with the dtype and shape of the sent tensor.
+absl::Status DecompressTensor(TensorCodec codec, absl::string_view content,
+                              float scale, Tensor* tensor);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_TENSOR_COMPRESSION_H_
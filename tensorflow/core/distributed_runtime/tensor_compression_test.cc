@@ -0,0 +1,147 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/tensor_compression.h"
+
+#include <cmath>
+
+#include "absl/strings/str_cat.h"
+
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/protobuf/transport_options.pb.h"
+
+namespace tensorflow {
+namespace {
+
+Tensor RoundTrip(TensorCodec codec, const Tensor& src,
+                 absl::string_view key = "") {
+  CompressedTensor compressed;
+  TF_CHECK_OK(EncodeTensor(codec, src, key, &compressed));
+  EXPECT_EQ(compressed.codec, codec);
+  Tensor dst(src.dtype(), src.shape());
+  TF_CHECK_OK(DecompressTensor(codec, compressed.content, compressed.scale,
+                               &dst));
+  return dst;
+}
+
+TEST(TensorCompressionTest, LosslessCodecs) {
+  Tensor floats(DT_FLOAT, TensorShape({64, 64}));
+  test::FillFn<float>(&floats, [](int i) { return (i % 17) * 0.5f; });
+  Tensor ints(DT_INT64, TensorShape({1000}));
+  test::FillIota<int64_t>(&ints, -10);
+  Tensor bytes(DT_UINT8, TensorShape({3, 5}));
+  test::FillIota<uint8_t>(&bytes, 0);
+  for (TensorCodec codec : {TENSOR_CODEC_SNAPPY, TENSOR_CODEC_SHUFFLE_ZSTD}) {
+    test::ExpectTensorEqual<float>(RoundTrip(codec, floats), floats);
+    test::ExpectTensorEqual<int64_t>(RoundTrip(codec, ints), ints);
+    test::ExpectTensorEqual<uint8_t>(RoundTrip(codec, bytes), bytes);
+  }
+}
+
+TEST(TensorCompressionTest, ShuffleZstdCompressesRepetitiveFloats) {
+  Tensor floats(DT_FLOAT, TensorShape({4096}));
+  test::FillFn<float>(&floats, [](int i) { return (i % 4) * 1.5f; });
+  CompressedTensor compressed;
+  TF_ASSERT_OK(
+      EncodeTensor(TENSOR_CODEC_SHUFFLE_ZSTD, floats, "", &compressed));
+  EXPECT_LT(compressed.content.size(), floats.TotalBytes() / 10);
+}
+
+TEST(TensorCompressionTest, LossyCodecs) {
+  Tensor src(DT_FLOAT, TensorShape({1000}));
+  test::FillFn<float>(&src, [](int i) { return std::sin(i * 0.01f) * 3.0f; });
+
+  CompressedTensor compressed;
+  TF_ASSERT_OK(EncodeTensor(TENSOR_CODEC_BF16, src, "", &compressed));
+  EXPECT_EQ(compressed.content.size(), src.TotalBytes() / 2);
+  test::ExpectTensorNear<float>(RoundTrip(TENSOR_CODEC_BF16, src), src, 0.02);
+
+  TF_ASSERT_OK(EncodeTensor(TENSOR_CODEC_INT8, src, "", &compressed));
+  EXPECT_EQ(compressed.content.size(), src.TotalBytes() / 4);
+  test::ExpectTensorNear<float>(RoundTrip(TENSOR_CODEC_INT8, src), src,
+                                3.0 / 127);
+}
+
+TEST(TensorCompressionTest, LossyCodecsOnlySuitFloats) {
+  Tensor ints(DT_INT32, TensorShape({16}));
+  CompressedTensor compressed;
+  EXPECT_FALSE(EncodeTensor(TENSOR_CODEC_BF16, ints, "", &compressed).ok());
+  EXPECT_FALSE(EncodeTensor(TENSOR_CODEC_INT8, ints, "", &compressed).ok());
+}
+
+TEST(TensorCompressionTest, IsLossyTensorCodec) {
+  EXPECT_TRUE(IsLossyTensorCodec(TENSOR_CODEC_BF16));
+  EXPECT_TRUE(IsLossyTensorCodec(TENSOR_CODEC_INT8));
+  EXPECT_FALSE(IsLossyTensorCodec(TENSOR_CODEC_SNAPPY));
+  EXPECT_FALSE(IsLossyTensorCodec(TENSOR_CODEC_SHUFFLE_ZSTD));
+}
+
+TEST(TensorCompressionTest, ErrorFeedback) {
+  // 1/3 is not representable in bfloat16, so each transfer rounds it.
+  Tensor src(DT_FLOAT, TensorShape({8}));
+  test::FillFn<float>(&src, [](int i) { return 1.0f / 3; });
+  float sum = 0;
+  const int kSteps = 64;
+  for (int step = 0; step < kSteps; ++step) {
+    sum += RoundTrip(TENSOR_CODEC_BF16, src, "edge").flat<float>()(0);
+  }
+  const float rounded = RoundTrip(TENSOR_CODEC_BF16, src).flat<float>()(0);
+  // With error feedback, the rounding errors cancel out over steps.
+  EXPECT_NEAR(sum, kSteps / 3.0f, 0.01);
+  EXPECT_GT(std::abs(rounded * kSteps - kSteps / 3.0f), 0.01);
+}
+
+TEST(TensorCompressionTest, ErrorFeedbackEvictsOldestKeys) {
+  Tensor src(DT_FLOAT, TensorShape({8}));
+  test::FillFn<float>(&src, [](int i) { return 1.0f / 3; });
+  const float rounded = RoundTrip(TENSOR_CODEC_BF16, src).flat<float>()(0);
+  RoundTrip(TENSOR_CODEC_BF16, src, "oldest");
+  // Keys that only exist for one step, as many as the map holds.
+  for (int step = 0; step < (1 << 14); ++step) {
+    RoundTrip(TENSOR_CODEC_BF16, src, absl::StrCat("step_", step));
+  }
+  RoundTrip(TENSOR_CODEC_BF16, src, "kept");
+  // The error of "oldest" was evicted, so it is rounded as a first transfer.
+  EXPECT_EQ(RoundTrip(TENSOR_CODEC_BF16, src, "oldest").flat<float>()(0),
+            rounded);
+  EXPECT_NE(RoundTrip(TENSOR_CODEC_BF16, src, "kept").flat<float>()(0),
+            rounded);
+}
+
+TEST(TensorCompressionTest, RejectsCorruptContent) {
+  Tensor dst(DT_FLOAT, TensorShape({16}));
+  EXPECT_FALSE(
+      DecompressTensor(TENSOR_CODEC_SHUFFLE_ZSTD, "garbage", 0, &dst).ok());
+  EXPECT_FALSE(DecompressTensor(TENSOR_CODEC_BF16, "short", 0, &dst).ok());
+  EXPECT_FALSE(DecompressTensor(TENSOR_CODEC_NONE, "", 0, &dst).ok());
+}
+
+TEST(TensorCompressionTest, DisabledByDefault) {
+  protobuf::RepeatedField<int> accepted;
+  AcceptTensorCodecs(&accepted);
+  EXPECT_TRUE(accepted.empty());
+  accepted.Add(TENSOR_CODEC_SNAPPY);
+  Tensor src(DT_FLOAT, TensorShape({64, 1024}));
+  src.flat<float>().setZero();
+  CompressedTensor compressed;
+  EXPECT_FALSE(CompressTensor(accepted, src, "", &compressed));
+}
+
+}  // namespace
+}  // namespace tensorflow
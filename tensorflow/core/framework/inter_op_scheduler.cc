@@ -0,0 +1,202 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/framework/inter_op_scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cfenv>  // NOLINT
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/platform/context.h"
+#include "tensorflow/core/platform/denormal.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/numa.h"
+#include "tensorflow/core/platform/setround.h"
+
+namespace tensorflow {
+
+namespace {
+
+struct PerThread {
+  const InterOpScheduler* scheduler = nullptr;
+  int index = -1;
+};
+
+PerThread* GetPerThread() {
+  static thread_local PerThread per_thread;
+  return &per_thread;
+}
+
+}  // namespace
+
+InterOpScheduler::InterOpScheduler(Env* env, const Options& options)
+    : env_(env), options_(options) {
+  const int num_threads = std::max(1, options_.num_threads);
+  workers_.resize(num_threads);
+  for (Worker& worker : workers_) {
+    for (auto& queue : worker.queues) {
+      queue = std::make_unique<Queue>(kQueueCapacity);
+    }
+  }
+  for (int i = 0; i < num_threads; ++i) {
+    workers_[i].thread.reset(env_->StartThread(
+        options_.thread_options, absl::StrCat(options_.name, "_", i),
+        [this, i]() {
+          // Set the processor flag to flush denormals to zero.
+          port::ScopedFlushDenormal flush;
+          // Set the processor rounding mode to ROUND TO NEAREST.
+          port::ScopedSetRound round(FE_TONEAREST);
+          if (options_.thread_options.numa_node != port::kNUMANoAffinity) {
+            port::NUMASetThreadNodeAffinity(options_.thread_options.numa_node);
+          }
+          WorkerLoop(i);
+        }));
+  }
+}
+
+InterOpScheduler::~InterOpScheduler() {
+  // The workers run the remaining closures before they exit.
+  cancelled_.store(true, std::memory_order_seq_cst);
+  {
+    mutex_lock l(sleep_mu_);
+    sleep_cv_.notify_all();
+  }
+  for (Worker& worker : workers_) {
+    worker.thread.reset();
+  }
+}
+
+std::unique_ptr<InterOpScheduler::Request> InterOpScheduler::CreateRequest(
+    int64_t priority, int64_t deadline_micros) {
+  return std::unique_ptr<Request>(
+      new Request(this, priority, deadline_micros));
+}
+
+int InterOpScheduler::CurrentWorker() const {
+  const PerThread* per_thread = GetPerThread();
+  return per_thread->scheduler == this ? per_thread->index : -1;
+}
+
+void InterOpScheduler::Schedule(Lane lane, std::function<void()> fn) {
+  Task task{std::move(fn), Context(ContextKind::kThread)};
+  const int num_workers = workers_.size();
+  int start = CurrentWorker();
+  if (start < 0) {
+    start = next_worker_.fetch_add(1, std::memory_order_relaxed) % num_workers;
+  }
+  bool pushed = false;
+  for (int i = 0; i < num_workers && !pushed; ++i) {
+    pushed = workers_[(start + i) % num_workers].queues[lane]->Push(
+        std::move(task));
+  }
+  if (!pushed) {
+    // Every queue of this lane is full; run the closure here rather than
+    // blocking the caller.
+    RunTask(task);
+    return;
+  }
+  // Pairs with the fence in WorkerLoop(): either the worker sees the task,
+  // or we see that it is going to sleep.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (num_sleeping_.load(std::memory_order_relaxed) > 0) {
+    mutex_lock l(sleep_mu_);
+    sleep_cv_.notify_one();
+  }
+}
+
+void InterOpScheduler::RunTask(Task& task) {
+  WithContext wc(task.context);
+  task.fn();
+}
+
+bool InterOpScheduler::FindTask(int index, Task* task) {
+  const int num_workers = workers_.size();
+  for (int lane = 0; lane < kNumLanes; ++lane) {
+    for (int i = 0; i < num_workers; ++i) {
+      if (workers_[(index + i) % num_workers].queues[lane]->Pop(task)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool InterOpScheduler::HasWork() const {
+  for (const Worker& worker : workers_) {
+    for (const auto& queue : worker.queues) {
+      if (!queue->Empty()) return true;
+    }
+  }
+  return false;
+}
+
+void InterOpScheduler::WorkerLoop(int index) {
+  PerThread* per_thread = GetPerThread();
+  per_thread->scheduler = this;
+  per_thread->index = index;
+  Task task;
+  while (true) {
+    bool found = false;
+    for (int i = 0; i < kSpinIterations && !found; ++i) {
+      found = FindTask(index, &task);
+    }
+    if (found) {
+      RunTask(task);
+      task = Task();
+      continue;
+    }
+    if (cancelled_.load(std::memory_order_seq_cst)) {
+      // The queues were empty after the scheduler was destroyed. A closure
+      // that is still running on another worker may schedule more, but that
+      // worker finds them before it exits.
+      return;
+    }
+    mutex_lock l(sleep_mu_);
+    num_sleeping_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (!cancelled_.load(std::memory_order_relaxed) && !HasWork()) {
+      sleep_cv_.wait(l);
+    }
+    num_sleeping_.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+InterOpScheduler::Request::Request(InterOpScheduler* scheduler,
+                                   int64_t priority, int64_t deadline_micros)
+    : scheduler_(scheduler),
+      priority_(priority),
+      deadline_micros_(deadline_micros),
+      lane_(priority > 0   ? kHighLane
+            : priority < 0 ? kLowLane
+                           : kNormalLane) {}
+
+void InterOpScheduler::Request::ScheduleInterOpClosure(
+    std::function<void()> fn) {
+  Lane lane = lane_;
+  if (deadline_micros_ > 0 &&
+      deadline_micros_ - scheduler_->env_->NowMicros() <
+          scheduler_->options_.urgent_deadline_slack_micros) {
+    lane = kDeadlineLane;
+  }
+  scheduler_->Schedule(lane, std::move(fn));
+}
+
+}  // namespace tensorflow
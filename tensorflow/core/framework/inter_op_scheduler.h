@@ -0,0 +1,234 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_FRAMEWORK_INTER_OP_SCHEDULER_H_
+#define TENSORFLOW_CORE_FRAMEWORK_INTER_OP_SCHEDULER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/platform/context.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+namespace internal {
+
+// A bounded multi-producer multi-consumer FIFO queue that never blocks.
+// Push() fails when the queue is full, and Pop() fails when it is empty.
+// Based on Dmitry Vyukov's bounded MPMC queue.
+template <typename T>
+class BoundedMpmcQueue {
+ public:
+  // `capacity` must be a power of two.
+  explicit BoundedMpmcQueue(size_t capacity)
+      : cells_(new Cell[capacity]), mask_(capacity - 1) {
+    DCHECK_EQ(capacity & mask_, 0);
+    for (size_t i = 0; i < capacity; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  bool Push(T&& value) {
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+      Cell& cell = cells_[pos & mask_];
+      const size_t seq = cell.sequence.load(std::memory_order_acquire);
+      const intptr_t diff =
+          static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          cell.value = std::move(value);
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool Pop(T* value) {
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+      Cell& cell = cells_[pos & mask_];
+      const size_t seq = cell.sequence.load(std::memory_order_acquire);
+      const intptr_t diff =
+          static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          *value = std::move(cell.value);
+          cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // May be stale by the time it returns.
+  bool Empty() const {
+    return dequeue_pos_.load(std::memory_order_relaxed) >=
+           enqueue_pos_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  const std::unique_ptr<Cell[]> cells_;
+  const size_t mask_;
+  // Keep the producer and consumer positions on separate cache lines.
+  alignas(64) std::atomic<size_t> enqueue_pos_{0};
+  alignas(64) std::atomic<size_t> dequeue_pos_{0};
+
+  BoundedMpmcQueue(const BoundedMpmcQueue&) = delete;
+  void operator=(const BoundedMpmcQueue&) = delete;
+};
+
+}  // namespace internal
+
+// InterOpScheduler runs the inter-op closures of concurrent requests (e.g.
+// Session::Run() calls) on one fixed set of threads, ordered by request
+// priority and deadline. It is an alternative to RunHandlerPool for
+// latency-sensitive serving.
+//
+// Closures go to one of kNumLanes priority lanes. Every worker has a
+// lock-free queue per lane. A closure scheduled from a worker is pushed to
+// that worker's own queue, and other closures are spread round-robin.
+// Workers always take work from the most urgent non-empty lane, first from
+// their own queue and then by stealing from the other workers. Requests are
+// never blocked on admission.
+//
+// A request's lane follows from its priority (as in
+// RunOptions::Experimental::RunHandlerPoolOptions, larger is more important),
+// and it is promoted to the deadline lane once its deadline is closer than
+// `Options::urgent_deadline_slack_micros`.
+//
+// The destructor runs all closures that have been scheduled, including the
+// ones that they schedule in turn, before it joins the workers. Closures must
+// not be scheduled from outside the workers once destruction has started.
+//
+// DirectSession can use this scheduler (see
+// `TF_RUN_HANDLER_USE_INTER_OP_SCHEDULER`). The TFRT work queue in
+// tfrt/run_handler_thread_pool does not: it must also run blocking tasks and
+// let callers wait on pending work, which this scheduler does not support.
+//
+// This class is thread safe.
+class InterOpScheduler {
+ public:
+  struct Options {
+    int num_threads = 1;
+    std::string name = "inter_op_scheduler";
+    ThreadOptions thread_options;
+    // Requests whose deadline is closer than this are scheduled in the
+    // deadline lane.
+    int64_t urgent_deadline_slack_micros = 10 * 1000;
+  };
+
+  // Lanes in decreasing order of urgency.
+  enum Lane { kDeadlineLane = 0, kHighLane, kNormalLane, kLowLane, kNumLanes };
+
+  class Request;
+
+  InterOpScheduler(Env* env, const Options& options);
+  ~InterOpScheduler();
+
+  // Returns a handle for scheduling the closures of one request. A deadline
+  // of 0 means none; otherwise it is in Env::NowMicros() time.
+  std::unique_ptr<Request> CreateRequest(int64_t priority,
+                                         int64_t deadline_micros = 0);
+
+  int NumThreads() const { return workers_.size(); }
+
+ private:
+  struct Task {
+    std::function<void()> fn;
+    Context context;
+  };
+  using Queue = internal::BoundedMpmcQueue<Task>;
+
+  struct Worker {
+    std::unique_ptr<Queue> queues[kNumLanes];
+    std::unique_ptr<Thread> thread;
+  };
+
+  static constexpr size_t kQueueCapacity = 1024;
+  // Times a worker polls all queues before it goes to sleep.
+  static constexpr int kSpinIterations = 64;
+
+  void Schedule(Lane lane, std::function<void()> fn);
+  void WorkerLoop(int index);
+  bool FindTask(int index, Task* task);
+  bool HasWork() const;
+  void RunTask(Task& task);
+  // Returns the index of the current thread's worker, or -1.
+  int CurrentWorker() const;
+
+  Env* const env_;
+  const Options options_;
+  std::vector<Worker> workers_;
+  std::atomic<uint64_t> next_worker_{0};
+  std::atomic<bool> cancelled_{false};
+
+  // Only used when workers go to sleep or must be woken up.
+  std::atomic<int> num_sleeping_{0};
+  mutex sleep_mu_;
+  condition_variable sleep_cv_;
+
+  InterOpScheduler(const InterOpScheduler&) = delete;
+  void operator=(const InterOpScheduler&) = delete;
+};
+
+class InterOpScheduler::Request {
+ public:
+  // Schedules `fn` to run on one of the scheduler's threads. If all queues
+  // are full, runs `fn` on the calling thread.
+  void ScheduleInterOpClosure(std::function<void()> fn);
+
+  int64_t priority() const { return priority_; }
+
+ private:
+  friend class InterOpScheduler;
+
+  Request(InterOpScheduler* scheduler, int64_t priority,
+          int64_t deadline_micros);
+
+  InterOpScheduler* const scheduler_;  // Not owned.
+  const int64_t priority_;
+  const int64_t deadline_micros_;
+  const Lane lane_;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_FRAMEWORK_INTER_OP_SCHEDULER_H_
@@ -0,0 +1,192 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/framework/inter_op_scheduler.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "absl/synchronization/notification.h"
+#include "tensorflow/core/platform/blocking_counter.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(BoundedMpmcQueueTest, PushAndPop) {
+  internal::BoundedMpmcQueue<int> queue(4);
+  EXPECT_TRUE(queue.Empty());
+  int value;
+  EXPECT_FALSE(queue.Pop(&value));
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_TRUE(queue.Push(int(i)));
+  }
+  EXPECT_FALSE(queue.Push(4));
+  EXPECT_FALSE(queue.Empty());
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_TRUE(queue.Pop(&value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_TRUE(queue.Empty());
+  // The queue wraps around.
+  EXPECT_TRUE(queue.Push(5));
+  ASSERT_TRUE(queue.Pop(&value));
+  EXPECT_EQ(value, 5);
+}
+
+InterOpScheduler::Options SchedulerOptions(int num_threads) {
+  InterOpScheduler::Options options;
+  options.num_threads = num_threads;
+  return options;
+}
+
+TEST(InterOpSchedulerTest, RunsClosuresFromManyThreads) {
+  InterOpScheduler scheduler(Env::Default(), SchedulerOptions(4));
+  EXPECT_EQ(scheduler.NumThreads(), 4);
+  constexpr int kNumCallers = 8;
+  constexpr int kClosuresPerCaller = 1000;
+  std::atomic<int> count{0};
+  BlockingCounter done(kNumCallers * kClosuresPerCaller);
+  {
+    std::vector<std::unique_ptr<Thread>> callers;
+    for (int i = 0; i < kNumCallers; ++i) {
+      callers.emplace_back(Env::Default()->StartThread(
+          ThreadOptions(), "caller", [&scheduler, &count, &done, i]() {
+            auto request = scheduler.CreateRequest(i % 3 - 1);
+            for (int j = 0; j < kClosuresPerCaller; ++j) {
+              request->ScheduleInterOpClosure([&count, &done]() {
+                count.fetch_add(1);
+                done.DecrementCount();
+              });
+            }
+          }));
+    }
+  }
+  done.Wait();
+  EXPECT_EQ(count.load(), kNumCallers * kClosuresPerCaller);
+}
+
+TEST(InterOpSchedulerTest, ClosuresCanScheduleClosures) {
+  InterOpScheduler scheduler(Env::Default(), SchedulerOptions(2));
+  auto request = scheduler.CreateRequest(0);
+  constexpr int kDepth = 100;
+  BlockingCounter done(kDepth);
+  std::function<void(int)> chain = [&](int depth) {
+    if (depth + 1 < kDepth) {
+      request->ScheduleInterOpClosure([&chain, depth]() { chain(depth + 1); });
+    }
+    done.DecrementCount();
+  };
+  request->ScheduleInterOpClosure([&chain]() { chain(0); });
+  done.Wait();
+}
+
+TEST(InterOpSchedulerTest, DestructorRunsQueuedClosures) {
+  auto scheduler = std::make_unique<InterOpScheduler>(Env::Default(),
+                                                      SchedulerOptions(1));
+  auto request = scheduler->CreateRequest(0);
+  absl::Notification started;
+  absl::Notification release;
+  request->ScheduleInterOpClosure([&]() {
+    started.Notify();
+    release.WaitForNotification();
+  });
+  started.WaitForNotification();
+  constexpr int kNumClosures = 10;
+  std::atomic<int> count{0};
+  for (int i = 0; i < kNumClosures; ++i) {
+    request->ScheduleInterOpClosure([&count]() { count.fetch_add(1); });
+  }
+  // Unblock the worker only once the destructor has started.
+  std::unique_ptr<Thread> releaser(Env::Default()->StartThread(
+      ThreadOptions(), "releaser", [&release]() {
+        Env::Default()->SleepForMicroseconds(10 * 1000);
+        release.Notify();
+      }));
+  request.reset();
+  scheduler.reset();
+  EXPECT_EQ(count.load(), kNumClosures);
+}
+
+// Blocks the single worker, queues closures from requests of different
+// priorities, and returns the order in which they ran.
+class InterOpSchedulerOrderTest : public ::testing::Test {
+ protected:
+  InterOpSchedulerOrderTest()
+      : scheduler_(Env::Default(), SchedulerOptions(1)) {
+    auto blocker = scheduler_.CreateRequest(0);
+    blocker->ScheduleInterOpClosure([this]() {
+      started_.Notify();
+      release_.WaitForNotification();
+    });
+    started_.WaitForNotification();
+  }
+
+  void Schedule(InterOpScheduler::Request* request, int id) {
+    request->ScheduleInterOpClosure([this, id]() {
+      mutex_lock l(mu_);
+      order_.push_back(id);
+    });
+  }
+
+  std::vector<int> Run(size_t expected) {
+    BlockingCounter done(1);
+    auto last = scheduler_.CreateRequest(-100);
+    last->ScheduleInterOpClosure([&done]() { done.DecrementCount(); });
+    release_.Notify();
+    done.Wait();
+    mutex_lock l(mu_);
+    EXPECT_EQ(order_.size(), expected);
+    return order_;
+  }
+
+  InterOpScheduler scheduler_;
+  absl::Notification started_;
+  absl::Notification release_;
+  mutex mu_;
+  std::vector<int> order_ TF_GUARDED_BY(mu_);
+};
+
+TEST_F(InterOpSchedulerOrderTest, HigherPriorityRunsFirst) {
+  auto low = scheduler_.CreateRequest(-1);
+  auto normal = scheduler_.CreateRequest(0);
+  auto high = scheduler_.CreateRequest(1);
+  Schedule(low.get(), 0);
+  Schedule(normal.get(), 1);
+  Schedule(high.get(), 2);
+  Schedule(low.get(), 3);
+  Schedule(high.get(), 4);
+  EXPECT_EQ(Run(5), std::vector<int>({2, 4, 1, 0, 3}));
+}
+
+TEST_F(InterOpSchedulerOrderTest, UrgentDeadlineRunsFirst) {
+  auto high = scheduler_.CreateRequest(1);
+  // Already past the deadline slack, so promoted to the deadline lane.
+  auto urgent = scheduler_.CreateRequest(-1, Env::Default()->NowMicros() + 1);
+  // Far from its deadline, so it stays in the low lane.
+  auto relaxed =
+      scheduler_.CreateRequest(-1, Env::Default()->NowMicros() + 3600000000LL);
+  Schedule(relaxed.get(), 0);
+  Schedule(high.get(), 1);
+  Schedule(urgent.get(), 2);
+  EXPECT_EQ(Run(3), std::vector<int>({2, 1, 0}));
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -15,9 +15,12 @@ limitations under the License.
 
 #include "tensorflow/core/framework/local_rendezvous.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
 #include <utility>
 #include <vector>
 
@@ -34,10 +37,41 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/manual_constructor.h"
 #include "tensorflow/core/lib/monitoring/counter.h"
 #include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tsl/platform/refcount.h"
 
 namespace tensorflow {
 
+namespace {
+// Values of a slot that do not hold an item. Items are aligned, and their
+// lowest bit is used to tag the type of the item.
+constexpr uintptr_t kEmptySlot = 0;
+constexpr uintptr_t kOverflowSlot = 2;
+constexpr uintptr_t kAbortedSlot = 4;
+
+// Set in the generation of a slot while a key is written to it.
+constexpr uint64_t kClaimingSlot = uint64_t{1} << 63;
+// Number of slots after the home slot of a key that it may claim.
+constexpr int kMaxSlotProbes = 8;
+constexpr int64_t kMaxSlots = int64_t{1} << 24;
+constexpr int kMaxFreeSlotTables = 16;
+
+// Every transfer allocates an Item on one thread and frees it on another, so
+// each thread keeps a few freed Items to serve the next allocations.
+constexpr int kMaxCachedItems = 64;
+struct ItemCache {
+  ~ItemCache() {
+    for (int i = 0; i < size; ++i) {
+      ::operator delete(items[i]);
+    }
+  }
+
+  void* items[kMaxCachedItems];
+  int size = 0;
+};
+thread_local ItemCache item_cache;
+}  // namespace
+
 // Represents a blocked Send() or Recv() call in the rendezvous.
 // Item hols a reference to the owner rendezvous, to make
 // sure the local rendezvous outlives any pending requests and callbacks.
@@ -93,6 +127,25 @@ struct LocalRendezvous::Item {
 
   activity_watcher::ActivityScope scope;
 
+  static void* operator new(size_t size) {
+    DCHECK_EQ(size, sizeof(Item));
+    ItemCache& cache = item_cache;
+    if (cache.size > 0) {
+      return cache.items[--cache.size];
+    }
+    return ::operator new(size);
+  }
+
+  static void operator delete(void* ptr) {
+    if (ptr == nullptr) return;
+    ItemCache& cache = item_cache;
+    if (cache.size < kMaxCachedItems) {
+      cache.items[cache.size++] = ptr;
+    } else {
+      ::operator delete(ptr);
+    }
+  }
+
  private:
   Item(tsl::core::RefCountPtr<Rendezvous> rc_owner, Rendezvous::Args args,
        Type type, activity_watcher::ActivityScope activity_scope)
@@ -106,6 +159,123 @@ struct LocalRendezvous::Item {
   }
 };
 
+// A key that is claimed without locks. `item` holds kEmptySlot, a pending
+// item tagged with its type, kOverflowSlot once the key has moved to the table
+// of its bucket, or kAbortedSlot.
+struct LocalRendezvous::Slot {
+  static_assert(alignof(Item) >= 2, "The type of an Item is in its lowest bit");
+
+  static uintptr_t Word(Item* item) {
+    return reinterpret_cast<uintptr_t>(item) | item->type;
+  }
+  static bool HoldsItem(uintptr_t word) { return word > kAbortedSlot; }
+  static Item* ItemOf(uintptr_t word) {
+    return reinterpret_cast<Item*>(word & ~uintptr_t{1});
+  }
+  static Item::Type TypeOf(uintptr_t word) {
+    return static_cast<Item::Type>(word & 1);
+  }
+
+  // Generation of the table when the key was written to the slot. A slot
+  // with an older generation is free.
+  std::atomic<uint64_t> generation{0};
+  std::atomic<uint64_t> key_hash{0};
+  std::atomic<uintptr_t> item{kEmptySlot};
+};
+
+// A table of slots, reused by the rendezvous of successive steps. A table is
+// handed to a new rendezvous by bumping its generation, which frees all its
+// slots without touching them.
+struct LocalRendezvous::SlotTable {
+  explicit SlotTable(int64_t size)
+      : size(size), slots(std::make_unique<Slot[]>(size)) {}
+
+  const int64_t size;
+  const std::unique_ptr<Slot[]> slots;
+  uint64_t generation = 0;
+
+  // Slots left holding kOverflowSlot, to be emptied before reuse.
+  mutex mu;
+  std::vector<int64_t> overflowed TF_GUARDED_BY(mu);
+};
+
+mutex& LocalRendezvous::slot_tables_mu_ = *new mutex();
+
+std::vector<LocalRendezvous::SlotTable*>& LocalRendezvous::free_slot_tables_ =
+    *new std::vector<LocalRendezvous::SlotTable*>();
+
+namespace {
+// Number of slots of each rendezvous, from TF_LOCAL_RENDEZVOUS_SLOTS.
+std::atomic<int64_t>& NumSlots() {
+  static std::atomic<int64_t>* num_slots = [] {
+    int64_t num_slots;
+    absl::Status status =
+        ReadInt64FromEnvVar("TF_LOCAL_RENDEZVOUS_SLOTS", 0, &num_slots);
+    if (!status.ok()) {
+      LOG(ERROR) << "LocalRendezvous: " << status.message();
+    }
+    return new std::atomic<int64_t>(num_slots);
+  }();
+  return *num_slots;
+}
+}  // namespace
+
+void LocalRendezvous::SetNumSlotsForTesting(int64_t num_slots) {
+  NumSlots().store(num_slots, std::memory_order_relaxed);
+}
+
+LocalRendezvous::SlotTable* LocalRendezvous::AcquireSlotTable() {
+  const int64_t num_slots = NumSlots().load(std::memory_order_relaxed);
+  if (num_slots <= 0) return nullptr;
+  // A power of two, so that a hash maps to a slot with a mask.
+  int64_t size = 1;
+  while (size < std::min(num_slots, kMaxSlots)) {
+    size <<= 1;
+  }
+
+  SlotTable* table = nullptr;
+  {
+    mutex_lock l(slot_tables_mu_);
+    while (table == nullptr && !free_slot_tables_.empty()) {
+      table = free_slot_tables_.back();
+      free_slot_tables_.pop_back();
+      if (table->size != size) {
+        delete table;
+        table = nullptr;
+      }
+    }
+  }
+  if (table == nullptr) {
+    table = new SlotTable(size);
+  }
+  ++table->generation;
+  return table;
+}
+
+void LocalRendezvous::ReleaseSlotTable(SlotTable* table, bool reuse) {
+  if (reuse) {
+    {
+      mutex_lock l(table->mu);
+      for (int64_t index : table->overflowed) {
+        table->slots[index].item.store(kEmptySlot, std::memory_order_relaxed);
+      }
+      table->overflowed.clear();
+    }
+    mutex_lock l(slot_tables_mu_);
+    if (free_slot_tables_.size() < kMaxFreeSlotTables) {
+      free_slot_tables_.push_back(table);
+      return;
+    }
+  }
+  delete table;
+}
+
+LocalRendezvous::LocalRendezvous(Rendezvous* owner, int num_shards)
+    : num_buckets_(num_shards > 0 ? num_shards : 1),
+      rc_owner_(owner),
+      table_buckets_(std::make_unique<TableBucket[]>(num_buckets_)),
+      slots_(AcquireSlotTable()) {}
+
 void LocalRendezvous::ItemQueue::push_back(Item* item) {
   if (TF_PREDICT_TRUE(head == nullptr)) {
     // The queue is empty.
@@ -126,7 +296,11 @@ LocalRendezvous::~LocalRendezvous() {
     auto& bucket = table_buckets_[i];
     {
       mutex_lock l(bucket.mu);
-      while (bucket.pending_callback_counter != 0) {
+      // Callbacks of items taken from a slot run without a lock, e.g. when
+      // the rendezvous has no owner to keep it alive.
+      while (bucket.pending_callback_counter != 0 ||
+             bucket.pending_slot_callback_counter.load(
+                 std::memory_order_relaxed) != 0) {
         bucket.pending_callback_cond_var.wait_for(
             l, std::chrono::milliseconds(50));
       }
@@ -135,9 +309,16 @@ LocalRendezvous::~LocalRendezvous() {
       table_not_empty = true;
     }
   }
+  if (slots_ != nullptr &&
+      pending_slot_items_.load(std::memory_order_acquire) != 0) {
+    table_not_empty = true;
+  }
   if (table_not_empty) {
     DoAbort(absl::CancelledError("LocalRendezvous deleted"));
   }
+  if (slots_ != nullptr) {
+    ReleaseSlotTable(slots_, status().ok());
+  }
 }
 
 namespace {
@@ -170,8 +351,139 @@ class KeyHash {
   uint64_t bucket_hash_;
   uint64_t table_hash_;
 };
+
+activity_watcher::ActivityScope MakeActivityScope(
+    const char* name, const void* rendezvous, const Rendezvous::ParsedKey& key,
+    const KeyHash& key_hash) {
+  return activity_watcher::ActivityScope(
+      [&]() {
+        return std::make_unique<activity_watcher::Activity>(
+            name, activity_watcher::ActivityCategory::kRendezvous,
+            activity_watcher::Activity::Attributes{
+                {"Rendezvous", absl::StrFormat("%p", rendezvous)},
+                {"key", std::string(key.FullKey())},
+                {"key_hash", key_hash.ToString()},
+            });
+      },
+      /*level=*/1);
+}
 }  // namespace
 
+LocalRendezvous::Slot* LocalRendezvous::FindSlot(uint64_t table_hash) {
+  if (slots_ == nullptr) return nullptr;
+  const uint64_t generation = slots_->generation;
+  const uint64_t mask = slots_->size - 1;
+  for (int probe = 0; probe < kMaxSlotProbes; ++probe) {
+    Slot& slot = slots_->slots[(table_hash + probe) & mask];
+    uint64_t slot_generation = slot.generation.load(std::memory_order_acquire);
+    while (true) {
+      if (slot_generation == generation) {
+        if (slot.key_hash.load(std::memory_order_relaxed) == table_hash) {
+          return &slot;
+        }
+        break;
+      }
+      if (slot_generation == (generation | kClaimingSlot)) {
+        // Another key is being written to the slot.
+        std::this_thread::yield();
+        slot_generation = slot.generation.load(std::memory_order_acquire);
+        continue;
+      }
+      if (slot.generation.compare_exchange_weak(
+              slot_generation, generation | kClaimingSlot,
+              std::memory_order_acquire, std::memory_order_acquire)) {
+        slot.key_hash.store(table_hash, std::memory_order_relaxed);
+        slot.generation.store(generation, std::memory_order_release);
+        return &slot;
+      }
+    }
+  }
+  return nullptr;
+}
+
+void LocalRendezvous::SlotCallbackDone(TableBucket& bucket) {
+  mutex_lock l(bucket.mu);
+  if (bucket.pending_slot_callback_counter.fetch_sub(
+          1, std::memory_order_relaxed) == 1) {
+    bucket.pending_callback_cond_var.notify_all();
+  }
+}
+
+void LocalRendezvous::MoveSlotToBucket(Slot* slot, TableBucket& bucket,
+                                       uint64_t table_hash) {
+  // Once aborted, DoAbort drains the slots.
+  if (!status().ok()) return;
+  uintptr_t word = slot->item.load(std::memory_order_acquire);
+  while (word != kOverflowSlot && word != kAbortedSlot) {
+    if (slot->item.compare_exchange_weak(word, kOverflowSlot,
+                                         std::memory_order_acq_rel,
+                                         std::memory_order_acquire)) {
+      if (Slot::HoldsItem(word)) {
+        bucket.table[table_hash].push_back(Slot::ItemOf(word));
+        pending_slot_items_.fetch_sub(1, std::memory_order_relaxed);
+      }
+      mutex_lock l(slots_->mu);
+      slots_->overflowed.push_back(slot - slots_->slots.get());
+      return;
+    }
+  }
+}
+
+void LocalRendezvous::CancelRecv(Slot* slot, TableBucket& bucket,
+                                 uint64_t table_hash,
+                                 CancellationToken token) {
+  Item* item = nullptr;
+  {
+    mutex_lock l(bucket.mu);
+    // The waiter in a slot cannot be matched with `token` without a lock, so
+    // it is moved to the table first.
+    if (slot != nullptr) {
+      MoveSlotToBucket(slot, bucket, table_hash);
+    }
+
+    auto it = bucket.table.find(table_hash);
+    if (it != bucket.table.end()) {
+      ItemQueue* queue = &it->second;
+      // Find an item in the queue with a cancellation token that matches
+      // `token`, and remove it.
+      if (queue->head != nullptr && queue->head->type == Item::kRecv) {
+        for (Item *prev = nullptr, *curr = queue->head; curr != nullptr;
+             prev = curr, curr = curr->next) {
+          if (curr->recv_state.cancellation_token == token) {
+            item = curr;
+            if (queue->head->next == nullptr) {
+              // We have a single-element queue, so we can erase it from
+              // the table.
+              bucket.table.erase(it);
+            } else {
+              // Remove the current item from the queue.
+              if (curr == queue->head) {
+                DCHECK_EQ(prev, nullptr);
+                queue->head = curr->next;
+              } else {
+                DCHECK_NE(prev, nullptr);
+                prev->next = curr->next;
+              }
+              if (queue->tail == curr) {
+                queue->tail = prev;
+              }
+            }
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  if (item != nullptr) {
+    (*item->recv_state.waiter)(
+        StatusGroup::MakeDerived(
+            absl::CancelledError("RecvAsync is cancelled.")),
+        Rendezvous::Args(), item->args, Tensor(), /*is_dead=*/false);
+    delete item;
+  }
+}
+
 absl::Status LocalRendezvous::Send(const Rendezvous::ParsedKey& key,
                                    const Rendezvous::Args& send_args,
                                    const Tensor& val, const bool is_dead) {
@@ -191,6 +503,67 @@ absl::Status LocalRendezvous::Send(const Rendezvous::ParsedKey& key,
 
   int bucket_index = key_hash.bucket(num_buckets_);
   auto& bucket = table_buckets_[bucket_index];
+
+  if (Slot* slot = FindSlot(key_hash.table_hash()); slot != nullptr) {
+    Item* item = nullptr;
+    uintptr_t word = slot->item.load(std::memory_order_acquire);
+    while (word != kOverflowSlot) {
+      if (word == kAbortedSlot) {
+        delete item;
+        return status();
+      }
+      if (word == kEmptySlot) {
+        // There is no waiter for this message. Publish it in the slot.
+        if (item == nullptr) {
+          DVLOG(2) << "Publish Send Item (key:" << key.FullKey() << "). ";
+          item = new Item(tsl::core::GetNewRef(rc_owner_), send_args, val,
+                          is_dead,
+                          MakeActivityScope("LocalRendezvous::Send", this,
+                                            key, key_hash));
+        }
+        // Counted before publishing, as the peer may take the item and
+        // destroy the rendezvous right after.
+        pending_slot_items_.fetch_add(1, std::memory_order_relaxed);
+        if (slot->item.compare_exchange_weak(word, Slot::Word(item),
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_acquire)) {
+          return absl::OkStatus();
+        }
+        pending_slot_items_.fetch_sub(1, std::memory_order_relaxed);
+        continue;
+      }
+      if (Slot::TypeOf(word) == Item::kSend) {
+        // Another message is pending under this key. The table of the bucket
+        // keeps the order of messages.
+        mutex_lock l(bucket.mu);
+        MoveSlotToBucket(slot, bucket, key_hash.table_hash());
+        break;
+      }
+      // Counted before taking the item, as the rendezvous may be destroyed
+      // as soon as the last item is taken.
+      bucket.pending_slot_callback_counter.fetch_add(1,
+                                                     std::memory_order_relaxed);
+      if (slot->item.compare_exchange_weak(word, kEmptySlot,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+        DVLOG(2) << "Consume Recv Item from slot (key:" << key.FullKey()
+                 << "). ";
+        delete item;
+        Item* waiter = Slot::ItemOf(word);
+        pending_slot_items_.fetch_sub(1, std::memory_order_relaxed);
+        (*waiter->recv_state.waiter)(absl::OkStatus(), send_args,
+                                     waiter->args, val, is_dead);
+        SlotCallbackDone(bucket);
+        // Delete the item at last since it may unref and destruct the
+        // rendezvous.
+        delete waiter;
+        return absl::OkStatus();
+      }
+      SlotCallbackDone(bucket);
+    }
+    delete item;
+  }
+
   bucket.mu.lock();
 
   if (auto s = status(); !s.ok()) {
@@ -208,20 +581,10 @@ absl::Status LocalRendezvous::Send(const Rendezvous::ParsedKey& key,
     // the lock.
     auto rc_owner = tsl::core::GetNewRef(rc_owner_);
     DVLOG(2) << "Enqueue Send Item (key:" << key.FullKey() << "). ";
-    activity_watcher::ActivityScope activity_scope(
-        [&]() {
-          return std::make_unique<activity_watcher::Activity>(
-              "LocalRendezvous::Send",
-              activity_watcher::ActivityCategory::kRendezvous,
-              activity_watcher::Activity::Attributes{
-                  {"Rendezvous", absl::StrFormat("%p", this)},
-                  {"key", std::string(key.FullKey())},
-                  {"key_hash", key_hash.ToString()},
-              });
-        },
-        /*level=*/1);
-    queue->push_back(new Item(std::move(rc_owner), send_args, val, is_dead,
-                              std::move(activity_scope)));
+    queue->push_back(
+        new Item(std::move(rc_owner), send_args, val, is_dead,
+                 MakeActivityScope("LocalRendezvous::Send", this, key,
+                                   key_hash)));
     bucket.mu.unlock();
     return absl::OkStatus();
   }
@@ -262,27 +625,17 @@ void LocalRendezvous::RecvAsync(const Rendezvous::ParsedKey& key,
   KeyHash key_hash = KeyHash(key.FullKey());
   DVLOG(2) << "Recv " << this << " " << key_hash.ToString() << " "
            << key.FullKey();
-  tsl::core::RefCountPtr<Rendezvous> rc_keep_alive;
+  const uint64_t table_hash = key_hash.table_hash();
 
   int bucket_index = key_hash.bucket(num_buckets_);
   auto& bucket = table_buckets_[bucket_index];
-  bucket.mu.lock();
+  Slot* slot = FindSlot(table_hash);
 
-  if (auto s = status(); !s.ok()) {
-    bucket.mu.unlock();
-    // Rendezvous has been aborted.
-    done(s, Rendezvous::Args(), recv_args, Tensor(), false);
-    return;
-  }
-
-  auto it = bucket.table.insert({key_hash.table_hash(), ItemQueue()}).first;
-  ItemQueue* queue = &it->second;
-  if (queue->head == nullptr || queue->head->type == Item::kRecv) {
-    // There is no message to pick up.
-    // Only recv-related fields need to be filled.
-    CancellationManager* cm = recv_args.cancellation_manager;
-    CancellationToken token = CancellationManager::kInvalidToken;
-    bool already_cancelled = false;
+  CancellationManager* cm = recv_args.cancellation_manager;
+  CancellationToken token = CancellationManager::kInvalidToken;
+  // Creates the waiter. Returns nullptr, and leaves `done` untouched, if `cm`
+  // is already cancelled.
+  auto new_waiter = [&]() -> Item* {
     if (cm != nullptr) {
       // Take a reference for the cancellation callback so that it does not
       // access LocalRendezvous after it is destroyed. It's dropped either
@@ -292,94 +645,27 @@ void LocalRendezvous::RecvAsync(const Rendezvous::ParsedKey& key,
         rc_owner_->Ref();
       }
       token = cm->get_cancellation_token();
-      already_cancelled = !cm->RegisterCallback(token, [this, token, key_hash,
-                                                        &bucket] {
-        tsl::core::RefCountPtr<Rendezvous> rc_owner(rc_owner_);
-        Item* item = nullptr;
-        {
-          mutex_lock l(bucket.mu);
-
-          auto it = bucket.table.find(key_hash.table_hash());
-          if (it != bucket.table.end()) {
-            ItemQueue* queue = &it->second;
-            // Find an item in the queue with a cancellation token that matches
-            // `token`, and remove it.
-            if (queue->head != nullptr && queue->head->type == Item::kRecv) {
-              for (Item *prev = nullptr, *curr = queue->head; curr != nullptr;
-                   prev = curr, curr = curr->next) {
-                if (curr->recv_state.cancellation_token == token) {
-                  item = curr;
-                  if (queue->head->next == nullptr) {
-                    // We have a single-element queue, so we can erase it from
-                    // the table.
-                    bucket.table.erase(it);
-                  } else {
-                    // Remove the current item from the queue.
-                    if (curr == queue->head) {
-                      DCHECK_EQ(prev, nullptr);
-                      queue->head = curr->next;
-                    } else {
-                      DCHECK_NE(prev, nullptr);
-                      prev->next = curr->next;
-                    }
-                    if (queue->tail == curr) {
-                      queue->tail = prev;
-                    }
-                  }
-                  break;
-                }
-              }
-            }
-          }
-        }
-
-        if (item != nullptr) {
-          (*item->recv_state.waiter)(
-              StatusGroup::MakeDerived(
-                  absl::CancelledError("RecvAsync is cancelled.")),
-              Rendezvous::Args(), item->args, Tensor(), /*is_dead=*/false);
-          delete item;
-        }
-      });
-    }
-    if (already_cancelled) {
-      if (queue->head == nullptr) {
-        bucket.table.erase(it);
-      }
-      bucket.mu.unlock();
-      done(StatusGroup::MakeDerived(
-               absl::CancelledError("RecvAsync is cancelled.")),
-           Rendezvous::Args(), recv_args, Tensor(), /*is_dead=*/false);
-      if (rc_owner_) {
-        rc_owner_->Unref();
+      const bool already_cancelled = !cm->RegisterCallback(
+          token, [this, token, slot, table_hash, &bucket] {
+            tsl::core::RefCountPtr<Rendezvous> rc_owner(rc_owner_);
+            CancelRecv(slot, bucket, table_hash, token);
+          });
+      if (already_cancelled) {
+        return nullptr;
       }
-      return;
     }
 
     DVLOG(2) << "Enqueue Recv Item (key:" << key.FullKey() << "). ";
-
-    // TODO(b/143786186): Investigate moving the allocation of `Item` outside
-    // the lock.
-    activity_watcher::ActivityScope activity_scope(
-        [&]() {
-          return std::make_unique<activity_watcher::Activity>(
-              "LocalRendezvous::RecvAsync",
-              activity_watcher::ActivityCategory::kRendezvous,
-              activity_watcher::Activity::Attributes{
-                  {"Rendezvous", absl::StrFormat("%p", this)},
-                  {"key", std::string(key.FullKey())},
-                  {"key_hash", key_hash.ToString()},
-              });
-        },
-        /*level=*/1);
+    activity_watcher::ActivityScope activity_scope = MakeActivityScope(
+        "LocalRendezvous::RecvAsync", this, key, key_hash);
     auto rc_owner = tsl::core::GetNewRef(rc_owner_);
     if (cm != nullptr) {
       // NOTE(mrry): We must wrap `done` with code that deregisters the
       // cancellation callback before calling the `done` callback, because the
       // cancellation manager may no longer be live after `done` is called.
-      queue->push_back(new Item(
+      return new Item(
           std::move(rc_owner), recv_args,
-          [this, cm, token, done = std::move(done)](
+          [this, cm, token = token, done = std::move(done)](
               const absl::Status& s, const Rendezvous::Args& send_args,
               const Rendezvous::Args& recv_args, const Tensor& v, bool dead) {
             // TryDeregisterCallback returns true when the cancellation callback
@@ -393,12 +679,175 @@ void LocalRendezvous::RecvAsync(const Rendezvous::ParsedKey& key,
             }
             done(s, send_args, recv_args, v, dead);
           },
-          token, std::move(activity_scope)));
-    } else {
-      queue->push_back(new Item(std::move(rc_owner), recv_args, std::move(done),
-                                token, std::move(activity_scope)));
+          token, std::move(activity_scope));
+    }
+    return new Item(std::move(rc_owner), recv_args, std::move(done), token,
+                    std::move(activity_scope));
+  };
+  auto done_cancelled = [&]() {
+    done(StatusGroup::MakeDerived(
+             absl::CancelledError("RecvAsync is cancelled.")),
+         Rendezvous::Args(), recv_args, Tensor(), /*is_dead=*/false);
+    if (rc_owner_) {
+      rc_owner_->Unref();
     }
+  };
 
+  if (slot != nullptr) {
+    Item* item = nullptr;
+    uintptr_t word = slot->item.load(std::memory_order_acquire);
+    while (word != kOverflowSlot) {
+      if (word == kAbortedSlot) {
+        if (item != nullptr) {
+          (*item->recv_state.waiter)(status(), Rendezvous::Args(), item->args,
+                                     Tensor(), false);
+          delete item;
+        } else {
+          done(status(), Rendezvous::Args(), recv_args, Tensor(), false);
+        }
+        return;
+      }
+      if (word == kEmptySlot) {
+        // There is no message to pick up. Publish the waiter in the slot.
+        if (item == nullptr) {
+          item = new_waiter();
+          if (item == nullptr) {
+            done_cancelled();
+            return;
+          }
+        }
+        // Counted before publishing, as the peer may take the item and
+        // destroy the rendezvous right after.
+        pending_slot_items_.fetch_add(1, std::memory_order_relaxed);
+        // A cancellation callback that runs before the waiter is published
+        // moves the key to the table, which makes this fail.
+        if (slot->item.compare_exchange_weak(word, Slot::Word(item),
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_acquire)) {
+          return;
+        }
+        pending_slot_items_.fetch_sub(1, std::memory_order_relaxed);
+        continue;
+      }
+      if (Slot::TypeOf(word) == Item::kRecv) {
+        // Another waiter is pending under this key. The table of the bucket
+        // keeps the order of waiters.
+        mutex_lock l(bucket.mu);
+        MoveSlotToBucket(slot, bucket, table_hash);
+        break;
+      }
+      // Counted before taking the item, as the rendezvous may be destroyed
+      // as soon as the last item is taken.
+      bucket.pending_slot_callback_counter.fetch_add(1,
+                                                     std::memory_order_relaxed);
+      if (slot->item.compare_exchange_weak(word, kEmptySlot,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+        DVLOG(2) << "Consume Send Item from slot (key:" << key.FullKey()
+                 << "). ";
+        Item* message = Slot::ItemOf(word);
+        pending_slot_items_.fetch_sub(1, std::memory_order_relaxed);
+        if (item != nullptr) {
+          (*item->recv_state.waiter)(absl::OkStatus(), message->args,
+                                     item->args, *message->send_state.value,
+                                     message->send_state.is_dead);
+        } else {
+          done(absl::OkStatus(), message->args, recv_args,
+               *message->send_state.value, message->send_state.is_dead);
+        }
+        SlotCallbackDone(bucket);
+        // Delete the items at last since they may unref and destruct the
+        // rendezvous.
+        delete item;
+        delete message;
+        return;
+      }
+      SlotCallbackDone(bucket);
+    }
+
+    if (item != nullptr) {
+      // The waiter was created for the slot, but the key has moved to the
+      // table of the bucket since.
+      bucket.mu.lock();
+      if (auto s = status(); !s.ok()) {
+        bucket.mu.unlock();
+        (*item->recv_state.waiter)(s, Rendezvous::Args(), item->args, Tensor(),
+                                   false);
+        delete item;
+        return;
+      }
+      auto it = bucket.table.insert({table_hash, ItemQueue()}).first;
+      ItemQueue* queue = &it->second;
+      if (queue->head == nullptr || queue->head->type == Item::kRecv) {
+        if (cm != nullptr && (cm->IsCancelling() || cm->IsCancelled())) {
+          // The cancellation callback may have run before the waiter was in
+          // the table.
+          if (queue->head == nullptr) {
+            bucket.table.erase(it);
+          }
+          bucket.mu.unlock();
+          (*item->recv_state.waiter)(
+              StatusGroup::MakeDerived(
+                  absl::CancelledError("RecvAsync is cancelled.")),
+              Rendezvous::Args(), item->args, Tensor(), /*is_dead=*/false);
+          delete item;
+          return;
+        }
+        queue->push_back(item);
+        bucket.mu.unlock();
+        return;
+      }
+      Item* message = queue->head;
+      if (message->next == nullptr) {
+        bucket.table.erase(it);
+      } else {
+        queue->head = message->next;
+      }
+      bucket.pending_callback_counter++;
+      bucket.mu.unlock();
+
+      (*item->recv_state.waiter)(absl::OkStatus(), message->args, item->args,
+                                 *message->send_state.value,
+                                 message->send_state.is_dead);
+      {
+        mutex_lock l(bucket.mu);
+        bucket.pending_callback_counter--;
+        if (bucket.pending_callback_counter == 0) {
+          bucket.pending_callback_cond_var.notify_all();
+        }
+      }
+      delete item;
+      delete message;
+      return;
+    }
+  }
+
+  bucket.mu.lock();
+
+  if (auto s = status(); !s.ok()) {
+    bucket.mu.unlock();
+    // Rendezvous has been aborted.
+    done(s, Rendezvous::Args(), recv_args, Tensor(), false);
+    return;
+  }
+
+  auto it = bucket.table.insert({table_hash, ItemQueue()}).first;
+  ItemQueue* queue = &it->second;
+  if (queue->head == nullptr || queue->head->type == Item::kRecv) {
+    // There is no message to pick up.
+    // Only recv-related fields need to be filled.
+    // TODO(b/143786186): Investigate moving the allocation of `Item` outside
+    // the lock.
+    Item* item = new_waiter();
+    if (item == nullptr) {
+      if (queue->head == nullptr) {
+        bucket.table.erase(it);
+      }
+      bucket.mu.unlock();
+      done_cancelled();
+      return;
+    }
+    queue->push_back(item);
     bucket.mu.unlock();
     return;
   }
@@ -464,6 +913,28 @@ void LocalRendezvous::DoAbort(const absl::Status& status) {
 
   // Keeps one Item to make sure the current rendezvous won't be destructed.
   std::unique_ptr<Item> to_delete;
+  for (int64_t i = 0; slots_ != nullptr && i < slots_->size; ++i) {
+    Slot& slot = slots_->slots[i];
+    uintptr_t word =
+        slot.item.exchange(kAbortedSlot, std::memory_order_acq_rel);
+    if (!Slot::HoldsItem(word)) continue;
+    pending_slot_items_.fetch_sub(1, std::memory_order_relaxed);
+    Item* item = Slot::ItemOf(word);
+    const uint64_t key_hash = slot.key_hash.load(std::memory_order_relaxed);
+    switch (item->type) {
+      case Item::kRecv:
+        (*item->recv_state.waiter)(status, Rendezvous::Args(),
+                                   Rendezvous::Args(), Tensor(), false);
+        LOG(INFO) << "Local rendezvous recv item cancelled. Key hash: "
+                  << key_hash;
+        break;
+      case Item::kSend:
+        LOG(INFO) << "Local rendezvous send item cancelled. Key hash: "
+                  << key_hash;
+        break;
+    }
+    to_delete.reset(item);
+  }
   for (int i = 0; i < num_buckets_; ++i) {
     auto& bucket = table_buckets_[i];
     Table table;
@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_FRAMEWORK_LOCAL_RENDEZVOUS_H_
 #define TENSORFLOW_CORE_FRAMEWORK_LOCAL_RENDEZVOUS_H_
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <vector>
@@ -37,16 +39,20 @@ namespace tensorflow {
 // IntraProcessRendezvous or RemoteRendezvous. This class does not implement
 // RendezvousInterface because virtual dispatch to LocalRendezvous methods
 // is not expected to be needed.
+//
+// When TF_LOCAL_RENDEZVOUS_SLOTS is set to a positive number, each key first
+// tries to claim one of that many lock-free slots, which hold a single
+// pending Send or Recv. A key falls back to the locked table once it has
+// more than one pending item of the same kind, its slot is cancelled, or no
+// slot is free near its hash. This suits graphs with many keys that are each
+// sent and received once per step.
 class LocalRendezvous {
  public:
   // If the class wrapping LocalRendezvous is refcounted (i.e., extending
   // Rendezvous), pass in its pointer in constructor so the LocalRendezvous
   // can make sure it outlives the async recv requests.
   // Pass in nullptr if the wrapping class is not refcounted.
-  explicit LocalRendezvous(Rendezvous* owner, int num_shards)
-      : num_buckets_(num_shards > 0 ? num_shards : 1),
-        rc_owner_(owner),
-        table_buckets_(std::make_unique<TableBucket[]>(num_buckets_)) {}
+  explicit LocalRendezvous(Rendezvous* owner, int num_shards);
   ~LocalRendezvous();
 
   absl::Status Send(const Rendezvous::ParsedKey& key,
@@ -64,6 +70,10 @@ class LocalRendezvous {
     aborted_rendezs_.clear();
   }
 
+  // Overrides TF_LOCAL_RENDEZVOUS_SLOTS, which is read once per process, for
+  // the rendezvous created from now on. Used in unit tests and benchmarks.
+  static void SetNumSlotsForTesting(int64_t num_slots);
+
  private:
   void DoAbort(const absl::Status& status);
 
@@ -96,10 +106,50 @@ class LocalRendezvous {
     // Track the number of pening callbacks using a counter.
     int pending_callback_counter TF_GUARDED_BY(mu) = 0;
     condition_variable pending_callback_cond_var TF_GUARDED_BY(mu);
+
+    // Number of Send or Recv callbacks running for items taken from a slot
+    // of this bucket. Incremented without `mu` before an item is taken, and
+    // decremented under `mu`, so that the destructor can wait on
+    // `pending_callback_cond_var` for it to reach zero.
+    std::atomic<int> pending_slot_callback_counter{0};
   };
 
   // Immutable set of buckets. This uses less memory than std::vector.
   const std::unique_ptr<TableBucket[]> table_buckets_;
+
+  struct Slot;
+  struct SlotTable;
+
+  // Returns the slot of the key with `table_hash`, claiming a free one if
+  // needed, or nullptr if the key must use the table of its bucket.
+  Slot* FindSlot(uint64_t table_hash);
+
+  // Moves the item pending in `slot`, if any, to the table of `bucket`, and
+  // makes the key use that table from now on.
+  void MoveSlotToBucket(Slot* slot, TableBucket& bucket, uint64_t table_hash)
+      TF_EXCLUSIVE_LOCKS_REQUIRED(bucket.mu);
+
+  // Decrements `bucket.pending_slot_callback_counter`, waking up the
+  // destructor if it drops to zero. The rendezvous may be destroyed as soon as
+  // this returns.
+  static void SlotCallbackDone(TableBucket& bucket);
+
+  // Removes the pending Recv registered with `token` and calls its waiter
+  // with a cancellation error. `slot` is nullptr if the key has no slot.
+  void CancelRecv(Slot* slot, TableBucket& bucket, uint64_t table_hash,
+                  CancellationToken token);
+
+  // Takes a slot table from the pool, or returns nullptr if the slots are
+  // disabled. Tables are returned to the pool on destruction, unless the
+  // rendezvous was aborted.
+  static SlotTable* AcquireSlotTable();
+  static void ReleaseSlotTable(SlotTable* table, bool reuse);
+
+  SlotTable* const slots_;
+  // Number of items published in a slot that have not been taken, moved to
+  // the table of their bucket, or aborted yet.
+  std::atomic<int64_t> pending_slot_items_{0};
+
   mutex mu_;
   absl::Status status_ TF_GUARDED_BY(mu_);
 
@@ -112,6 +162,10 @@ class LocalRendezvous {
   static std::vector<tsl::core::RefCountPtr<Rendezvous> >& aborted_rendezs_
       TF_GUARDED_BY(aborted_rendezs_mu_);
 
+  static mutex& slot_tables_mu_;
+  static std::vector<SlotTable*>& free_slot_tables_
+      TF_GUARDED_BY(slot_tables_mu_);
+
   LocalRendezvous(const LocalRendezvous&) = delete;
   void operator=(const LocalRendezvous&) = delete;
 };
@@ -22,7 +22,11 @@ limitations under the License.
 #include <memory>
 #include <optional>
 #include <queue>
+#include <string>
+#include <vector>
 
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "absl/time/clock.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/metrics.h"
@@ -64,6 +68,19 @@ constexpr double kBufferDownsizeMultipliter = 0.9;
 // Threshold of low buffer watermark before a buffer is a candidate for
 // upsizing.
 constexpr int64_t kBufferLowWatermarkThreshold = 2;
+// The number of the latest processing time samples of a node that the
+// learned cost model optimization fits to.
+constexpr int kCostModelSampleWindow = 64;
+// The number of processing time samples of a node below which the learned cost
+// model optimization keeps the parallelism of its stage unchanged.
+constexpr int kCostModelMinSamples = 3;
+// The learned cost model optimization stops increasing the parallelism of the
+// slowest stage when its time is predicted to improve by less than this share.
+constexpr double kCostModelMinImprovement = 0.05;
+// Upper bound of the stage utilization used for buffer sizing in the learned
+// cost model optimization. It keeps the buffer sizes of stages that are as fast
+// as their consumer finite.
+constexpr double kCostModelMaxUtilization = 0.9;
 
 constexpr char kDataService[] = "DataService";
 constexpr char kFlatMap[] = "FlatMap";
@@ -229,6 +246,17 @@ std::string RemoveArrayIndices(absl::string_view s) {
   return res;
 }
 
+// Returns the path of `node` in the model, which consists of the names of the
+// nodes from the output node to `node` with array indices removed.
+std::string WarmStartNodePath(const Node* node) {
+  std::vector<std::string> names;
+  for (; node != nullptr; node = node->output()) {
+    names.push_back(RemoveArrayIndices(node->name()));
+  }
+  std::reverse(names.begin(), names.end());
+  return absl::StrJoin(names, "/");
+}
+
 // Returns true if all parameters have reached their max values.
 bool AreAllParametersMax(const Model::ModelParameters& parameters) {
   for (const auto& pair : parameters) {
@@ -361,6 +389,83 @@ inline void UpdateStateValues(Node::ModelParameters* parameters) {
   }
 }
 
+// Returns the tunable parameter with the given name of `node`, or `nullptr` if
+// the node has no such parameter.
+Parameter* GetTunableParameter(const Node& node, const std::string& name) {
+  for (auto& pair : node.CollectNodeTunableParameters()) {
+    if (pair.second->name == name) {
+      return pair.second.get();
+    }
+  }
+  return nullptr;
+}
+
+// Returns the value the input pipeline is currently running with for the given
+// parameter.
+double CurrentStateValue(const Parameter& parameter) {
+  mutex_lock l(*parameter.state->mu);
+  return parameter.state->value == kAutotune ? parameter.value
+                                             : parameter.state->value;
+}
+
+// The processing time per element of a node as a function of its parallelism,
+// `intercept + slope * parallelism` nanoseconds. The slope models the
+// contention between the parallel calls of the node.
+struct ProcessingTimeFit {
+  double intercept = 0.0;
+  double slope = 0.0;
+  // Coefficient of variation of the observed processing times around the fit.
+  double variation = 0.0;
+
+  // Returns the time it takes the node to produce an element when running
+  // `parallelism` calls in parallel.
+  double TimePerElement(double parallelism) const {
+    return (intercept + slope * parallelism) / parallelism;
+  }
+};
+
+// Fits the processing times of `history` with least squares. The slope is not
+// allowed to be negative, so that more parallelism never makes a single call
+// faster.
+ProcessingTimeFit FitProcessingTime(
+    const ModelProto::CostModel::NodeHistory& history) {
+  ProcessingTimeFit fit;
+  const int num_samples = history.samples_size();
+  if (num_samples == 0) {
+    return fit;
+  }
+  double mean_parallelism = 0.0;
+  double mean_processing_time = 0.0;
+  for (const auto& sample : history.samples()) {
+    mean_parallelism += sample.parallelism();
+    mean_processing_time += sample.processing_time();
+  }
+  mean_parallelism /= num_samples;
+  mean_processing_time /= num_samples;
+  double covariance = 0.0;
+  double variance = 0.0;
+  for (const auto& sample : history.samples()) {
+    covariance += (sample.parallelism() - mean_parallelism) *
+                  (sample.processing_time() - mean_processing_time);
+    variance += Square(sample.parallelism() - mean_parallelism);
+  }
+  if (variance > 0.0 && covariance > 0.0) {
+    fit.slope = covariance / variance;
+  }
+  fit.intercept = mean_processing_time - fit.slope * mean_parallelism;
+  if (mean_processing_time > 0.0) {
+    double squared_error = 0.0;
+    for (const auto& sample : history.samples()) {
+      squared_error +=
+          Square(sample.processing_time() -
+                 (fit.intercept + fit.slope * sample.parallelism()));
+    }
+    fit.variation =
+        std::sqrt(squared_error / num_samples) / mean_processing_time;
+  }
+  return fit;
+}
+
 // Recursively produces protos for nodes in a subtree of `output` node and
 // appends them to nodes of the given model.
 absl::Status ModelToProtoHelper(std::shared_ptr<Node> output,
@@ -1990,6 +2095,54 @@ void Node::SyncStateValuesToParameterValues(const std::string& parameter_name) {
   }
 }
 
+void Node::InitializeTunableStateValues(
+    const absl::flat_hash_map<std::string, double>& values) {
+  // As above, `parameter->state->mu` must be locked before the node mutex.
+  std::vector<Parameter*> parameters;
+  {
+    tf_shared_lock l(mu_);
+    for (auto& [name, parameter] : parameters_) {
+      if (parameter->state != nullptr && parameter->state->tunable &&
+          values.contains(parameter->name)) {
+        parameters.push_back(parameter.get());
+      }
+    }
+  }
+  for (auto& parameter : parameters) {
+    mutex_lock l(*parameter->state->mu);
+    if (parameter->state->value != kAutotune) {
+      continue;
+    }
+    double value = std::clamp(values.at(parameter->name), parameter->min,
+                              parameter->max);
+    VLOG(2) << "Warm-starting " << long_name() << " " << parameter->name
+            << " at " << value;
+    parameter->state->value = value;
+    parameter->value = value;
+    parameter->state->cond_var->notify_all();
+  }
+}
+
+absl::flat_hash_map<std::string, double> Node::TunableStateValues() const {
+  std::vector<Parameter*> parameters;
+  {
+    tf_shared_lock l(mu_);
+    for (auto& [name, parameter] : parameters_) {
+      if (parameter->state != nullptr && parameter->state->tunable) {
+        parameters.push_back(parameter.get());
+      }
+    }
+  }
+  absl::flat_hash_map<std::string, double> values;
+  for (auto& parameter : parameters) {
+    tf_shared_lock l(*parameter->state->mu);
+    if (parameter->state->value != kAutotune) {
+      values[parameter->name] = parameter->state->value;
+    }
+  }
+  return values;
+}
+
 Node::NodeVector Node::CollectNodesLocked(
     TraversalOrder order, bool collect_node(const std::shared_ptr<Node>)) const
     TF_SHARED_LOCKS_REQUIRED(mu_) {
@@ -2276,6 +2429,10 @@ Model::Model(std::optional<std::string> dataset_name)
             absl::Status s = ModelToProtoHelper(snapshot_, &model_proto);
             if (s.ok()) {
               *model_proto.mutable_optimization_params() = optimization_params_;
+              {
+                tf_shared_lock cost_model_lock(cost_model_mu_);
+                *model_proto.mutable_cost_model() = cost_model_;
+              }
               tf_shared_lock l(gap_mu_);
               *model_proto.mutable_gap_times() = {gap_times_usec_.begin(),
                                                   gap_times_usec_.end()};
@@ -2304,17 +2461,31 @@ void Model::AddNode(Node::Factory factory, const std::string& name,
   // The name captures the sequence of iterators joined by `::`. We only use the
   // last element of the sequence as the name node.
   auto node_name = str_util::Split(name, ':', str_util::SkipEmpty()).back();
-  mutex_lock l(mu_);
-  std::shared_ptr<Node> node = factory({id_counter_++, node_name, parent});
-  if (!output_) {
-    output_ = node;
-  }
-  if (parent) {
-    VLOG(3) << "Adding " << node->long_name() << " as input for "
-            << parent->long_name();
-    parent->add_input(node);
-  } else {
-    VLOG(3) << "Adding " << node->long_name();
+  std::shared_ptr<Node> node;
+  std::optional<absl::flat_hash_map<std::string, double>> warm_start_values;
+  {
+    mutex_lock l(mu_);
+    node = factory({id_counter_++, node_name, parent});
+    if (!output_) {
+      output_ = node;
+    }
+    if (parent) {
+      VLOG(3) << "Adding " << node->long_name() << " as input for "
+              << parent->long_name();
+      parent->add_input(node);
+    } else {
+      VLOG(3) << "Adding " << node->long_name();
+    }
+    if (warm_start_) {
+      auto it = warm_start_->values.find(WarmStartNodePath(node.get()));
+      if (it != warm_start_->values.end()) {
+        warm_start_values = it->second;
+      }
+    }
+  }
+  // The state mutexes of the node must not be locked while holding `mu_`.
+  if (warm_start_values.has_value()) {
+    node->InitializeTunableStateValues(*warm_start_values);
   }
   *out_node = std::move(node);
   // TODO(jsimsa): Reset the optimization period when a node is added so that
@@ -2322,6 +2493,105 @@ void Model::AddNode(Node::Factory factory, const std::string& name,
   // to enable this functionality caused a regression (see b/179812091).
 }
 
+absl::Status Model::EnableWarmStart(const std::string& checkpoint_path,
+                                    uint64_t fingerprint) {
+  WarmStart warm_start;
+  warm_start.checkpoint_path = checkpoint_path;
+  warm_start.fingerprint = fingerprint;
+  warm_start.last_save_ms = EnvTime::NowMicros() / EnvTime::kMillisToMicros;
+  absl::Status s = Env::Default()->FileExists(checkpoint_path);
+  if (s.ok()) {
+    AutotuneCheckpoint checkpoint;
+    TF_RETURN_IF_ERROR(
+        ReadBinaryProto(Env::Default(), checkpoint_path, &checkpoint));
+    if (checkpoint.fingerprint() == fingerprint) {
+      for (const auto& parameter : checkpoint.parameters()) {
+        warm_start.values[parameter.node_path()][parameter.name()] =
+            parameter.value();
+      }
+      VLOG(1) << "Warm-starting the autotuning with "
+              << checkpoint.parameters_size() << " parameter values from "
+              << checkpoint_path;
+    } else {
+      VLOG(1) << "Not warm-starting the autotuning because " << checkpoint_path
+              << " was saved for a different input pipeline.";
+    }
+  } else if (!absl::IsNotFound(s)) {
+    return s;
+  }
+  mutex_lock l(mu_);
+  warm_start_ = std::move(warm_start);
+  return absl::OkStatus();
+}
+
+absl::Status Model::SaveWarmStartCheckpoint() {
+  std::string checkpoint_path;
+  AutotuneCheckpoint checkpoint;
+  std::deque<std::shared_ptr<Node>> queue;
+  {
+    tf_shared_lock l(mu_);
+    if (!warm_start_) {
+      return absl::FailedPreconditionError(
+          "Warm-starting the autotuning is not enabled.");
+    }
+    checkpoint_path = warm_start_->checkpoint_path;
+    checkpoint.set_fingerprint(warm_start_->fingerprint);
+    if (output_) queue.push_back(output_);
+  }
+  // Nodes created by the same iterator, such as the inputs of an interleave,
+  // share a path. The values of the first one visited are saved.
+  absl::flat_hash_set<std::string> visited_paths;
+  while (!queue.empty()) {
+    auto node = queue.front();
+    queue.pop_front();
+    std::string node_path = WarmStartNodePath(node.get());
+    if (visited_paths.insert(node_path).second) {
+      auto values = node->TunableStateValues();
+      std::vector<std::string> names;
+      for (const auto& [name, value] : values) {
+        names.push_back(name);
+      }
+      std::sort(names.begin(), names.end());
+      for (const auto& name : names) {
+        auto* parameter = checkpoint.add_parameters();
+        parameter->set_node_path(node_path);
+        parameter->set_name(name);
+        parameter->set_value(values[name]);
+      }
+    }
+    for (const auto& input : node->inputs()) {
+      queue.push_back(input);
+    }
+  }
+  // Writes to a temporary file first so that a restarted job never reads a
+  // partially written checkpoint.
+  std::string tmp_path = checkpoint_path;
+  if (!Env::Default()->CreateUniqueFileName(&tmp_path, ".tmp")) {
+    return absl::InternalError(absl::StrCat(
+        "Failed to create a temporary file name for ", checkpoint_path));
+  }
+  TF_RETURN_IF_ERROR(WriteBinaryProto(Env::Default(), tmp_path, checkpoint));
+  return Env::Default()->RenameFile(tmp_path, checkpoint_path);
+}
+
+void Model::MaybeSaveWarmStartCheckpoint() {
+  int64_t now_ms = EnvTime::NowMicros() / EnvTime::kMillisToMicros;
+  {
+    mutex_lock l(mu_);
+    if (!warm_start_ ||
+        warm_start_->last_save_ms + kWarmStartSavePeriodMs > now_ms) {
+      return;
+    }
+    warm_start_->last_save_ms = now_ms;
+  }
+  absl::Status s = SaveWarmStartCheckpoint();
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to save the tf.data autotuning warm-start "
+                    "checkpoint: "
+                 << s;
+  }
+}
+
 void Model::FlushMetrics() {
   std::deque<std::shared_ptr<Node>> queue;
   {
@@ -2402,6 +2672,10 @@ void Model::Optimize(AutotuneAlgorithm algorithm,
       OptimizeStageBased(snapshot, optimization_params, cancellation_manager,
                          ram_budget_manager);
       break;
+    case AutotuneAlgorithm::LEARNED_COST_MODEL:
+      OptimizeLearnedCostModel(snapshot, optimization_params,
+                               cancellation_manager, ram_budget_manager);
+      break;
     default:
       VLOG(2) << "Autotuning algorithm was not recognized. Aborting "
                  "optimization.";
@@ -2573,10 +2847,11 @@ absl::Status Model::OptimizeLoop(AutotuneAlgorithm algorithm,
     int64_t start_ms = EnvTime::NowMicros() / EnvTime::kMillisToMicros;
     double model_input_time = 0.0;
     // Model input time is set to 0 for all optimization algorithms except for
-    // stage-based optimization algorithm for historical reason. In stage-based
-    // optimization algorithm, the model input time is used as a target
-    // optimization time of all stages in the pipeline.
-    if (algorithm == AutotuneAlgorithm::STAGE_BASED) {
+    // the stage-based and learned cost model optimization algorithms for
+    // historical reason. In these algorithms, the model input time is used as
+    // a target optimization time of all stages in the pipeline.
+    if (algorithm == AutotuneAlgorithm::STAGE_BASED ||
+        algorithm == AutotuneAlgorithm::LEARNED_COST_MODEL) {
       model_input_time = ComputeTargetTimeNsec();
     }
     Optimize(algorithm, cpu_budget_func, ram_budget_share, fixed_ram_budget,
@@ -2594,6 +2869,7 @@ absl::Status Model::OptimizeLoop(AutotuneAlgorithm algorithm,
     current_time_ms = EnvTime::NowMicros() / EnvTime::kMillisToMicros;
     last_optimization_ms = current_time_ms;
     FlushMetrics();
+    MaybeSaveWarmStartCheckpoint();
   }
 }
 
@@ -3019,6 +3295,254 @@ void Model::OptimizeStageBasedNonAsyncInterleaveManyNodes(
   }
 }
 
+void Model::RecordCostModelSamples(std::shared_ptr<Node> snapshot) {
+  Node::NodeVector nodes =
+      snapshot->CollectNodes(TraversalOrder::BFS, IsAnyNode);
+  nodes.push_back(snapshot);
+  absl::flat_hash_set<int64_t> node_ids;
+  mutex_lock l(cost_model_mu_);
+  auto* histories = cost_model_.mutable_histories();
+  for (const auto& node : nodes) {
+    if (!node->IsAsync() || !node->autotune()) {
+      continue;
+    }
+    Parameter* parallelism = GetTunableParameter(*node, kParallelism);
+    if (parallelism == nullptr &&
+        GetTunableParameter(*node, kBufferSize) == nullptr) {
+      continue;
+    }
+    node_ids.insert(node->id());
+    ModelProto::CostModel::NodeHistory& history = (*histories)[node->id()];
+    const int64_t num_elements = node->num_elements();
+    const int64_t processing_time = node->processing_time();
+    const int64_t delta_elements = num_elements - history.num_elements();
+    const int64_t delta_processing_time =
+        processing_time - history.processing_time();
+    history.set_num_elements(num_elements);
+    history.set_processing_time(processing_time);
+    if (delta_elements <= 0 || delta_processing_time <= 0) {
+      continue;
+    }
+    auto* sample = history.add_samples();
+    sample->set_parallelism(
+        parallelism != nullptr ? CurrentStateValue(*parallelism) : 1.0);
+    sample->set_processing_time(static_cast<double>(delta_processing_time) /
+                                static_cast<double>(delta_elements));
+    if (history.samples_size() > kCostModelSampleWindow) {
+      history.mutable_samples()->DeleteSubrange(
+          0, history.samples_size() - kCostModelSampleWindow);
+    }
+  }
+  // Forget the nodes that are no longer part of the model.
+  for (auto it = histories->begin(); it != histories->end();) {
+    if (node_ids.contains(it->first)) {
+      ++it;
+    } else {
+      it = histories->erase(it);
+    }
+  }
+}
+
+void Model::OptimizeLearnedCostModel(
+    std::shared_ptr<Node> snapshot,
+    const OptimizationParams& optimization_params,
+    CancellationManager* cancellation_manager,
+    RamBudgetManager& ram_budget_manager) {
+  VLOG(2) << "Starting optimization of tunable parameters with the learned "
+             "cost model with a target time of "
+          << optimization_params.model_input_time() << " nanoseconds.";
+  RecordCostModelSamples(snapshot);
+  absl::flat_hash_map<int64_t, ProcessingTimeFit> fits;
+  // The nodes with too few samples for their fit to be trusted.
+  absl::flat_hash_set<int64_t> cold_nodes;
+  {
+    tf_shared_lock l(cost_model_mu_);
+    for (const auto& [node_id, history] : cost_model_.histories()) {
+      fits[node_id] = FitProcessingTime(history);
+      if (history.samples_size() < kCostModelMinSamples) {
+        cold_nodes.insert(node_id);
+      }
+    }
+  }
+
+  // A stage whose root node has a tunable parallelism parameter.
+  struct Stage {
+    Node* root;
+    Parameter* parallelism;
+    ProcessingTimeFit fit;
+    double pipeline_ratio;
+    // The time the synchronous inputs of the root take to produce an element.
+    double input_time;
+
+    // Predicted time it takes the stage to produce the elements needed for one
+    // output element.
+    double Time() const {
+      return pipeline_ratio *
+             (fit.TimePerElement(parallelism->value) + input_time);
+    }
+  };
+  ModelTiming model_timing(snapshot);
+  std::vector<Stage> stages;
+  // The time of the slowest stage that cannot be tuned.
+  double fixed_stage_time = 0.0;
+  // The parallelism of the stages that cannot be tuned.
+  int64_t cpu_used = 0;
+  for (const auto& root : model_timing.GetStageRoots()) {
+    const ModelTiming::NodeTiming* timing = model_timing.GetTiming(root.get());
+    Parameter* parallelism = GetTunableParameter(*root, kParallelism);
+    if (parallelism == nullptr || !fits.contains(root->id()) ||
+        cold_nodes.contains(root->id())) {
+      // Until the fit of a stage has enough samples, it keeps running with its
+      // current parallelism, as observed by the model timing.
+      if (parallelism != nullptr) {
+        parallelism->value = CurrentStateValue(*parallelism);
+        cpu_used += parallelism->value;
+      }
+      fixed_stage_time = std::max(
+          fixed_stage_time, timing->total_time_nsec * timing->pipeline_ratio);
+      continue;
+    }
+    Stage stage;
+    stage.root = root.get();
+    stage.parallelism = parallelism;
+    stage.fit = fits[root->id()];
+    stage.pipeline_ratio = timing->pipeline_ratio;
+    stage.input_time =
+        std::max(0.0, timing->total_time_nsec - timing->self_time_nsec);
+    stages.push_back(stage);
+  }
+
+  // Minimizes the time of the slowest stage. Because the predicted time of a
+  // stage only depends on its own parallelism, repeatedly giving one more
+  // thread to the slowest stage finds the best allocation of the CPU budget.
+  for (auto& stage : stages) {
+    stage.parallelism->value = stage.parallelism->min;
+    cpu_used += stage.parallelism->min;
+  }
+  const double target_time = optimization_params.model_input_time();
+  while (!stages.empty()) {
+    if (cancellation_manager->IsCancelled()) {
+      return;
+    }
+    Stage& slowest = *std::max_element(
+        stages.begin(), stages.end(), [](const Stage& a, const Stage& b) {
+          return a.Time() < b.Time();
+        });
+    const double time = slowest.Time();
+    // Removes the `<index>` of `[<index>]` to reduce the number of labels.
+    const std::string stage_name =
+        RemoveArrayIndices(slowest.root->long_name());
+    if (time <= target_time) {
+      metrics::RecordTFDataAutotuneStoppingCriteria("target_time_reached");
+      break;
+    }
+    if (time <= fixed_stage_time) {
+      metrics::RecordTFDataAutotuneStoppingCriteria(
+          "no_optimizable_parameter");
+      break;
+    }
+    if (slowest.parallelism->value >= slowest.parallelism->max) {
+      metrics::RecordTFDataAutotuneStoppingCriteria(
+          absl::StrCat("parameter_max_exceeded:", stage_name));
+      break;
+    }
+    if (cpu_used >= optimization_params.cpu_budget()) {
+      metrics::RecordTFDataAutotuneStoppingCriteria("cpu_budget_exceeded");
+      break;
+    }
+    slowest.parallelism->value += 1.0;
+    if (time - slowest.Time() < kCostModelMinImprovement * time) {
+      slowest.parallelism->value -= 1.0;
+      metrics::RecordTFDataAutotuneStoppingCriteria(
+          absl::StrCat("total_time_not_improved:", stage_name));
+      break;
+    }
+    if (TotalMaximumBufferedBytes(snapshot) >
+        optimization_params.ram_budget()) {
+      slowest.parallelism->value -= 1.0;
+      metrics::RecordTFDataAutotuneStoppingCriteria(
+          absl::StrCat("ram_budget_exceeded:", stage_name));
+      break;
+    }
+    ++cpu_used;
+  }
+
+  std::vector<ModelProto::CostModel::Decision> decisions;
+  double output_time = std::max(target_time, fixed_stage_time);
+  for (const auto& stage : stages) {
+    output_time = std::max(output_time, stage.Time());
+    const ProcessingTimeFit& fit = stage.fit;
+    ModelProto::CostModel::Decision& decision = decisions.emplace_back();
+    decision.set_node_id(stage.root->id());
+    decision.set_parameter_name(kParallelism);
+    decision.set_value(stage.parallelism->value);
+    decision.set_intercept(fit.intercept);
+    decision.set_slope(fit.slope);
+    decision.set_variation(fit.variation);
+    decision.set_predicted_time(stage.Time());
+  }
+
+  // Sizes the buffers with Kingman's approximation of the mean queue length of
+  // a stage with the given utilization and variation of processing times,
+  // assuming the consumer is about as variable as a Poisson process. Skip
+  // buffer size optimization if we are running the new buffering algorithm.
+  const bool skip_buffer_sizes =
+      experiments_.contains("autotune_buffer_optimization");
+  Node::NodeVector nodes =
+      snapshot->CollectNodes(TraversalOrder::BFS, IsAnyNode);
+  nodes.insert(nodes.begin(), snapshot);
+  for (const auto& node : nodes) {
+    Parameter* buffer_size = GetTunableParameter(*node, kBufferSize);
+    if (buffer_size == nullptr || skip_buffer_sizes) {
+      continue;
+    }
+    const ProcessingTimeFit& fit = fits[node->id()];
+    const ModelTiming::NodeTiming* timing = model_timing.GetTiming(node.get());
+    const double stage_time = timing->total_time_nsec * timing->pipeline_ratio;
+    const double utilization =
+        output_time > 0.0
+            ? std::min(kCostModelMaxUtilization, stage_time / output_time)
+            : kCostModelMaxUtilization;
+    const double queue_length = Square(utilization) / (1.0 - utilization) *
+                                (1.0 + Square(fit.variation)) / 2.0;
+    buffer_size->value = std::clamp(std::ceil(queue_length) + 1.0,
+                                    buffer_size->min, buffer_size->max);
+    while (buffer_size->value > buffer_size->min &&
+           TotalMaximumBufferedBytes(snapshot) >
+               optimization_params.ram_budget()) {
+      buffer_size->value -= 1.0;
+    }
+    ModelProto::CostModel::Decision& decision = decisions.emplace_back();
+    decision.set_node_id(node->id());
+    decision.set_parameter_name(kBufferSize);
+    decision.set_value(buffer_size->value);
+    decision.set_intercept(fit.intercept);
+    decision.set_slope(fit.slope);
+    decision.set_variation(fit.variation);
+    decision.set_predicted_time(stage_time);
+  }
+
+  Node::ModelParameters tunable_parameters;
+  for (auto& pair : CollectTunableParameters(snapshot)) {
+    if (pair.second->name == kParallelism ||
+        (pair.second->name == kBufferSize && !skip_buffer_sizes)) {
+      tunable_parameters.push_back(std::move(pair));
+    }
+  }
+  const bool allocated = ram_budget_manager.RequestModelAllocation(
+      TotalMaximumBufferedBytes(snapshot));
+  if (allocated) {
+    UpdateStateValues(&tunable_parameters);
+  }
+  mutex_lock l(cost_model_mu_);
+  cost_model_.clear_decisions();
+  if (allocated) {
+    for (auto& decision : decisions) {
+      *cost_model_.add_decisions() = std::move(decision);
+    }
+  }
+}
+
 void Model::OptimizeBuffers(std::shared_ptr<Node> snapshot,
                             int64_t ram_budget) {
   VLOG(2) << "Starting optimization of buffer_size parameters.";
@@ -3190,6 +3714,10 @@ absl::Status Model::ToProto(ModelProto* model_proto) {
   if (dataset_name_.has_value()) {
     model_proto->set_dataset_name(dataset_name_.value());
   }
+  {
+    tf_shared_lock cost_model_lock(cost_model_mu_);
+    *model_proto->mutable_cost_model() = cost_model_;
+  }
   tf_shared_lock gap_lock(gap_mu_);
   *model_proto->mutable_gap_times() = {gap_times_usec_.begin(),
                                        gap_times_usec_.end()};
@@ -3203,6 +3731,10 @@ absl::Status Model::FromProto(ModelProto model_proto,
   TF_RETURN_IF_ERROR(
       ModelFromProtoHelper(model_proto, &restored_model->output_));
   restored_model->id_counter_ = model_proto.id_counter();
+  {
+    mutex_lock cost_model_lock(restored_model->cost_model_mu_);
+    restored_model->cost_model_ = model_proto.cost_model();
+  }
   *model = std::move(restored_model);
   return absl::OkStatus();
 }
@@ -3218,6 +3750,10 @@ absl::Status Model::Save(const std::string& fname,
     model_snapshot->id_counter_ = id_counter_;
   }
   TF_RETURN_IF_ERROR(model_snapshot->ToProto(&model_proto));
+  {
+    tf_shared_lock l(cost_model_mu_);
+    *model_proto.mutable_cost_model() = cost_model_;
+  }
   OptimizationParams* saved_optimization_params =
       model_proto.mutable_optimization_params();
   *saved_optimization_params = optimization_params;
@@ -231,6 +231,35 @@ class RamBudgetManager {
     return true;
   }
 
+  // Requests `delta_bytes` additional bytes for buffers that can move their
+  // contents out of RAM, e.g. shuffle buffers that spill to local disk.
+  // `delta_bytes` can be negative.
+  //
+  // These bytes are only granted out of what the model and the legacy prefetch
+  // autotuner leave unused, and they do not reduce the RAM available to either
+  // of them. When the model or the legacy prefetch autotuner grow into them,
+  // `SpillableBytesOverBudget()` becomes positive and the owners of the
+  // buffers are expected to move that many bytes out of RAM.
+  //
+  // Returns whether the request succeeded. Releasing bytes always succeeds.
+  bool RequestSpillableBytes(int64_t delta_bytes) {
+    mutex_lock l(mu_);
+    if (delta_bytes > 0 &&
+        delta_bytes > budget_ - legacy_prefetch_allocated_ - model_allocated_ -
+                          spillable_allocated_) {
+      return false;
+    }
+    spillable_allocated_ += delta_bytes;
+    return true;
+  }
+
+  // The number of spillable bytes that no longer fit in the budget.
+  int64_t SpillableBytesOverBudget() const {
+    tf_shared_lock l(mu_);
+    return std::max<int64_t>(0, legacy_prefetch_allocated_ + model_allocated_ +
+                                    spillable_allocated_ - budget_);
+  }
+
   // The total number of bytes that the model could potentially use.
   int64_t AvailableModelRam() const {
     tf_shared_lock l(mu_);
@@ -247,7 +276,8 @@ class RamBudgetManager {
     mutex_lock l(mu_);
     return absl::StrCat("RamBudgetManager: budget_: ", budget_,
                         " prefetch allocated: ", legacy_prefetch_allocated_,
-                        " model allocated: ", model_allocated_);
+                        " model allocated: ", model_allocated_,
+                        " spillable allocated: ", spillable_allocated_);
   }
 
  private:
@@ -257,6 +287,8 @@ class RamBudgetManager {
   int64_t legacy_prefetch_allocated_ TF_GUARDED_BY(mu_) = 0;
   // Number of bytes allocated by the model.
   int64_t model_allocated_ TF_GUARDED_BY(mu_) = 0;
+  // Number of bytes allocated by buffers that can spill out of RAM.
+  int64_t spillable_allocated_ TF_GUARDED_BY(mu_) = 0;
 };
 
 // Abstract representation of a TensorFlow input pipeline node. It collects
@@ -639,6 +671,18 @@ class Node {
   // name matches `parameter_name`.
   void SyncStateValuesToParameterValues(const std::string& parameter_name);
 
+  // Sets the state values of the tunable parameters of this node that are
+  // still `kAutotune` to the values in `values`, keyed by parameter name.
+  // Values are clamped to the range of the parameter.
+  void InitializeTunableStateValues(
+      const absl::flat_hash_map<std::string, double>& values)
+      TF_LOCKS_EXCLUDED(mu_);
+
+  // Returns the state values of the tunable parameters of this node that are
+  // not `kAutotune`, keyed by parameter name.
+  absl::flat_hash_map<std::string, double> TunableStateValues() const
+      TF_LOCKS_EXCLUDED(mu_);
+
   void SetEstimatedElementSize(std::optional<int64_t> estimated_element_size) {
     mutex_lock l(mu_);
     estimated_element_size_ = estimated_element_size;
@@ -1027,6 +1071,22 @@ class Model {
                            std::unique_ptr<Model>* model,
                            OptimizationParams* optimization_params);
 
+  // Enables warm-starting the autotuning from the checkpoint at
+  // `checkpoint_path`. If the checkpoint was saved for an input pipeline with
+  // the same `fingerprint`, the tunable parameters of the nodes added
+  // afterwards start from the saved values instead of their defaults. From
+  // then on, `OptimizeLoop()` periodically saves the tuned values to the
+  // checkpoint.
+  //
+  // A missing checkpoint or a checkpoint for a different fingerprint is not an
+  // error; the autotuning then starts from scratch.
+  absl::Status EnableWarmStart(const std::string& checkpoint_path,
+                               uint64_t fingerprint) TF_LOCKS_EXCLUDED(mu_);
+
+  // Saves the current values of the tunable parameters to the warm-start
+  // checkpoint. Requires `EnableWarmStart()` to have been called.
+  absl::Status SaveWarmStartCheckpoint() TF_LOCKS_EXCLUDED(mu_);
+
   // Records gap time between consecutive `GetNext()` calls.
   void RecordIteratorGapTime(uint64_t duration_usec);
 
@@ -1055,6 +1115,19 @@ class Model {
   static constexpr int64_t kOptimizationPeriodMinMs = 10;
   static constexpr int64_t kOptimizationPeriodMaxMs =
       60 * EnvTime::kSecondsToMillis;
+  // Minimum time between two saves of the warm-start checkpoint.
+  static constexpr int64_t kWarmStartSavePeriodMs =
+      10 * EnvTime::kSecondsToMillis;
+
+  // State of the warm-start of the autotuning.
+  struct WarmStart {
+    std::string checkpoint_path;
+    uint64_t fingerprint;
+    // Saved parameter values, keyed by node path and parameter name.
+    absl::flat_hash_map<std::string, absl::flat_hash_map<std::string, double>>
+        values;
+    int64_t last_save_ms = 0;
+  };
 
   // Collects tunable parameters in the tree rooted in the given node, returning
   // a vector which contains pairs of node names and tunable parameters.
@@ -1086,6 +1159,10 @@ class Model {
   // Flushes metrics recorded by the model.
   void FlushMetrics() TF_LOCKS_EXCLUDED(mu_);
 
+  // Saves the warm-start checkpoint if warm-starting is enabled and the
+  // checkpoint has not been saved for `kWarmStartSavePeriodMs`.
+  void MaybeSaveWarmStartCheckpoint() TF_LOCKS_EXCLUDED(mu_);
+
   // This optimization algorithm starts by setting all tunable parallelism
   // parameters to the minimum value. It then improves current parameters by
   // making a step in the direction opposite to the gradient of `OutputTime` and
@@ -1155,6 +1232,25 @@ class Model {
       CancellationManager* cancellation_manager,
       RamBudgetManager& ram_budget_manager);
 
+  // This optimization fits the processing time per element of each
+  // asynchronous node as a linear function of its parallelism, using the
+  // metrics observed between consecutive optimizations. It then repeatedly
+  // increases the parallelism of the stage that is predicted to be the slowest
+  // until the stage is faster than the target time, more parallelism is
+  // predicted to no longer help, or the CPU or RAM budget is used up. Stages
+  // with too few observations keep their current parallelism. Buffer sizes
+  // are chosen to absorb the observed variation of processing times. The
+  // observations and decisions are recorded in `cost_model_`.
+  void OptimizeLearnedCostModel(std::shared_ptr<Node> snapshot,
+                                const OptimizationParams& optimization_params,
+                                CancellationManager* cancellation_manager,
+                                RamBudgetManager& ram_budget_manager);
+
+  // Records the processing time per element of the asynchronous nodes rooted
+  // at `snapshot` since the previous optimization in `cost_model_`.
+  void RecordCostModelSamples(std::shared_ptr<Node> snapshot)
+      TF_LOCKS_EXCLUDED(cost_model_mu_);
+
   // Determines if we should stop the gradient descent optimization iterations
   // based on number of increasable parameters, CPU budget, RAM budget and
   // current resource usage.
@@ -1223,6 +1319,14 @@ class Model {
   OptimizationParams optimization_params_ TF_GUARDED_BY(mu_);
   // Stores the model id in the string format
   std::string model_id_;
+  // Set if warm-starting the autotuning is enabled.
+  std::optional<WarmStart> warm_start_ TF_GUARDED_BY(mu_);
+  // Used to coordinate accesses to the state of the `LEARNED_COST_MODEL`
+  // algorithm between the optimization and `ToProto()`.
+  mutable mutex cost_model_mu_;
+  // Stores the observations and the latest decisions of the
+  // `LEARNED_COST_MODEL` algorithm.
+  ModelProto::CostModel cost_model_ TF_GUARDED_BY(cost_model_mu_);
 };
 
 // Class to compute timing information for a model.
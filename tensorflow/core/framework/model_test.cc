@@ -1227,6 +1227,115 @@ TEST(SaveModelTest, Model) {
   EXPECT_TRUE(restored_current->inputs().empty());
 }
 
+std::shared_ptr<SharedState> MakeSharedState(double value) {
+  return std::make_shared<SharedState>(value, std::make_shared<mutex>(),
+                                       std::make_shared<condition_variable>());
+}
+
+// Adds a prefetch node with a tunable buffer size and a parallel map node with
+// a tunable parallelism, using the names of the iterator prefixes.
+void AddWarmStartNodes(model::Model& model,
+                       std::shared_ptr<SharedState> buffer_size,
+                       std::shared_ptr<SharedState> parallelism) {
+  std::shared_ptr<Node> prefetch;
+  model.AddNode(
+      [&buffer_size](model::Node::Args args) {
+        return model::MakeAsyncKnownRatioNode(
+            std::move(args), 1,
+            {model::MakeParameter(kBufferSize, buffer_size, /*min=*/1,
+                                  /*max=*/16)});
+      },
+      "Iterator::Model::Prefetch", nullptr, &prefetch);
+  std::shared_ptr<Node> map;
+  model.AddNode(
+      [&parallelism](model::Node::Args args) {
+        return model::MakeAsyncKnownRatioNode(
+            std::move(args), 1,
+            {model::MakeParameter(kParallelism, parallelism, /*min=*/1,
+                                  /*max=*/8)});
+      },
+      "Iterator::Model::Prefetch::ParallelMapV2[0]", prefetch, &map);
+}
+
+std::string WarmStartCheckpointPath() {
+  std::string path;
+  EXPECT_TRUE(Env::Default()->LocalTempFilename(&path));
+  return path + "_autotune_warm_start_test";
+}
+
+TEST(WarmStartTest, RestoresTunedValues) {
+  const std::string path = WarmStartCheckpointPath();
+  model::Model model;
+  TF_ASSERT_OK(model.EnableWarmStart(path, /*fingerprint=*/42));
+  auto buffer_size = MakeSharedState(model::kAutotune);
+  auto parallelism = MakeSharedState(model::kAutotune);
+  AddWarmStartNodes(model, buffer_size, parallelism);
+  // Nothing was saved yet.
+  EXPECT_EQ(buffer_size->value, model::kAutotune);
+  EXPECT_EQ(parallelism->value, model::kAutotune);
+  buffer_size->value = 6;
+  parallelism->value = 3;
+  TF_ASSERT_OK(model.SaveWarmStartCheckpoint());
+
+  model::Model restored_model;
+  TF_ASSERT_OK(restored_model.EnableWarmStart(path, /*fingerprint=*/42));
+  auto restored_buffer_size = MakeSharedState(model::kAutotune);
+  auto restored_parallelism = MakeSharedState(model::kAutotune);
+  AddWarmStartNodes(restored_model, restored_buffer_size,
+                    restored_parallelism);
+  EXPECT_EQ(restored_buffer_size->value, 6);
+  EXPECT_EQ(restored_parallelism->value, 3);
+  TF_ASSERT_OK(Env::Default()->DeleteFile(path));
+}
+
+TEST(WarmStartTest, IgnoresDifferentFingerprint) {
+  const std::string path = WarmStartCheckpointPath();
+  model::Model model;
+  TF_ASSERT_OK(model.EnableWarmStart(path, /*fingerprint=*/42));
+  auto buffer_size = MakeSharedState(model::kAutotune);
+  auto parallelism = MakeSharedState(model::kAutotune);
+  AddWarmStartNodes(model, buffer_size, parallelism);
+  buffer_size->value = 6;
+  parallelism->value = 3;
+  TF_ASSERT_OK(model.SaveWarmStartCheckpoint());
+
+  model::Model other_model;
+  TF_ASSERT_OK(other_model.EnableWarmStart(path, /*fingerprint=*/43));
+  auto other_buffer_size = MakeSharedState(model::kAutotune);
+  auto other_parallelism = MakeSharedState(model::kAutotune);
+  AddWarmStartNodes(other_model, other_buffer_size, other_parallelism);
+  EXPECT_EQ(other_buffer_size->value, model::kAutotune);
+  EXPECT_EQ(other_parallelism->value, model::kAutotune);
+  TF_ASSERT_OK(Env::Default()->DeleteFile(path));
+}
+
+TEST(WarmStartTest, DoesNotOverrideFixedValues) {
+  const std::string path = WarmStartCheckpointPath();
+  model::Model model;
+  TF_ASSERT_OK(model.EnableWarmStart(path, /*fingerprint=*/42));
+  auto buffer_size = MakeSharedState(model::kAutotune);
+  auto parallelism = MakeSharedState(model::kAutotune);
+  AddWarmStartNodes(model, buffer_size, parallelism);
+  buffer_size->value = 6;
+  parallelism->value = 3;
+  TF_ASSERT_OK(model.SaveWarmStartCheckpoint());
+
+  model::Model restored_model;
+  TF_ASSERT_OK(restored_model.EnableWarmStart(path, /*fingerprint=*/42));
+  auto fixed_buffer_size = MakeSharedState(/*value=*/2);
+  auto restored_parallelism = MakeSharedState(model::kAutotune);
+  AddWarmStartNodes(restored_model, fixed_buffer_size, restored_parallelism);
+  EXPECT_EQ(fixed_buffer_size->value, 2);
+  EXPECT_EQ(restored_parallelism->value, 3);
+  TF_ASSERT_OK(Env::Default()->DeleteFile(path));
+}
+
+TEST(WarmStartTest, SaveRequiresWarmStart) {
+  model::Model model;
+  EXPECT_EQ(model.SaveWarmStartCheckpoint().code(),
+            absl::StatusCode::kFailedPrecondition);
+}
+
 class ComputeWaitTimeTest
     : public ::testing::TestWithParam<std::tuple<double, double, double>> {};
 
@@ -3159,6 +3268,273 @@ TEST_F(ModelTimingTest, OptimizeStageBased_PipelineRatioLessThanOne) {
   EXPECT_EQ(14, GetNode(/*node_id=*/1)->parameter_value("parallelism"));
 }
 
+TEST_F(ModelTimingTest, OptimizeLearnedCostModel_CpuBudget) {
+  BuildModelFromProto(R"pb(
+    nodes: {
+      key: 1
+      value: {
+        id: 1
+        name: "ParallelMapV2"
+        autotune: true
+        num_elements: 100
+        processing_time: 25000
+        bytes_produced: 10000
+        node_class: ASYNC_KNOWN_RATIO
+        ratio: 1
+        inputs: 2
+        parameters: {
+          name: "parallelism"
+          value: 4
+          state_value: 4
+          min: 1
+          max: 16
+          tunable: true
+        }
+      }
+    }
+    nodes: {
+      key: 2
+      value: {
+        id: 2
+        name: "ParallelMapV2"
+        autotune: true
+        num_elements: 100
+        processing_time: 20000
+        bytes_produced: 10000
+        node_class: ASYNC_KNOWN_RATIO
+        ratio: 1
+        inputs: 3
+        parameters: {
+          name: "parallelism"
+          value: 4
+          state_value: 4
+          min: 1
+          max: 16
+          tunable: true
+        }
+      }
+    }
+    nodes: {
+      key: 3
+      value: {
+        id: 3
+        name: "SSTable"
+        autotune: true
+        num_elements: 100
+        processing_time: 1000
+        node_class: KNOWN_RATIO
+        ratio: 2
+      }
+    }
+    output: 1
+    cost_model: {
+      histories: {
+        key: 1
+        value: {
+          samples: { parallelism: 4 processing_time: 250 }
+          samples: { parallelism: 4 processing_time: 250 }
+        }
+      }
+      histories: {
+        key: 2
+        value: {
+          samples: { parallelism: 4 processing_time: 200 }
+          samples: { parallelism: 4 processing_time: 200 }
+        }
+      }
+    }
+  )pb");
+
+  CellReader<int64_t> cell_reader(
+      "/tensorflow/data/autotune_stopping_criteria");
+  CancellationManager cancellation_manager;
+  RamBudgetManager ram_budget_manager(0);
+  model_->Optimize(AutotuneAlgorithm::LEARNED_COST_MODEL, CpuBudgetFunc(5),
+                   /*ram_budget_share=*/1.0,
+                   /*fixed_ram_budget=*/1000,
+                   /*model_input_time=*/50, ram_budget_manager,
+                   &cancellation_manager);
+
+  // Unlike the stage-based optimization, the total parallelism stays within
+  // the CPU budget.
+  EXPECT_EQ(3, GetNode(/*node_id=*/1)->parameter_value("parallelism"));
+  EXPECT_EQ(2, GetNode(/*node_id=*/2)->parameter_value("parallelism"));
+  EXPECT_EQ(cell_reader.Read("cpu_budget_exceeded"), 1);
+
+  ModelProto model_proto;
+  TF_ASSERT_OK(model_->ToProto(&model_proto));
+  const ModelProto::CostModel& cost_model = model_proto.cost_model();
+  ASSERT_EQ(cost_model.decisions_size(), 2);
+  EXPECT_EQ(cost_model.decisions(0).node_id(), 1);
+  EXPECT_EQ(cost_model.decisions(0).parameter_name(), "parallelism");
+  EXPECT_EQ(cost_model.decisions(0).value(), 3);
+  EXPECT_DOUBLE_EQ(cost_model.decisions(0).intercept(), 250);
+  EXPECT_DOUBLE_EQ(cost_model.decisions(0).slope(), 0);
+  EXPECT_EQ(cost_model.decisions(1).node_id(), 2);
+  EXPECT_EQ(cost_model.decisions(1).value(), 2);
+}
+
+TEST_F(ModelTimingTest, OptimizeLearnedCostModel_FitsContention) {
+  BuildModelFromProto(R"pb(
+    nodes: {
+      key: 1
+      value: {
+        id: 1
+        name: "ParallelMapV2"
+        autotune: true
+        num_elements: 100
+        processing_time: 30000
+        bytes_produced: 10000
+        node_class: ASYNC_KNOWN_RATIO
+        ratio: 1
+        inputs: 2
+        parameters: {
+          name: "parallelism"
+          value: 4
+          state_value: 4
+          min: 1
+          max: 16
+          tunable: true
+        }
+      }
+    }
+    nodes: {
+      key: 2
+      value: {
+        id: 2
+        name: "SSTable"
+        autotune: true
+        num_elements: 100
+        node_class: KNOWN_RATIO
+        ratio: 1
+      }
+    }
+    output: 1
+  )pb");
+
+  CancellationManager cancellation_manager;
+  RamBudgetManager ram_budget_manager(0);
+  auto optimize = [&cancellation_manager, &ram_budget_manager](Model* model) {
+    model->Optimize(AutotuneAlgorithm::LEARNED_COST_MODEL, CpuBudgetFunc(100),
+                    /*ram_budget_share=*/1.0,
+                    /*fixed_ram_budget=*/100000,
+                    /*model_input_time=*/0, ram_budget_manager,
+                    &cancellation_manager);
+  };
+  // The processing time per element is `100 + 50 * parallelism`.
+  Node* node = MutableGetNode(/*node_id=*/1);
+  auto run = [node](int parallelism) {
+    for (int i = 0; i < 100; ++i) {
+      node->record_element();
+    }
+    node->add_processing_time(100 * (100 + 50 * parallelism));
+  };
+  optimize(model_.get());
+  run(/*parallelism=*/4);
+  optimize(model_.get());
+  run(/*parallelism=*/4);
+  // With a single observed parallelism, the contention is not known yet.
+  optimize(model_.get());
+  EXPECT_EQ(16, GetNode(/*node_id=*/1)->parameter_value("parallelism"));
+
+  run(/*parallelism=*/16);
+  optimize(model_.get());
+  // Beyond 5, one more call improves the time per element by less than 5%.
+  EXPECT_EQ(5, GetNode(/*node_id=*/1)->parameter_value("parallelism"));
+
+  ModelProto model_proto;
+  TF_ASSERT_OK(model_->ToProto(&model_proto));
+  ASSERT_EQ(model_proto.cost_model().histories().at(1).samples_size(), 4);
+  ASSERT_EQ(model_proto.cost_model().decisions_size(), 1);
+  const ModelProto::CostModel::Decision& decision =
+      model_proto.cost_model().decisions(0);
+  EXPECT_EQ(decision.value(), 5);
+  EXPECT_NEAR(decision.intercept(), 100, 1e-6);
+  EXPECT_NEAR(decision.slope(), 50, 1e-6);
+  EXPECT_NEAR(decision.variation(), 0, 1e-6);
+  EXPECT_NEAR(decision.predicted_time(), 100.0 / 5 + 50, 1e-6);
+
+  // Refitting the restored observations reproduces the decision.
+  std::unique_ptr<Model> restored_model;
+  TF_ASSERT_OK(Model::FromProto(model_proto, &restored_model));
+  optimize(restored_model.get());
+  ModelProto restored_model_proto;
+  TF_ASSERT_OK(restored_model->ToProto(&restored_model_proto));
+  ASSERT_EQ(restored_model_proto.cost_model().decisions_size(), 1);
+  EXPECT_EQ(restored_model_proto.cost_model().decisions(0).value(), 5);
+  EXPECT_EQ(restored_model->output()->parameter_value("parallelism"), 5);
+}
+
+TEST_F(ModelTimingTest, OptimizeLearnedCostModel_ColdStart) {
+  BuildModelFromProto(R"pb(
+    nodes: {
+      key: 1
+      value: {
+        id: 1
+        name: "ParallelMapV2"
+        autotune: true
+        num_elements: 100
+        processing_time: 30000
+        bytes_produced: 10000
+        node_class: ASYNC_KNOWN_RATIO
+        ratio: 1
+        inputs: 2
+        parameters: {
+          name: "parallelism"
+          value: 8
+          state_value: 8
+          min: 1
+          max: 16
+          tunable: true
+        }
+      }
+    }
+    nodes: {
+      key: 2
+      value: {
+        id: 2
+        name: "ParallelMapV2"
+        autotune: true
+        node_class: ASYNC_KNOWN_RATIO
+        ratio: 1
+        inputs: 3
+        parameters: {
+          name: "parallelism"
+          value: 6
+          state_value: 6
+          min: 1
+          max: 16
+          tunable: true
+        }
+      }
+    }
+    nodes: {
+      key: 3
+      value: {
+        id: 3
+        name: "SSTable"
+        autotune: true
+        node_class: KNOWN_RATIO
+        ratio: 1
+      }
+    }
+    output: 1
+  )pb");
+
+  CancellationManager cancellation_manager;
+  RamBudgetManager ram_budget_manager(0);
+  model_->Optimize(AutotuneAlgorithm::LEARNED_COST_MODEL, CpuBudgetFunc(100),
+                   /*ram_budget_share=*/1.0,
+                   /*fixed_ram_budget=*/100000,
+                   /*model_input_time=*/50, ram_budget_manager,
+                   &cancellation_manager);
+
+  // Node 1 has a single sample and node 2 none, so neither stage is dropped
+  // to its minimum parallelism on a fit of zero processing time.
+  EXPECT_EQ(8, GetNode(/*node_id=*/1)->parameter_value("parallelism"));
+  EXPECT_EQ(6, GetNode(/*node_id=*/2)->parameter_value("parallelism"));
+}
+
 TEST_F(ModelTimingTest, ComputeTargetTime) {
   model_ = std::make_unique<Model>();
 
@@ -3575,6 +3951,24 @@ TEST(RamBudgetManagerTest, RequestAllocationsWithBudgetAdjustment) {
   EXPECT_TRUE(rbm.RequestLegacyPrefetchBytes(4));
 }
 
+TEST(RamBudgetManagerTest, RequestSpillableBytes) {
+  RamBudgetManager rbm(10);
+  EXPECT_TRUE(rbm.RequestModelAllocation(4));
+  // Spillable bytes only use what the model leaves unused.
+  EXPECT_FALSE(rbm.RequestSpillableBytes(7));
+  EXPECT_TRUE(rbm.RequestSpillableBytes(6));
+  EXPECT_EQ(rbm.SpillableBytesOverBudget(), 0);
+  // They do not reduce the RAM available to the model.
+  EXPECT_EQ(rbm.AvailableModelRam(), 10);
+  EXPECT_TRUE(rbm.RequestModelAllocation(7));
+  EXPECT_EQ(rbm.SpillableBytesOverBudget(), 3);
+  EXPECT_TRUE(rbm.RequestSpillableBytes(-3));
+  EXPECT_EQ(rbm.SpillableBytesOverBudget(), 0);
+  // Shrinking the budget also pushes spillable bytes out.
+  rbm.UpdateBudget(8);
+  EXPECT_EQ(rbm.SpillableBytesOverBudget(), 2);
+}
+
 TEST(NodeTest, OnlyCollectParametersThatHaveElementsProduced) {
   // Builds a graph:
   // root <- parallel_map <- parallel_interleave
@@ -801,6 +801,64 @@ absl::Status OpKernelContext::allocate_tensor(
   return absl::OkStatus();
 }
 
+bool OpKernelContext::temps_step_local() const {
+  // Stateful kernels may keep temporaries in resources that outlive the step,
+  // e.g. the buckets of a MutableDenseHashTable, and any kernel may pass a
+  // temporary to set_output().
+  if (params_->op_kernel == nullptr || params_->op_kernel->is_stateful()) {
+    return false;
+  }
+  for (int i = 0; i < num_outputs(); ++i) {
+    if (params_->outputs_step_local_array == nullptr ||
+        !params_->outputs_step_local_array[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool OpKernelContext::maybe_allocate_step_local(
+    int output_index, DataType type, const TensorShape& shape,
+    Tensor* out_tensor, AllocatorAttributes allocator_attr) {
+  Allocator* planned_allocator = nullptr;
+  if (output_index >= 0) {
+    if (params_->outputs_step_local_array == nullptr ||
+        !params_->outputs_step_local_array[output_index]) {
+      return false;
+    }
+    if (params_->planned_output_allocators != nullptr) {
+      planned_allocator = params_->planned_output_allocators[output_index];
+    }
+  }
+  if ((planned_allocator == nullptr && params_->step_allocator == nullptr) ||
+      allocator_attr.value != 0 || allocator_attr.scope_id != 0 ||
+      track_allocations() || params_->log_memory ||
+      !DataTypeCanUseMemcpy(type)) {
+    return false;
+  }
+  const int64_t num_bytes = DataTypeSize(type) * shape.num_elements();
+  if (num_bytes <= 0) {
+    return false;
+  }
+  if (planned_allocator != nullptr) {
+    Tensor new_tensor(planned_allocator, type, shape);
+    if (new_tensor.IsInitialized()) {
+      *out_tensor = std::move(new_tensor);
+      return true;
+    }
+  }
+  if (params_->step_allocator == nullptr ||
+      static_cast<size_t>(num_bytes) > params_->step_allocator_max_bytes) {
+    return false;
+  }
+  Tensor new_tensor(params_->step_allocator, type, shape);
+  if (!new_tensor.IsInitialized()) {
+    return false;
+  }
+  *out_tensor = std::move(new_tensor);
+  return true;
+}
+
 absl::Status OpKernelContext::allocate_output(int index,
                                               const TensorShape& shape,
                                               Tensor** output,
@@ -841,7 +899,11 @@ absl::Status OpKernelContext::allocate_output(int index,
       op_kernel().name_view(), step_id(), "output", type,
       [&shape]() { return shape.DebugString(); });
   auto output_tensor = std::make_unique<Tensor>();
-  absl::Status s = allocate_tensor(type, shape, output_tensor.get(), attr);
+  absl::Status s;
+  if (!maybe_allocate_step_local(index, type, shape, output_tensor.get(),
+                                 attr)) {
+    s = allocate_tensor(type, shape, output_tensor.get(), attr);
+  }
   if (s.ok()) {
     outputs_[index] = TensorValue(output_tensor.release());
     *output = outputs_[index].tensor;
@@ -871,8 +933,13 @@ absl::Status OpKernelContext::allocate_temp(
   tsl::profiler::ScopedMemoryDebugAnnotation op_annotation(
       op_kernel().name_view(), step_id(), "temp", type,
       [&shape]() { return shape.DebugString(); });
-  absl::Status s =
-      allocate_tensor(type, shape, out_temp, allocator_attr, allocation_attr);
+  absl::Status s;
+  if (!temps_step_local() ||
+      !maybe_allocate_step_local(/*output_index=*/-1, type, shape, out_temp,
+                                 allocator_attr)) {
+    s = allocate_tensor(type, shape, out_temp, allocator_attr,
+                        allocation_attr);
+  }
   if (track_allocations() && s.ok() && out_temp->TotalBytes() > 0) {
     Allocator* a = get_allocator(allocator_attr);
     if (a->TracksAllocationSizes()) {
@@ -703,6 +703,22 @@ class OpKernelContext {
     // outputs are required.
     bool* outputs_required_array = nullptr;
 
+    // If non-null, an allocator for outputs and temporaries that are not
+    // expected to outlive the step. Only requests of up to
+    // `step_allocator_max_bytes` bytes are routed to it. Temporaries are
+    // only routed to it if the kernel is stateless and all of its outputs are
+    // step-local, since they might otherwise outlive the step.
+    Allocator* step_allocator = nullptr;
+    size_t step_allocator_max_bytes = 0;
+
+    // If non-null, the ith bool is true if the ith output may be allocated
+    // with `step_allocator` or `planned_output_allocators`.
+    const bool* outputs_step_local_array = nullptr;
+
+    // If non-null, the ith entry, when non-null, is an allocator that serves
+    // the ith output from memory planned ahead of the step.
+    Allocator* const* planned_output_allocators = nullptr;
+
     // For access to distributed coordination service.
     tsl::CoordinationServiceAgent* coordination_service_agent = nullptr;
   };
@@ -1295,6 +1311,20 @@ class OpKernelContext {
                                AllocatorAttributes allocator_attr,
                                const AllocationAttributes& allocation_attr);
 
+  // Returns true if the temporaries of the kernel cannot outlive the step:
+  // the kernel is stateless, and none of its outputs, which a temporary may
+  // become through `set_output()`, escape the step.
+  bool temps_step_local() const;
+
+  // Allocates `out_tensor` from memory reserved for the step if the request
+  // qualifies: from the planned allocator of output `output_index`, or from
+  // `params_->step_allocator`. `output_index` is -1 for temporaries, which
+  // the caller must check with `temps_step_local()` first. Returns false if
+  // the caller must allocate it.
+  bool maybe_allocate_step_local(int output_index, DataType type,
+                                 const TensorShape& shape, Tensor* out_tensor,
+                                 AllocatorAttributes allocator_attr);
+
   // Helpers for `set_output()`.
 
   // Returns `true` if the tensor was copied into an allocated output.
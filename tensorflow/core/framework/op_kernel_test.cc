@@ -629,6 +629,86 @@ TEST_F(OpKernelTest, ScopedAllocationTest) {
   EXPECT_EQ(sa_device->num_allocations(true), 1);
 }
 
+// Counts the allocations made for the step.
+class StepAllocator : public Allocator {
+ public:
+  std::string Name() override { return "step"; }
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    ++num_allocations_;
+    return cpu_allocator()->AllocateRaw(alignment, num_bytes);
+  }
+  void DeallocateRaw(void* ptr) override {
+    cpu_allocator()->DeallocateRaw(ptr);
+  }
+
+  int num_allocations_ = 0;
+};
+
+REGISTER_OP("StatelessTemp");
+REGISTER_KERNEL_BUILDER(Name("StatelessTemp").Device(DEVICE_CPU), DummyKernel);
+REGISTER_OP("StatefulTemp").SetIsStateful();
+REGISTER_KERNEL_BUILDER(Name("StatefulTemp").Device(DEVICE_CPU), DummyKernel);
+
+TEST_F(OpKernelTest, StepAllocatorServesStatelessTemporariesOnly) {
+  Env* env = Env::Default();
+  DummyDevice device(env);
+  StepAllocator step_allocator;
+  // Stands in for a resource that keeps a temporary past the step.
+  Tensor kept;
+  for (const char* op_type : {"StatelessTemp", "StatefulTemp"}) {
+    OpKernelContext::Params params;
+    params.device = &device;
+    params.step_allocator = &step_allocator;
+    params.step_allocator_max_bytes = 1024;
+    absl::Status status;
+    std::unique_ptr<OpKernel> op(
+        CreateOpKernel(DEVICE_CPU, params.device, cpu_allocator(),
+                       CreateNodeDef(op_type, {}), TF_GRAPH_DEF_VERSION,
+                       &status));
+    TF_ASSERT_OK(status);
+    params.op_kernel = op.get();
+    auto ctx = std::make_unique<OpKernelContext>(&params);
+    TF_ASSERT_OK(ctx->allocate_temp(DT_FLOAT, TensorShape({8}), &kept));
+  }
+  // Only the temporary of the stateless kernel came from the step, so the
+  // one kept by the stateful kernel does not pin the step's memory.
+  EXPECT_EQ(step_allocator.num_allocations_, 1);
+  kept.flat<float>().setZero();
+}
+
+REGISTER_OP("OutputTemp").Output("out: float");
+REGISTER_KERNEL_BUILDER(Name("OutputTemp").Device(DEVICE_CPU), DummyKernel);
+
+TEST_F(OpKernelTest, StepAllocatorServesTemporariesOfStepLocalOutputsOnly) {
+  Env* env = Env::Default();
+  DummyDevice device(env);
+  StepAllocator step_allocator;
+  absl::Status status;
+  std::unique_ptr<OpKernel> op(CreateOpKernel(
+      DEVICE_CPU, &device, cpu_allocator(), CreateNodeDef("OutputTemp", {}),
+      TF_GRAPH_DEF_VERSION, &status));
+  TF_ASSERT_OK(status);
+  // Stands in for an output that escapes the step.
+  Tensor escaping;
+  for (const bool output_step_local : {true, false}) {
+    OpKernelContext::Params params;
+    params.device = &device;
+    params.op_kernel = op.get();
+    params.step_allocator = &step_allocator;
+    params.step_allocator_max_bytes = 1024;
+    const bool outputs_step_local[] = {output_step_local};
+    params.outputs_step_local_array = outputs_step_local;
+    auto ctx = std::make_unique<OpKernelContext>(&params, 1);
+    Tensor temp;
+    TF_ASSERT_OK(ctx->allocate_temp(DT_FLOAT, TensorShape({8}), &temp));
+    ctx->set_output(0, temp);
+    escaping = *ctx->mutable_output(0);
+  }
+  // The temporary that became an escaping output did not come from the step.
+  EXPECT_EQ(step_allocator.num_allocations_, 1);
+  escaping.flat<float>().setZero();
+}
+
 TEST_F(OpKernelTest, TraceString) {
   Env* env = Env::Default();
   OpKernelContext::Params params;
@@ -15,10 +15,13 @@ limitations under the License.
 
 #include "tensorflow/core/framework/rendezvous.h"
 
+#include <vector>
+
 #include "absl/status/status.h"
 #include "absl/synchronization/notification.h"
 #include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
 #include "tensorflow/core/framework/cancellation.h"
+#include "tensorflow/core/framework/local_rendezvous.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/tensor_types.h"
@@ -26,6 +29,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/blocking_counter.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
@@ -517,5 +521,61 @@ void BM_PingPong(::testing::benchmark::State& state) {
 }
 BENCHMARK(BM_PingPong)->Arg(100)->Arg(200)->Arg(300);
 
+// Send/Recv pairs over distinct keys, as between the partitions of a graph.
+// Runs state.range(0) sender and as many receiver threads, with
+// state.range(1) lock-free slots in the rendezvous.
+void BM_SendRecvDistinctKeys(::testing::benchmark::State& state) {
+  const int num_threads = state.range(0);
+  LocalRendezvous::SetNumSlotsForTesting(state.range(1));
+  constexpr int kKeysPerThread = 1000;
+  std::vector<Rendezvous::ParsedKey> keys(num_threads * kKeysPerThread);
+  for (int i = 0; i < num_threads * kKeysPerThread; ++i) {
+    TF_CHECK_OK(Rendezvous::ParseKey(
+        Rendezvous::CreateKey("/job:mnist/replica:1/task:2/cpu:0", 7890,
+                              "/job:mnist/replica:1/task:2/cpu:1",
+                              strings::StrCat("edge_", i), FrameAndIter(0, 0)),
+        &keys[i]));
+  }
+  thread::ThreadPool pool(Env::Default(), "test", 2 * num_threads);
+  const Tensor val = V("val");
+
+  for (auto s : state) {
+    Rendezvous* rendez = NewLocalRendezvous();
+    // Counts the received values and the threads that are done.
+    BlockingCounter counter(keys.size() + 2 * num_threads);
+    for (int t = 0; t < num_threads; ++t) {
+      pool.Schedule([&, t]() {
+        for (int i = t * kKeysPerThread; i < (t + 1) * kKeysPerThread; ++i) {
+          TF_CHECK_OK(rendez->Send(keys[i], Rendezvous::Args(), val, false));
+        }
+        counter.DecrementCount();
+      });
+      pool.Schedule([&, t]() {
+        for (int i = t * kKeysPerThread; i < (t + 1) * kKeysPerThread; ++i) {
+          rendez->RecvAsync(
+              keys[i], Rendezvous::Args(),
+              [&counter](const absl::Status& s, const Rendezvous::Args&,
+                         const Rendezvous::Args&, const Tensor&, bool) {
+                TF_CHECK_OK(s);
+                counter.DecrementCount();
+              });
+        }
+        counter.DecrementCount();
+      });
+    }
+    counter.Wait();
+    rendez->Unref();
+  }
+  state.SetItemsProcessed(keys.size() * state.iterations());
+  LocalRendezvous::SetNumSlotsForTesting(0);
+}
+BENCHMARK(BM_SendRecvDistinctKeys)
+    ->ArgPair(1, 0)
+    ->ArgPair(1, 65536)
+    ->ArgPair(4, 0)
+    ->ArgPair(4, 65536)
+    ->ArgPair(16, 0)
+    ->ArgPair(16, 65536);
+
 }  // namespace
 }  // namespace tensorflow
@@ -25,6 +25,7 @@ limitations under the License.
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "xla/tsl/platform/statusor.h"
+#include "tensorflow/core/data/batch_slab.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/global_shuffle_utils.h"
 #include "tensorflow/core/data/name_utils.h"
@@ -55,6 +56,10 @@ namespace data {
 constexpr char kInputImplEmpty[] = "input_impl_empty";
 constexpr char kBatchDataset[] = "BatchDataset";
 
+// Experiment that lets the input iterator allocate the elements of a batch
+// directly in the batch output (see `BatchSlab`).
+constexpr char kBatchSlabExperiment[] = "batch_slab";
+
 class BatchDatasetOp::Dataset : public DatasetBase {
  public:
   Dataset(OpKernelContext* ctx, int64_t batch_size, bool drop_remainder,
@@ -199,12 +204,21 @@ class BatchDatasetOp::Dataset : public DatasetBase {
 
     absl::Status Initialize(IteratorContext* ctx) override {
       tsl::mutex_lock l(mu_);
+      // Parallel copies are cheaper than a sequential copy into a slab.
+      use_batch_slab_ =
+          !dataset()->parallel_copy_ &&
+          BatchSlab::IsSupported(dataset()->input_->output_dtypes(),
+                                 dataset()->input_->output_shapes()) &&
+          GetExperiments().contains(kBatchSlabExperiment);
       return dataset()->input_->MakeIterator(ctx, this, prefix(), &input_impl_);
     }
 
     absl::Status GetNextInternal(IteratorContext* ctx,
                                  std::vector<Tensor>* out_tensors,
                                  bool* end_of_sequence) override {
+      if (use_batch_slab_) {
+        return GetNextFromSlab(ctx, out_tensors, end_of_sequence);
+      }
       // Each row of `batch_elements` is a tuple of tensors from the
       // input iterator.
       std::vector<std::vector<Tensor>> batch_elements;
@@ -247,9 +261,8 @@ class BatchDatasetOp::Dataset : public DatasetBase {
       //
       // NOTE(mrry): If the input or output sizes are statically known, we
       // could potentially read the input values in-place into their
-      // respective slice locations. This would require a different GetNext()
-      // overload that supports zero-copy, and might make sense in an
-      // optimization pass.
+      // respective slice locations. `GetNextFromSlab()` does this when the
+      // `batch_slab` experiment is enabled.
       TF_RETURN_IF_ERROR(CopyBatch(AnyContext(ctx), std::move(batch_elements),
                                    dataset()->parallel_copy_, out_tensors));
 
@@ -321,8 +334,70 @@ class BatchDatasetOp::Dataset : public DatasetBase {
     }
 
    private:
+    // Like `GetNextInternal()`, but places the elements in a `BatchSlab` as
+    // they are produced instead of copying them after the batch is complete.
+    absl::Status GetNextFromSlab(IteratorContext* ctx,
+                                 std::vector<Tensor>* out_tensors,
+                                 bool* end_of_sequence) {
+      std::unique_ptr<BatchSlab> slab;
+      {
+        mutex_lock l(mu_);
+        if (!input_impl_) {
+          *end_of_sequence = true;
+          return absl::OkStatus();
+        }
+        // The slab is only allocated once the input is known not to have
+        // ended, since callers ask for a batch past the last one.
+        TF_ASSIGN_OR_RETURN(
+            slab, BatchSlab::Create(ctx->allocator({}),
+                                    dataset()->input_->output_dtypes(),
+                                    dataset()->input_->output_shapes(),
+                                    dataset()->batch_size_));
+        *end_of_sequence = false;
+        IteratorContextWithIndexMapper ctx_with_index_mapper(ctx, this);
+        IteratorContext::Params params(ctx_with_index_mapper.Get());
+        params.allocator_getter =
+            [slab_allocator = slab->allocator(),
+             allocator_getter = std::move(params.allocator_getter)](
+                AllocatorAttributes attrs) {
+              // Only default allocations can be placed in the batch.
+              return attrs.value == 0 ? slab_allocator
+                                      : allocator_getter(attrs);
+            };
+        IteratorContext slab_ctx(std::move(params));
+        for (int i = 0; i < dataset()->batch_size_ && !*end_of_sequence; ++i) {
+          std::vector<Tensor> batch_element_tuple;
+          TF_RETURN_IF_ERROR(input_impl_->GetNext(
+              &slab_ctx, &batch_element_tuple, end_of_sequence));
+          if (!*end_of_sequence) {
+            TF_RETURN_IF_ERROR(slab->AddElement(std::move(batch_element_tuple)));
+          } else {
+            input_impl_.reset();
+          }
+        }
+        ctx_with_index_mapper.Get()->MergeCheckpoint(slab_ctx.checkpoint());
+        ctx_with_index_mapper.MergeCheckpoint();
+      }
+
+      if (slab->num_elements() == 0) {
+        DCHECK(*end_of_sequence);
+        return absl::OkStatus();
+      }
+
+      if (dataset()->drop_remainder_ &&
+          slab->num_elements() < dataset()->batch_size_) {
+        *end_of_sequence = true;
+        return absl::OkStatus();
+      }
+
+      TF_RETURN_IF_ERROR(slab->Finish(out_tensors));
+      *end_of_sequence = false;
+      return absl::OkStatus();
+    }
+
     mutex mu_;
     std::unique_ptr<IteratorBase> input_impl_ TF_GUARDED_BY(mu_);
+    bool use_batch_slab_ = false;
   };
 
   const int64_t batch_size_;
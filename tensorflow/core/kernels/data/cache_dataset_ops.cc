@@ -17,7 +17,9 @@ limitations under the License.
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -25,6 +27,7 @@ limitations under the License.
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "tensorflow/core/data/columnar_cache.h"
 #include "tensorflow/core/data/global_shuffle_utils.h"
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/serialization_utils.h"
@@ -149,10 +152,22 @@ class DatasetRandomAccessCache {
 class IteratorRandomAccessCache {
  public:
   explicit IteratorRandomAccessCache(const DatasetBase* input)
-      : input_(input) {}
+      : input_(input) {
+    if (std::optional<ColumnarCache::Options> options =
+            GetColumnarCacheOptions()) {
+      columnar_cache_ = std::make_unique<ColumnarCache>(*options);
+    }
+  }
 
   absl::Status Get(AnyContext ctx, size_t element_position,
                    std::vector<Tensor>* out_tensors) {
+    if (columnar_cache_) {
+      if (columnar_cache_->Contains(element_position)) {
+        return columnar_cache_->Get(element_position, out_tensors);
+      }
+      TF_RETURN_IF_ERROR(input_->Get(ctx, element_position, out_tensors));
+      return columnar_cache_->Put(element_position, *out_tensors);
+    }
     if (element_position < cache_.size() && !cache_[element_position].empty()) {
       *out_tensors = cache_[element_position];
       return absl::OkStatus();
@@ -169,6 +184,8 @@ class IteratorRandomAccessCache {
  private:
   const DatasetBase* input_ = nullptr;
   std::vector<std::vector<Tensor>> cache_;
+  // Used instead of `cache_` with `kColumnarMemoryCacheExperiment`.
+  std::unique_ptr<ColumnarCache> columnar_cache_;
 };
 
 class CacheDatasetOp::FileDatasetBase : public DatasetBase {
@@ -894,8 +911,10 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
       mutex_lock l(mu_);
       if (cache_->IsCompleted()) {
         TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kCacheCompleted, ""));
+        std::vector<std::vector<Tensor>> elements;
+        TF_RETURN_IF_ERROR(cache_->GetAll(&elements));
         TF_RETURN_IF_ERROR(
-            WriteElementsToCheckpoint(writer, prefix(), cache_->data()));
+            WriteElementsToCheckpoint(writer, prefix(), elements));
       }
       TF_RETURN_IF_ERROR(global_shuffle_iterator_.Save(prefix(), ctx, writer));
       return SaveInput(ctx, writer, iterator_);
@@ -1009,8 +1028,9 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
         // is that this is incorrect if there are concurrent instances of this
         // iterator.
         tf_shared_lock l(mu_);
-        for (size_t i = 0; i < cache_->size(); ++i) {
-          RecordBufferEnqueue(ctx, cache_->at(i));
+        if (ctx->model() && model_node()) {
+          model_node()->record_buffer_event(cache_->AllocatedBytes(),
+                                            cache_->size());
         }
         return absl::OkStatus();
       }
@@ -1020,9 +1040,11 @@ class CacheDatasetOp::MemoryDatasetBase : public DatasetBase {
                                    bool* end_of_sequence) override {
         mutex_lock l(mu_);
         if (index_ < cache_->size()) {
-          const std::vector<Tensor>& cache_tensors = cache_->at(index_);
-          out_tensors->insert(out_tensors->begin(), cache_tensors.begin(),
-                              cache_tensors.end());
+          std::vector<Tensor> cache_tensors;
+          TF_RETURN_IF_ERROR(cache_->Get(index_, &cache_tensors));
+          out_tensors->insert(out_tensors->begin(),
+                              std::make_move_iterator(cache_tensors.begin()),
+                              std::make_move_iterator(cache_tensors.end()));
           index_++;
           *end_of_sequence = false;
           return absl::OkStatus();
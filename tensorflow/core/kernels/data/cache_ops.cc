@@ -17,12 +17,16 @@ limitations under the License.
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/log/check.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/data/columnar_cache.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/partial_tensor_shape.h"
@@ -42,10 +46,57 @@ constexpr char kMemoryCache[] = "MemoryCache";
 
 std::string MemoryCacheManager::DebugString() const { return kMemoryCache; }
 
+std::optional<ColumnarCache::Options> GetColumnarCacheOptions() {
+  absl::flat_hash_set<std::string> experiments = GetExperiments();
+  if (!experiments.contains(kColumnarMemoryCacheExperiment)) {
+    return std::nullopt;
+  }
+  ColumnarCache::Options options;
+  options.compress =
+      experiments.contains(kColumnarMemoryCacheCompressionExperiment);
+  return options;
+}
+
+MemoryCache::MemoryCache() : columnar_options_(GetColumnarCacheOptions()) {}
+
 void MemoryCache::Complete(std::vector<std::vector<Tensor>>&& cache) {
+  if (IsCompleted()) {
+    return;
+  }
+  int64_t allocated_bytes = 0;
+  std::unique_ptr<ColumnarCache> columnar_cache;
+  if (columnar_options_.has_value()) {
+    // Releases the elements as they are stored, so that the cache is not held
+    // twice in memory.
+    columnar_cache = std::make_unique<ColumnarCache>(*columnar_options_);
+    for (size_t i = 0; i < cache.size(); ++i) {
+      absl::Status s = columnar_cache->Append(cache[i]);
+      if (!s.ok()) {
+        LOG(WARNING) << "Failed to store the cached elements in a columnar "
+                        "cache: "
+                     << s;
+        for (size_t j = 0; j < i; ++j) {
+          TF_CHECK_OK(columnar_cache->Get(j, &cache[j]));
+        }
+        columnar_cache.reset();
+        break;
+      }
+      cache[i].clear();
+    }
+  }
+  if (columnar_cache) {
+    cache.clear();
+    allocated_bytes = columnar_cache->AllocatedBytes();
+  } else {
+    for (const auto& element : cache) {
+      allocated_bytes += GetAllocatedBytes(element);
+    }
+  }
   mutex_lock l(mu_);
   if (!completed_) {
     cache_ = std::move(cache);
+    columnar_cache_ = std::move(columnar_cache);
+    allocated_bytes_ = allocated_bytes;
     completed_ = true;
   }
 }
@@ -59,22 +110,47 @@ void MemoryCache::Reset() {
   mutex_lock l(mu_);
   completed_ = false;
   cache_.clear();
+  columnar_cache_.reset();
+  allocated_bytes_ = 0;
 }
 
-const std::vector<Tensor>& MemoryCache::at(int64_t index) {
+absl::Status MemoryCache::Get(int64_t index, std::vector<Tensor>* element) {
   tf_shared_lock l(mu_);
-  DCHECK(index < cache_.size());
-  return cache_[index];
+  if (columnar_cache_) {
+    return columnar_cache_->Get(index, element);
+  }
+  if (index < 0 || index >= cache_.size()) {
+    return absl::OutOfRangeError(
+        absl::StrCat("Index out of range [0, ", cache_.size(), "):", index));
+  }
+  *element = cache_[index];
+  return absl::OkStatus();
 }
 
 size_t MemoryCache::size() {
   tf_shared_lock l(mu_);
+  if (columnar_cache_) {
+    return columnar_cache_->size();
+  }
   return cache_.size();
 }
 
-const std::vector<std::vector<Tensor>>& MemoryCache::data() {
+absl::Status MemoryCache::GetAll(std::vector<std::vector<Tensor>>* elements) {
+  tf_shared_lock l(mu_);
+  if (!columnar_cache_) {
+    *elements = cache_;
+    return absl::OkStatus();
+  }
+  elements->resize(columnar_cache_->size());
+  for (size_t i = 0; i < elements->size(); ++i) {
+    TF_RETURN_IF_ERROR(columnar_cache_->Get(i, &(*elements)[i]));
+  }
+  return absl::OkStatus();
+}
+
+int64_t MemoryCache::AllocatedBytes() {
   tf_shared_lock l(mu_);
-  return cache_;
+  return allocated_bytes_;
 }
 
 AnonymousMemoryCacheHandleOp::AnonymousMemoryCacheHandleOp(
@@ -16,7 +16,13 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_KERNELS_DATA_CACHE_OPS_H_
 #define TENSORFLOW_CORE_KERNELS_DATA_CACHE_OPS_H_
 
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
 #include "absl/status/status.h"
+#include "tensorflow/core/data/columnar_cache.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 
@@ -28,9 +34,12 @@ namespace data {
 // The expected use is that a single `MemoryWriterIterator` populates the
 // cache with dataset elements. Once all elements are cached, the cache can
 // be used by one or more `MemoryReaderIterator`s.
+//
+// With `kColumnarMemoryCacheExperiment`, the completed cache is stored in a
+// `ColumnarCache`.
 class MemoryCache {
  public:
-  MemoryCache() = default;
+  MemoryCache();
 
   // Marks the cache as completed.
   void Complete(std::vector<std::vector<Tensor>>&& cache);
@@ -42,22 +51,32 @@ class MemoryCache {
   void Reset();
 
   // Returns the element at the given index.
-  const std::vector<Tensor>& at(int64_t index);
+  absl::Status Get(int64_t index, std::vector<Tensor>* element);
 
   // Returns the size of the cache.
   size_t size();
 
-  // Returns a reference to the cache's data. The returned reference will be
-  // invalidated by any call to Reset().
-  const std::vector<std::vector<Tensor>>& data();
+  // Returns all elements of the cache.
+  absl::Status GetAll(std::vector<std::vector<Tensor>>* elements);
+
+  // Returns the number of bytes allocated for the cached elements.
+  int64_t AllocatedBytes();
 
  private:
   mutex mu_;
+  // Set if the completed cache is stored in a `ColumnarCache`.
+  const std::optional<ColumnarCache::Options> columnar_options_;
   // Determines whether all elements of the dataset have been cached.
   bool completed_ TF_GUARDED_BY(mu_) = false;
   std::vector<std::vector<Tensor>> cache_ TF_GUARDED_BY(mu_);
+  std::unique_ptr<ColumnarCache> columnar_cache_ TF_GUARDED_BY(mu_);
+  int64_t allocated_bytes_ TF_GUARDED_BY(mu_) = 0;
 };
 
+// Returns the options of the `ColumnarCache` to store cached elements in, or
+// `std::nullopt` if `kColumnarMemoryCacheExperiment` is disabled.
+std::optional<ColumnarCache::Options> GetColumnarCacheOptions();
+
 // A resource wrapping a shared instance of a memory cache.
 class MemoryCacheManager : public ResourceBase {
  public:
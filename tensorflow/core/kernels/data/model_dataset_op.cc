@@ -15,6 +15,11 @@ limitations under the License.
 #include "tensorflow/core/kernels/data/model_dataset_op.h"
 
 #include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/framework/cancellation.h"
@@ -23,13 +28,20 @@ limitations under the License.
 // dependencies are available there. The op is replaced with a no-op.
 #if !defined(IS_MOBILE_PLATFORM)
 #include "absl/memory/memory.h"
+#include "absl/strings/str_format.h"
+#include "tensorflow/core/data/hash_utils.h"
+#include "tensorflow/core/data/serialization_utils.h"
 #include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/model.h"
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/hash.h"
+#include "tensorflow/core/platform/path.h"
 #include "tensorflow/core/platform/stringprintf.h"
 
 namespace tensorflow {
@@ -39,6 +51,40 @@ namespace {
 // Default share of available RAM that can be used by model's internal buffers.
 constexpr double kRamBudgetShare = model::kRamBudgetShare;
 
+// Directory of the checkpoints used to warm-start the autotuning across job
+// restarts. Warm-starting is disabled if it is not set.
+constexpr char kWarmStartDirEnvVar[] = "TF_DATA_AUTOTUNE_WARM_START_DIR";
+
+std::string WarmStartDir() {
+  const char* dir = std::getenv(kWarmStartDirEnvVar);
+  return dir == nullptr ? "" : dir;
+}
+
+// Returns the fingerprint of the input pipeline graph of `input` if
+// warm-starting is enabled.
+std::optional<uint64_t> WarmStartFingerprint(OpKernelContext* ctx,
+                                             const DatasetBase* input) {
+  if (WarmStartDir().empty()) {
+    return std::nullopt;
+  }
+  std::vector<std::pair<std::string, Tensor>> input_list;
+  GraphDef graph_def;
+  std::string dataset_node;
+  uint64_t fingerprint = 0;
+  absl::Status s =
+      AsGraphDefForRewrite(ctx, input, &input_list, &graph_def, &dataset_node);
+  if (s.ok()) {
+    s = HashGraph(graph_def, &fingerprint);
+  }
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to fingerprint the input pipeline. The tf.data "
+                    "autotuning will not be warm-started: "
+                 << s;
+    return std::nullopt;
+  }
+  return fingerprint;
+}
+
 }  // namespace
 
 /* static */ constexpr const char* const ModelDatasetOp::kDatasetType;
@@ -52,17 +98,18 @@ class ModelDatasetOp::Dataset : public DatasetBase {
   Dataset(OpKernelContext* ctx, const DatasetBase* input,
           model::AutotuneAlgorithm algorithm, int64_t cpu_budget,
           int64_t ram_budget)
-      : Dataset(DatasetContext(ctx), input, algorithm, cpu_budget, ram_budget) {
-  }
+      : Dataset(DatasetContext(ctx), input, algorithm, cpu_budget, ram_budget,
+                WarmStartFingerprint(ctx, input)) {}
 
   Dataset(DatasetContext&& ctx, const DatasetBase* input,
           model::AutotuneAlgorithm algorithm, int64_t cpu_budget,
-          int64_t ram_budget)
+          int64_t ram_budget, std::optional<uint64_t> warm_start_fingerprint)
       : DatasetBase(std::move(ctx)),
         input_(input),
         algorithm_(algorithm),
         cpu_budget_(cpu_budget),
         ram_budget_(ram_budget),
+        warm_start_fingerprint_(warm_start_fingerprint),
         traceme_metadata_(
             {{"algorithm", model::AutotuneAlgorithm_Name(algorithm)},
              {"cpu_budget",
@@ -142,6 +189,11 @@ class ModelDatasetOp::Dataset : public DatasetBase {
     ~Iterator() override { cancellation_manager_->StartCancel(); }
 
     absl::Status Initialize(IteratorContext* ctx) override {
+      // The nodes of the input iterators pick up the warm-start values when
+      // they are added to the model, so this must happen before creating them.
+      if (!ctx->model() && dataset()->warm_start_fingerprint_.has_value()) {
+        MaybeEnableWarmStart();
+      }
       return dataset()->input_->MakeIterator(IteratorContext(CreateParams(ctx)),
                                              this, prefix(), &input_impl_);
     }
@@ -180,6 +232,28 @@ class ModelDatasetOp::Dataset : public DatasetBase {
     }
 
    private:
+    void MaybeEnableWarmStart() {
+      // The tuned values depend on the algorithm and the CPU budget as well as
+      // on the input pipeline.
+      uint64_t fingerprint = Hash64Combine(
+          *dataset()->warm_start_fingerprint_,
+          Hash64Combine(static_cast<uint64_t>(dataset()->algorithm_),
+                        static_cast<uint64_t>(cpu_budget_)));
+      std::string dir = WarmStartDir();
+      absl::Status s = Env::Default()->RecursivelyCreateDir(dir);
+      if (s.ok()) {
+        s = model_->EnableWarmStart(
+            io::JoinPath(dir, absl::StrFormat("autotune_%016x.pb",
+                                              fingerprint)),
+            fingerprint);
+      }
+      if (!s.ok()) {
+        LOG(WARNING) << "Failed to enable warm-starting of the tf.data "
+                        "autotuning: "
+                     << s;
+      }
+    }
+
     IteratorContext::Params CreateParams(IteratorContext* ctx) {
       IteratorContext::Params params(ctx);
       if (!ctx->model()) {
@@ -225,6 +299,8 @@ class ModelDatasetOp::Dataset : public DatasetBase {
   const model::AutotuneAlgorithm algorithm_;
   const int64_t cpu_budget_;
   const int64_t ram_budget_;
+  // Set if the autotuning is warm-started from a checkpoint.
+  const std::optional<uint64_t> warm_start_fingerprint_;
   const TraceMeMetadata traceme_metadata_;
 };
 
@@ -238,7 +314,8 @@ void ModelDatasetOp::MakeDatasetFromOptions(OpKernelContext* ctx,
   *output = new ModelDatasetOp::Dataset(
       DatasetContext(DatasetContext::Params(
           {ModelDatasetOp::kDatasetType, ModelDatasetOp::kDatasetOp})),
-      input, algorithm, cpu_budget, ram_budget);
+      input, algorithm, cpu_budget, ram_budget,
+      WarmStartFingerprint(ctx, input));
 }
 
 ModelDatasetOp::ModelDatasetOp(OpKernelConstruction* ctx)
@@ -34,6 +34,7 @@ limitations under the License.
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/stats_utils.h"
+#include "tensorflow/core/data/work_stealing_runner.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/metrics.h"
 #include "tensorflow/core/framework/model.h"
@@ -401,6 +402,9 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
       }
       thread_pool_ = ctx->CreateThreadPool(
           "data_parallel_interleave_worker_pool", num_threads);
+      if (GetExperiments().contains(kWorkStealingRunnerExperiment)) {
+        work_stealing_runner_ = std::make_unique<WorkStealingRunner>();
+      }
       if (num_parallel_calls_->value == model::kAutotune) {
         num_parallel_calls_->value = std::min(
             GetAutotuneDefaultParallelism(ctx), dataset()->cycle_length_);
@@ -1153,6 +1157,7 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
       element.inputs = std::make_unique<std::vector<Tensor>>(std::move(inputs));
       IteratorContext::Params params(ctx);
       params.interleave_depth += 1;
+      MaybeUseWorkStealingRunner(&params);
       IteratorContext nested_ctx(params);
       status = MakeIteratorFromInputElement(
           &nested_ctx, this, *element.inputs, element.id,
@@ -1472,6 +1477,7 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
             reader->ReadScalar(key_prefix, kIdSuffix, &element->id));
         IteratorContext::Params params(ctx);
         params.interleave_depth += 1;
+        MaybeUseWorkStealingRunner(&params);
         IteratorContext ctx_copy(params);
         TF_RETURN_IF_ERROR(MakeIteratorFromInputElement(
             &ctx_copy, this, *element->inputs, element->id,
@@ -1550,6 +1556,14 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
       return absl::OkStatus();
     }
 
+    // Makes the functions of the interleaved iterators run on the work-stealing
+    // thread pool when `kWorkStealingRunnerExperiment` is enabled.
+    void MaybeUseWorkStealingRunner(IteratorContext::Params* params) const {
+      if (work_stealing_runner_ != nullptr) {
+        params->runner = work_stealing_runner_->AsRunnerFunction();
+      }
+    }
+
     absl::Status ReadElementsParallel(
         IteratorContext* ctx, IteratorStateReader* reader, int64_t size,
         const std::string& name,
@@ -1713,6 +1727,8 @@ class ParallelInterleaveDatasetOp::Dataset : public DatasetBase {
     condition_variable outstanding_threads_finished_cond_var_;
 
     std::unique_ptr<thread::ThreadPool> thread_pool_;
+    // Set when `kWorkStealingRunnerExperiment` is enabled.
+    std::unique_ptr<WorkStealingRunner> work_stealing_runner_;
 
     int64_t element_id_counter_ TF_GUARDED_BY(mu_) = 0;
 
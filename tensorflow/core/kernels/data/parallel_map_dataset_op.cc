@@ -39,6 +39,7 @@ limitations under the License.
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/stats_utils.h"
 #include "tensorflow/core/data/unbounded_thread_pool.h"
+#include "tensorflow/core/data/work_stealing_runner.h"
 #include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/dataset_options.pb.h"
@@ -298,7 +299,9 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
     absl::Status Initialize(IteratorContext* ctx) override {
       mutex_lock l(*mu_);
       interleave_depth_ = ctx->interleave_depth();
-      if (use_unbounded_threadpool_) {
+      if (GetExperiments().contains(kWorkStealingRunnerExperiment)) {
+        work_stealing_runner_ = std::make_unique<WorkStealingRunner>();
+      } else if (use_unbounded_threadpool_) {
         unbounded_thread_pool_ = std::make_unique<UnboundedThreadPool>(
             ctx->env(), "tf_data_map_unbounded_thread_pool");
       }
@@ -582,7 +585,15 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
 
       // Apply the map function on `input_element`, storing the result in
       // `result->return_values`, and invoking `done` when finished.
-      if (use_unbounded_threadpool_) {
+      if (work_stealing_runner_ != nullptr &&
+          dataset()->captured_func_->use_inter_op_parallelism()) {
+        instantiated_captured_func_->RunAsync(
+            work_stealing_runner_->AsRunnerFunction(),
+            ctx->cancellation_manager(), ctx->collective_executor(),
+            std::move(input_element), &result->return_values, std::move(done),
+            model_node());
+      } else if (use_unbounded_threadpool_ &&
+                 work_stealing_runner_ == nullptr) {
         auto runner_fn = [this](std::function<void()> fn) {
           this->unbounded_thread_pool_->Schedule(fn);
         };
@@ -596,8 +607,9 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
             std::move(done), model_node());
       } else {
         // In this case, the function will be executed using single-threaded
-        // executor. We schedule it using `ctx->runner()` to enable concurrent
-        // application of the function over different input elements.
+        // executor. We schedule it using `ctx->runner()` (or the work-stealing
+        // runner) to enable concurrent application of the function over
+        // different input elements.
         auto fn = std::bind(
             [this, ctx, result](std::vector<Tensor> input_element) {
               return instantiated_captured_func_->Run(
@@ -605,7 +617,10 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
                   model_node());
             },
             std::move(input_element));
-        (*ctx->runner())(
+        auto runner = work_stealing_runner_ != nullptr
+                          ? work_stealing_runner_->AsRunnerFunction()
+                          : *ctx->runner();
+        runner(
             [this, ctx, fn = std::move(fn), done = std::move(done)]() {
               absl::Status s;
               // Check whether we are already recording to prevent invalid
@@ -818,6 +833,10 @@ class ParallelMapDatasetOp::Dataset : public DatasetBase {
     std::unique_ptr<Thread> runner_thread_ TF_GUARDED_BY(*mu_);
     std::unique_ptr<Thread> stats_thread_ TF_GUARDED_BY(*mu_);
     std::unique_ptr<UnboundedThreadPool> unbounded_thread_pool_;
+    // Set when `kWorkStealingRunnerExperiment` is enabled, in which case the
+    // function invocations run on the process-wide work-stealing thread pool
+    // instead of `unbounded_thread_pool_` or `ctx->runner()`.
+    std::unique_ptr<WorkStealingRunner> work_stealing_runner_;
 
     // Method for deregistering the cancellation callback.
     std::function<void()> deregister_fn_;
@@ -34,6 +34,7 @@ limitations under the License.
 #include "absl/strings/str_join.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/name_utils.h"
+#include "tensorflow/core/data/numa_utils.h"
 #include "tensorflow/core/data/stats_utils.h"
 #include "tensorflow/core/framework/attr_value.pb.h"
 #include "tensorflow/core/framework/dataset.h"
@@ -47,6 +48,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
+#include "tensorflow/core/platform/numa.h"
 #include "tensorflow/core/platform/status.h"
 #include "tensorflow/core/platform/stringprintf.h"
 #include "tensorflow/core/profiler/lib/traceme.h"
@@ -174,6 +176,8 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
           cond_var_(std::make_shared<condition_variable>()),
           buffer_size_min_(params.dataset->buffer_size_min_),
           legacy_autotune_(params.dataset->legacy_autotune_),
+          numa_aware_(IsMultiNUMANode() &&
+                      GetExperiments().contains(kNumaAwarePrefetchExperiment)),
           // If `legacy_autotune_`, initialize the `buffer_size_` value to be 0
           // to avoid the created node to be collected as tunable nodes in the
           // autotuning optimization.
@@ -541,16 +545,30 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
       if (!prefetch_thread_) {
         std::shared_ptr<IteratorContext> new_ctx =
             std::make_shared<IteratorContext>(*ctx);
+        // The thread that starts the prefetch thread is usually the one that
+        // consumes the buffer.
+        const int numa_node =
+            numa_aware_ ? GetCurrentNUMANode() : port::kNUMANoAffinity;
         prefetch_thread_ = ctx->StartThread(
-            "tf_data_prefetch", [this, new_ctx]() { PrefetchThread(new_ctx); });
+            "tf_data_prefetch", [this, new_ctx, numa_node]() {
+              PrefetchThread(new_ctx, numa_node);
+            });
       }
       return absl::OkStatus();
     }
 
     // Prefetches elements of the input, storing results in an internal buffer.
+    // Unless `numa_node` is `port::kNUMANoAffinity`, the thread runs on
+    // `numa_node` and places the larger tensors of the buffered elements there.
     //
     // It owns the iterator context passed to it.
-    void PrefetchThread(const std::shared_ptr<IteratorContext>& ctx) {
+    void PrefetchThread(const std::shared_ptr<IteratorContext>& ctx,
+                        int numa_node) {
+      if (numa_node != port::kNUMANoAffinity) {
+        // Memory that the input iterator allocates on this thread is first
+        // touched here, and thus lands on the node of the consumer.
+        port::NUMASetThreadNodeAffinity(numa_node);
+      }
       RecordStart(ctx.get());
       auto cleanup = gtl::MakeCleanup([this, ctx] { RecordStop(ctx.get()); });
       // Keep track of where we are in an iteration "burst"
@@ -599,6 +617,17 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
               ctx.get(), &buffer_element.value, &end_of_sequence);
           buffer_element.checkpoint.Merge(ctx->checkpoint());
         }
+        if (numa_node != port::kNUMANoAffinity && buffer_element.status.ok()) {
+          // Tensors that were produced elsewhere, e.g. by the threads of a
+          // parallel map, are copied here rather than read remotely by the
+          // consumer.
+          const int64_t bytes_moved = MoveToNUMANode(
+              numa_node, kMinNUMAMoveBytes, &buffer_element.value);
+          if (bytes_moved > 0) {
+            VLOG(3) << "Moved " << bytes_moved << " bytes to NUMA node "
+                    << numa_node;
+          }
+        }
         if (buffer_element.status.ok() && end_of_sequence) {
           mutex_lock l(*mu_);
           prefetch_thread_finished_ = true;
@@ -683,6 +712,8 @@ class PrefetchDatasetOp::Dataset : public DatasetBase {
     bool cancelled_ TF_GUARDED_BY(*mu_) = false;
     bool prefetch_thread_finished_ TF_GUARDED_BY(*mu_) = false;
     const bool legacy_autotune_;
+    // Whether the prefetch thread runs on the NUMA node of the consumer.
+    const bool numa_aware_;
 
     std::atomic<int64_t> slack_us_;
 
@@ -20,11 +20,13 @@ limitations under the License.
 #include <limits>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <string>
 #include <tuple>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
@@ -32,10 +34,12 @@ limitations under the License.
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/serialization_utils.h"
 #include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/model.h"
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/kernels/data/random_seed_ops.h"
+#include "tensorflow/core/kernels/data/shuffle_spill_store.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/random/philox_random.h"
 #include "tensorflow/core/lib/random/random.h"
@@ -66,6 +70,11 @@ namespace data {
 
 const int64_t kLogIntervalMicros = 10 * 1000000;  // 10 seconds.
 const int64_t kMaxEpochsInBuffer = 3;
+const int64_t kSpillSegmentBytes = 64LL << 20;  // 64MB
+
+// Experiment that lets shuffle buffers keep the elements that do not fit in
+// the RAM budget in segment files on local disk.
+constexpr char kShuffleSpillExperiment[] = "shuffle_spill_to_disk";
 
 constexpr char kNumRandomSamples[] = "num_random_samples";
 constexpr char kDataProduced[] = "data_produced";
@@ -203,12 +212,24 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
       }
     }
 
+    ~Iterator() override {
+      mutex_lock l(mu_);
+      ReleaseSpillStateLocked();
+    }
+
     bool SymbolicCheckpointCompatible() const override { return true; }
 
     absl::Status Initialize(IteratorContext* ctx) override {
       mutex_lock l(mu_);
       seed_generator_->GenerateSeeds(&seed_, &seed2_);
       ResetRngs();
+      if (ctx->ram_budget_manager() != nullptr &&
+          GetExperiments().contains(kShuffleSpillExperiment)) {
+        TF_ASSIGN_OR_RETURN(
+            spill_store_,
+            ShuffleSpillStore::Create(ctx->env(), kSpillSegmentBytes));
+        ram_budget_manager_ = ctx->ram_budget_manager();
+      }
       // Initialize checkpoint_indices_ to the entire buffer.
       if (ctx->symbolic_checkpoint()) {
         for (int64_t i = 0; i < buffer_->size(); ++i) {
@@ -237,10 +258,8 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
       int64_t offset =
           Random() % (slices_.front()->end - slices_.front()->start);
       int64_t index = (slices_.front()->start + offset) % buffer_->size();
-      *out_tensors = std::move(buffer_->at(index));
-      this->RecordBufferDequeue(ctx, *out_tensors);
-      std::swap(buffer_->at(index),
-                buffer_->at(slices_.front()->start % buffer_->size()));
+      TF_RETURN_IF_ERROR(TakeFromShuffleBuffer(ctx, index, out_tensors));
+      SwapBufferSlots(index, slices_.front()->start % buffer_->size());
       checkpoint_indices_.insert(index);
       checkpoint_indices_.insert(slices_.front()->start % buffer_->size());
       slices_.front()->start++;
@@ -288,17 +307,31 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
       TF_RETURN_IF_ERROR(
           writer->WriteScalar(prefix(), kNumElements, num_elements_));
       const std::string key_prefix = absl::StrCat(prefix(), kColon, "buffer");
+      // Spilled elements are read back one at a time while writing them.
+      auto get_element = [this](int64_t index, std::vector<Tensor>* element)
+                             TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+                               return ReadFromShuffleBuffer(index, element);
+                             };
       if (ctx->symbolic_checkpoint()) {
         // When symbolic checkpointing is turned on, `writer`
         // already contains checkpoint of the shuffle buffer created by the
         // previous invocation of this instance and the indices that need to be
         // updated are stored in `checkpoint_indices`.
-        TF_RETURN_IF_ERROR(UpdateCheckpointElements(
-            writer, key_prefix, *buffer_, checkpoint_indices_));
+        if (spilled_.empty()) {
+          TF_RETURN_IF_ERROR(UpdateCheckpointElements(
+              writer, key_prefix, *buffer_, checkpoint_indices_));
+        } else {
+          TF_RETURN_IF_ERROR(
+              UpdateCheckpointElements(writer, key_prefix, buffer_->size(),
+                                       checkpoint_indices_, get_element));
+        }
         checkpoint_indices_.clear();
-      } else {
+      } else if (spilled_.empty()) {
         TF_RETURN_IF_ERROR(
             WriteElementsToCheckpoint(writer, key_prefix, *buffer_));
+      } else {
+        TF_RETURN_IF_ERROR(WriteElementsToCheckpoint(
+            writer, key_prefix, buffer_->size(), get_element));
       }
 
       TF_RETURN_IF_ERROR(
@@ -366,6 +399,7 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
         }
         slices_size = static_cast<size_t>(temp);
       }
+      ReleaseSpillStateLocked();
       buffer_ = std::make_unique<std::vector<std::vector<Tensor>>>();
       TF_RETURN_IF_ERROR(ReadElementsFromCheckpoint(
           ctx, reader, absl::StrCat(prefix(), kColon, "buffer"),
@@ -376,8 +410,9 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
           checkpoint_indices_.insert(i);
         }
       }
-      for (const auto& element : *buffer_) {
-        RecordBufferEnqueue(ctx, element);
+      for (size_t i = 0; i < buffer_->size(); ++i) {
+        std::vector<Tensor> element = std::move(buffer_->at(i));
+        TF_RETURN_IF_ERROR(StoreInShuffleBuffer(ctx, i, std::move(element)));
       }
       if (!IsShuffleAll()) {
         buffer_->resize(dataset()->buffer_size_);
@@ -478,7 +513,7 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
           slices_.back()->reached_end_of_sequence = true;
         }
         if (!end_of_input_sequence) {
-          AddToShuffleBuffer(ctx, std::move(input_element));
+          TF_RETURN_IF_ERROR(AddToShuffleBuffer(ctx, std::move(input_element)));
           continue;
         }
         input_impl_.reset();
@@ -535,25 +570,143 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
       return absl::OkStatus();
     }
 
-    void AddToShuffleBuffer(IteratorContext* ctx, std::vector<Tensor>&& element)
+    absl::Status AddToShuffleBuffer(IteratorContext* ctx,
+                                    std::vector<Tensor>&& element)
         TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
       data_produced_ = true;
       if (num_elements_ == 0) {
         VLOG(1) << "Starting to fill up shuffle buffer of size: "
                 << BufferSizeString();
       }
-      this->RecordBufferEnqueue(ctx, element);
+      size_t index;
       if (num_elements_ == buffer_->size()) {
         DCHECK(IsShuffleAll());
-        checkpoint_indices_.insert(buffer_->size());
-        buffer_->push_back(element);
+        index = buffer_->size();
+        buffer_->emplace_back();
       } else {
-        size_t index = slices_.back()->end % buffer_->size();
-        checkpoint_indices_.insert(index);
-        buffer_->at(index) = std::move(element);
+        index = slices_.back()->end % buffer_->size();
       }
+      checkpoint_indices_.insert(index);
+      TF_RETURN_IF_ERROR(StoreInShuffleBuffer(ctx, index, std::move(element)));
       num_elements_++;
       slices_.back()->end++;
+      return absl::OkStatus();
+    }
+
+    // Stores `element` at `index` of `buffer_`, or spills it to disk if the
+    // shuffle buffer can spill and the element does not fit in the RAM
+    // budget.
+    absl::Status StoreInShuffleBuffer(IteratorContext* ctx, int64_t index,
+                                      std::vector<Tensor>&& element)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (ram_budget_manager_ != nullptr && !element.empty()) {
+        const int64_t bytes = GetAllocatedBytes(element);
+        if (!ram_budget_manager_->RequestSpillableBytes(bytes)) {
+          TF_ASSIGN_OR_RETURN(spilled_[index], spill_store_->Spill(element));
+          buffer_->at(index).clear();
+          return absl::OkStatus();
+        }
+        in_memory_bytes_ += bytes;
+      }
+      this->RecordBufferEnqueue(ctx, element);
+      buffer_->at(index) = std::move(element);
+      return ShrinkMemoryTier(ctx);
+    }
+
+    // Moves the element at `index` of `buffer_` to `out_tensors`, reading it
+    // back from disk if it was spilled.
+    absl::Status TakeFromShuffleBuffer(IteratorContext* ctx, int64_t index,
+                                       std::vector<Tensor>* out_tensors)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      auto it = spilled_.find(index);
+      if (it != spilled_.end()) {
+        TF_RETURN_IF_ERROR(spill_store_->Read(it->second, out_tensors));
+        spill_store_->Release(it->second);
+        spilled_.erase(it);
+        return absl::OkStatus();
+      }
+      *out_tensors = std::move(buffer_->at(index));
+      buffer_->at(index).clear();
+      this->RecordBufferDequeue(ctx, *out_tensors);
+      if (ram_budget_manager_ != nullptr && !out_tensors->empty()) {
+        const int64_t bytes = GetAllocatedBytes(*out_tensors);
+        ram_budget_manager_->RequestSpillableBytes(-bytes);
+        in_memory_bytes_ -= bytes;
+      }
+      return absl::OkStatus();
+    }
+
+    // Copies the element at `index` of `buffer_` to `element`, reading it
+    // back from disk if it was spilled.
+    absl::Status ReadFromShuffleBuffer(int64_t index,
+                                       std::vector<Tensor>* element)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      auto it = spilled_.find(index);
+      if (it != spilled_.end()) {
+        return spill_store_->Read(it->second, element);
+      }
+      *element = buffer_->at(index);
+      return absl::OkStatus();
+    }
+
+    void SwapBufferSlots(int64_t i, int64_t j)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      std::swap(buffer_->at(i), buffer_->at(j));
+      if (spilled_.empty() || i == j) {
+        return;
+      }
+      std::optional<ShuffleSpillStore::Handle> handle_i;
+      std::optional<ShuffleSpillStore::Handle> handle_j;
+      if (auto it = spilled_.find(i); it != spilled_.end()) {
+        handle_i = it->second;
+        spilled_.erase(it);
+      }
+      if (auto it = spilled_.find(j); it != spilled_.end()) {
+        handle_j = it->second;
+        spilled_.erase(it);
+      }
+      if (handle_i.has_value()) spilled_[j] = *handle_i;
+      if (handle_j.has_value()) spilled_[i] = *handle_j;
+    }
+
+    // Spills in-memory elements while the RAM budget manager reports that the
+    // in-memory part of the buffer exceeds its share of the budget, e.g.
+    // because the autotuner gave the RAM to other transformations. Which
+    // elements are spilled does not affect the order of the output.
+    absl::Status ShrinkMemoryTier(IteratorContext* ctx)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      if (ram_budget_manager_ == nullptr) {
+        return absl::OkStatus();
+      }
+      int64_t excess_bytes = ram_budget_manager_->SpillableBytesOverBudget();
+      for (int64_t n = 0; excess_bytes > 0 && n < buffer_->size(); ++n) {
+        const int64_t index = spill_cursor_++ % buffer_->size();
+        std::vector<Tensor>& element = buffer_->at(index);
+        if (element.empty()) {
+          continue;
+        }
+        TF_ASSIGN_OR_RETURN(spilled_[index], spill_store_->Spill(element));
+        this->RecordBufferDequeue(ctx, element);
+        const int64_t bytes = GetAllocatedBytes(element);
+        ram_budget_manager_->RequestSpillableBytes(-bytes);
+        in_memory_bytes_ -= bytes;
+        excess_bytes -= bytes;
+        element.clear();
+      }
+      return absl::OkStatus();
+    }
+
+    // Drops all spilled elements and returns the RAM budget held by the
+    // in-memory ones.
+    void ReleaseSpillStateLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      for (const auto& [index, handle] : spilled_) {
+        spill_store_->Release(handle);
+      }
+      spilled_.clear();
+      if (ram_budget_manager_ != nullptr) {
+        ram_budget_manager_->RequestSpillableBytes(-in_memory_bytes_);
+      }
+      in_memory_bytes_ = 0;
     }
 
     void ClearEmptySlices() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
@@ -594,6 +747,22 @@ class ShuffleDatasetOpBase::ShuffleDatasetBase : public DatasetBase {
         TF_GUARDED_BY(mu_);
     int64_t num_random_samples_ TF_GUARDED_BY(mu_) = 0;
     bool data_produced_ TF_GUARDED_BY(mu_) = false;
+
+    // Only set when the shuffle buffer can spill to disk. The bytes of the
+    // in-memory elements are then requested from `ram_budget_manager_` as
+    // spillable bytes, and elements that do not fit are kept in
+    // `spill_store_`.
+    std::shared_ptr<model::RamBudgetManager> ram_budget_manager_
+        TF_GUARDED_BY(mu_);
+    std::unique_ptr<ShuffleSpillStore> spill_store_ TF_GUARDED_BY(mu_);
+    // Maps the indices of `buffer_` whose elements are on disk to their
+    // handles in `spill_store_`. The slots themselves are empty.
+    absl::flat_hash_map<int64_t, ShuffleSpillStore::Handle> spilled_
+        TF_GUARDED_BY(mu_);
+    // Bytes of the in-memory elements granted by `ram_budget_manager_`.
+    int64_t in_memory_bytes_ TF_GUARDED_BY(mu_) = 0;
+    // Where `ShrinkMemoryTier()` resumes looking for elements to spill.
+    int64_t spill_cursor_ TF_GUARDED_BY(mu_) = 0;
   };
 
   const DatasetBase* const input_;
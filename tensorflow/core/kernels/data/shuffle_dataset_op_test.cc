@@ -11,12 +11,16 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/shuffle_dataset_op.h"
 
+#include <cstdlib>
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "tensorflow/core/data/dataset_test_base.h"
 #include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/serialization_utils.h"
+#include "tensorflow/core/framework/model.h"
 
 namespace tensorflow {
 namespace data {
@@ -595,6 +599,91 @@ TEST_F(ShuffleDatasetOpTest, InvalidArguments) {
   }
 }
 
+class ShuffleDatasetOpSpillTest : public ShuffleDatasetOpTest {
+ protected:
+  void SetUp() override {
+    setenv("TF_JOB_NAME", "test_job", /*overwrite=*/1);
+    setenv("TF_TASK_ID", "0", /*overwrite=*/1);
+    setenv("TF_DATA_EXPERIMENT_OPT_IN", "shuffle_spill_to_disk",
+           /*overwrite=*/1);
+  }
+
+  void TearDown() override {
+    unsetenv("TF_JOB_NAME");
+    unsetenv("TF_TASK_ID");
+    unsetenv("TF_DATA_EXPERIMENT_OPT_IN");
+  }
+
+  // Appends the next `num_elements` elements of `iterator` to `out_tensors`,
+  // or all of the remaining elements if `num_elements` is negative.
+  void GetNext(IteratorContext* ctx, IteratorBase* iterator, int num_elements,
+               std::vector<Tensor>* out_tensors) {
+    bool end_of_sequence = false;
+    for (int i = 0; i != num_elements && !end_of_sequence; ++i) {
+      std::vector<Tensor> next;
+      TF_ASSERT_OK(iterator->GetNext(ctx, &next, &end_of_sequence));
+      out_tensors->insert(out_tensors->end(), next.begin(), next.end());
+    }
+  }
+};
+
+TEST_F(ShuffleDatasetOpSpillTest, SpilledBufferMatchesInMemoryBuffer) {
+  ShuffleDatasetParams dataset_params(
+      RangeDatasetParams(0, 20, 1),
+      /*buffer_size=*/10,
+      /*seed=*/1,
+      /*seed2=*/2,
+      /*count=*/1,
+      /*reshuffle_each_iteration=*/false,
+      /*output_dtypes=*/{DT_INT64},
+      /*output_shapes=*/{PartialTensorShape({})},
+      /*node_name=*/kShuffleNodeName);
+  TF_ASSERT_OK(Initialize(dataset_params));
+  // The default iterator context has an unlimited RAM budget, so nothing is
+  // spilled.
+  std::vector<Tensor> expected;
+  GetNext(iterator_ctx_.get(), iterator_.get(), /*num_elements=*/-1,
+          &expected);
+  ASSERT_EQ(expected.size(), 20);
+
+  // A budget of two elements spills the other eight buffered elements.
+  const int64_t element_bytes =
+      GetAllocatedBytes({Tensor(DT_INT64, TensorShape({}))});
+  auto ram_budget_manager =
+      std::make_shared<model::RamBudgetManager>(2 * element_bytes);
+  IteratorContext::Params params(iterator_ctx_.get());
+  params.ram_budget_manager = ram_budget_manager;
+  IteratorContext spill_ctx(std::move(params));
+  std::unique_ptr<IteratorBase> iterator;
+  TF_ASSERT_OK(dataset_->MakeIterator(&spill_ctx, /*parent=*/nullptr,
+                                      dataset_params.iterator_prefix(),
+                                      &iterator));
+  std::vector<Tensor> out_tensors;
+  GetNext(&spill_ctx, iterator.get(), /*num_elements=*/5, &out_tensors);
+  EXPECT_FALSE(ram_budget_manager->RequestSpillableBytes(element_bytes));
+
+  // Save and restore while most of the buffer is on disk.
+  std::unique_ptr<SerializationContext> serialization_ctx;
+  TF_ASSERT_OK(CreateSerializationContext(&serialization_ctx));
+  VariantTensorDataWriter writer;
+  TF_ASSERT_OK(iterator->Save(serialization_ctx.get(), &writer));
+  std::vector<const VariantTensorData*> data;
+  writer.GetData(&data);
+  VariantTensorDataReader reader(data);
+  // Destroying the iterator returns its RAM budget, so the restored iterator
+  // keeps the same two elements in memory and spills the rest.
+  iterator.reset();
+  EXPECT_TRUE(ram_budget_manager->RequestSpillableBytes(2 * element_bytes));
+  ram_budget_manager->RequestSpillableBytes(-2 * element_bytes);
+  TF_ASSERT_OK(RestoreIterator(&spill_ctx, &reader,
+                               dataset_params.iterator_prefix(), *dataset_,
+                               &iterator));
+  EXPECT_FALSE(ram_budget_manager->RequestSpillableBytes(element_bytes));
+  GetNext(&spill_ctx, iterator.get(), /*num_elements=*/-1, &out_tensors);
+
+  TF_EXPECT_OK(ExpectEqual(out_tensors, expected, /*compare_order=*/true));
+}
+
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
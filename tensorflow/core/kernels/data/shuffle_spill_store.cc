@@ -0,0 +1,175 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/shuffle_spill_store.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/log.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/data/compression_utils.h"
+#include "tensorflow/core/framework/dataset.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/platform/errors.h"
+#include "tensorflow/core/platform/tstring.h"
+
+namespace tensorflow {
+namespace data {
+
+absl::StatusOr<std::unique_ptr<ShuffleSpillStore>> ShuffleSpillStore::Create(
+    Env* env, int64_t segment_bytes) {
+  std::string filename_prefix;
+  if (!env->LocalTempFilename(&filename_prefix)) {
+    return absl::UnavailableError(
+        "Failed to create a local temporary file name for spilling the "
+        "shuffle buffer.");
+  }
+  return absl::WrapUnique(
+      new ShuffleSpillStore(env, std::move(filename_prefix), segment_bytes));
+}
+
+ShuffleSpillStore::ShuffleSpillStore(Env* env, std::string filename_prefix,
+                                     int64_t segment_bytes)
+    : env_(env),
+      filename_prefix_(std::move(filename_prefix)),
+      segment_bytes_(segment_bytes) {}
+
+ShuffleSpillStore::~ShuffleSpillStore() {
+  active_writer_.reset();
+  active_file_.reset();
+  for (auto& [id, segment] : segments_) {
+    segment.reader.reset();
+    segment.file.reset();
+    absl::Status s = env_->DeleteFile(segment.filename);
+    if (!s.ok()) {
+      LOG(WARNING) << "Failed to delete shuffle spill segment "
+                   << segment.filename << ": " << s;
+    }
+  }
+}
+
+absl::StatusOr<ShuffleSpillStore::Handle> ShuffleSpillStore::Spill(
+    const std::vector<Tensor>& element) {
+  CompressedElement compressed;
+  TF_RETURN_IF_ERROR(CompressElement(element, &compressed));
+  if (active_segment_ < 0) {
+    TF_RETURN_IF_ERROR(OpenActiveSegment());
+  }
+  int64_t offset;
+  TF_RETURN_IF_ERROR(active_file_->Tell(&offset));
+  TF_RETURN_IF_ERROR(
+      active_writer_->WriteRecord(compressed.SerializeAsString()));
+  active_segment_dirty_ = true;
+
+  Handle handle{active_segment_, static_cast<uint64_t>(offset)};
+  ++segments_[active_segment_].num_elements;
+  ++num_elements_;
+  int64_t segment_size;
+  TF_RETURN_IF_ERROR(active_file_->Tell(&segment_size));
+  if (segment_size >= segment_bytes_) {
+    TF_RETURN_IF_ERROR(SealActiveSegment());
+  }
+  return handle;
+}
+
+absl::Status ShuffleSpillStore::Read(const Handle& handle,
+                                     std::vector<Tensor>* element) {
+  auto it = segments_.find(handle.segment);
+  if (it == segments_.end()) {
+    return absl::InternalError(absl::StrCat(
+        "Shuffle spill segment ", handle.segment, " does not exist."));
+  }
+  Segment& segment = it->second;
+  if (handle.segment == active_segment_ && active_segment_dirty_) {
+    TF_RETURN_IF_ERROR(active_writer_->Flush());
+    active_segment_dirty_ = false;
+  }
+  if (segment.reader == nullptr) {
+    TF_RETURN_IF_ERROR(
+        env_->NewRandomAccessFile(segment.filename, &segment.file));
+    segment.reader = std::make_unique<io::RecordReader>(segment.file.get());
+  }
+  uint64_t offset = handle.offset;
+  tstring record;
+  TF_RETURN_IF_ERROR(segment.reader->ReadRecord(&offset, &record));
+  CompressedElement compressed;
+  if (!compressed.ParseFromString(record)) {
+    return absl::DataLossError(
+        absl::StrCat("Failed to parse element at offset ", handle.offset,
+                     " of shuffle spill segment ", segment.filename));
+  }
+  element->clear();
+  return UncompressElement(compressed, element);
+}
+
+void ShuffleSpillStore::Release(const Handle& handle) {
+  auto it = segments_.find(handle.segment);
+  if (it == segments_.end()) {
+    return;
+  }
+  --it->second.num_elements;
+  --num_elements_;
+  MaybeDeleteSegment(handle.segment);
+}
+
+absl::Status ShuffleSpillStore::OpenActiveSegment() {
+  const int64_t id = next_segment_++;
+  Segment& segment = segments_[id];
+  segment.filename = absl::StrCat(filename_prefix_, "_shuffle_spill_", id);
+  TF_RETURN_IF_ERROR(env_->NewWritableFile(segment.filename, &active_file_));
+  active_writer_ = std::make_unique<io::RecordWriter>(active_file_.get());
+  active_segment_ = id;
+  active_segment_dirty_ = false;
+  return absl::OkStatus();
+}
+
+absl::Status ShuffleSpillStore::SealActiveSegment() {
+  const int64_t id = active_segment_;
+  TF_RETURN_IF_ERROR(active_writer_->Close());
+  TF_RETURN_IF_ERROR(active_file_->Close());
+  active_writer_.reset();
+  active_file_.reset();
+  active_segment_ = -1;
+  active_segment_dirty_ = false;
+  MaybeDeleteSegment(id);
+  return absl::OkStatus();
+}
+
+void ShuffleSpillStore::MaybeDeleteSegment(int64_t id) {
+  if (id == active_segment_) {
+    return;
+  }
+  auto it = segments_.find(id);
+  if (it == segments_.end() || it->second.num_elements > 0) {
+    return;
+  }
+  it->second.reader.reset();
+  it->second.file.reset();
+  absl::Status s = env_->DeleteFile(it->second.filename);
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to delete shuffle spill segment "
+                 << it->second.filename << ": " << s;
+  }
+  segments_.erase(it);
+}
+
+}  // namespace data
+}  // namespace tensorflow
@@ -0,0 +1,114 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_DATA_SHUFFLE_SPILL_STORE_H_
+#define TENSORFLOW_CORE_KERNELS_DATA_SHUFFLE_SPILL_STORE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/lib/io/record_writer.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/file_system.h"
+
+namespace tensorflow {
+namespace data {
+
+// ShuffleSpillStore keeps dataset elements in segment files on local disk, so
+// that a shuffle buffer only needs to hold part of its elements in RAM.
+//
+// Elements are appended to the active segment, which is sealed once it grows
+// past `segment_bytes`. A segment file is deleted as soon as it is sealed and
+// all of its elements have been released, so disk usage stays proportional to
+// the number of spilled elements that are still buffered.
+//
+// Not thread-safe.
+class ShuffleSpillStore {
+ public:
+  // Identifies a spilled element.
+  struct Handle {
+    int64_t segment = -1;
+    uint64_t offset = 0;
+  };
+
+  // Creates a store whose segment files live in a local temporary directory.
+  static absl::StatusOr<std::unique_ptr<ShuffleSpillStore>> Create(
+      Env* env, int64_t segment_bytes);
+
+  // Deletes all segment files.
+  ~ShuffleSpillStore();
+
+  // Writes `element` to the active segment.
+  absl::StatusOr<Handle> Spill(const std::vector<Tensor>& element);
+
+  // Reads back the element identified by `handle`. The element stays in the
+  // store until it is released.
+  absl::Status Read(const Handle& handle, std::vector<Tensor>* element);
+
+  // Releases the element identified by `handle`.
+  void Release(const Handle& handle);
+
+  // The number of elements that have been spilled and not released.
+  int64_t num_elements() const { return num_elements_; }
+
+ private:
+  struct Segment {
+    std::string filename;
+    // Number of elements in the segment that have not been released.
+    int64_t num_elements = 0;
+    // Opened on the first read. `reader` borrows `file`.
+    std::unique_ptr<RandomAccessFile> file;
+    std::unique_ptr<io::RecordReader> reader;
+  };
+
+  ShuffleSpillStore(Env* env, std::string filename_prefix,
+                    int64_t segment_bytes);
+
+  absl::Status OpenActiveSegment();
+  absl::Status SealActiveSegment();
+  void MaybeDeleteSegment(int64_t id);
+
+  Env* const env_;
+  const std::string filename_prefix_;
+  const int64_t segment_bytes_;
+
+  absl::flat_hash_map<int64_t, Segment> segments_;
+  int64_t next_segment_ = 0;
+
+  // The segment that new elements are appended to, or -1 if there is none.
+  // `active_writer_` borrows `active_file_`.
+  int64_t active_segment_ = -1;
+  std::unique_ptr<WritableFile> active_file_;
+  std::unique_ptr<io::RecordWriter> active_writer_;
+  // Whether the active segment has writes that readers cannot see yet.
+  bool active_segment_dirty_ = false;
+
+  int64_t num_elements_ = 0;
+
+  ShuffleSpillStore(const ShuffleSpillStore&) = delete;
+  void operator=(const ShuffleSpillStore&) = delete;
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_DATA_SHUFFLE_SPILL_STORE_H_
@@ -0,0 +1,115 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/shuffle_spill_store.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/statusor.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+std::vector<Tensor> MakeElement(int64_t value) {
+  return {test::AsTensor<int64_t>({value, value + 1}),
+          test::AsTensor<tstring>({"element"})};
+}
+
+void ExpectElement(const std::vector<Tensor>& element, int64_t value) {
+  const std::vector<Tensor> expected = MakeElement(value);
+  ASSERT_EQ(element.size(), expected.size());
+  for (size_t i = 0; i < element.size(); ++i) {
+    test::ExpectEqual(element[i], expected[i]);
+  }
+}
+
+TEST(ShuffleSpillStoreTest, SpillAndRead) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ShuffleSpillStore> store,
+                          ShuffleSpillStore::Create(Env::Default(),
+                                                    /*segment_bytes=*/1 << 20));
+  std::vector<ShuffleSpillStore::Handle> handles;
+  for (int64_t i = 0; i < 10; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(ShuffleSpillStore::Handle handle,
+                            store->Spill(MakeElement(i)));
+    handles.push_back(handle);
+  }
+  EXPECT_EQ(store->num_elements(), 10);
+
+  // Reads from the active segment see all preceding writes, in any order.
+  for (int64_t i : {7, 0, 9, 3}) {
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(store->Read(handles[i], &element));
+    ExpectElement(element, i);
+  }
+  for (const auto& handle : handles) {
+    store->Release(handle);
+  }
+  EXPECT_EQ(store->num_elements(), 0);
+}
+
+TEST(ShuffleSpillStoreTest, InterleavedSpillsAndReads) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ShuffleSpillStore> store,
+                          ShuffleSpillStore::Create(Env::Default(),
+                                                    /*segment_bytes=*/1 << 20));
+  for (int64_t i = 0; i < 5; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(ShuffleSpillStore::Handle handle,
+                            store->Spill(MakeElement(i)));
+    std::vector<Tensor> element;
+    TF_ASSERT_OK(store->Read(handle, &element));
+    ExpectElement(element, i);
+    store->Release(handle);
+  }
+  EXPECT_EQ(store->num_elements(), 0);
+}
+
+TEST(ShuffleSpillStoreTest, SegmentsAreDeletedOnceReleased) {
+  Env* env = Env::Default();
+  // Every element seals its segment.
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ShuffleSpillStore> store,
+                          ShuffleSpillStore::Create(env, /*segment_bytes=*/1));
+  std::vector<ShuffleSpillStore::Handle> handles;
+  for (int64_t i = 0; i < 4; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(ShuffleSpillStore::Handle handle,
+                            store->Spill(MakeElement(i)));
+    handles.push_back(handle);
+  }
+  for (int64_t i = 1; i < 4; ++i) {
+    EXPECT_NE(handles[i].segment, handles[i - 1].segment);
+  }
+
+  std::vector<Tensor> element;
+  TF_ASSERT_OK(store->Read(handles[2], &element));
+  ExpectElement(element, 2);
+  store->Release(handles[2]);
+  EXPECT_TRUE(absl::IsInternal(store->Read(handles[2], &element)));
+
+  // The remaining elements are unaffected.
+  for (int64_t i : {3, 0, 1}) {
+    TF_ASSERT_OK(store->Read(handles[i], &element));
+    ExpectElement(element, i);
+  }
+}
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
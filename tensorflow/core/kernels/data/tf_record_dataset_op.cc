@@ -15,7 +15,13 @@ limitations under the License.
 #include "tensorflow/core/kernels/data/tf_record_dataset_op.h"
 
 #include <cstdint>
+#include <memory>
+#include <utility>
 
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/data/dataset_utils.h"
 #include "tensorflow/core/data/name_utils.h"
 #include "tensorflow/core/data/utils.h"
 #include "tensorflow/core/framework/dataset.h"
@@ -23,13 +29,17 @@ limitations under the License.
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tf_data_file_logger_options.h"
+#include "tensorflow/core/lib/hash/crc32c.h"
 #include "tensorflow/core/lib/io/buffered_inputstream.h"
 #include "tensorflow/core/lib/io/inputbuffer.h"
 #include "tensorflow/core/lib/io/random_inputstream.h"
 #include "tensorflow/core/lib/io/record_reader.h"
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
 #include "tensorflow/core/lib/io/zlib_inputstream.h"
+#include "tensorflow/core/platform/coding.h"
+#include "tensorflow/core/platform/file_system.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/tstring.h"
 #include "tsl/profiler/lib/traceme.h"
 
 namespace tensorflow {
@@ -53,6 +63,9 @@ constexpr int64_t kUnspecifiedBufferSize = -1;
 constexpr int64_t kDefaultBufferSize = 256LL << 10;  // 256KB
 constexpr int64_t kCloudTpuBlockSize = 127LL << 20;  // 127MB.
 constexpr int64_t kS3BlockSize = kCloudTpuBlockSize;
+// Experiment that reads uncompressed files through a read-only memory mapping
+// instead of a `RandomAccessFile`.
+constexpr char kMmapExperiment[] = "tf_record_dataset_mmap";
 
 bool is_cloud_tpu_gcs_fs() {
 #if defined(LIBTPU_ON_GCE)
@@ -64,18 +77,107 @@ bool is_cloud_tpu_gcs_fs() {
 #endif
 }
 
+namespace {
+
+// Reads uncompressed TFRecords directly out of a read-only memory mapping of
+// the file. Records are returned as `tstring` views into the mapping that hold
+// a reference to it, so producing a record neither copies its bytes nor
+// allocates, and the mapping stays alive for as long as any record does.
+//
+// The file must not be truncated while it is mapped.
+class MappedRecordReader {
+ public:
+  explicit MappedRecordReader(std::unique_ptr<ReadOnlyMemoryRegion> region)
+      : region_(new RegionOwner(std::move(region))),
+        data_(static_cast<const char*>(region_->value()->data())),
+        size_(region_->value()->length()) {}
+
+  ~MappedRecordReader() { region_->Unref(); }
+
+  // Reads the next record into `*record`. Returns OUT_OF_RANGE at the end of
+  // the file and DATA_LOSS for truncated or corrupted records.
+  absl::Status ReadRecord(tstring* record) {
+    absl::string_view data;
+    TF_RETURN_IF_ERROR(ReadRecordView(/*verify_data=*/true, &data));
+    record->assign_as_shared_view(data, region_);
+    return absl::OkStatus();
+  }
+
+  // Skips `num_to_skip` records. Only the record headers are checksummed.
+  absl::Status SkipRecords(int num_to_skip, int* num_skipped) {
+    absl::string_view unused;
+    for (*num_skipped = 0; *num_skipped < num_to_skip; ++*num_skipped) {
+      TF_RETURN_IF_ERROR(ReadRecordView(/*verify_data=*/false, &unused));
+    }
+    return absl::OkStatus();
+  }
+
+  uint64_t TellOffset() const { return offset_; }
+
+  // Unlike `io::SequentialRecordReader`, seeking backwards is free.
+  absl::Status SeekOffset(uint64_t offset) {
+    offset_ = offset;
+    return absl::OkStatus();
+  }
+
+ private:
+  using RegionOwner = tstring::owner<std::unique_ptr<ReadOnlyMemoryRegion>>;
+
+  static constexpr uint64_t kHeaderSize = io::RecordReader::kHeaderSize;
+  static constexpr uint64_t kFooterSize = io::RecordReader::kFooterSize;
+
+  static bool ChecksumMatches(const char* data, size_t n) {
+    return crc32c::Unmask(core::DecodeFixed32(data + n)) ==
+           crc32c::Value(data, n);
+  }
+
+  absl::Status ReadRecordView(bool verify_data, absl::string_view* record) {
+    if (offset_ >= size_) {
+      return absl::OutOfRangeError(absl::StrCat("eof at ", offset_));
+    }
+    if (size_ - offset_ < kHeaderSize) {
+      return absl::DataLossError(absl::StrCat("truncated record at ", offset_));
+    }
+    const char* header = data_ + offset_;
+    if (!ChecksumMatches(header, sizeof(uint64_t))) {
+      return absl::DataLossError(absl::StrCat("corrupted record at ", offset_));
+    }
+    const uint64_t length = core::DecodeFixed64(header);
+    if (size_ - offset_ - kHeaderSize < kFooterSize ||
+        length > size_ - offset_ - kHeaderSize - kFooterSize) {
+      return absl::DataLossError(absl::StrCat("truncated record at ", offset_));
+    }
+    const char* data = header + kHeaderSize;
+    if (verify_data && !ChecksumMatches(data, length)) {
+      return absl::DataLossError(absl::StrCat("corrupted record at ", offset_));
+    }
+    *record = absl::string_view(data, length);
+    offset_ += kHeaderSize + length + kFooterSize;
+    return absl::OkStatus();
+  }
+
+  RegionOwner* const region_;
+  const char* const data_;
+  const uint64_t size_;
+  uint64_t offset_ = 0;
+};
+
+}  // namespace
+
 class TFRecordDatasetOp::Dataset : public DatasetBase {
  public:
   explicit Dataset(OpKernelContext* ctx, std::vector<std::string> filenames,
                    const std::string& compression_type, int64_t buffer_size,
-                   std::vector<int64_t> byte_offsets, int op_version)
+                   std::vector<int64_t> byte_offsets, int op_version,
+                   bool use_mmap)
       : DatasetBase(DatasetContext(ctx)),
         filenames_(std::move(filenames)),
         compression_type_(compression_type),
         options_(io::RecordReaderOptions::CreateRecordReaderOptions(
             compression_type)),
         byte_offsets_(std::move(byte_offsets)),
-        op_version_(op_version) {
+        op_version_(op_version),
+        use_mmap_(use_mmap) {
     if (buffer_size > 0) {
       options_.buffer_size = buffer_size;
     }
@@ -153,11 +255,11 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
       mutex_lock l(mu_);
       do {
         // We are currently processing a file, so try to read the next record.
-        if (reader_) {
+        if (HasReaderLocked()) {
           out_tensors->emplace_back(ctx->allocator({}), DT_STRING,
                                     TensorShape({}));
           absl::Status s =
-              reader_->ReadRecord(&out_tensors->back().scalar<tstring>()());
+              ReadRecordLocked(&out_tensors->back().scalar<tstring>()());
           if (s.ok()) {
             static monitoring::CounterCell* bytes_counter =
                 metrics::GetTFDataBytesReadCounter(kDatasetType);
@@ -200,10 +302,10 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
       do {
         // We are currently processing a file, so try to skip reading
         // the next (num_to_skip - *num_skipped) record.
-        if (reader_) {
+        if (HasReaderLocked()) {
           int last_num_skipped;
-          absl::Status s = reader_->SkipRecords(num_to_skip - *num_skipped,
-                                                &last_num_skipped);
+          absl::Status s = SkipRecordsLocked(num_to_skip - *num_skipped,
+                                             &last_num_skipped);
           *num_skipped += last_num_skipped;
           if (s.ok()) {
             *end_of_sequence = false;
@@ -246,9 +348,9 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
       TF_RETURN_IF_ERROR(writer->WriteScalar(prefix(), kCurrentFileIndex,
                                              current_file_index_));
 
-      if (reader_) {
+      if (HasReaderLocked()) {
         TF_RETURN_IF_ERROR(
-            writer->WriteScalar(prefix(), kOffset, reader_->TellOffset()));
+            writer->WriteScalar(prefix(), kOffset, TellOffsetLocked()));
       }
       return absl::OkStatus();
     }
@@ -265,7 +367,7 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
         int64_t offset;
         TF_RETURN_IF_ERROR(reader->ReadScalar(prefix(), kOffset, &offset));
         TF_RETURN_IF_ERROR(SetupStreamsLocked(ctx->env()));
-        TF_RETURN_IF_ERROR(reader_->SeekOffset(offset));
+        TF_RETURN_IF_ERROR(SeekOffsetLocked(offset));
       }
       return absl::OkStatus();
     }
@@ -288,24 +390,67 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
           },
           tsl::profiler::kInfo);
 
-      TF_RETURN_IF_ERROR(env->NewRandomAccessFile(
-          TranslateFileName(dataset()->filenames_[current_file_index_]),
-          &file_));
-      reader_ = std::make_unique<io::SequentialRecordReader>(
-          file_.get(), dataset()->options_);
+      const std::string filename =
+          TranslateFileName(dataset()->filenames_[current_file_index_]);
+      if (dataset()->use_mmap_) {
+        std::unique_ptr<ReadOnlyMemoryRegion> region;
+        absl::Status s = env->NewReadOnlyMemoryRegionFromFile(filename, &region);
+        if (s.ok()) {
+          mapped_reader_ =
+              std::make_unique<MappedRecordReader>(std::move(region));
+        } else {
+          // File systems without mmap support (e.g. remote ones) and empty
+          // files, which cannot be mapped, use the regular reader.
+          VLOG(2) << "Not memory mapping " << filename << ": " << s;
+        }
+      }
+      if (!mapped_reader_) {
+        TF_RETURN_IF_ERROR(env->NewRandomAccessFile(filename, &file_));
+        reader_ = std::make_unique<io::SequentialRecordReader>(
+            file_.get(), dataset()->options_);
+      }
       if (!dataset()->byte_offsets_.empty()) {
         TF_RETURN_IF_ERROR(
-            reader_->SeekOffset(dataset()->byte_offsets_[current_file_index_]));
+            SeekOffsetLocked(dataset()->byte_offsets_[current_file_index_]));
       }
       return absl::OkStatus();
     }
 
     // Resets all reader streams.
     void ResetStreamsLocked() TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      mapped_reader_.reset();
       reader_.reset();
       file_.reset();
     }
 
+    bool HasReaderLocked() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      return mapped_reader_ != nullptr || reader_ != nullptr;
+    }
+
+    absl::Status ReadRecordLocked(tstring* record)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      return mapped_reader_ ? mapped_reader_->ReadRecord(record)
+                            : reader_->ReadRecord(record);
+    }
+
+    absl::Status SkipRecordsLocked(int num_to_skip, int* num_skipped)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      return mapped_reader_
+                 ? mapped_reader_->SkipRecords(num_to_skip, num_skipped)
+                 : reader_->SkipRecords(num_to_skip, num_skipped);
+    }
+
+    uint64_t TellOffsetLocked() const TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      return mapped_reader_ ? mapped_reader_->TellOffset()
+                            : reader_->TellOffset();
+    }
+
+    absl::Status SeekOffsetLocked(uint64_t offset)
+        TF_EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+      return mapped_reader_ ? mapped_reader_->SeekOffset(offset)
+                            : reader_->SeekOffset(offset);
+    }
+
     mutex mu_;
     size_t current_file_index_ TF_GUARDED_BY(mu_) = 0;
 
@@ -313,6 +458,8 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
     // we must destroy `reader_` before `file_`.
     std::unique_ptr<RandomAccessFile> file_ TF_GUARDED_BY(mu_);
     std::unique_ptr<io::SequentialRecordReader> reader_ TF_GUARDED_BY(mu_);
+    // Set instead of `file_` and `reader_` when the file is memory mapped.
+    std::unique_ptr<MappedRecordReader> mapped_reader_ TF_GUARDED_BY(mu_);
   };
 
   const std::vector<std::string> filenames_;
@@ -320,6 +467,9 @@ class TFRecordDatasetOp::Dataset : public DatasetBase {
   io::RecordReaderOptions options_;
   const std::vector<int64_t> byte_offsets_;
   const int op_version_;
+  // Whether to read files through `MappedRecordReader` when the file system
+  // supports memory mapping them. Only set for uncompressed files.
+  const bool use_mmap_;
 };
 
 TFRecordDatasetOp::TFRecordDatasetOp(OpKernelConstruction* ctx)
@@ -401,8 +551,13 @@ void TFRecordDatasetOp::MakeDataset(OpKernelContext* ctx,
         << buffer_size;
   }
 
+  // Only uncompressed records can be handed out as views into the file.
+  const bool use_mmap = compression_type.empty() &&
+                        GetExperiments().contains(kMmapExperiment);
+
   *output = new Dataset(ctx, std::move(filenames), compression_type,
-                        buffer_size, std::move(byte_offsets), op_version_);
+                        buffer_size, std::move(byte_offsets), op_version_,
+                        use_mmap);
 }
 
 namespace {
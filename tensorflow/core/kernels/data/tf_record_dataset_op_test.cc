@@ -12,6 +12,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/data/tf_record_dataset_op.h"
 
 #include <cstdint>
+#include <cstdlib>
 #include <memory>
 #include <string>
 #include <utility>
@@ -379,6 +380,121 @@ IteratorSaveAndRestoreTestCases() {
 ITERATOR_SAVE_AND_RESTORE_TEST_P(TFRecordDatasetOpTest, TFRecordDatasetParams,
                                  IteratorSaveAndRestoreTestCases())
 
+// Runs the tests with the experiment that memory maps uncompressed files.
+class TFRecordDatasetOpMmapTest : public TFRecordDatasetOpTest {
+ protected:
+  void SetUp() override {
+    setenv("TF_JOB_NAME", "test_job", /*overwrite=*/1);
+    setenv("TF_TASK_ID", "0", /*overwrite=*/1);
+    setenv("TF_DATA_EXPERIMENT_OPT_IN", "tf_record_dataset_mmap",
+           /*overwrite=*/1);
+  }
+
+  void TearDown() override {
+    unsetenv("TF_JOB_NAME");
+    unsetenv("TF_TASK_ID");
+    unsetenv("TF_DATA_EXPERIMENT_OPT_IN");
+  }
+};
+
+TEST_F(TFRecordDatasetOpMmapTest, GetNext) {
+  auto dataset_params = TFRecordDatasetParams4();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  bool end_of_sequence = false;
+  std::vector<Tensor> out_tensors;
+  while (!end_of_sequence) {
+    TF_ASSERT_OK(iterator_->GetNext(iterator_ctx_.get(), &out_tensors,
+                                    &end_of_sequence));
+  }
+  ASSERT_EQ(out_tensors.size(), 6);
+  for (const Tensor& tensor : out_tensors) {
+    EXPECT_EQ(tensor.scalar<tstring>()().type(), tstring::VIEW);
+  }
+  // The records keep the mapping alive after the iterator is destroyed.
+  iterator_.reset();
+  TF_EXPECT_OK(ExpectEqual(
+      out_tensors,
+      CreateTensors<tstring>(TensorShape({}), {{"1"}, {"22"}, {"333"}, {"bb"},
+                                               {"ccc"}, {"zzz"}}),
+      /*compare_order=*/true));
+}
+
+TEST_F(TFRecordDatasetOpMmapTest, CompressedFilesAreNotMapped) {
+  auto dataset_params = TFRecordDatasetParams1();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  bool end_of_sequence = false;
+  std::vector<Tensor> out_tensors;
+  TF_ASSERT_OK(iterator_->GetNext(iterator_ctx_.get(), &out_tensors,
+                                  &end_of_sequence));
+  ASSERT_EQ(out_tensors.size(), 1);
+  EXPECT_NE(out_tensors[0].scalar<tstring>()().type(), tstring::VIEW);
+  EXPECT_EQ(out_tensors[0].scalar<tstring>()(), "1");
+}
+
+TEST_F(TFRecordDatasetOpMmapTest, Skip) {
+  auto dataset_params = TFRecordDatasetParams3();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  bool end_of_sequence = false;
+  int num_skipped = 0;
+  TF_ASSERT_OK(iterator_->Skip(iterator_ctx_.get(), /*num_to_skip=*/4,
+                               &end_of_sequence, &num_skipped));
+  EXPECT_EQ(num_skipped, 4);
+  std::vector<Tensor> out_tensors;
+  TF_ASSERT_OK(iterator_->GetNext(iterator_ctx_.get(), &out_tensors,
+                                  &end_of_sequence));
+  ASSERT_EQ(out_tensors.size(), 1);
+  EXPECT_EQ(out_tensors[0].scalar<tstring>()(), "bb");
+}
+
+TEST_F(TFRecordDatasetOpMmapTest, InvalidByteOffsetsToSeek) {
+  auto dataset_params = InvalidByteOffsets();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  bool end_of_sequence = false;
+  std::vector<Tensor> out_tensors;
+  EXPECT_EQ(
+      iterator_->GetNext(iterator_ctx_.get(), &out_tensors, &end_of_sequence)
+          .code(),
+      absl::StatusCode::kDataLoss);
+}
+
+TEST_F(TFRecordDatasetOpMmapTest, TruncatedFile) {
+  std::vector<tstring> filenames = {
+      absl::StrCat(testing::TmpDir(), "/tf_record_UNCOMPRESSED_truncated")};
+  TF_ASSERT_OK(CreateTestFiles(filenames, {{"1", "22", "333"}},
+                               CompressionType::UNCOMPRESSED));
+  std::string contents;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), filenames[0], &contents));
+  contents.resize(contents.size() - 1);
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), filenames[0], contents));
+
+  TFRecordDatasetParams dataset_params(filenames,
+                                       CompressionType::UNCOMPRESSED,
+                                       /*buffer_size=*/10,
+                                       /*byte_offsets=*/{},
+                                       /*node_name=*/kNodeName);
+  TF_ASSERT_OK(Initialize(dataset_params));
+  bool end_of_sequence = false;
+  std::vector<Tensor> out_tensors;
+  TF_ASSERT_OK(iterator_->GetNext(iterator_ctx_.get(), &out_tensors,
+                                  &end_of_sequence));
+  TF_ASSERT_OK(iterator_->GetNext(iterator_ctx_.get(), &out_tensors,
+                                  &end_of_sequence));
+  EXPECT_EQ(
+      iterator_->GetNext(iterator_ctx_.get(), &out_tensors, &end_of_sequence)
+          .code(),
+      absl::StatusCode::kDataLoss);
+}
+
+TEST_F(TFRecordDatasetOpMmapTest, IteratorSaveAndRestore) {
+  auto dataset_params = TFRecordDatasetParams3();
+  TF_ASSERT_OK(Initialize(dataset_params));
+  TF_ASSERT_OK(CheckIteratorSaveAndRestore(
+      dataset_params.iterator_prefix(),
+      CreateTensors<tstring>(TensorShape({}), {{"1"}, {"22"}, {"333"}, {"a"},
+                                               {"bb"}, {"ccc"}}),
+      /*breakpoints=*/{0, 2, 7}, /*compare_order=*/true));
+}
+
 }  // namespace
 }  // namespace data
 }  // namespace tensorflow
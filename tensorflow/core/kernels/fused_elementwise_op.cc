@@ -0,0 +1,403 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// See docs in ../ops/math_ops.cc.
+
+#define EIGEN_USE_THREADS
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "unsupported/Eigen/CXX11/Tensor"  // from @eigen_archive
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/broadcast_to_op.h"
+#include "tensorflow/core/kernels/cwise_ops.h"
+#include "tensorflow/core/util/bcast.h"
+
+namespace tensorflow {
+
+typedef Eigen::ThreadPoolDevice CPUDevice;
+
+namespace {
+
+enum class ElementwiseOp {
+  // Unary ops.
+  kAbs,
+  kExp,
+  kLog,
+  kNeg,
+  kReciprocal,
+  kRelu,
+  kRsqrt,
+  kSigmoid,
+  kSqrt,
+  kSquare,
+  kTanh,
+  // Binary ops.
+  kAdd,
+  kDiv,
+  kMaximum,
+  kMinimum,
+  kMul,
+  kSquaredDifference,
+  kSub,
+};
+
+struct ElementwiseOpInfo {
+  ElementwiseOp op;
+  bool is_binary;
+};
+
+const absl::flat_hash_map<std::string, ElementwiseOpInfo>& ElementwiseOps() {
+  static const auto* ops =
+      new absl::flat_hash_map<std::string, ElementwiseOpInfo>({
+          {"Abs", {ElementwiseOp::kAbs, false}},
+          {"Exp", {ElementwiseOp::kExp, false}},
+          {"Inv", {ElementwiseOp::kReciprocal, false}},
+          {"Log", {ElementwiseOp::kLog, false}},
+          {"Neg", {ElementwiseOp::kNeg, false}},
+          {"Reciprocal", {ElementwiseOp::kReciprocal, false}},
+          {"Relu", {ElementwiseOp::kRelu, false}},
+          {"Rsqrt", {ElementwiseOp::kRsqrt, false}},
+          {"Sigmoid", {ElementwiseOp::kSigmoid, false}},
+          {"Sqrt", {ElementwiseOp::kSqrt, false}},
+          {"Square", {ElementwiseOp::kSquare, false}},
+          {"Tanh", {ElementwiseOp::kTanh, false}},
+          {"Add", {ElementwiseOp::kAdd, true}},
+          {"AddV2", {ElementwiseOp::kAdd, true}},
+          {"Div", {ElementwiseOp::kDiv, true}},
+          {"Maximum", {ElementwiseOp::kMaximum, true}},
+          {"Minimum", {ElementwiseOp::kMinimum, true}},
+          {"Mul", {ElementwiseOp::kMul, true}},
+          {"RealDiv", {ElementwiseOp::kDiv, true}},
+          {"SquaredDifference", {ElementwiseOp::kSquaredDifference, true}},
+          {"Sub", {ElementwiseOp::kSub, true}},
+      });
+  return *ops;
+}
+
+}  // namespace
+
+// Evaluates the program of a _FusedElementwise node. The output is computed
+// in blocks of kBlockSize elements, and each op of the program runs over the
+// whole block before the next one, so intermediate values stay in cache and
+// are never materialized as tensors.
+template <typename T>
+class FusedElementwiseOp : public OpKernel {
+ public:
+  explicit FusedElementwiseOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    int num_args;
+    std::vector<std::string> op_names;
+    std::vector<int32_t> operands;
+    OP_REQUIRES_OK(context, context->GetAttr("num_args", &num_args));
+    OP_REQUIRES_OK(context, context->GetAttr("op_names", &op_names));
+    OP_REQUIRES_OK(context, context->GetAttr("operands", &operands));
+    OP_REQUIRES(context, !op_names.empty(),
+                absl::InvalidArgumentError(
+                    "Fused elementwise op must have at least one op"));
+    OP_REQUIRES(context, operands.size() == 2 * op_names.size(),
+                absl::InvalidArgumentError(absl::StrCat(
+                    "Expected ", 2 * op_names.size(), " operands, got ",
+                    operands.size())));
+
+    num_args_ = num_args;
+    int cost = 0;
+    for (int i = 0; i < op_names.size(); ++i) {
+      auto it = ElementwiseOps().find(op_names[i]);
+      OP_REQUIRES(context, it != ElementwiseOps().end(),
+                  absl::InvalidArgumentError(absl::StrCat(
+                      "Unsupported fused elementwise op: ", op_names[i])));
+      Instruction instruction;
+      instruction.op = it->second.op;
+      instruction.x = operands[2 * i];
+      instruction.y = operands[2 * i + 1];
+      // An op may only use the inputs and the values of earlier ops.
+      const int num_values = num_args_ + i;
+      OP_REQUIRES(
+          context,
+          instruction.x >= 0 && instruction.x < num_values &&
+              (it->second.is_binary
+                   ? instruction.y >= 0 && instruction.y < num_values
+                   : instruction.y == -1),
+          absl::InvalidArgumentError(absl::StrCat(
+              "Invalid operands for op ", i, " (", op_names[i], "): ",
+              instruction.x, ", ", instruction.y)));
+      cost += Cost(instruction.op);
+      program_.push_back(instruction);
+    }
+    cost_ = cost;
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    OpInputList args;
+    OP_REQUIRES_OK(ctx, ctx->input_list("args", &args));
+    OP_REQUIRES(ctx, args.size() == num_args_,
+                absl::InvalidArgumentError(absl::StrCat(
+                    "Expected ", num_args_, " inputs, got ", args.size())));
+
+    // The fused ops are elementwise, so broadcasting every input to the
+    // broadcast shape of all inputs gives the same result as broadcasting at
+    // each op.
+    TensorShape shape = args[0].shape();
+    for (int i = 1; i < num_args_; ++i) {
+      if (args[i].shape() == shape) continue;
+      BCast bcast(BCast::FromShape(shape), BCast::FromShape(args[i].shape()));
+      OP_REQUIRES(ctx, bcast.IsValid(),
+                  absl::InvalidArgumentError(absl::StrCat(
+                      "Incompatible shapes: ", shape.DebugString(), " vs. ",
+                      args[i].shape().DebugString())));
+      shape = BCast::ToShape(bcast.output_shape());
+    }
+
+    absl::InlinedVector<int, 4> forwardable_inputs;
+    for (int i = 0; i < num_args_; ++i) {
+      if (args[i].shape() == shape) forwardable_inputs.push_back(i);
+    }
+    Tensor* out = nullptr;
+    OP_REQUIRES_OK(ctx, ctx->forward_input_or_allocate_output(
+                            forwardable_inputs, 0, shape, &out));
+    const int64_t num_elements = shape.num_elements();
+    if (num_elements == 0) return;
+
+    // Inputs of the full shape are read in place, and single elements are
+    // splatted into a block in each shard. Other inputs are broadcast to the
+    // full shape up front.
+    std::vector<const T*> arg_data(num_args_);
+    std::vector<bool> arg_is_scalar(num_args_, false);
+    std::vector<Tensor> broadcast_args;
+    broadcast_args.reserve(num_args_);
+    for (int i = 0; i < num_args_; ++i) {
+      const Tensor& arg = args[i];
+      if (arg.shape() == shape) {
+        arg_data[i] = arg.flat<T>().data();
+      } else if (arg.NumElements() == 1) {
+        arg_data[i] = arg.flat<T>().data();
+        arg_is_scalar[i] = true;
+      } else {
+        broadcast_args.emplace_back();
+        Tensor& broadcast = broadcast_args.back();
+        OP_REQUIRES_OK(ctx, ctx->allocate_temp(DataTypeToEnum<T>::value,
+                                               shape, &broadcast));
+        BCast bcast(BCast::FromShape(arg.shape()), BCast::FromShape(shape),
+                    /*fewer_dims_optimization=*/true);
+        functor::BroadcastTo<CPUDevice, T>()(ctx->eigen_device<CPUDevice>(),
+                                             ctx, broadcast, shape, arg,
+                                             arg.shape(), bcast);
+        if (!ctx->status().ok()) return;
+        arg_data[i] = broadcast.flat<T>().data();
+      }
+    }
+
+    T* out_data = out->flat<T>().data();
+    const int num_ops = program_.size();
+    auto compute_fn = [this, &arg_data, &arg_is_scalar, out_data, num_ops](
+                          int64_t begin, int64_t end) {
+      // One block per scalar input, and one per op except the last, which
+      // writes to the output.
+      const int num_scalars =
+          std::count(arg_is_scalar.begin(), arg_is_scalar.end(), true);
+      std::unique_ptr<T[]> scratch(
+          new T[(num_scalars + num_ops - 1) * kBlockSize]);
+      T* next_block = scratch.get();
+      absl::InlinedVector<const T*, 16> values(num_args_ + num_ops);
+      for (int i = 0; i < num_args_; ++i) {
+        if (arg_is_scalar[i]) {
+          std::fill(next_block, next_block + kBlockSize, *arg_data[i]);
+          values[i] = next_block;
+          next_block += kBlockSize;
+        }
+      }
+      T* const registers = next_block;
+
+      for (int64_t start = begin; start < end; start += kBlockSize) {
+        const int64_t len = std::min<int64_t>(kBlockSize, end - start);
+        for (int i = 0; i < num_args_; ++i) {
+          if (!arg_is_scalar[i]) values[i] = arg_data[i] + start;
+        }
+        for (int i = 0; i < num_ops; ++i) {
+          const Instruction& instruction = program_[i];
+          T* dst = i == num_ops - 1 ? out_data + start
+                                    : registers + i * kBlockSize;
+          Run(instruction.op, values[instruction.x],
+              instruction.y >= 0 ? values[instruction.y] : nullptr, dst, len);
+          values[num_args_ + i] = dst;
+        }
+      }
+    };
+
+    const CPUDevice& device = ctx->eigen_device<CPUDevice>();
+    Eigen::TensorOpCost cost(/*bytes_loaded=*/sizeof(T) * num_args_,
+                             /*bytes_stored=*/sizeof(T), cost_);
+    device.parallelFor(num_elements, cost, AlignBlockSize,
+                       std::move(compute_fn));
+  }
+
+ private:
+  struct Instruction {
+    ElementwiseOp op;
+    int x;
+    int y;
+  };
+
+  using ConstBlock = typename TTypes<T>::UnalignedConstFlat;
+  using Block = typename TTypes<T>::UnalignedFlat;
+
+  // Number of elements each op processes at a time.
+  static constexpr int64_t kBlockSize = 1024;
+
+  static int64_t AlignBlockSize(int64_t block_size) {
+    return (block_size + kBlockSize - 1) & ~(kBlockSize - 1);
+  }
+
+  template <typename Functor>
+  static int FunctorCost() {
+    return Eigen::internal::functor_traits<typename Functor::func>::Cost;
+  }
+
+  static int Cost(ElementwiseOp op) {
+    switch (op) {
+      case ElementwiseOp::kAbs:
+        return FunctorCost<functor::abs<T>>();
+      case ElementwiseOp::kExp:
+        return FunctorCost<functor::exp<T>>();
+      case ElementwiseOp::kLog:
+        return FunctorCost<functor::log<T>>();
+      case ElementwiseOp::kNeg:
+        return FunctorCost<functor::neg<T>>();
+      case ElementwiseOp::kReciprocal:
+        return FunctorCost<functor::inverse<T>>();
+      case ElementwiseOp::kRelu:
+        return Eigen::internal::functor_traits<
+            Eigen::internal::scalar_max_op<T>>::Cost;
+      case ElementwiseOp::kRsqrt:
+        return FunctorCost<functor::rsqrt<T>>();
+      case ElementwiseOp::kSigmoid:
+        return FunctorCost<functor::sigmoid<T>>();
+      case ElementwiseOp::kSqrt:
+        return FunctorCost<functor::sqrt<T>>();
+      case ElementwiseOp::kSquare:
+        return FunctorCost<functor::square<T>>();
+      case ElementwiseOp::kTanh:
+        return FunctorCost<functor::tanh<T>>();
+      case ElementwiseOp::kAdd:
+        return FunctorCost<functor::add<T>>();
+      case ElementwiseOp::kDiv:
+        return FunctorCost<functor::div<T>>();
+      case ElementwiseOp::kMaximum:
+        return FunctorCost<functor::maximum<T>>();
+      case ElementwiseOp::kMinimum:
+        return FunctorCost<functor::minimum<T>>();
+      case ElementwiseOp::kMul:
+        return FunctorCost<functor::mul<T>>();
+      case ElementwiseOp::kSquaredDifference:
+        return FunctorCost<functor::squared_difference<T>>();
+      case ElementwiseOp::kSub:
+        return FunctorCost<functor::sub<T>>();
+    }
+    return 1;
+  }
+
+  // Uses the same functors as the unfused kernels, so that the results are
+  // the same.
+  static void Run(ElementwiseOp op, const T* x_data, const T* y_data, T* dst,
+                  int64_t len) {
+    ConstBlock x(x_data, len);
+    ConstBlock y(y_data, y_data == nullptr ? 0 : len);
+    Block out(dst, len);
+    switch (op) {
+      case ElementwiseOp::kAbs:
+        out = x.unaryExpr(typename functor::abs<T>::func());
+        break;
+      case ElementwiseOp::kExp:
+        out = x.unaryExpr(typename functor::exp<T>::func());
+        break;
+      case ElementwiseOp::kLog:
+        out = x.unaryExpr(typename functor::log<T>::func());
+        break;
+      case ElementwiseOp::kNeg:
+        out = x.unaryExpr(typename functor::neg<T>::func());
+        break;
+      case ElementwiseOp::kReciprocal:
+        out = x.unaryExpr(typename functor::inverse<T>::func());
+        break;
+      case ElementwiseOp::kRelu:
+        out = x.template cwiseMax<Eigen::PropagateNaN>(static_cast<T>(0));
+        break;
+      case ElementwiseOp::kRsqrt:
+        out = x.unaryExpr(typename functor::rsqrt<T>::func());
+        break;
+      case ElementwiseOp::kSigmoid:
+        out = x.unaryExpr(typename functor::sigmoid<T>::func());
+        break;
+      case ElementwiseOp::kSqrt:
+        out = x.unaryExpr(typename functor::sqrt<T>::func());
+        break;
+      case ElementwiseOp::kSquare:
+        out = x.unaryExpr(typename functor::square<T>::func());
+        break;
+      case ElementwiseOp::kTanh:
+        out = x.unaryExpr(typename functor::tanh<T>::func());
+        break;
+      case ElementwiseOp::kAdd:
+        out = x.binaryExpr(y, typename functor::add<T>::func());
+        break;
+      case ElementwiseOp::kDiv:
+        out = x.binaryExpr(y, typename functor::div<T>::func());
+        break;
+      case ElementwiseOp::kMaximum:
+        out = x.binaryExpr(y, typename functor::maximum<T>::func());
+        break;
+      case ElementwiseOp::kMinimum:
+        out = x.binaryExpr(y, typename functor::minimum<T>::func());
+        break;
+      case ElementwiseOp::kMul:
+        out = x.binaryExpr(y, typename functor::mul<T>::func());
+        break;
+      case ElementwiseOp::kSquaredDifference:
+        out = x.binaryExpr(y, typename functor::squared_difference<T>::func());
+        break;
+      case ElementwiseOp::kSub:
+        out = x.binaryExpr(y, typename functor::sub<T>::func());
+        break;
+    }
+  }
+
+  int num_args_;
+  std::vector<Instruction> program_;
+  int cost_ = 0;
+};
+
+#define REGISTER_CPU(T)                                                    \
+  REGISTER_KERNEL_BUILDER(                                                 \
+      Name("_FusedElementwise").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+      FusedElementwiseOp<T>);
+
+REGISTER_CPU(float);
+REGISTER_CPU(double);
+
+#undef REGISTER_CPU
+
+}  // namespace tensorflow
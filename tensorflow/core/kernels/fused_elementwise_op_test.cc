@@ -0,0 +1,105 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+class FusedElementwiseOpTest : public OpsTestBase {
+ protected:
+  absl::Status InitFusedOp(int num_args,
+                           const std::vector<std::string>& op_names,
+                           const std::vector<int>& operands) {
+    TF_RETURN_IF_ERROR(NodeDefBuilder("fused", "_FusedElementwise")
+                           .Input(FakeInput(num_args, DT_FLOAT))
+                           .Attr("T", DT_FLOAT)
+                           .Attr("num_args", num_args)
+                           .Attr("op_names", op_names)
+                           .Attr("operands", operands)
+                           .Finalize(node_def()));
+    return InitOp();
+  }
+};
+
+TEST_F(FusedElementwiseOpTest, Chain) {
+  // relu(sigmoid(x * y) - 0.5)
+  TF_ASSERT_OK(InitFusedOp(3, {"Mul", "Sigmoid", "Sub", "Relu"},
+                           {0, 1, 3, -1, 4, 2, 5, -1}));
+  // Spans several blocks and ends with a partial one.
+  const int64_t n = 5000;
+  std::vector<float> x(n), y(n), expected(n);
+  for (int64_t i = 0; i < n; ++i) {
+    x[i] = (i % 97) / 10.0f - 4.0f;
+    y[i] = (i % 13) / 4.0f - 1.5f;
+    const float s = 1.0f / (1.0f + std::exp(-x[i] * y[i]));
+    expected[i] = std::max(0.0f, s - 0.5f);
+  }
+  AddInputFromArray<float>(TensorShape({n}), x);
+  AddInputFromArray<float>(TensorShape({n}), y);
+  AddInputFromArray<float>(TensorShape({}), {0.5f});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected_tensor(DT_FLOAT, TensorShape({n}));
+  test::FillValues<float>(&expected_tensor, expected);
+  test::ExpectClose(expected_tensor, *GetOutput(0));
+}
+
+TEST_F(FusedElementwiseOpTest, BroadcastsInputs) {
+  // (x + y) * x, with x: [2, 1] and y: [3].
+  TF_ASSERT_OK(InitFusedOp(2, {"AddV2", "Mul"}, {0, 1, 2, 0}));
+  AddInputFromArray<float>(TensorShape({2, 1}), {1, 2});
+  AddInputFromArray<float>(TensorShape({3}), {10, 20, 30});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected(DT_FLOAT, TensorShape({2, 3}));
+  test::FillValues<float>(&expected, {11, 21, 31, 24, 44, 64});
+  test::ExpectTensorEqual<float>(expected, *GetOutput(0));
+}
+
+TEST_F(FusedElementwiseOpTest, IncompatibleShapes) {
+  TF_ASSERT_OK(InitFusedOp(2, {"Mul", "Neg"}, {0, 1, 2, -1}));
+  AddInputFromArray<float>(TensorShape({2}), {1, 2});
+  AddInputFromArray<float>(TensorShape({3}), {1, 2, 3});
+  absl::Status s = RunOpKernel();
+  EXPECT_TRUE(absl::IsInvalidArgument(s)) << s;
+}
+
+TEST_F(FusedElementwiseOpTest, RejectsInvalidPrograms) {
+  // Unknown op.
+  EXPECT_FALSE(InitFusedOp(1, {"Sin"}, {0, -1}).ok());
+  // A unary op with two operands.
+  EXPECT_FALSE(InitFusedOp(2, {"Neg"}, {0, 1}).ok());
+  // An op that reads its own value.
+  EXPECT_FALSE(InitFusedOp(1, {"Neg", "Mul"}, {0, -1, 2, 2}).ok());
+  // Missing operands.
+  EXPECT_FALSE(InitFusedOp(1, {"Neg", "Neg"}, {0, -1}).ok());
+}
+
+}  // namespace
+}  // namespace tensorflow
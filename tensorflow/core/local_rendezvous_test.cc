@@ -17,11 +17,14 @@ limitations under the License.
 
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <thread>  // NOLINT(build/c++11)
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "xla/tsl/lib/core/status_test_util.h"
 #include "tensorflow/core/framework/rendezvous.h"
 #include "tensorflow/core/platform/test.h"
@@ -30,7 +33,24 @@ limitations under the License.
 namespace tensorflow {
 namespace {
 
-TEST(LocalRendezvous, Stress) {
+// Runs each test with the locked table only, and with lock-free slots.
+class LocalRendezvousTest : public ::testing::TestWithParam<int> {
+ protected:
+  void SetUp() override { LocalRendezvous::SetNumSlotsForTesting(GetParam()); }
+  void TearDown() override { LocalRendezvous::SetNumSlotsForTesting(0); }
+};
+
+Rendezvous::ParsedKey MakeKey(const std::string& name) {
+  Rendezvous::ParsedKey key;
+  TF_CHECK_OK(Rendezvous::ParseKey(
+      Rendezvous::CreateKey("/job:mnist/replica:1/task:2/cpu:0", 7890,
+                            "/job:mnist/replica:1/task:2/cpu:1", name,
+                            FrameAndIter(0, 0)),
+      &key));
+  return key;
+}
+
+TEST_P(LocalRendezvousTest, Stress) {
   Rendezvous::ParsedKey key;
   TF_EXPECT_OK(Rendezvous::ParseKey(
       Rendezvous::CreateKey("/job:mnist/replica:1/task:2/cpu:0", 7890,
@@ -73,7 +93,7 @@ TEST(LocalRendezvous, Stress) {
   }
 }
 
-TEST(LocalRendezvous, CancelDestroyRace) {
+TEST_P(LocalRendezvousTest, CancelDestroyRace) {
   Rendezvous::ParsedKey key;
   TF_EXPECT_OK(Rendezvous::ParseKey(
       Rendezvous::CreateKey("/job:mnist/replica:1/task:2/cpu:0", 7890,
@@ -101,7 +121,7 @@ TEST(LocalRendezvous, CancelDestroyRace) {
   }
 }
 
-TEST(LocalRendezvous, CancelRecvRace) {
+TEST_P(LocalRendezvousTest, CancelRecvRace) {
   Rendezvous::ParsedKey key;
   TF_EXPECT_OK(Rendezvous::ParseKey(
       Rendezvous::CreateKey("/job:mnist/replica:1/task:2/cpu:0", 7890,
@@ -126,5 +146,54 @@ TEST(LocalRendezvous, CancelRecvRace) {
   }
 }
 
+TEST_P(LocalRendezvousTest, ManyKeys) {
+  // More keys than slots, so that some keys use the locked table.
+  constexpr int kNumKeys = 1000;
+  std::vector<Rendezvous::ParsedKey> keys;
+  for (int i = 0; i < kNumKeys; ++i) {
+    keys.push_back(MakeKey(absl::StrCat("edge_", i)));
+  }
+  // Successive rendezvous reuse the slots of the previous ones.
+  for (int step = 0; step < 10; ++step) {
+    std::atomic<int> recv_count = 0;
+    tsl::core::RefCountPtr<Rendezvous> rendezvous(NewLocalRendezvous());
+    std::thread sender([&] {
+      for (int i = 0; i < kNumKeys; ++i) {
+        TF_EXPECT_OK(rendezvous->Send(keys[i], Rendezvous::Args(),
+                                      Tensor(static_cast<int32_t>(i)), false));
+      }
+    });
+    for (int i = kNumKeys - 1; i >= 0; --i) {
+      rendezvous->RecvAsync(
+          keys[i], Rendezvous::Args(),
+          [&recv_count, i](const absl::Status& s, const Rendezvous::Args&,
+                           const Rendezvous::Args&, const Tensor& val, bool) {
+            TF_EXPECT_OK(s);
+            EXPECT_EQ(val.scalar<int32_t>()(), i);
+            recv_count++;
+          });
+    }
+    sender.join();
+    ASSERT_EQ(kNumKeys, recv_count);
+  }
+}
+
+TEST_P(LocalRendezvousTest, KeepsOrderOfMessages) {
+  Rendezvous::ParsedKey key = MakeKey("foo");
+  tsl::core::RefCountPtr<Rendezvous> rendezvous(NewLocalRendezvous());
+  for (int32_t i = 0; i < 3; ++i) {
+    TF_ASSERT_OK(rendezvous->Send(key, Rendezvous::Args(), Tensor(i), false));
+  }
+  for (int32_t i = 0; i < 3; ++i) {
+    Tensor val;
+    bool is_dead;
+    TF_ASSERT_OK(rendezvous->Recv(key, Rendezvous::Args(), &val, &is_dead));
+    EXPECT_EQ(val.scalar<int32_t>()(), i);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(Slots, LocalRendezvousTest,
+                         ::testing::Values(0, 64));
+
 }  // namespace
 }  // namespace tensorflow
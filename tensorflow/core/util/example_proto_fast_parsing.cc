@@ -15,7 +15,10 @@ limitations under the License.
 #include "tensorflow/core/util/example_proto_fast_parsing.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <functional>
+#include <limits>
 #include <optional>
 #include <utility>
 #include <vector>
@@ -119,6 +122,83 @@ constexpr uint8_t kVarintTag(uint32_t tag) { return (tag << 3) | 0; }
 constexpr uint8_t kDelimitedTag(uint32_t tag) { return (tag << 3) | 2; }
 constexpr uint8_t kFixed32Tag(uint32_t tag) { return (tag << 3) | 5; }
 
+// Points `*data` at the next `length` bytes of `stream` without consuming
+// them. The streams used here always wrap a flat array, so the bytes are
+// contiguous. Returns false if fewer than `length` bytes are left before the
+// current limit.
+bool PeekBytes(protobuf::io::CodedInputStream* stream, uint32_t length,
+               const uint8_t** data) {
+  if (length == 0) {
+    *data = nullptr;
+    return true;
+  }
+  const void* ptr;
+  int size;
+  if (!stream->GetDirectBufferPointer(&ptr, &size) ||
+      static_cast<uint32_t>(size) < length) {
+    return false;
+  }
+  *data = static_cast<const uint8_t*>(ptr);
+  return true;
+}
+
+constexpr uint64_t kVarintContinuationBits = 0x8080808080808080ULL;
+
+// Returns the number of varints terminated in `[p, p + n)`, i.e. the number of
+// bytes without the continuation bit. Scans eight bytes at a time.
+size_t CountPackedVarints(const uint8_t* p, size_t n) {
+  size_t count = 0;
+  for (; n >= sizeof(uint64_t); p += sizeof(uint64_t), n -= sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    // One bit per terminating byte, summed across the bytes by the multiply.
+    const uint64_t terminators = (~word & kVarintContinuationBits) >> 7;
+    count += (terminators * 0x0101010101010101ULL) >> 56;
+  }
+  for (; n > 0; ++p, --n) {
+    count += *p < 0x80;
+  }
+  return count;
+}
+
+// Decodes the varints packed in `[p, end)`. The first `capacity` values are
+// stored in `out`, the remaining ones are only validated. Returns the number
+// of values, or -1 if the data is malformed.
+int64_t DecodePackedVarints(const uint8_t* p, const uint8_t* end, int64_t* out,
+                            int64_t capacity) {
+  int64_t num_values = 0;
+  while (p != end) {
+    // Runs of single byte values, which are common for ids and labels, are
+    // widened eight at a time.
+    if (end - p >= 8 && capacity - num_values >= 8) {
+      uint64_t word;
+      std::memcpy(&word, p, sizeof(word));
+      if ((word & kVarintContinuationBits) == 0) {
+        for (int i = 0; i < 8; ++i) {
+          out[num_values + i] = p[i];
+        }
+        p += 8;
+        num_values += 8;
+        continue;
+      }
+    }
+    uint64_t value = 0;
+    int shift = 0;
+    uint8_t byte;
+    do {
+      if (p == end || shift >= 64) return -1;
+      byte = *p++;
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      shift += 7;
+    } while (byte & 0x80);
+    if (num_values < capacity) {
+      out[num_values] = static_cast<int64_t>(value);
+    }
+    ++num_values;
+  }
+  return num_values;
+}
+
 namespace parsed {
 
 // ParseDataType has to be called first, then appropriate ParseZzzzList.
@@ -311,15 +391,20 @@ class Feature {
         if (!stream.ExpectTag(kDelimitedTag(1))) return false;  // packed tag
         uint32_t packed_length;
         if (!stream.ReadVarint32(&packed_length)) return false;
-        auto packed_limit = stream.PushLimit(packed_length);
-
-        while (!stream.ExpectAtEnd()) {
-          protobuf_uint64 n;  // There is no API for int64
-          if (!stream.ReadVarint64(&n)) return false;
-          int64_list->push_back(static_cast<int64_t>(n));
+        const uint8_t* packed;
+        if (!PeekBytes(&stream, packed_length, &packed)) return false;
+
+        // Size the output once and decode straight into it. As for floats,
+        // a LimitedArraySlice may hold fewer elements than requested.
+        const size_t initial_size = int64_list->size();
+        int64_list->resize(initial_size +
+                           CountPackedVarints(packed, packed_length));
+        if (DecodePackedVarints(packed, packed + packed_length,
+                                int64_list->data() + initial_size,
+                                int64_list->size() - initial_size) < 0) {
+          return false;
         }
-
-        stream.PopLimit(packed_limit);
+        if (!stream.Skip(packed_length)) return false;
       } else {  // non-packed
         while (!stream.ExpectAtEnd()) {
           if (!stream.ExpectTag(kVarintTag(1))) return false;
@@ -2003,18 +2088,18 @@ inline int ParseInt64Feature(protobuf::io::CodedInputStream* stream,
           !stream->ReadVarint32(&packed_length)) {
         return -1;
       }
-      auto packed_limit = stream->PushLimit(packed_length);
-      while (!stream->ExpectAtEnd()) {
-        protobuf_uint64 n;  // There is no API for int64
-        if (!stream->ReadVarint64(&n)) {
-          return -1;
-        }
-        if (out != nullptr) {
-          *out++ = n;
-        }
-        num_elements++;
+      const uint8_t* packed;
+      if (!PeekBytes(stream, packed_length, &packed)) {
+        return -1;
       }
-      stream->PopLimit(packed_limit);
+      // The caller sized `out` from a previous counting pass.
+      const int64_t num_decoded = DecodePackedVarints(
+          packed, packed + packed_length, out,
+          out == nullptr ? 0 : std::numeric_limits<int64_t>::max());
+      if (num_decoded < 0 || !stream->Skip(packed_length)) {
+        return -1;
+      }
+      num_elements += num_decoded;
     } else if (peek_tag == kVarintTag(1)) {
       while (!stream->ExpectAtEnd()) {
         protobuf_uint64 n;  // There is no API for int64
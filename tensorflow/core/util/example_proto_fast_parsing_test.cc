@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/util/example_proto_fast_parsing.h"
 
 #include <cstdint>
+#include <limits>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -258,6 +259,31 @@ static std::string ExampleWithSomeFeatures() {
 
 TEST(FastParse, SomeFeatures) { TestCorrectness(ExampleWithSomeFeatures()); }
 
+TEST(FastParse, PackedInt64) {
+  Example example;
+  Int64List* int64_list =
+      (*example.mutable_features()->mutable_feature())["int64_list"]
+          .mutable_int64_list();
+  // Mixes runs of single byte values with multi-byte and negative values, so
+  // that both the bulk and the per-value decoding paths are exercised.
+  for (int64_t i = 0; i < 100; ++i) {
+    int64_list->add_value(i % 128);
+    if (i % 11 == 0) int64_list->add_value(i * 1000003);
+    if (i % 17 == 0) int64_list->add_value(-i);
+  }
+  int64_list->add_value(std::numeric_limits<int64_t>::min());
+  int64_list->add_value(std::numeric_limits<int64_t>::max());
+  TestCorrectness(Serialize(example));
+}
+
+TEST(FastParse, PackedInt64TruncatedVarint) {
+  // A packed int64 list whose only value has its continuation bit set.
+  Example example;
+  EXPECT_FALSE(TestFastParse(
+      "\x0a\x0e\x0a\x0c\x0a\x03\x61\x67\x65\x12\x05\x1a\x03\x0a\x01\x8d",
+      &example));
+}
+
 static void AddDenseFeature(const char* feature_name, DataType dtype,
                             PartialTensorShape shape, bool variable_length,
                             size_t elements_per_stride,
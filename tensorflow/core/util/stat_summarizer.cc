@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/util/stat_summarizer.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <map>
 #include <queue>
@@ -24,6 +25,7 @@ limitations under the License.
 #include <vector>
 
 #include "absl/strings/match.h"
+#include "absl/strings/str_format.h"
 #include "tensorflow/core/framework/step_stats.pb.h"
 #include "tensorflow/core/framework/tensor_description.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
@@ -82,13 +84,46 @@ void StatSummarizer::Validate(const std::vector<TensorDescription>* outputs,
 }
 
 void StatSummarizer::PrintStepStats() const {
-  std::string output = GetOutputString();
+  std::string output = GetOutputString() + GetHardwareCountersString();
   std::istringstream iss(output);
   for (std::string line; std::getline(iss, line);) {
     LOG(INFO) << line;
   }
 }
 
+std::string StatSummarizer::GetHardwareCountersString() const {
+  if (hardware_counters_.empty()) return "";
+  std::vector<const std::pair<const std::string, HardwareCounterTotals>*>
+      entries;
+  for (const auto& entry : hardware_counters_) {
+    entries.push_back(&entry);
+  }
+  std::sort(entries.begin(), entries.end(), [](const auto* a, const auto* b) {
+    return a->second.cycles > b->second.cycles;
+  });
+
+  // Per thousand instructions.
+  auto pki = [](int64_t events, int64_t instructions) {
+    return instructions > 0 ? 1000.0 * events / instructions : 0.0;
+  };
+  std::stringstream stream;
+  stream << "============ Hardware counters by node, sorted by cycles "
+            "============\n";
+  stream << "[node type]\t[count]\t[avg cycles]\t[avg instructions]\t[IPC]"
+            "\t[LLC MPKI]\t[branch MPKI]\t[Name]\n";
+  for (const auto* entry : entries) {
+    const HardwareCounterTotals& totals = entry->second;
+    stream << absl::StrFormat(
+        "%s\t%d\t%d\t%d\t%.3f\t%.3f\t%.3f\t%s\n", totals.op_type,
+        totals.count, totals.cycles / totals.count,
+        totals.instructions / totals.count,
+        totals.cycles > 0 ? 1.0 * totals.instructions / totals.cycles : 0.0,
+        pki(totals.llc_misses, totals.instructions),
+        pki(totals.branch_misses, totals.instructions), entry->first);
+  }
+  return stream.str();
+}
+
 namespace {
 std::string OpType(const DeviceStepStats& ds, const NodeExecStats& ns) {
   // There is no published specification of how DeviceStats and NodeStats
@@ -214,6 +249,16 @@ void StatSummarizer::ProcessStepStats(const StepStats& step_stats) {
 
       mem_total += curr_node_mem;
 
+      if (ns.has_hardware_counters()) {
+        HardwareCounterTotals& totals = hardware_counters_[name];
+        totals.op_type = op_type;
+        ++totals.count;
+        totals.cycles += ns.hardware_counters().cycles();
+        totals.instructions += ns.hardware_counters().instructions();
+        totals.llc_misses += ns.hardware_counters().llc_misses();
+        totals.branch_misses += ns.hardware_counters().branch_misses();
+      }
+
       Validate(outputs, ns);
     }
   }
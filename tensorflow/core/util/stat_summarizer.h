@@ -68,7 +68,14 @@ class StatSummarizer {
     return stats_calculator_->GetShortSummary();
   }
 
-  // Prints the string returned by GetOutputString().
+  // Returns a tab-separated table of the hardware counters recorded for each
+  // node, sorted by cycles, or an empty string if the StepStats had none (see
+  // TF_STEP_STATS_HARDWARE_COUNTERS). Instructions per cycle and misses per
+  // thousand instructions tell compute-bound from memory-bound kernels.
+  std::string GetHardwareCountersString() const;
+
+  // Prints the string returned by GetOutputString(), followed by the one
+  // returned by GetHardwareCountersString().
   void PrintStepStats() const;
 
   // Prints the output tensor sizes and types for each node.
@@ -109,6 +116,17 @@ class StatSummarizer {
 
   std::map<std::string, std::vector<TensorDescription> > outputs_;
 
+  // Sums of the hardware counters of a node over all runs.
+  struct HardwareCounterTotals {
+    std::string op_type;
+    int64_t count = 0;
+    int64_t cycles = 0;
+    int64_t instructions = 0;
+    int64_t llc_misses = 0;
+    int64_t branch_misses = 0;
+  };
+  std::map<std::string, HardwareCounterTotals> hardware_counters_;
+
   std::unique_ptr<StatsCalculator> stats_calculator_;
 };
 
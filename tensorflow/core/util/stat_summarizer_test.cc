@@ -88,5 +88,45 @@ versions {
   ASSERT_TRUE(absl::StrContains(by_node_type, "Const")) << by_node_type;
 }
 
+TEST(StatSummarizerTest, SummarizesHardwareCounters) {
+  const std::string step_stats_str(R"EOF(
+dev_stats {
+  device: "/job:localhost/replica:0/task:0/device:CPU:0"
+  node_stats {
+    node_name: "matmul"
+    all_end_rel_micros: 10
+    timeline_label: "matmul = MatMul(a, b)"
+    hardware_counters {
+      cycles: 1000
+      instructions: 2000
+      llc_misses: 4
+      branch_misses: 2
+    }
+  }
+  node_stats {
+    node_name: "add"
+    all_end_rel_micros: 1
+    timeline_label: "add = AddV2(matmul, c)"
+  }
+}
+  )EOF");
+  StepStats step_stats;
+  ASSERT_TRUE(
+      protobuf::TextFormat::ParseFromString(step_stats_str, &step_stats));
+
+  StatSummarizer stats((StatSummarizerOptions()));
+  EXPECT_EQ(stats.GetHardwareCountersString(), "");
+  stats.ProcessStepStats(step_stats);
+  stats.ProcessStepStats(step_stats);
+
+  const std::string output = stats.GetHardwareCountersString();
+  EXPECT_TRUE(
+      absl::StrContains(output, "MatMul\t2\t1000\t2000\t2.000\t2.000\t1.000"
+                                "\tmatmul\n"))
+      << output;
+  // Nodes without counters are not listed.
+  EXPECT_FALSE(absl::StrContains(output, "AddV2")) << output;
+}
+
 }  // namespace
 }  // namespace tensorflow
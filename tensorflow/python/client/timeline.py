@@ -526,6 +526,12 @@ class Timeline(object):
       args['kernel'] = nodestats.timeline_label.split('@@')[0]
     for i, iname in enumerate(inputs):
       args['input%d' % i] = iname
+    if nodestats.HasField('hardware_counters'):
+      counters = nodestats.hardware_counters
+      args['cycles'] = counters.cycles
+      args['instructions'] = counters.instructions
+      args['llc_misses'] = counters.llc_misses
+      args['branch_misses'] = counters.branch_misses
     self._chrome_trace.emit_region(start, duration, pid, tid, 'Op', op, args)
 
   def _emit_tensor_snapshot(
@@ -39,6 +39,8 @@ class RecordWriterOptions:
     def compression_type(self): ...
     @property
     def zlib_options(self) -> ZlibCompressionOptions: ...
+    @property
+    def zstd_options(self) -> ZstdCompressionOptions: ...
 
 class ZlibCompressionOptions:
     compression_level: int
@@ -50,3 +52,8 @@ class ZlibCompressionOptions:
     output_buffer_size: int
     window_bits: int
     def __init__(self, *args, **kwargs) -> None: ...
+
+class ZstdCompressionOptions:
+    block_size: int
+    compression_level: int
+    def __init__(self, *args, **kwargs) -> None: ...
@@ -191,6 +191,7 @@ class PyRecordWriter {
   static absl::Status New(const std::string& filename,
                           const tensorflow::io::RecordWriterOptions& options,
                           PyRecordWriter** out) {
+    TF_RETURN_IF_ERROR(tensorflow::io::RecordWriter::ValidateOptions(options));
     std::unique_ptr<tensorflow::WritableFile> file;
     TF_RETURN_IF_ERROR(
         tensorflow::Env::Default()->NewWritableFile(filename, &file));
@@ -363,11 +364,18 @@ PYBIND11_MODULE(_pywrap_record_io, m, pybind11::mod_gil_not_used()) {
       .def_readwrite("compression_strategy",
                      &ZlibCompressionOptions::compression_strategy);
 
+  using tsl::io::ZstdCompressionOptions;
+  py::class_<ZstdCompressionOptions>(m, "ZstdCompressionOptions")
+      .def_readwrite("block_size", &ZstdCompressionOptions::block_size)
+      .def_readwrite("compression_level",
+                     &ZstdCompressionOptions::compression_level);
+
   using tensorflow::io::RecordWriterOptions;
   py::class_<RecordWriterOptions>(m, "RecordWriterOptions")
       .def(py::init(&RecordWriterOptions::CreateRecordWriterOptions))
       .def_readonly("compression_type", &RecordWriterOptions::compression_type)
-      .def_readonly("zlib_options", &RecordWriterOptions::zlib_options);
+      .def_readonly("zlib_options", &RecordWriterOptions::zlib_options)
+      .def_readonly("zstd_options", &RecordWriterOptions::zstd_options);
 
   using tensorflow::MaybeRaiseRegisteredFromStatus;
 
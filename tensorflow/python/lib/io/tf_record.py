@@ -30,6 +30,7 @@ class TFRecordCompressionType(object):
   NONE = 0
   ZLIB = 1
   GZIP = 2
+  ZSTD = 3
 
 
 @tf_export(
@@ -41,6 +42,7 @@ class TFRecordOptions(object):
   compression_type_map = {
       TFRecordCompressionType.ZLIB: "ZLIB",
       TFRecordCompressionType.GZIP: "GZIP",
+      TFRecordCompressionType.ZSTD: "ZSTD",
       TFRecordCompressionType.NONE: ""
   }
 
@@ -64,12 +66,16 @@ class TFRecordOptions(object):
     Leaving an option as `None` allows C++ to set a reasonable default.
 
     Args:
-      compression_type: `"GZIP"`, `"ZLIB"`, or `""` (no compression).
+      compression_type: `"GZIP"`, `"ZLIB"`, `"ZSTD"`, or `""` (no
+        compression). `"ZSTD"` files are written as independently
+        decompressable blocks, so readers can seek without decompressing the
+        preceding data. `"ZSTD"` only supports `compression_level`.
       flush_mode: flush mode or `None`, Default: Z_NO_FLUSH.
       input_buffer_size: int or `None`.
       output_buffer_size: int or `None`.
       window_bits: int or `None`.
-      compression_level: 0 to 9, or `None`.
+      compression_level: 0 to 9, or `None`. For `"ZSTD"`, a zstd level, where
+        0 selects the zstd default.
       compression_method: compression method or `None`.
       mem_level: 1 to 9, or `None`.
       compression_strategy: strategy or `None`. Default: Z_DEFAULT_STRATEGY.
@@ -78,7 +84,8 @@ class TFRecordOptions(object):
       A `TFRecordOptions` object.
 
     Raises:
-      ValueError: If compression_type is invalid.
+      ValueError: If compression_type is invalid, or if an option is set that
+        compression_type does not support.
     """
     # pylint: enable=line-too-long
     # Check compression_type is valid, but for backwards compatibility don't
@@ -93,6 +100,21 @@ class TFRecordOptions(object):
     self.compression_method = compression_method
     self.mem_level = mem_level
     self.compression_strategy = compression_strategy
+    if self.get_compression_type_string(compression_type) == "ZSTD":
+      zlib_only_options = {
+          "flush_mode": flush_mode,
+          "input_buffer_size": input_buffer_size,
+          "output_buffer_size": output_buffer_size,
+          "window_bits": window_bits,
+          "compression_method": compression_method,
+          "mem_level": mem_level,
+          "compression_strategy": compression_strategy,
+      }
+      for name, value in zlib_only_options.items():
+        if value is not None:
+          raise ValueError(
+              'Option {} is not supported with compression_type "ZSTD"'.format(
+                  name))
 
   @classmethod
   def get_compression_type_string(cls, options):
@@ -122,10 +144,14 @@ class TFRecordOptions(object):
 
   def _as_record_writer_options(self):
     """Convert to RecordWriterOptions for use with PyRecordWriter."""
+    compression_type = self.get_compression_type_string(self.compression_type)
     options = _pywrap_record_io.RecordWriterOptions(
-        compat.as_bytes(
-            self.get_compression_type_string(self.compression_type)))
+        compat.as_bytes(compression_type))
 
+    if compression_type == "ZSTD":
+      if self.compression_level is not None:
+        options.zstd_options.compression_level = self.compression_level
+      return options
     if self.flush_mode is not None:
       options.zlib_options.flush_mode = self.flush_mode
     if self.input_buffer_size is not None:
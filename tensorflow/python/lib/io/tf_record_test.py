@@ -23,6 +23,7 @@ import zlib
 import six
 
 from tensorflow.python.framework import errors_impl
+from tensorflow.python.lib.io import _pywrap_record_io
 from tensorflow.python.lib.io import tf_record
 from tensorflow.python.platform import test
 from tensorflow.python.util import compat
@@ -292,6 +293,30 @@ class TFRecordWriterTest(TFCompressionTestCase):
             "Setting {} = {}, file was {} smaller didn't match sign of {}"
             .format(prop, value, delta, delta_sign))
 
+  def testZstdCompressionOptions(self):
+    """test Zstd Compression Options"""
+    records = [compat.as_bytes(_TEXT * 20), compat.as_bytes(_TEXT * 20)]
+    options_a = tf_record.TFRecordOptions("ZSTD", compression_level=1)
+    options_b = tf_record.TFRecordOptions("ZSTD", compression_level=19)
+    # A higher level compresses better or equal.
+    self.assertGreaterEqual(
+        self._CompressionSizeDelta(records, options_a, options_b), 0)
+
+    with self.assertRaisesRegex(ValueError, "window_bits"):
+      tf_record.TFRecordOptions("ZSTD", window_bits=8)
+    with self.assertRaisesRegex(ValueError, "output_buffer_size"):
+      tf_record.TFRecordOptions("ZSTD", output_buffer_size=4096)
+
+  def testZstdInvalidBlockSize(self):
+    """test Zstd Invalid Block Size"""
+    fn = os.path.join(self.get_temp_dir(), "zstd_invalid_block_size")
+    for block_size in [0, -1, 1 << 30]:
+      options = _pywrap_record_io.RecordWriterOptions(b"ZSTD")
+      options.zstd_options.block_size = block_size
+      with self.assertRaisesRegex(errors_impl.InvalidArgumentError,
+                                  "block_size"):
+        _pywrap_record_io.RecordWriter(fn, options)
+
 
 class TFRecordWriterZlibTest(TFCompressionTestCase):
   """TFRecordWriter Zlib test"""
@@ -46,6 +46,7 @@ limitations under the License.
 #include "xla/tsl/platform/logging.h"
 #include "xla/tsl/profiler/utils/trace_filter_utils.h"
 #include "xla/tsl/protobuf/bfc_memory_map.pb.h"
+#include "tsl/platform/cpu_info.h"
 #include "tsl/platform/numbers.h"
 #include "tsl/platform/stacktrace.h"
 #include "tsl/profiler/lib/scoped_memory_debug_annotation.h"
@@ -134,6 +135,21 @@ BFCAllocator::BFCAllocator(std::unique_ptr<SubAllocator> sub_allocator,
       CHECK_NE(BinForSize(bin_size * 2), BinFromIndex(b));
     }
   }
+
+  if (opts.thread_cache_bytes > 0) {
+    CHECK(!opts.enable_spatial_partitioning)  // Crash OK
+        << "Thread caches cannot be combined with spatial partitioning.";
+    num_thread_caches_ = static_cast<int>(absl::bit_ceil(static_cast<unsigned>(
+        std::clamp(port::MaxParallelism(), 1, kMaxThreadCaches))));
+    VLOG(1) << "Creating " << num_thread_caches_ << " thread caches of "
+            << strings::HumanReadableNumBytes(opts.thread_cache_bytes)
+            << " for " << name;
+    thread_caches_ = std::make_unique<ThreadCache[]>(num_thread_caches_);
+    for (int i = 0; i < num_thread_caches_; ++i) {
+      absl::MutexLock l(thread_caches_[i].mu);
+      thread_caches_[i].magazines.resize(kNumThreadCacheClasses);
+    }
+  }
 }
 
 BFCAllocator::~BFCAllocator() {
@@ -317,6 +333,8 @@ void* BFCAllocator::AllocateRawInternalWithRetry(
   static const int64_t kMaxMillisToWait = 10000;  // 10 seconds
   r = retry_helper_.AllocateRaw(
       [this, &allocation_attr](size_t a, size_t nb, bool v) {
+        // Chunks held by thread caches may be what this request needs.
+        FlushThreadCaches(/*release_cached_chunks=*/true);
         uint64_t freed_by_count = 0;
         if (allocation_attr.freed_by_func != nullptr) {
           freed_by_count = (*allocation_attr.freed_by_func)();
@@ -338,6 +356,14 @@ void* BFCAllocator::AllocateRaw(size_t alignment, size_t num_bytes,
   // kLower, requests only ever land in AllocateChunkFromLowEnd.
   DCHECK(opts_.enable_spatial_partitioning ||
          allocation_attr.allocation_end == AllocationEnd::kLower);
+  if (ThreadCacheEnabled() && allocation_attr.freed_by_func == nullptr) {
+    if (void* ptr = AllocateFromThreadCache(alignment, num_bytes);
+        ptr != nullptr) {
+      VLOG(3) << "AllocateRaw " << Name() << "  " << num_bytes << " " << ptr
+              << " (thread cache)";
+      return ptr;
+    }
+  }
   void* result = [&] {
     if (!opts_.allow_retry_on_failure || !allocation_attr.retry_on_failure) {
       // If we have globally disabled retry-on-failure and fail to allocate an
@@ -361,9 +387,17 @@ void* BFCAllocator::AllocateRaw(size_t alignment, size_t num_bytes,
       if (allocation_attr.freed_by_func != nullptr) {
         freed_by_count = (*allocation_attr.freed_by_func)();
       }
-      void* res =
-          AllocateRawInternal(alignment, num_bytes, dump_log_on_failure,
-                              freed_by_count, allocation_attr.allocation_end);
+      void* res = AllocateRawInternal(
+          alignment, num_bytes, dump_log_on_failure && thread_caches_ == nullptr,
+          freed_by_count, allocation_attr.allocation_end);
+      if (res == nullptr && thread_caches_ != nullptr) {
+        // Return the chunks held by thread caches and try once more before
+        // reporting an OOM.
+        FlushThreadCaches(/*release_cached_chunks=*/true);
+        res = AllocateRawInternal(alignment, num_bytes, dump_log_on_failure,
+                                  freed_by_count,
+                                  allocation_attr.allocation_end);
+      }
       if (res == nullptr) {
         int32_t counter_value = log_counter.load(std::memory_order_relaxed);
         if (counter_value < kMaxFailureLogs) {
@@ -963,6 +997,10 @@ void BFCAllocator::DeallocateRaw(void* ptr) {
   VLOG(4) << "[mem-debug] DeallocateRaw," << Name() << ","
           << (ptr ? RequestedSize(ptr) : 0) << "," << ptr << ","
           << tsl::CurrentStackTrace();
+  if (ptr != nullptr && ThreadCacheEnabled()) {
+    DeallocateToThreadCache(ptr);
+    return;
+  }
   DeallocateRawInternal(ptr);
   retry_helper_.NotifyDealloc();
 }
@@ -983,6 +1021,18 @@ void BFCAllocator::DeallocateRawInternal(void* ptr) {
   int64_t req_bytes = chunk->requested_size;
   int64_t alloc_bytes = chunk->size;
 
+  ReturnChunkToBins(h);
+
+  // TraceMe needs to be added after MarkFree and InsertFreeChunk for
+  // correct aggregation stats (bytes_in_use, fragmentation).
+  AddTraceMe("MemoryDeallocation", chunk_ptr, req_bytes, alloc_bytes);
+
+  if (VLOG_IS_ON(4)) {
+    LOG(INFO) << "F: " << RenderOccupancy();
+  }
+}
+
+void BFCAllocator::ReturnChunkToBins(ChunkHandle h) {
   MarkFree(h);
 
   // Consider coalescing it.
@@ -992,14 +1042,167 @@ void BFCAllocator::DeallocateRawInternal(void* ptr) {
   } else {
     InsertFreeChunk(TryToCoalesce(h, false));
   }
+}
 
-  // TraceMe needs to be added after MarkFree and InsertFreeChunk for
-  // correct aggregation stats (bytes_in_use, fragmentation).
-  AddTraceMe("MemoryDeallocation", chunk_ptr, req_bytes, alloc_bytes);
+BFCAllocator::ThreadCache* BFCAllocator::CurrentThreadCache() {
+  // Slots are shared by all allocators; a thread keeps its slot for life.
+  static std::atomic<uint32_t> next_thread_slot{0};
+  thread_local const uint32_t thread_slot =
+      next_thread_slot.fetch_add(1, std::memory_order_relaxed);
+  return &thread_caches_[thread_slot & (num_thread_caches_ - 1)];
+}
 
-  if (VLOG_IS_ON(4)) {
-    LOG(INFO) << "F: " << RenderOccupancy();
+void* BFCAllocator::AllocateFromThreadCache(size_t alignment,
+                                            size_t num_bytes) {
+  if (num_bytes == 0) {
+    return nullptr;
+  }
+  const size_t rounded_bytes = RoundedBytes(num_bytes);
+  if (rounded_bytes > kMaxThreadCachedBytes) {
+    return nullptr;
+  }
+  ThreadCache* cache = CurrentThreadCache();
+  void* ptr = nullptr;
+  bool returned_to_bins = false;
+  {
+    absl::MutexLock l(cache->mu);
+    std::vector<CachedChunk>& magazine =
+        cache->magazines[ThreadCacheClass(rounded_bytes)];
+    if (magazine.empty() ||
+        (absl::bit_cast<uintptr_t>(magazine.back().ptr) & (alignment - 1)) !=
+            0) {
+      return nullptr;
+    }
+
+    // The chunk's metadata and the stats are updated when the cache is
+    // flushed.
+    PendingAllocation& pending = cache->pending_allocations.emplace_back();
+    pending.chunk = magazine.back();
+    pending.requested_size = num_bytes;
+    ScopedAllocationTrace::Snapshot allocation_annotation =
+        ScopedAllocationTrace::Current();
+    if (!allocation_annotation.frames.empty()) {
+      pending.allocation_annotation = std::move(allocation_annotation);
+    }
+    magazine.pop_back();
+    cache->cached_bytes -= pending.chunk.size;
+    ptr = pending.chunk.ptr;
+
+    if (cache->pending_allocations.size() >= kThreadCacheBatchSize) {
+      returned_to_bins =
+          FlushThreadCache(cache, /*release_cached_chunks=*/false);
+    }
+  }
+  if (returned_to_bins) {
+    retry_helper_.NotifyDealloc();
+  }
+  return ptr;
+}
+
+void BFCAllocator::DeallocateToThreadCache(void* ptr) {
+  ThreadCache* cache = CurrentThreadCache();
+  bool returned_to_bins = false;
+  {
+    absl::MutexLock l(cache->mu);
+    cache->pending_frees.push_back(ptr);
+    if (cache->pending_frees.size() >= kThreadCacheBatchSize) {
+      returned_to_bins =
+          FlushThreadCache(cache, /*release_cached_chunks=*/false);
+    }
+  }
+  if (returned_to_bins) {
+    retry_helper_.NotifyDealloc();
+  }
+}
+
+void BFCAllocator::FlushThreadCaches(bool release_cached_chunks) {
+  bool returned_to_bins = false;
+  for (int i = 0; i < num_thread_caches_; ++i) {
+    ThreadCache* cache = &thread_caches_[i];
+    absl::MutexLock l(cache->mu);
+    returned_to_bins |= FlushThreadCache(cache, release_cached_chunks);
+  }
+  if (returned_to_bins) {
+    retry_helper_.NotifyDealloc();
+  }
+}
+
+bool BFCAllocator::FlushThreadCache(ThreadCache* cache,
+                                    bool release_cached_chunks) {
+  if (cache->pending_allocations.empty() && cache->pending_frees.empty() &&
+      (!release_cached_chunks || cache->cached_bytes == 0)) {
+    return false;
+  }
+  bool returned_to_bins = false;
+  absl::MutexLock l(mutex_);
+
+  // Allocations are applied before frees, so peak_bytes_in_use may overstate
+  // but never understates the peak reached within the batch.
+  for (PendingAllocation& pending : cache->pending_allocations) {
+    ++stats_.num_allocs;
+    stats_.bytes_in_use += pending.chunk.size;
+    stats_.largest_alloc_size =
+        std::max<std::size_t>(stats_.largest_alloc_size, pending.chunk.size);
+    Chunk* c = ChunkFromHandle(pending.chunk.handle);
+    if (c->allocation_id != pending.chunk.cache_id) {
+      // Already freed through another thread's cache, which accounted for it.
+      continue;
+    }
+    c->requested_size = pending.requested_size;
+    c->allocation_id = next_allocation_id_++;
+    c->allocation_annotation = std::move(pending.allocation_annotation);
+    AddTraceMe("MemoryAllocation", c->ptr);
+  }
+  stats_.peak_bytes_in_use =
+      std::max(stats_.peak_bytes_in_use, stats_.bytes_in_use);
+  cache->pending_allocations.clear();
+
+  for (void* ptr : cache->pending_frees) {
+    ChunkHandle h = region_manager_.get_handle(ptr);
+    CHECK(h != kInvalidChunkHandle);
+    Chunk* c = ChunkFromHandle(h);
+    const int64_t req_bytes = c->requested_size;
+    const int64_t alloc_bytes = c->size;
+    std::vector<CachedChunk>* magazine = nullptr;
+    if (!release_cached_chunks && c->size <= kMaxThreadCachedBytes &&
+        cache->cached_bytes + c->size <= opts_.thread_cache_bytes) {
+      magazine = &cache->magazines[ThreadCacheClass(c->size)];
+      if (magazine->size() >= kThreadCacheMagazineSize) {
+        magazine = nullptr;
+      }
+    }
+    if (magazine != nullptr) {
+      // Keep the chunk in use so the shared bins never see it, and give it a
+      // fresh id so stale pending allocations of it can be told apart.
+      CHECK(c->in_use());
+      stats_.bytes_in_use -= c->size;
+      c->allocation_id = next_allocation_id_++;
+      c->allocation_annotation.reset();
+      magazine->push_back({ptr, h, c->size, c->allocation_id});
+      cache->cached_bytes += c->size;
+    } else {
+      ReturnChunkToBins(h);
+      returned_to_bins = true;
+    }
+    AddTraceMe("MemoryDeallocation", ptr, req_bytes, alloc_bytes);
+  }
+  cache->pending_frees.clear();
+
+  if (release_cached_chunks) {
+    for (std::vector<CachedChunk>& magazine : cache->magazines) {
+      for (const CachedChunk& cached : magazine) {
+        DCHECK_EQ(ChunkFromHandle(cached.handle)->allocation_id,
+                  cached.cache_id);
+        // MarkFree subtracts the size again.
+        stats_.bytes_in_use += cached.size;
+        ReturnChunkToBins(cached.handle);
+        returned_to_bins = true;
+      }
+      magazine.clear();
+    }
+    cache->cached_bytes = 0;
   }
+  return returned_to_bins;
 }
 
 BFCAllocator::ChunkTag BFCAllocator::MergedChunkTag(ChunkTag a,
@@ -1281,6 +1484,9 @@ bool BFCAllocator::TracksAllocationSizes() const { return true; }
 
 size_t BFCAllocator::RequestedSize(const void* ptr) const {
   CHECK(ptr);
+  // Thread cache hits update their chunk's metadata lazily.
+  const_cast<BFCAllocator*>(this)->FlushThreadCaches(
+      /*release_cached_chunks=*/false);
   absl::MutexLock l(mutex_);
   BFCAllocator::ChunkHandle h = region_manager_.get_handle(ptr);
   CHECK(h != kInvalidChunkHandle)
@@ -1299,6 +1505,8 @@ size_t BFCAllocator::AllocatedSize(const void* ptr) const {
 }
 
 int64_t BFCAllocator::AllocationId(const void* ptr) const {
+  const_cast<BFCAllocator*>(this)->FlushThreadCaches(
+      /*release_cached_chunks=*/false);
   absl::MutexLock l(mutex_);
   BFCAllocator::ChunkHandle h = region_manager_.get_handle(ptr);
   CHECK(h != kInvalidChunkHandle)
@@ -1528,6 +1736,8 @@ void BFCAllocator::MaybeWriteMemoryMap() {
 }
 
 MemoryDump BFCAllocator::RecordMemoryMap() {
+  // Chunks held by thread caches would otherwise show up as in use.
+  FlushThreadCaches(/*release_cached_chunks=*/true);
   absl::MutexLock l(mutex_);
   return RecordMemoryMapInternal();
 }
@@ -1599,6 +1809,7 @@ MemoryDump BFCAllocator::RecordMemoryMapInternal() {
 }
 
 std::optional<AllocatorStats> BFCAllocator::GetStats() {
+  FlushThreadCaches(/*release_cached_chunks=*/false);
   absl::MutexLock l(mutex_);
   AllocatorStats stats = stats_;
   stats.largest_free_block_bytes = static_cast<int64_t>(LargestFreeChunk());
@@ -1606,6 +1817,7 @@ std::optional<AllocatorStats> BFCAllocator::GetStats() {
 }
 
 bool BFCAllocator::ClearStats() {
+  FlushThreadCaches(/*release_cached_chunks=*/false);
   absl::MutexLock l(mutex_);
   stats_.num_allocs = 0;
   stats_.peak_bytes_in_use = stats_.bytes_in_use;
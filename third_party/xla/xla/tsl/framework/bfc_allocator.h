@@ -140,6 +140,18 @@ class BFCAllocator : public Allocator {
     //
     // Requires allow_growth=false (a single fixed address range).
     bool enable_spatial_partitioning = false;
+
+    // If nonzero, enables a per-thread front-end cache in front of the shared
+    // bins. Each thread slot keeps magazines of recently freed chunks of up to
+    // kMaxThreadCachedBytes, grouped by size class, and holds at most this
+    // many bytes in them. Allocations that hit a magazine, and all frees, only
+    // take the slot's own lock; frees and the bookkeeping of cache hits are
+    // handed to the shared bins in batches. GetStats() and RecordMemoryMap()
+    // flush every slot first, so their results stay exact.
+    //
+    // Incompatible with enable_spatial_partitioning. Ignored while a timing
+    // counter is set.
+    size_t thread_cache_bytes = 0;
   };
 
   BFCAllocator(std::unique_ptr<SubAllocator> sub_allocator, size_t total_memory,
@@ -152,6 +164,10 @@ class BFCAllocator : public Allocator {
   static constexpr size_t kMinAllocationBits = 8;
   static constexpr size_t kMinAllocationSize = 1 << kMinAllocationBits;
 
+  // Largest chunk that the per-thread cache holds. See
+  // Options::thread_cache_bytes.
+  static constexpr size_t kMaxThreadCachedBytes = 64 << 10;
+
   void* AllocateRaw(size_t alignment, size_t num_bytes) override {
     return AllocateRaw(alignment, num_bytes, AllocationAttributes());
   }
@@ -197,6 +213,22 @@ class BFCAllocator : public Allocator {
 
   void DeallocateRawInternal(void* ptr);
 
+  // Serves an allocation of 'num_bytes' from the current thread's cache.
+  // Returns nullptr if the matching magazine has no suitably aligned chunk.
+  void* AllocateFromThreadCache(size_t alignment, size_t num_bytes);
+
+  // Queues 'ptr' on the current thread's cache to be freed in the next batch.
+  void DeallocateToThreadCache(void* ptr);
+
+  // Folds the pending allocations and frees of every thread cache into the
+  // shared state. If 'release_cached_chunks' is true, the magazines are also
+  // emptied back into the bins. No-op without thread caches.
+  void FlushThreadCaches(bool release_cached_chunks);
+
+  bool ThreadCacheEnabled() const {
+    return thread_caches_ != nullptr && timing_counter_ == nullptr;
+  }
+
   // Chunks whose freed_at_count is later than the safe frontier value are kept
   // on a special list and not subject to merging immediately upon being freed.
   //
@@ -396,6 +428,60 @@ class BFCAllocator : public Allocator {
         : bin_size(bs), free_chunks(ChunkComparator(allocator)) {}
   };
 
+  // A chunk held in a ThreadCache magazine. The chunk stays marked in use in
+  // chunks_, so the shared allocator never coalesces or reissues it, but its
+  // bytes are not counted in stats_.bytes_in_use.
+  struct CachedChunk {
+    void* ptr = nullptr;
+    ChunkHandle handle = kInvalidChunkHandle;
+    size_t size = 0;
+    // The allocation_id the chunk was given when it entered the magazine.
+    // Used to detect that a cache hit has since been freed through another
+    // thread's cache.
+    int64_t cache_id = -1;
+  };
+
+  // A chunk handed out from a magazine whose Chunk metadata and stats have
+  // not been updated yet.
+  struct PendingAllocation {
+    CachedChunk chunk;
+    size_t requested_size = 0;
+    std::optional<ScopedAllocationTrace::Snapshot> allocation_annotation;
+  };
+
+  // Per-thread front end of the allocator. Threads are mapped to caches
+  // round-robin, so each cache's lock is normally uncontended. Lock order is
+  // ThreadCache::mu before mutex_.
+  struct ThreadCache {
+    absl::Mutex mu;
+    // Magazines indexed by ThreadCacheClass(chunk size).
+    std::vector<std::vector<CachedChunk>> magazines ABSL_GUARDED_BY(mu);
+    size_t cached_bytes ABSL_GUARDED_BY(mu) = 0;
+    std::vector<PendingAllocation> pending_allocations ABSL_GUARDED_BY(mu);
+    std::vector<void*> pending_frees ABSL_GUARDED_BY(mu);
+  };
+
+  // Number of pending allocations or frees after which a ThreadCache is
+  // flushed into the shared state.
+  static constexpr size_t kThreadCacheBatchSize = 32;
+  // Maximum number of chunks in one magazine.
+  static constexpr size_t kThreadCacheMagazineSize = 32;
+  static constexpr size_t kNumThreadCacheClasses =
+      kMaxThreadCachedBytes / kMinAllocationSize;
+  // Upper bound on the number of ThreadCaches.
+  static constexpr int kMaxThreadCaches = 64;
+
+  static size_t ThreadCacheClass(size_t rounded_bytes) {
+    return rounded_bytes / kMinAllocationSize - 1;
+  }
+
+  ThreadCache* CurrentThreadCache();
+
+  // Applies the pending allocations and frees of 'cache' under mutex_.
+  // Returns true if any chunk was returned to the bins.
+  bool FlushThreadCache(ThreadCache* cache, bool release_cached_chunks)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(cache->mu);
+
   // BFCAllocator allocates memory into a collection of disjoint
   // AllocationRegions.  Each AllocationRegion corresponds to one call to
   // SubAllocator::Alloc().  (Actually, if a subsequent call to
@@ -702,6 +788,10 @@ class BFCAllocator : public Allocator {
 
   void MarkFree(ChunkHandle h) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  // Marks the in-use chunk 'h' free and returns it to its free structure,
+  // coalescing it with its neighbors unless its free is timestamped.
+  void ReturnChunkToBins(ChunkHandle h) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   ChunkHandle TryToCoalesce(ChunkHandle h, bool ignore_freed_at)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
@@ -793,6 +883,11 @@ class BFCAllocator : public Allocator {
   // Stats.
   AllocatorStats stats_ ABSL_GUARDED_BY(mutex_);
 
+  // Per-thread caches, or nullptr if Options::thread_cache_bytes is zero.
+  std::unique_ptr<ThreadCache[]> thread_caches_;
+  // Power of two.
+  int num_thread_caches_ = 0;
+
 #ifdef TENSORFLOW_MEM_DEBUG
   int64_t action_counter_ ABSL_GUARDED_BY(mutex_);
 #define MEM_DEBUG_SIZE_HISTORY_SIZE 4096
@@ -33,12 +33,14 @@ limitations under the License.
 #include "absl/base/no_destructor.h"
 #include "absl/log/scoped_mock_log.h"
 #include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/mutex.h"
 #include "xla/tsl/framework/allocator.h"
 #include "xla/tsl/framework/scoped_allocation_trace.h"
 #include "xla/tsl/platform/env.h"
 #include "xla/tsl/platform/test.h"
 #include "xla/tsl/platform/test_benchmark.h"
 #include "xla/tsl/platform/threadpool.h"
+#include "xla/tsl/protobuf/bfc_memory_map.pb.h"
 
 namespace tsl {
 namespace {
@@ -724,6 +726,138 @@ TEST(BFCAllocatorTest, SpatialUnderContention) {
   EXPECT_EQ(failures.load(std::memory_order_relaxed), 0);
 }
 
+//===----------------------------------------------------------------------===//
+// Thread cache tests.
+//===----------------------------------------------------------------------===//
+
+TEST(BFCAllocatorTest, ThreadCacheReusesFreedChunk) {
+  BFCAllocator::Options opts;
+  opts.thread_cache_bytes = 1 << 20;
+  BFCAllocator alloc(std::make_unique<FakeSubAllocator>(),
+                     /*total_memory=*/16 << 20, /*name=*/"thread_cache", opts);
+
+  void* first = alloc.AllocateRaw(kAlignment, 1000);
+  ASSERT_NE(first, nullptr);
+  const int64_t first_id = alloc.AllocationId(first);
+  alloc.DeallocateRaw(first);
+
+  // GetStats flushes the pending free into the thread's magazine.
+  std::optional<AllocatorStats> stats = alloc.GetStats();
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_EQ(stats->bytes_in_use, 0);
+  EXPECT_EQ(stats->num_allocs, 1);
+
+  void* second = alloc.AllocateRaw(kAlignment, 900);
+  EXPECT_EQ(second, first);
+  EXPECT_EQ(alloc.RequestedSize(second), 900);
+  EXPECT_EQ(alloc.AllocatedSize(second), 1024);
+  EXPECT_GT(alloc.AllocationId(second), first_id);
+
+  stats = alloc.GetStats();
+  EXPECT_EQ(stats->bytes_in_use, 1024);
+  EXPECT_EQ(stats->peak_bytes_in_use, 1024);
+  EXPECT_EQ(stats->num_allocs, 2);
+  alloc.DeallocateRaw(second);
+}
+
+TEST(BFCAllocatorTest, ThreadCacheUnderContention) {
+  BFCAllocator::Options opts;
+  opts.thread_cache_bytes = 256 << 10;
+  BFCAllocator alloc(std::make_unique<FakeSubAllocator>(),
+                     /*total_memory=*/256 << 20, /*name=*/"thread_cache", opts);
+
+  constexpr int kNumThreads = 8;
+  constexpr int kItersPerThread = 2000;
+  constexpr int kLivePerThread = 16;
+  // The last size is too large for the thread cache.
+  constexpr std::array<size_t, 6> kSizes = {1,    300,   1024,
+                                            4096, 60000, 100000};
+
+  tsl::thread::ThreadPool threads(tsl::Env::Default(), "thread_cache",
+                                  kNumThreads);
+  absl::BlockingCounter counter(kNumThreads);
+  // Each thread frees half of its pointers on the next thread, so that chunks
+  // also move between caches.
+  std::array<absl::Mutex, kNumThreads> handoff_mu;
+  std::array<std::vector<void*>, kNumThreads> handoff;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.Schedule([&, t] {
+      std::mt19937 rng(t);
+      std::vector<void*> live;
+      for (int i = 0; i < kItersPerThread; ++i) {
+        void* ptr = alloc.AllocateRaw(kAlignment, kSizes[rng() % kSizes.size()]);
+        EXPECT_NE(ptr, nullptr);
+        EXPECT_TRUE(IsAligned(ptr, kAlignment));
+        live.push_back(ptr);
+        if (live.size() == kLivePerThread) {
+          for (int j = 0; j < kLivePerThread / 2; ++j) {
+            alloc.DeallocateRaw(live.back());
+            live.pop_back();
+          }
+          absl::MutexLock l(handoff_mu[(t + 1) % kNumThreads]);
+          handoff[(t + 1) % kNumThreads].insert(
+              handoff[(t + 1) % kNumThreads].end(), live.begin(), live.end());
+          live.clear();
+        }
+        std::vector<void*> mine;
+        {
+          absl::MutexLock l(handoff_mu[t]);
+          mine.swap(handoff[t]);
+        }
+        for (void* p : mine) {
+          alloc.DeallocateRaw(p);
+        }
+      }
+      for (void* p : live) {
+        alloc.DeallocateRaw(p);
+      }
+      counter.DecrementCount();
+    });
+  }
+  counter.Wait();
+  for (int t = 0; t < kNumThreads; ++t) {
+    for (void* p : handoff[t]) {
+      alloc.DeallocateRaw(p);
+    }
+  }
+
+  std::optional<AllocatorStats> stats = alloc.GetStats();
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_EQ(stats->bytes_in_use, 0);
+  EXPECT_EQ(stats->num_allocs, kNumThreads * kItersPerThread);
+
+  // The memory map returns cached chunks to the bins, so nothing is in use.
+  MemoryDump md = alloc.RecordMemoryMap();
+  EXPECT_EQ(md.stats().bytes_in_use(), 0);
+  for (const auto& chunk : md.chunk()) {
+    EXPECT_FALSE(chunk.in_use());
+  }
+}
+
+TEST(BFCAllocatorTest, ThreadCacheReleasedBeforeOom) {
+  BFCAllocator::Options opts;
+  opts.allow_growth = false;
+  opts.thread_cache_bytes = 1 << 20;
+  BFCAllocator alloc(std::make_unique<FakeSubAllocator>(),
+                     /*total_memory=*/1 << 20, /*name=*/"thread_cache", opts);
+
+  constexpr size_t kChunkBytes = 64 << 10;
+  std::vector<void*> ptrs;
+  for (int i = 0; i < (1 << 20) / kChunkBytes; ++i) {
+    ptrs.push_back(alloc.AllocateRaw(kAlignment, kChunkBytes));
+    ASSERT_NE(ptrs.back(), nullptr);
+  }
+  for (void* ptr : ptrs) {
+    alloc.DeallocateRaw(ptr);
+  }
+  // Move every chunk into a magazine.
+  alloc.GetStats();
+
+  void* whole = alloc.AllocateRaw(kAlignment, 1 << 20, *kLower);
+  EXPECT_NE(whole, nullptr);
+  alloc.DeallocateRaw(whole);
+}
+
 //===----------------------------------------------------------------------===//
 // Performance benchmarks.
 //===----------------------------------------------------------------------===//
@@ -801,13 +935,17 @@ BENCHMARK(BM_SpatialAllocBatchThenFree)->Arg(100)->Arg(1000);
 // Contention benchmarks.
 //===----------------------------------------------------------------------===//
 
+// Args: number of threads, and whether the per-thread cache is enabled.
 static void BM_AllocAndFreeUnderContention(benchmark::State& state) {
   size_t num_threads = state.range(0);
   static constexpr int kItersPerThread = 10000;
 
+  BFCAllocator::Options opts;
+  if (state.range(1) != 0) {
+    opts.thread_cache_bytes = 1 << 20;
+  }
   BFCAllocator alloc(std::make_unique<FakeSubAllocator>(),
-                     /*total_memory=*/256 << 20, /*name=*/"bench",
-                     BFCAllocator::Options{});
+                     /*total_memory=*/256 << 20, /*name=*/"bench", opts);
   tsl::thread::ThreadPool threads(tsl::Env::Default(), "bench", num_threads);
 
   for (auto _ : state) {
@@ -828,10 +966,7 @@ static void BM_AllocAndFreeUnderContention(benchmark::State& state) {
 
 BENCHMARK(BM_AllocAndFreeUnderContention)
     ->MeasureProcessCPUTime()
-    ->Arg(2)
-    ->Arg(4)
-    ->Arg(8)
-    ->Arg(16);
+    ->ArgsProduct({{1, 2, 4, 8, 16, 32, 64}, {0, 1}});
 
 }  // namespace
 }  // namespace tsl
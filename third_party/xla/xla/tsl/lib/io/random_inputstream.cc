@@ -76,18 +76,21 @@ absl::Status RandomAccessInputStream::SkipNBytes(int64_t bytes_to_skip) {
   if (bytes_to_skip < 0) {
     return absl::InvalidArgumentError("Can't skip a negative number of bytes");
   }
-  std::unique_ptr<char[]> scratch(new char[kMaxSkipSize]);
   // Try to read 1 bytes first, if we could complete the read then EOF is
   // not reached yet and we could return.
   if (bytes_to_skip > 0) {
+    char probe;
     absl::string_view data;
     absl::Status s = file_->Read(pos_ + bytes_to_skip - 1, data,
-                                 absl::MakeSpan(scratch.get(), 1));
+                                 absl::MakeSpan(&probe, 1));
     if ((s.ok() || absl::IsOutOfRange(s)) && data.size() == 1) {
       pos_ += bytes_to_skip;
       return absl::OkStatus();
     }
   }
+  // Only allocate the skip buffer when the probe above hit the end of file.
+  std::unique_ptr<char[]> scratch(
+      new char[std::min<int64_t>(kMaxSkipSize, bytes_to_skip)]);
   // Read kDefaultSkipSize at a time till bytes_to_skip.
   while (bytes_to_skip > 0) {
     int64_t bytes_to_read = std::min<int64_t>(kMaxSkipSize, bytes_to_skip);
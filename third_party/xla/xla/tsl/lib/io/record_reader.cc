@@ -26,6 +26,7 @@ limitations under the License.
 #include "absl/status/status.h"
 #include "absl/status/status_macros.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "xla/tsl/lib/hash/crc32c.h"
 #include "xla/tsl/lib/io/buffered_inputstream.h"
 #include "xla/tsl/lib/io/compression.h"
@@ -35,8 +36,12 @@ limitations under the License.
 #include "xla/tsl/lib/io/zlib_inputstream.h"
 #include "xla/tsl/platform/env.h"
 #include "xla/tsl/platform/errors.h"
+#include "tsl/platform/platform.h"
 #include "tsl/platform/raw_coding.h"
 #include "tsl/platform/tstring.h"
+#if !defined(IS_SLIM_BUILD) && !defined(IS_MOBILE_PLATFORM)
+#include "xla/tsl/lib/io/zstd/zstd_inputstream.h"
+#endif
 
 namespace tsl {
 namespace io {
@@ -59,6 +64,8 @@ RecordReaderOptions RecordReaderOptions::CreateRecordReaderOptions(
     options.zlib_options = io::ZlibCompressionOptions::GZIP();
   } else if (compression_type == compression::kSnappy) {
     options.compression_type = io::RecordReaderOptions::SNAPPY_COMPRESSION;
+  } else if (compression_type == compression::kZstd) {
+    options.compression_type = io::RecordReaderOptions::ZSTD_COMPRESSION;
   } else if (compression_type != compression::kNone) {
     LOG(ERROR) << "Unsupported compression_type:" << compression_type
                << ". No compression will be used.";
@@ -90,6 +97,27 @@ RecordReader::RecordReader(RandomAccessFile* file,
     input_stream_.reset(
         new SnappyInputStream(input_stream_.release(),
                               options.snappy_options.output_buffer_size, true));
+  } else if (options.compression_type ==
+             RecordReaderOptions::ZSTD_COMPRESSION) {
+#if defined(IS_MOBILE_PLATFORM)
+    LOG(FATAL) << "ZSTD compression is unsupported on mobile platforms.";
+#else
+    // Seeking to a record only decompresses the block containing it.
+    auto* zstd_input_stream =
+        new ZstdInputStream(input_stream_.release(), true);
+    input_stream_.reset(zstd_input_stream);
+    // With the index from the footer, the first seek does not have to walk
+    // the block headers either.
+    absl::string_view fname;
+    uint64_t file_size;
+    if (file->Name(&fname).ok() &&
+        Env::Default()->GetFileSize(std::string(fname), &file_size).ok()) {
+      absl::Status s = zstd_input_stream->LoadBlockIndex(file, file_size);
+      if (!s.ok()) {
+        VLOG(1) << "Reading " << fname << " without a zstd block index: " << s;
+      }
+    }
+#endif  // IS_MOBILE_PLATFORM
   } else if (options.compression_type == RecordReaderOptions::NONE) {
     // Nothing to do.
   } else {
@@ -18,6 +18,9 @@ limitations under the License.
 #include "absl/status/status_macros.h"
 #include "xla/tsl/lib/hash/crc32c.h"
 #include "xla/tsl/lib/io/compression.h"
+#if !defined(IS_SLIM_BUILD) && !defined(IS_MOBILE_PLATFORM)
+#include "xla/tsl/lib/io/zstd/zstd_outputbuffer.h"
+#endif  // !IS_SLIM_BUILD && !IS_MOBILE_PLATFORM
 #include "xla/tsl/platform/env.h"
 #include "tsl/platform/coding.h"
 
@@ -31,6 +34,10 @@ bool IsZlibCompressed(const RecordWriterOptions& options) {
 bool IsSnappyCompressed(const RecordWriterOptions& options) {
   return options.compression_type == RecordWriterOptions::SNAPPY_COMPRESSION;
 }
+
+bool IsZstdCompressed(const RecordWriterOptions& options) {
+  return options.compression_type == RecordWriterOptions::ZSTD_COMPRESSION;
+}
 }  // namespace
 
 RecordWriterOptions RecordWriterOptions::CreateRecordWriterOptions(
@@ -50,6 +57,8 @@ RecordWriterOptions RecordWriterOptions::CreateRecordWriterOptions(
     options.zlib_options = io::ZlibCompressionOptions::GZIP();
   } else if (compression_type == compression::kSnappy) {
     options.compression_type = io::RecordWriterOptions::SNAPPY_COMPRESSION;
+  } else if (compression_type == compression::kZstd) {
+    options.compression_type = io::RecordWriterOptions::ZSTD_COMPRESSION;
   } else if (compression_type != compression::kNone) {
     LOG(ERROR) << "Unsupported compression_type:" << compression_type
                << ". No compression will be used.";
@@ -79,6 +88,12 @@ RecordWriter::RecordWriter(WritableFile* dest,
     dest_ =
         new SnappyOutputBuffer(dest, options.snappy_options.input_buffer_size,
                                options.snappy_options.output_buffer_size);
+  } else if (IsZstdCompressed(options)) {
+#if defined(IS_MOBILE_PLATFORM)
+    LOG(FATAL) << "ZSTD compression is unsupported on mobile platforms.";
+#else
+    dest_ = new ZstdOutputBuffer(dest, options.zstd_options);
+#endif  // IS_MOBILE_PLATFORM
   } else if (options.compression_type == RecordWriterOptions::NONE) {
     // Nothing to do
   } else {
@@ -87,6 +102,15 @@ RecordWriter::RecordWriter(WritableFile* dest,
 #endif
 }
 
+absl::Status RecordWriter::ValidateOptions(const RecordWriterOptions& options) {
+#if !defined(IS_SLIM_BUILD) && !defined(IS_MOBILE_PLATFORM)
+  if (IsZstdCompressed(options)) {
+    return ZstdOutputBuffer::ValidateOptions(options.zstd_options);
+  }
+#endif
+  return absl::OkStatus();
+}
+
 RecordWriter::~RecordWriter() {
   if (dest_ != nullptr) {
     absl::Status s = Close();
@@ -138,7 +162,8 @@ absl::Status RecordWriter::WriteRecord(const absl::Cord& data) {
 
 absl::Status RecordWriter::Close() {
   if (dest_ == nullptr) return absl::OkStatus();
-  if (IsZlibCompressed(options_) || IsSnappyCompressed(options_)) {
+  if (IsZlibCompressed(options_) || IsSnappyCompressed(options_) ||
+      IsZstdCompressed(options_)) {
     absl::Status s = dest_->Close();
     delete dest_;
     dest_ = nullptr;
@@ -25,6 +25,7 @@ limitations under the License.
 #include "xla/tsl/lib/io/snappy/snappy_outputbuffer.h"
 #include "xla/tsl/lib/io/zlib_compression_options.h"
 #include "xla/tsl/lib/io/zlib_outputbuffer.h"
+#include "xla/tsl/lib/io/zstd/zstd_compression_options.h"
 #endif  // IS_SLIM_BUILD
 #include "xla/tsl/platform/macros.h"
 #include "xla/tsl/platform/types.h"
@@ -41,7 +42,8 @@ struct RecordWriterOptions {
   enum CompressionType {
     NONE = 0,
     ZLIB_COMPRESSION = 1,
-    SNAPPY_COMPRESSION = 2
+    SNAPPY_COMPRESSION = 2,
+    ZSTD_COMPRESSION = 3
   };
   CompressionType compression_type = NONE;
 
@@ -52,6 +54,7 @@ struct RecordWriterOptions {
   // Options specific to compression.
   io::ZlibCompressionOptions zlib_options;
   io::SnappyCompressionOptions snappy_options;
+  io::ZstdCompressionOptions zstd_options;
 #endif  // IS_SLIM_BUILD
 };
 
@@ -71,6 +74,11 @@ class RecordWriter {
   explicit RecordWriter(WritableFile* dest, const RecordWriterOptions& options =
                                                 RecordWriterOptions());
 
+  // Returns INVALID_ARGUMENT if `options` hold compression options that the
+  // constructor would reject by crashing. Callers that build the options from
+  // user input should check them first.
+  static absl::Status ValidateOptions(const RecordWriterOptions& options);
+
   // Calls Close() and logs if an error occurs.
   //
   // TODO(jhseu): Require that callers explicitly call Close() and remove the
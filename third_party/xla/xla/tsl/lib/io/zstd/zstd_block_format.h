@@ -0,0 +1,72 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_TSL_LIB_IO_ZSTD_ZSTD_BLOCK_FORMAT_H_
+#define XLA_TSL_LIB_IO_ZSTD_ZSTD_BLOCK_FORMAT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace tsl {
+namespace io {
+
+// Layout of a stream written by ZstdOutputBuffer:
+//
+//   stream      := block* index_block footer
+//   block       := fixed32 compressed_length
+//                  fixed32 uncompressed_length
+//                  byte    zstd_frame[compressed_length]
+//   index_block := fixed32 index_length
+//                  fixed32 kZstdIndexBlockMarker
+//                  handle  handles[index_length / kZstdBlockHandleSize]
+//   handle      := fixed64 offset
+//                  fixed64 uncompressed_offset
+//   footer      := fixed64 offset of index_block
+//                  fixed32 masked crc32c of handles
+//                  fixed32 kZstdFooterMagic
+//
+// Every zstd frame can be decompressed on its own, so a reader that knows the
+// uncompressed offset it wants only has to decompress the block containing
+// it. The index holds one handle per block followed by a sentinel handle that
+// points at the index block itself and carries the total uncompressed size.
+// Readers that know the file size load it from the footer, so that their
+// first seek goes straight to the right block. Readers that do not, or that
+// read a stream that was not closed, rebuild the same index lazily by walking
+// the block headers, which never requires decompressing a block.
+
+// Position of the start of a block in the compressed stream (`offset`) and in
+// the uncompressed data (`uncompressed_offset`).
+struct ZstdBlockHandle {
+  uint64_t offset = 0;
+  uint64_t uncompressed_offset = 0;
+};
+
+inline constexpr size_t kZstdBlockHeaderSize = 2 * sizeof(uint32_t);
+inline constexpr size_t kZstdBlockHandleSize = 2 * sizeof(uint64_t);
+inline constexpr size_t kZstdFooterSize =
+    sizeof(uint64_t) + 2 * sizeof(uint32_t);
+
+// Stored in the `uncompressed_length` slot of the index block header. Data
+// blocks never reach this size.
+inline constexpr uint32_t kZstdIndexBlockMarker = 0xffffffff;
+inline constexpr uint32_t kZstdFooterMagic = 0x5a53544b;  // "ZSTK"
+
+// Upper bound on the uncompressed size of a single block accepted by readers.
+inline constexpr uint32_t kZstdMaxBlockSize = 1u << 30;
+
+}  // namespace io
+}  // namespace tsl
+
+#endif  // XLA_TSL_LIB_IO_ZSTD_ZSTD_BLOCK_FORMAT_H_
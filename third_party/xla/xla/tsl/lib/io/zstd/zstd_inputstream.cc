@@ -0,0 +1,378 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/tsl/lib/io/zstd/zstd_inputstream.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/log/check.h"
+#include "absl/status/status.h"
+#include "absl/status/status_macros.h"
+#include "absl/strings/cord.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "xla/tsl/lib/hash/crc32c.h"
+#include "xla/tsl/lib/io/inputstream_interface.h"
+#include "xla/tsl/lib/io/zstd/zstd_block_format.h"
+#include "xla/tsl/platform/file_system.h"
+#include "tsl/platform/coding.h"
+#include "tsl/platform/tstring.h"
+
+// NOTE: The way zstd is packaged in TF, we cannot include it as <zstd.h>.
+#include "zstd.h"  // NOLINT(build/include)
+
+namespace tsl {
+namespace io {
+namespace {
+
+// Reads the block index from the footer of a closed stream occupying the first
+// `file_size` bytes of `file`. The returned index ends with a sentinel handle
+// whose `uncompressed_offset` is the total uncompressed size.
+absl::Status ReadBlockIndex(RandomAccessFile* file, uint64_t file_size,
+                            std::vector<ZstdBlockHandle>* index) {
+  if (file_size < kZstdBlockHeaderSize + kZstdFooterSize) {
+    return absl::DataLossError(
+        absl::StrCat("File of ", file_size,
+                     " bytes is too small to hold a zstd block index."));
+  }
+
+  char footer_scratch[kZstdFooterSize];
+  absl::string_view footer;
+  absl::Status s =
+      file->Read(file_size - kZstdFooterSize, footer,
+                 absl::MakeSpan(footer_scratch, kZstdFooterSize));
+  if (footer.size() != kZstdFooterSize) {
+    return s.ok() ? absl::DataLossError("Truncated zstd footer.") : s;
+  }
+  const uint64_t index_offset = core::DecodeFixed64(footer.data());
+  const uint32_t masked_crc =
+      core::DecodeFixed32(footer.data() + sizeof(uint64_t));
+  const uint32_t magic =
+      core::DecodeFixed32(footer.data() + sizeof(uint64_t) + sizeof(uint32_t));
+  if (magic != kZstdFooterMagic) {
+    return absl::DataLossError(
+        "Missing zstd block index footer. Was the writer closed?");
+  }
+  if (index_offset > file_size - kZstdFooterSize - kZstdBlockHeaderSize) {
+    return absl::DataLossError(
+        absl::StrCat("Invalid zstd block index offset ", index_offset));
+  }
+
+  const size_t index_block_size = file_size - kZstdFooterSize - index_offset;
+  std::unique_ptr<char[]> scratch(new char[index_block_size]);
+  absl::string_view index_block;
+  s = file->Read(index_offset, index_block,
+                 absl::MakeSpan(scratch.get(), index_block_size));
+  if (index_block.size() != index_block_size) {
+    return s.ok() ? absl::DataLossError("Truncated zstd block index.") : s;
+  }
+  const size_t handles_size = index_block_size - kZstdBlockHeaderSize;
+  if (core::DecodeFixed32(index_block.data()) != handles_size ||
+      core::DecodeFixed32(index_block.data() + sizeof(uint32_t)) !=
+          kZstdIndexBlockMarker ||
+      handles_size % kZstdBlockHandleSize != 0) {
+    return absl::DataLossError("Corrupted zstd block index header.");
+  }
+  const char* handles = index_block.data() + kZstdBlockHeaderSize;
+  if (crc32c::Unmask(masked_crc) != crc32c::Value(handles, handles_size)) {
+    return absl::DataLossError("Corrupted zstd block index.");
+  }
+
+  std::vector<ZstdBlockHandle> result(handles_size / kZstdBlockHandleSize);
+  for (ZstdBlockHandle& handle : result) {
+    handle.offset = core::DecodeFixed64(handles);
+    handle.uncompressed_offset =
+        core::DecodeFixed64(handles + sizeof(uint64_t));
+    handles += kZstdBlockHandleSize;
+  }
+  if (result.empty() || result.back().offset != index_offset) {
+    return absl::DataLossError("zstd block index is missing its sentinel.");
+  }
+  if (result[0].offset != 0 || result[0].uncompressed_offset != 0) {
+    return absl::DataLossError(
+        "zstd block index does not start with the first block.");
+  }
+  for (size_t i = 1; i < result.size(); ++i) {
+    if (result[i].offset <= result[i - 1].offset ||
+        result[i].uncompressed_offset < result[i - 1].uncompressed_offset) {
+      return absl::DataLossError(
+          absl::StrCat("zstd block index is not sorted at handle ", i));
+    }
+  }
+  *index = std::move(result);
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+ZstdInputStream::ZstdInputStream(InputStreamInterface* input_stream,
+                                 bool owns_input_stream)
+    : input_stream_(input_stream),
+      owns_input_stream_(owns_input_stream),
+      dctx_(ZSTD_createDCtx()) {
+  CHECK(dctx_ != nullptr) << "Failed to create zstd decompression context.";
+  index_.push_back({0, 0});
+}
+
+ZstdInputStream::ZstdInputStream(InputStreamInterface* input_stream)
+    : ZstdInputStream(input_stream, false) {}
+
+ZstdInputStream::~ZstdInputStream() {
+  ZSTD_freeDCtx(dctx_);
+  if (owns_input_stream_) {
+    delete input_stream_;
+  }
+}
+
+absl::Status ZstdInputStream::ReadNBytes(int64_t bytes_to_read,
+                                         tstring* result) {
+  if (bytes_to_read < 0) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Can't read a negative number of bytes: ", bytes_to_read));
+  }
+  result->clear();
+  result->resize_uninitialized(bytes_to_read);
+
+  char* result_ptr = result->mdata();
+  size_t remaining = bytes_to_read;
+  while (true) {
+    const size_t bytes_read = ReadBytesFromCache(remaining, result_ptr);
+    result_ptr += bytes_read;
+    remaining -= bytes_read;
+    if (remaining == 0) {
+      break;
+    }
+    absl::Status s = Inflate();
+    if (!s.ok()) {
+      result->resize(bytes_to_read - remaining);
+      return s;
+    }
+  }
+  return absl::OkStatus();
+}
+
+#if defined(TF_CORD_SUPPORT)
+absl::Status ZstdInputStream::ReadNBytes(int64_t bytes_to_read,
+                                         absl::Cord* result) {
+  tstring buf;
+  absl::Status s = ReadNBytes(bytes_to_read, &buf);
+  result->Clear();
+  result->Append(absl::string_view(buf.data(), buf.size()));
+  return s;
+}
+#endif
+
+absl::Status ZstdInputStream::SkipNBytes(int64_t bytes_to_skip) {
+  if (bytes_to_skip < 0) {
+    return absl::InvalidArgumentError("Can't skip a negative number of bytes");
+  }
+  if (static_cast<uint64_t>(bytes_to_skip) <= avail_out_) {
+    next_out_ += bytes_to_skip;
+    avail_out_ -= bytes_to_skip;
+    bytes_read_ += bytes_to_skip;
+    return absl::OkStatus();
+  }
+  return Seek(bytes_read_ + bytes_to_skip);
+}
+
+int64_t ZstdInputStream::Tell() const { return bytes_read_; }
+
+absl::Status ZstdInputStream::Reset() {
+  ABSL_RETURN_IF_ERROR(input_stream_->Reset());
+  offset_ = 0;
+  bytes_read_ = 0;
+  eof_ = false;
+  next_out_ = 0;
+  avail_out_ = 0;
+  return absl::OkStatus();
+}
+
+absl::Status ZstdInputStream::LoadBlockIndex(RandomAccessFile* file,
+                                             uint64_t file_size) {
+  std::vector<ZstdBlockHandle> index;
+  ABSL_RETURN_IF_ERROR(ReadBlockIndex(file, file_size, &index));
+  index_ = std::move(index);
+  index_complete_ = true;
+  return absl::OkStatus();
+}
+
+absl::Status ZstdInputStream::PositionInputStream(uint64_t offset) {
+  const int64_t curr_pos = input_stream_->Tell();
+  const int64_t desired_pos = static_cast<int64_t>(offset);
+  if (curr_pos == desired_pos) {
+    return absl::OkStatus();
+  }
+  if (curr_pos < 0 || curr_pos > desired_pos) {
+    ABSL_RETURN_IF_ERROR(input_stream_->Reset());
+    return input_stream_->SkipNBytes(desired_pos);
+  }
+  return input_stream_->SkipNBytes(desired_pos - curr_pos);
+}
+
+absl::Status ZstdInputStream::ReadBlockHeader(uint32_t* compressed_length,
+                                              uint32_t* uncompressed_length) {
+  if (eof_) {
+    return absl::OutOfRangeError("eof");
+  }
+  ABSL_RETURN_IF_ERROR(PositionInputStream(offset_));
+
+  tstring header;
+  absl::Status s = input_stream_->ReadNBytes(kZstdBlockHeaderSize, &header);
+  if (!s.ok()) {
+    if (absl::IsOutOfRange(s) && !header.empty()) {
+      return absl::DataLossError(
+          absl::StrCat("Truncated zstd block header at offset ", offset_));
+    }
+    return s;
+  }
+  *compressed_length = core::DecodeFixed32(header.data());
+  *uncompressed_length = core::DecodeFixed32(header.data() + sizeof(uint32_t));
+  if (*uncompressed_length == kZstdIndexBlockMarker) {
+    // Every block before this one has been recorded, so the index now ends
+    // with the sentinel handle.
+    eof_ = true;
+    index_complete_ = true;
+    return absl::OutOfRangeError("eof");
+  }
+  if (*uncompressed_length > kZstdMaxBlockSize) {
+    return absl::DataLossError(
+        absl::StrCat("Corrupted zstd block header at offset ", offset_));
+  }
+  RecordNextBlock(offset_ + kZstdBlockHeaderSize + *compressed_length,
+                  bytes_read_ + *uncompressed_length);
+  return absl::OkStatus();
+}
+
+absl::Status ZstdInputStream::InflateBlock(uint32_t compressed_length,
+                                           uint32_t uncompressed_length) {
+  DCHECK_EQ(avail_out_, 0);
+  tstring compressed_block;
+  absl::Status s =
+      input_stream_->ReadNBytes(compressed_length, &compressed_block);
+  if (absl::IsOutOfRange(s)) {
+    return absl::DataLossError(
+        absl::StrCat("Failed to read ", compressed_length,
+                     " bytes from file. Possible data corruption."));
+  }
+  ABSL_RETURN_IF_ERROR(s);
+
+  if (output_buffer_.size() < uncompressed_length) {
+    output_buffer_.resize(uncompressed_length);
+  }
+  const size_t decompressed_length =
+      ZSTD_decompressDCtx(dctx_, output_buffer_.data(), uncompressed_length,
+                          compressed_block.data(), compressed_length);
+  if (ZSTD_isError(decompressed_length)) {
+    return absl::DataLossError(
+        absl::StrCat("zstd decompression failed at offset ", offset_, ": ",
+                     ZSTD_getErrorName(decompressed_length)));
+  }
+  if (decompressed_length != uncompressed_length) {
+    return absl::DataLossError(absl::StrCat(
+        "zstd block at offset ", offset_, " decompressed to ",
+        decompressed_length, " bytes, expected ", uncompressed_length));
+  }
+  offset_ += kZstdBlockHeaderSize + compressed_length;
+  next_out_ = 0;
+  avail_out_ = uncompressed_length;
+  return absl::OkStatus();
+}
+
+absl::Status ZstdInputStream::Inflate() {
+  uint32_t compressed_length;
+  uint32_t uncompressed_length;
+  ABSL_RETURN_IF_ERROR(
+      ReadBlockHeader(&compressed_length, &uncompressed_length));
+  return InflateBlock(compressed_length, uncompressed_length);
+}
+
+absl::Status ZstdInputStream::Seek(uint64_t target) {
+  next_out_ = 0;
+  avail_out_ = 0;
+  eof_ = false;
+
+  // Start from the last known block that begins at or before `target`.
+  auto it = std::upper_bound(
+      index_.begin(), index_.end(), target,
+      [](uint64_t value, const ZstdBlockHandle& handle) {
+        return value < handle.uncompressed_offset;
+      });
+  DCHECK(it != index_.begin());
+  --it;
+  offset_ = it->offset;
+  bytes_read_ = it->uncompressed_offset;
+  if (index_complete_ && it + 1 == index_.end()) {
+    eof_ = true;
+    if (target == static_cast<uint64_t>(bytes_read_)) {
+      return absl::OkStatus();
+    }
+    return absl::OutOfRangeError("reached end of stream");
+  }
+
+  while (static_cast<uint64_t>(bytes_read_) < target) {
+    uint32_t compressed_length;
+    uint32_t uncompressed_length;
+    ABSL_RETURN_IF_ERROR(
+        ReadBlockHeader(&compressed_length, &uncompressed_length));
+    if (target < static_cast<uint64_t>(bytes_read_) + uncompressed_length) {
+      ABSL_RETURN_IF_ERROR(
+          InflateBlock(compressed_length, uncompressed_length));
+      const size_t bytes_to_skip = target - bytes_read_;
+      next_out_ += bytes_to_skip;
+      avail_out_ -= bytes_to_skip;
+      bytes_read_ += bytes_to_skip;
+      return absl::OkStatus();
+    }
+    absl::Status s = input_stream_->SkipNBytes(compressed_length);
+    if (absl::IsOutOfRange(s)) {
+      return absl::DataLossError(
+          absl::StrCat("Truncated zstd block at offset ", offset_));
+    }
+    ABSL_RETURN_IF_ERROR(s);
+    offset_ += kZstdBlockHeaderSize + compressed_length;
+    bytes_read_ += uncompressed_length;
+  }
+  return absl::OkStatus();
+}
+
+void ZstdInputStream::RecordNextBlock(uint64_t offset,
+                                      uint64_t uncompressed_offset) {
+  if (!index_complete_ && offset > index_.back().offset) {
+    index_.push_back({offset, uncompressed_offset});
+  }
+}
+
+size_t ZstdInputStream::ReadBytesFromCache(size_t bytes_to_read,
+                                           char* result) {
+  const size_t can_read_bytes = std::min(bytes_to_read, avail_out_);
+  if (can_read_bytes > 0) {
+    memcpy(result, output_buffer_.data() + next_out_, can_read_bytes);
+    next_out_ += can_read_bytes;
+    avail_out_ -= can_read_bytes;
+  }
+  bytes_read_ += can_read_bytes;
+  return can_read_bytes;
+}
+
+}  // namespace io
+}  // namespace tsl
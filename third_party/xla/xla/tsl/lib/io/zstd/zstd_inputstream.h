@@ -0,0 +1,147 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_TSL_LIB_IO_ZSTD_ZSTD_INPUTSTREAM_H_
+#define XLA_TSL_LIB_IO_ZSTD_ZSTD_INPUTSTREAM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "xla/tsl/lib/io/inputstream_interface.h"
+#include "xla/tsl/lib/io/zstd/zstd_block_format.h"
+#include "xla/tsl/platform/file_system.h"
+
+typedef struct ZSTD_DCtx_s ZSTD_DCtx;
+
+namespace tsl {
+namespace io {
+
+// Reads a stream written by ZstdOutputBuffer.
+//
+// Unlike the other compressed input streams, `SkipNBytes()` does not
+// decompress the data it skips over: it uses the block index to reposition the
+// underlying stream at the block containing the target offset, so only that
+// block is decompressed. The index is either loaded from the footer of the
+// file with `LoadBlockIndex()`, or discovered from the block headers as the
+// stream is read or skipped, e.g. for a file that is still being written. The
+// index survives `Reset()`, so rewinding and skipping forward (as RecordReader
+// does for backward seeks) does not reread any block header.
+class ZstdInputStream : public InputStreamInterface {
+ public:
+  // Creates a ZstdInputStream for `input_stream`, which must be positioned at
+  // the beginning of the compressed stream.
+  //
+  // Takes ownership of `input_stream` iff `owns_input_stream` is true.
+  ZstdInputStream(InputStreamInterface* input_stream, bool owns_input_stream);
+
+  // Equivalent to the previous constructor with owns_input_stream = false.
+  explicit ZstdInputStream(InputStreamInterface* input_stream);
+
+  ~ZstdInputStream() override;
+
+  // Reads bytes_to_read bytes into *result, overwriting *result.
+  //
+  // Return Status codes:
+  // OK:           If successful.
+  // OUT_OF_RANGE: If there are not enough bytes to read before
+  //               the end of the stream. *result holds the bytes that were
+  //               available.
+  // DATA_LOSS:    If a block is truncated or fails to decompress.
+  // others:       If reading from stream failed.
+  absl::Status ReadNBytes(int64_t bytes_to_read, tstring* result) override;
+
+#if defined(TF_CORD_SUPPORT)
+  absl::Status ReadNBytes(int64_t bytes_to_read, absl::Cord* result) override;
+#endif
+
+  // Skips `bytes_to_skip` uncompressed bytes, decompressing at most the block
+  // that contains the new position.
+  absl::Status SkipNBytes(int64_t bytes_to_skip) override;
+
+  int64_t Tell() const override;
+
+  absl::Status Reset() override;
+
+  // Loads the block index from the footer of the closed stream occupying the
+  // first `file_size` bytes of `file`, which must be the file the stream reads
+  // from. Returns DATA_LOSS, and keeps discovering blocks from their headers,
+  // if the file has no valid footer.
+  absl::Status LoadBlockIndex(RandomAccessFile* file, uint64_t file_size);
+
+ private:
+  // Moves the underlying stream to `offset`, rewinding it if needed.
+  absl::Status PositionInputStream(uint64_t offset);
+
+  // Reads the header of the block at the current position. Returns
+  // OUT_OF_RANGE at the end of the data blocks.
+  absl::Status ReadBlockHeader(uint32_t* compressed_length,
+                               uint32_t* uncompressed_length);
+
+  // Reads and decompresses the payload of the block whose header was just
+  // read.
+  absl::Status InflateBlock(uint32_t compressed_length,
+                            uint32_t uncompressed_length);
+
+  // Decompresses the next block into `output_buffer_`.
+  absl::Status Inflate();
+
+  // Positions the stream at uncompressed offset `target`.
+  absl::Status Seek(uint64_t target);
+
+  // Records the handle of the block following the one that was just read, so
+  // that later seeks can jump past it.
+  void RecordNextBlock(uint64_t offset, uint64_t uncompressed_offset);
+
+  // Attempt to read `bytes_to_read` from the decompressed data cache. Returns
+  // the actual number of bytes read.
+  size_t ReadBytesFromCache(size_t bytes_to_read, char* result);
+
+  InputStreamInterface* input_stream_;
+  const bool owns_input_stream_;
+  ZSTD_DCtx* dctx_;
+
+  // Position of `input_stream_` relative to the start of the compressed
+  // stream.
+  uint64_t offset_ = 0;
+
+  // Specifies the number of decompressed bytes currently read.
+  int64_t bytes_read_ = 0;
+
+  // Set once the end of the data blocks has been reached.
+  bool eof_ = false;
+
+  // Holds the most recently decompressed block. The unread part starts at
+  // `next_out_` and is `avail_out_` bytes long.
+  std::string output_buffer_;
+  size_t next_out_ = 0;
+  size_t avail_out_ = 0;
+
+  // Known block handles, sorted by offset. Always starts with the handle of
+  // the first block. When `index_complete_` is true the last handle is the
+  // sentinel marking the end of the data.
+  std::vector<ZstdBlockHandle> index_;
+  bool index_complete_ = false;
+
+  ZstdInputStream(const ZstdInputStream&) = delete;
+  void operator=(const ZstdInputStream&) = delete;
+};
+
+}  // namespace io
+}  // namespace tsl
+
+#endif  // XLA_TSL_LIB_IO_ZSTD_ZSTD_INPUTSTREAM_H_
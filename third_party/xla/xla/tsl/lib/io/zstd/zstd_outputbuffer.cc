@@ -0,0 +1,221 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "xla/tsl/lib/io/zstd/zstd_outputbuffer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "absl/log/check.h"
+#include "absl/log/log.h"
+#include "absl/status/status.h"
+#include "absl/status/status_macros.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "xla/tsl/lib/hash/crc32c.h"
+#include "xla/tsl/lib/io/zstd/zstd_block_format.h"
+#include "tsl/platform/coding.h"
+
+// NOTE: The way zstd is packaged in TF, we cannot include it as <zstd.h>.
+#include "zstd.h"  // NOLINT(build/include)
+
+namespace tsl {
+namespace io {
+namespace {
+
+// Returns the block size of `options`, which are checked before any buffer is
+// sized from them.
+size_t CheckedBlockSize(const ZstdCompressionOptions& options) {
+  CHECK_OK(ZstdOutputBuffer::ValidateOptions(options));
+  return options.block_size;
+}
+
+}  // namespace
+
+absl::Status ZstdOutputBuffer::ValidateOptions(
+    const ZstdCompressionOptions& options) {
+  if (options.block_size <= 0 || options.block_size >= kZstdMaxBlockSize) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("zstd block_size must be in (0, ", kZstdMaxBlockSize,
+                     "), got ", options.block_size));
+  }
+  return absl::OkStatus();
+}
+
+ZstdOutputBuffer::ZstdOutputBuffer(WritableFile* file,
+                                   const ZstdCompressionOptions& options)
+    : file_(file),
+      options_(options),
+      cctx_(ZSTD_createCCtx()),
+      input_buffer_capacity_(CheckedBlockSize(options)),
+      output_buffer_capacity_(kZstdBlockHeaderSize +
+                              ZSTD_compressBound(input_buffer_capacity_)) {
+  input_buffer_.reset(new char[input_buffer_capacity_]);
+  output_buffer_.reset(new char[output_buffer_capacity_]);
+  CHECK(cctx_ != nullptr) << "Failed to create zstd compression context.";
+  ZSTD_CCtx_setParameter(cctx_, ZSTD_c_compressionLevel,
+                         options.compression_level);
+  // Lets readers detect corrupted blocks even when the payload is not covered
+  // by another checksum.
+  ZSTD_CCtx_setParameter(cctx_, ZSTD_c_checksumFlag, 1);
+}
+
+ZstdOutputBuffer::~ZstdOutputBuffer() {
+  if (avail_in_ > 0) {
+    LOG(WARNING) << "There is still data in the input buffer. "
+                 << "Possible data loss has occurred.";
+  }
+  ZSTD_freeCCtx(cctx_);
+}
+
+absl::Status ZstdOutputBuffer::Append(absl::string_view data) {
+  if (closed_) {
+    return absl::FailedPreconditionError(
+        "Append() called on a closed ZstdOutputBuffer");
+  }
+  while (!data.empty()) {
+    // Compress full blocks straight out of `data` when nothing is buffered,
+    // to avoid copying large records through `input_buffer_`.
+    if (avail_in_ == 0 && data.size() >= input_buffer_capacity_) {
+      ABSL_RETURN_IF_ERROR(
+          CompressBlock(data.substr(0, input_buffer_capacity_)));
+      data.remove_prefix(input_buffer_capacity_);
+      continue;
+    }
+    const size_t bytes_to_copy =
+        std::min(data.size(), input_buffer_capacity_ - avail_in_);
+    memcpy(input_buffer_.get() + avail_in_, data.data(), bytes_to_copy);
+    avail_in_ += bytes_to_copy;
+    data.remove_prefix(bytes_to_copy);
+    if (avail_in_ == input_buffer_capacity_) {
+      ABSL_RETURN_IF_ERROR(CompressBuffered());
+    }
+  }
+  return absl::OkStatus();
+}
+
+#if defined(TF_CORD_SUPPORT)
+absl::Status ZstdOutputBuffer::Append(const absl::Cord& cord) {
+  for (absl::string_view fragment : cord.Chunks()) {
+    ABSL_RETURN_IF_ERROR(Append(fragment));
+  }
+  return absl::OkStatus();
+}
+#endif
+
+absl::Status ZstdOutputBuffer::Close() {
+  if (closed_) {
+    return absl::FailedPreconditionError(
+        "Close() called on a closed ZstdOutputBuffer");
+  }
+  ABSL_RETURN_IF_ERROR(CompressBuffered());
+  ABSL_RETURN_IF_ERROR(WriteIndex());
+  closed_ = true;
+  // Given that we do not own `file`, we don't close it.
+  return file_->Flush();
+}
+
+absl::Status ZstdOutputBuffer::Name(absl::string_view* result) const {
+  return file_->Name(result);
+}
+
+absl::Status ZstdOutputBuffer::Sync() {
+  ABSL_RETURN_IF_ERROR(Flush());
+  return file_->Sync();
+}
+
+absl::Status ZstdOutputBuffer::Tell(int64_t* position) {
+  return file_->Tell(position);
+}
+
+absl::Status ZstdOutputBuffer::Flush() {
+  if (closed_) {
+    return absl::FailedPreconditionError(
+        "Flush() called on a closed ZstdOutputBuffer");
+  }
+  ABSL_RETURN_IF_ERROR(CompressBuffered());
+  return file_->Flush();
+}
+
+absl::Status ZstdOutputBuffer::CompressBuffered() {
+  if (avail_in_ == 0) {
+    return absl::OkStatus();
+  }
+  ABSL_RETURN_IF_ERROR(
+      CompressBlock(absl::string_view(input_buffer_.get(), avail_in_)));
+  avail_in_ = 0;
+  return absl::OkStatus();
+}
+
+absl::Status ZstdOutputBuffer::CompressBlock(absl::string_view data) {
+  DCHECK_LE(data.size(), input_buffer_capacity_);
+  char* header = output_buffer_.get();
+  const size_t compressed_length = ZSTD_compress2(
+      cctx_, header + kZstdBlockHeaderSize,
+      output_buffer_capacity_ - kZstdBlockHeaderSize, data.data(),
+      data.size());
+  if (ZSTD_isError(compressed_length)) {
+    return absl::InternalError(absl::StrCat(
+        "zstd compression failed: ", ZSTD_getErrorName(compressed_length)));
+  }
+  core::EncodeFixed32(header, static_cast<uint32_t>(compressed_length));
+  core::EncodeFixed32(header + sizeof(uint32_t),
+                      static_cast<uint32_t>(data.size()));
+
+  const size_t block_length = kZstdBlockHeaderSize + compressed_length;
+  ABSL_RETURN_IF_ERROR(file_->Append(absl::string_view(header, block_length)));
+  index_.push_back({offset_, uncompressed_offset_});
+  offset_ += block_length;
+  uncompressed_offset_ += data.size();
+  return absl::OkStatus();
+}
+
+absl::Status ZstdOutputBuffer::WriteIndex() {
+  // The sentinel handle marks the end of the data blocks.
+  index_.push_back({offset_, uncompressed_offset_});
+
+  std::string index_block(
+      kZstdBlockHeaderSize + index_.size() * kZstdBlockHandleSize, '\0');
+  char* p = index_block.data();
+  core::EncodeFixed32(p, index_.size() * kZstdBlockHandleSize);
+  core::EncodeFixed32(p + sizeof(uint32_t), kZstdIndexBlockMarker);
+  p += kZstdBlockHeaderSize;
+  for (const ZstdBlockHandle& handle : index_) {
+    core::EncodeFixed64(p, handle.offset);
+    core::EncodeFixed64(p + sizeof(uint64_t), handle.uncompressed_offset);
+    p += kZstdBlockHandleSize;
+  }
+
+  char footer[kZstdFooterSize];
+  core::EncodeFixed64(footer, offset_);
+  core::EncodeFixed32(
+      footer + sizeof(uint64_t),
+      crc32c::Mask(crc32c::Value(index_block.data() + kZstdBlockHeaderSize,
+                                 index_block.size() - kZstdBlockHeaderSize)));
+  core::EncodeFixed32(footer + sizeof(uint64_t) + sizeof(uint32_t),
+                      kZstdFooterMagic);
+
+  ABSL_RETURN_IF_ERROR(file_->Append(index_block));
+  ABSL_RETURN_IF_ERROR(
+      file_->Append(absl::string_view(footer, kZstdFooterSize)));
+  offset_ += index_block.size() + kZstdFooterSize;
+  return absl::OkStatus();
+}
+
+}  // namespace io
+}  // namespace tsl
@@ -0,0 +1,125 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef XLA_TSL_LIB_IO_ZSTD_ZSTD_OUTPUTBUFFER_H_
+#define XLA_TSL_LIB_IO_ZSTD_ZSTD_OUTPUTBUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "xla/tsl/lib/io/zstd/zstd_block_format.h"
+#include "xla/tsl/lib/io/zstd/zstd_compression_options.h"
+#include "xla/tsl/platform/env.h"
+#include "xla/tsl/platform/macros.h"
+#include "xla/tsl/platform/types.h"
+#include "tsl/platform/platform.h"
+
+typedef struct ZSTD_CCtx_s ZSTD_CCtx;
+
+namespace tsl {
+namespace io {
+
+// Compresses input data using zstd (https://github.com/facebook/zstd) and
+// writes it to `file` as a sequence of independently decompressable blocks
+// followed by a block index. See zstd_block_format.h for the layout.
+//
+// Input is buffered until `options.block_size` bytes are available, at which
+// point they are compressed into one block. `Flush()` emits a (possibly short)
+// block for any buffered input. `Close()` additionally writes the block index
+// and footer; a stream that was never closed can still be read sequentially
+// but has no index.
+class ZstdOutputBuffer : public WritableFile {
+ public:
+  // Does not take ownership of `file`. Offsets recorded in the block index are
+  // relative to the position of `file` when the buffer is created. `options`
+  // must pass `ValidateOptions()`.
+  ZstdOutputBuffer(WritableFile* file, const ZstdCompressionOptions& options);
+
+  // Returns INVALID_ARGUMENT if `options` cannot be used to create a
+  // ZstdOutputBuffer, e.g. because they come from a user.
+  static absl::Status ValidateOptions(const ZstdCompressionOptions& options);
+
+  // Per convention, the dtor does not call Flush() or Close(). We expect the
+  // caller to call those manually when done.
+  ~ZstdOutputBuffer() override;
+
+  // Adds `data` to the compression pipeline.
+  absl::Status Append(absl::string_view data) override;
+
+#if defined(TF_CORD_SUPPORT)
+  absl::Status Append(const absl::Cord& cord) override;
+#endif
+
+  // Compresses any buffered input and writes the block index and footer.
+  //
+  // After calling this, any further calls to `Append()`, `Flush()` or
+  // `Close()` will fail.
+  absl::Status Close() override;
+
+  // Returns the name of the underlying file.
+  absl::Status Name(absl::string_view* result) const override;
+
+  // Compresses any buffered input, writes it to file and syncs it.
+  absl::Status Sync() override;
+
+  // Returns the write position in the underlying file. The position does not
+  // reflect buffered, un-flushed data.
+  absl::Status Tell(int64_t* position) override;
+
+  // Compresses any buffered input into a block and flushes `file`.
+  absl::Status Flush() override;
+
+ private:
+  // Compresses the buffered input, if any, into a single block.
+  absl::Status CompressBuffered();
+
+  // Compresses `data` into a single block and appends it to `file_`.
+  absl::Status CompressBlock(absl::string_view data);
+
+  // Appends the block index and footer to `file_`.
+  absl::Status WriteIndex();
+
+  WritableFile* file_;  // Not owned
+  const ZstdCompressionOptions options_;
+  ZSTD_CCtx* cctx_;
+  bool closed_ = false;
+
+  // Uncompressed input waiting to be compressed.
+  std::unique_ptr<char[]> input_buffer_;
+  const size_t input_buffer_capacity_;
+  size_t avail_in_ = 0;
+
+  // Scratch space for one block header plus its compressed payload.
+  std::unique_ptr<char[]> output_buffer_;
+  const size_t output_buffer_capacity_;
+
+  // Number of compressed and uncompressed bytes emitted so far.
+  uint64_t offset_ = 0;
+  uint64_t uncompressed_offset_ = 0;
+
+  std::vector<ZstdBlockHandle> index_;
+
+  ZstdOutputBuffer(const ZstdOutputBuffer&) = delete;
+  void operator=(const ZstdOutputBuffer&) = delete;
+};
+
+}  // namespace io
+}  // namespace tsl
+
+#endif  // XLA_TSL_LIB_IO_ZSTD_ZSTD_OUTPUTBUFFER_H_
@@ -0,0 +1,248 @@
+/* Copyright 2026 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "xla/tsl/lib/core/status_test_util.h"
+#include "xla/tsl/lib/io/random_inputstream.h"
+#include "xla/tsl/lib/io/record_reader.h"
+#include "xla/tsl/lib/io/record_writer.h"
+#include "xla/tsl/lib/io/zstd/zstd_block_format.h"
+#include "xla/tsl/lib/io/zstd/zstd_compression_options.h"
+#include "xla/tsl/lib/io/zstd/zstd_inputstream.h"
+#include "xla/tsl/lib/io/zstd/zstd_outputbuffer.h"
+#include "xla/tsl/platform/env.h"
+#include "xla/tsl/platform/file_system.h"
+#include "xla/tsl/platform/test.h"
+#include "tsl/platform/coding.h"
+#include "tsl/platform/tstring.h"
+
+namespace tsl {
+namespace io {
+namespace {
+
+std::string GenTestString(int length) {
+  std::string result;
+  result.reserve(length);
+  for (int i = 0; result.size() < static_cast<size_t>(length); ++i) {
+    absl::StrAppend(&result, i % 1000, ",");
+  }
+  result.resize(length);
+  return result;
+}
+
+// Writes `data` in chunks of `write_size` bytes and returns the file name.
+std::string WriteCompressed(const std::string& data, size_t write_size,
+                            const ZstdCompressionOptions& options,
+                            bool close = true) {
+  Env* env = Env::Default();
+  std::string fname = testing::TmpDir() + "/zstd_buffers_test";
+  std::unique_ptr<WritableFile> file_writer;
+  TF_CHECK_OK(env->NewWritableFile(fname, &file_writer));
+  ZstdOutputBuffer out(file_writer.get(), options);
+  for (size_t pos = 0; pos < data.size(); pos += write_size) {
+    TF_CHECK_OK(out.Append(absl::string_view(data).substr(pos, write_size)));
+  }
+  if (close) {
+    TF_CHECK_OK(out.Close());
+  } else {
+    TF_CHECK_OK(out.Flush());
+  }
+  TF_CHECK_OK(file_writer->Close());
+  return fname;
+}
+
+ZstdCompressionOptions SmallBlockOptions() {
+  ZstdCompressionOptions options;
+  options.block_size = 1000;
+  return options;
+}
+
+TEST(ZstdBuffers, ReadWrite) {
+  for (size_t write_size : {1, 17, 999, 1000, 1001, 4096}) {
+    const std::string data = GenTestString(20000);
+    std::string fname = WriteCompressed(data, write_size, SmallBlockOptions());
+
+    std::unique_ptr<RandomAccessFile> file_reader;
+    TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(fname, &file_reader));
+    ZstdInputStream in(new RandomAccessInputStream(file_reader.get()),
+                       /*owns_input_stream=*/true);
+    tstring result;
+    TF_ASSERT_OK(in.ReadNBytes(data.size(), &result));
+    EXPECT_EQ(result, data) << write_size;
+    EXPECT_EQ(in.Tell(), static_cast<int64_t>(data.size()));
+    EXPECT_TRUE(absl::IsOutOfRange(in.ReadNBytes(1, &result)));
+    EXPECT_TRUE(result.empty());
+  }
+}
+
+TEST(ZstdBuffers, ReadPastEndReturnsPartialData) {
+  const std::string data = GenTestString(2500);
+  std::string fname = WriteCompressed(data, 100, SmallBlockOptions());
+
+  std::unique_ptr<RandomAccessFile> file_reader;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(fname, &file_reader));
+  ZstdInputStream in(new RandomAccessInputStream(file_reader.get()), true);
+  TF_ASSERT_OK(in.SkipNBytes(2000));
+  tstring result;
+  EXPECT_TRUE(absl::IsOutOfRange(in.ReadNBytes(1000, &result)));
+  EXPECT_EQ(result, data.substr(2000));
+}
+
+TEST(ZstdBuffers, SkipAndRewind) {
+  const std::string data = GenTestString(20000);
+  std::string fname = WriteCompressed(data, 333, SmallBlockOptions());
+
+  std::unique_ptr<RandomAccessFile> file_reader;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(fname, &file_reader));
+  ZstdInputStream in(new RandomAccessInputStream(file_reader.get()), true);
+
+  tstring result;
+  for (int64_t target : {0, 5, 999, 1000, 1001, 15000, 7777, 19999, 3}) {
+    TF_ASSERT_OK(in.Reset());
+    TF_ASSERT_OK(in.SkipNBytes(target));
+    EXPECT_EQ(in.Tell(), target);
+    TF_ASSERT_OK(in.ReadNBytes(1, &result));
+    EXPECT_EQ(result, data.substr(target, 1)) << target;
+  }
+
+  TF_ASSERT_OK(in.Reset());
+  TF_ASSERT_OK(in.SkipNBytes(data.size()));
+  EXPECT_TRUE(absl::IsOutOfRange(in.SkipNBytes(1)));
+  EXPECT_EQ(in.Tell(), static_cast<int64_t>(data.size()));
+}
+
+TEST(ZstdBuffers, LoadBlockIndex) {
+  const std::string data = GenTestString(10500);
+  std::string fname = WriteCompressed(data, 4096, SmallBlockOptions());
+
+  // Corrupt the header of the first block. Seeking past it is only possible
+  // without reading it, i.e. with the index from the footer.
+  std::string contents;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), fname, &contents));
+  core::EncodeFixed32(&contents[sizeof(uint32_t)], kZstdMaxBlockSize + 1);
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), fname, contents));
+
+  std::unique_ptr<RandomAccessFile> file_reader;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(fname, &file_reader));
+  ZstdInputStream in(new RandomAccessInputStream(file_reader.get()), true);
+  TF_ASSERT_OK(in.LoadBlockIndex(file_reader.get(), contents.size()));
+  TF_ASSERT_OK(in.SkipNBytes(9876));
+  tstring result;
+  TF_ASSERT_OK(in.ReadNBytes(10, &result));
+  EXPECT_EQ(result, data.substr(9876, 10));
+  // Skipping to the end does not need to read any block.
+  TF_ASSERT_OK(in.SkipNBytes(data.size() - in.Tell()));
+  EXPECT_TRUE(absl::IsOutOfRange(in.ReadNBytes(1, &result)));
+
+  ZstdInputStream walking_in(new RandomAccessInputStream(file_reader.get()),
+                             true);
+  EXPECT_TRUE(absl::IsDataLoss(walking_in.SkipNBytes(9876)));
+}
+
+TEST(ZstdBuffers, UnclosedStreamIsReadable) {
+  const std::string data = GenTestString(3000);
+  std::string fname =
+      WriteCompressed(data, 3000, SmallBlockOptions(), /*close=*/false);
+
+  uint64_t file_size;
+  TF_ASSERT_OK(Env::Default()->GetFileSize(fname, &file_size));
+  std::unique_ptr<RandomAccessFile> file_reader;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(fname, &file_reader));
+  // The stream has no index block to stop at, only the end of the file.
+  ZstdInputStream in(new RandomAccessInputStream(file_reader.get()), true);
+  EXPECT_TRUE(
+      absl::IsDataLoss(in.LoadBlockIndex(file_reader.get(), file_size)));
+  tstring result;
+  TF_ASSERT_OK(in.ReadNBytes(data.size(), &result));
+  EXPECT_EQ(result, data);
+  EXPECT_TRUE(absl::IsOutOfRange(in.ReadNBytes(1, &result)));
+}
+
+TEST(ZstdBuffers, ValidateOptions) {
+  ZstdCompressionOptions options;
+  TF_EXPECT_OK(ZstdOutputBuffer::ValidateOptions(options));
+  for (int64_t block_size : {int64_t{0}, int64_t{-1},
+                             int64_t{kZstdMaxBlockSize}}) {
+    options.block_size = block_size;
+    EXPECT_TRUE(
+        absl::IsInvalidArgument(ZstdOutputBuffer::ValidateOptions(options)));
+  }
+}
+
+TEST(ZstdBuffers, CorruptedBlock) {
+  const std::string data = GenTestString(5000);
+  std::string fname = WriteCompressed(data, 5000, SmallBlockOptions());
+
+  std::string contents;
+  TF_ASSERT_OK(ReadFileToString(Env::Default(), fname, &contents));
+  const uint32_t compressed_length = core::DecodeFixed32(contents.data());
+  contents[kZstdBlockHeaderSize + compressed_length / 2] ^= 0x55;
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), fname, contents));
+
+  std::unique_ptr<RandomAccessFile> file_reader;
+  TF_ASSERT_OK(Env::Default()->NewRandomAccessFile(fname, &file_reader));
+  ZstdInputStream in(new RandomAccessInputStream(file_reader.get()), true);
+  tstring result;
+  EXPECT_TRUE(absl::IsDataLoss(in.ReadNBytes(10, &result)));
+}
+
+TEST(ZstdRecords, NonSequentialReads) {
+  RecordWriterOptions writer_options =
+      RecordWriterOptions::CreateRecordWriterOptions("ZSTD");
+  writer_options.zstd_options.block_size = 256;
+  Env* env = Env::Default();
+  std::string fname = testing::TmpDir() + "/zstd_records_test";
+  std::unique_ptr<WritableFile> file;
+  TF_ASSERT_OK(env->NewWritableFile(fname, &file));
+  {
+    RecordWriter writer(file.get(), writer_options);
+    for (int i = 0; i < 1000; ++i) {
+      TF_ASSERT_OK(writer.WriteRecord(GenTestString(i % 50)));
+    }
+    TF_ASSERT_OK(writer.Close());
+  }
+  TF_ASSERT_OK(file->Close());
+
+  std::unique_ptr<RandomAccessFile> read_file;
+  TF_ASSERT_OK(env->NewRandomAccessFile(fname, &read_file));
+  RecordReader reader(read_file.get(),
+                      RecordReaderOptions::CreateRecordReaderOptions("ZSTD"));
+  std::vector<uint64_t> offsets;
+  uint64_t offset = 0;
+  tstring record;
+  for (int i = 0; i < 1000; ++i) {
+    offsets.push_back(offset);
+    TF_ASSERT_OK(reader.ReadRecord(&offset, &record));
+    EXPECT_EQ(record, GenTestString(i % 50));
+  }
+  EXPECT_TRUE(absl::IsOutOfRange(reader.ReadRecord(&offset, &record)));
+
+  for (int i : {700, 3, 999, 0, 512}) {
+    offset = offsets[i];
+    TF_ASSERT_OK(reader.ReadRecord(&offset, &record));
+    EXPECT_EQ(record, GenTestString(i % 50)) << i;
+  }
+}
+
+}  // namespace
+}  // namespace io
+}  // namespace tsl